@@ -0,0 +1,618 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Await_hpp
+#define oatpp_async_Await_hpp
+
+/**
+ * Optional C++20 layer over oatpp coroutines. Header-only - the library itself is built as C++11,
+ * include this header from code compiled with C++20. <br>
+ * Coroutine function returns &l:Task; and is run on &id:oatpp::async::Processor; by &l:AwaitCoroutine;:
+ * ```
+ * oatpp::async::Task handle(std::shared_ptr<Connection> connection) {
+ *   co_await oatpp::async::waitForIO(connection->getHandle(), Action::IO_EVENT_READ);
+ *   co_await oatpp::async::action([&](AbstractCoroutine* parent, const Action& next) {
+ *     return oatpp::data::stream::transferAsync(parent, next, connection, output, 0, buffer);
+ *   });
+ *   auto response = co_await oatpp::async::callback<const std::shared_ptr<Response>&>([&](AbstractCoroutine* parent, auto callback) {
+ *     return requestExecutor->executeAsync(parent, callback, "GET", "/", headers, nullptr);
+ *   });
+ * }
+ *
+ * executor.execute<oatpp::async::AwaitCoroutine>(handle(connection));
+ * ```
+ */
+
+#if !defined(__cpp_impl_coroutine)
+#error "oatpp/core/async/Await.hpp requires C++20 coroutines"
+#endif
+
+#include "./Coroutine.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <cstddef>
+
+namespace oatpp { namespace async {
+
+class AwaitCoroutine; // FWD
+
+/**
+ * Allocator of C++20 coroutine frames. Frames are taken from the thread's &id:oatpp::async::FramePool; -
+ * they share size classes with frames of other coroutines. Frame may be freed on another thread -
+ * it goes back to the pool it was taken from.
+ * Frames larger than the biggest size class are allocated with operator new.
+ */
+class FrameAllocator {
+public:
+  
+  /**
+   * Biggest pooled frame size.
+   */
+  static constexpr const v_int32 MAX_POOLED_SIZE = FramePool::MAX_POOLED_FRAME_SIZE - FramePool::HEADER_SIZE;
+  
+  static void* allocate(std::size_t size) {
+    static thread_local FramePool::Counters* counters = nullptr;
+    FramePool& pool = FramePool::getThreadPool();
+    if(counters == nullptr) {
+      counters = pool.getCounters(typeid(FrameAllocator), 0);
+    }
+    return pool.allocate(counters, (v_int32) size);
+  }
+  
+  static void deallocate(void* ptr, std::size_t size) {
+    (void) size;
+    FramePool::free(ptr);
+  }
+  
+};
+
+/**
+ * Return type of C++20 coroutine functions run by &l:AwaitCoroutine;.
+ * Task starts suspended. It is started either by &l:AwaitCoroutine; or by `co_await` from another Task.
+ * Tasks awaited by each other run within the same step of &l:AwaitCoroutine; - there is no Processor round trip. <br>
+ * Exception not handled by Task is rethrown from `co_await` of the awaiting Task.
+ * Exception not handled by the top-level Task unwinds &l:AwaitCoroutine; with an error.
+ */
+class Task {
+public:
+  
+  class promise_type; // FWD
+  typedef std::coroutine_handle<promise_type> Handle;
+  
+  class FinalAwaiter {
+  public:
+    bool await_ready() noexcept { return false; }
+    void await_suspend(Handle handle) noexcept;
+    void await_resume() noexcept {}
+  };
+  
+  class promise_type {
+  public:
+    /* Coroutine which runs the chain of Tasks. Set once Task is started */
+    AwaitCoroutine* coroutine = nullptr;
+    /* Task to resume once this one is done */
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+  public:
+    
+    Task get_return_object() {
+      return Task(Handle::from_promise(*this));
+    }
+    
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+    
+    FinalAwaiter final_suspend() noexcept {
+      return {};
+    }
+    
+    void return_void() {}
+    
+    void unhandled_exception() {
+      exception = std::current_exception();
+    }
+    
+    static void* operator new(std::size_t size) {
+      return FrameAllocator::allocate(size);
+    }
+    
+    static void operator delete(void* ptr, std::size_t size) {
+      FrameAllocator::deallocate(ptr, size);
+    }
+    
+  };
+  
+  /**
+   * Awaiter of Task awaited by another Task. Child Task runs on the same &l:AwaitCoroutine;.
+   */
+  class Awaiter {
+  private:
+    Handle m_handle;
+  public:
+    
+    Awaiter(Handle handle)
+      : m_handle(handle)
+    {}
+    
+    bool await_ready() noexcept {
+      return false;
+    }
+    
+    void await_suspend(Handle parent) noexcept;
+    void await_resume();
+    
+  };
+  
+private:
+  Handle m_handle;
+public:
+  
+  explicit Task(Handle handle)
+    : m_handle(handle)
+  {}
+  
+  Task(Task&& other) noexcept
+    : m_handle(other.m_handle)
+  {
+    other.m_handle = nullptr;
+  }
+  
+  Task& operator = (Task&& other) noexcept {
+    if(this != &other) {
+      if(m_handle) {
+        m_handle.destroy();
+      }
+      m_handle = other.m_handle;
+      other.m_handle = nullptr;
+    }
+    return *this;
+  }
+  
+  Task(const Task&) = delete;
+  Task& operator = (const Task&) = delete;
+  
+  ~Task() {
+    if(m_handle) {
+      m_handle.destroy();
+    }
+  }
+  
+  Handle getHandle() const {
+    return m_handle;
+  }
+  
+  Awaiter operator co_await() const noexcept {
+    return Awaiter(m_handle);
+  }
+  
+};
+
+/**
+ * Coroutine which runs &l:Task; on &id:oatpp::async::Processor;. <br>
+ * Each `co_await` suspends the Task and hands the Action of the awaited operation to the Processor -
+ * I/O waits, timers, wait lists and child coroutines are handled the same way as for regular coroutines.
+ * Errors of child coroutines, deadlines and cancellation are thrown as &id:oatpp::async::Error; from `co_await`.
+ */
+class AwaitCoroutine : public Coroutine<AwaitCoroutine> {
+  friend Task;
+public:
+  
+  /**
+   * Operation re-checked each time the coroutine is resumed, until it's done.
+   */
+  class Retry {
+  public:
+    virtual ~Retry() = default;
+    
+    /**
+     * @return - Action to wait on, or any other action if operation is done.
+     */
+    virtual Action check() = 0;
+  };
+  
+private:
+  Task m_task;
+  /* Innermost Task of the chain - the one to resume */
+  std::coroutine_handle<> m_current;
+  /* Switch between Tasks of the chain. Tasks are resumed in a loop - symmetric transfer isn't a guaranteed tail call */
+  bool m_switchTask;
+  Action m_action;
+  Retry* m_retry;
+  void* m_result;
+  Error m_error;
+  bool m_hasError;
+public:
+  
+  AwaitCoroutine(Task task)
+    : m_task(std::move(task))
+    , m_current(m_task.getHandle())
+    , m_switchTask(false)
+    , m_action(Action::_FINISH)
+    , m_retry(nullptr)
+    , m_result(nullptr)
+    , m_error(nullptr)
+    , m_hasError(false)
+  {
+    m_task.getHandle().promise().coroutine = this;
+  }
+  
+  /**
+   * Run Task as child of a regular coroutine.
+   * @param actionOnReturn - action of the parent coroutine to take once Task is done.
+   * @param task - &l:Task;.
+   * @return - Action to return from the parent coroutine.
+   */
+  static Action start(const Action& actionOnReturn, Task task) {
+    AwaitCoroutine* coroutine = getBench().obtain(std::move(task));
+    coroutine->m_parentReturnAction = actionOnReturn;
+    return Action(Action::TYPE_COROUTINE, coroutine, nullptr);
+  }
+  
+  static bool isWaitAction(const Action& action) {
+    switch(action.getType()) {
+      case Action::TYPE_WAIT_RETRY:
+      case Action::TYPE_WAIT_FOR_IO:
+      case Action::TYPE_WAIT_UNTIL:
+      case Action::TYPE_WAIT_LIST:
+        return true;
+      default:
+        return false;
+    }
+  }
+  
+  Action act() override {
+    
+    if(m_retry != nullptr) {
+      Action action = m_retry->check();
+      if(isWaitAction(action)) {
+        return action;
+      }
+      m_retry = nullptr;
+    }
+    
+    m_action = Action(Error("[oatpp::async::AwaitCoroutine::act()]: Task suspended on unsupported awaitable"));
+    do {
+      m_switchTask = false;
+      m_current.resume();
+    } while(m_switchTask);
+    
+    Task::Handle handle = m_task.getHandle();
+    if(handle.done()) {
+      if(handle.promise().exception) {
+        std::rethrow_exception(handle.promise().exception);
+      }
+      return finish();
+    }
+    
+    return m_action;
+    
+  }
+  
+  Action handleError(const Error& error) override {
+    if(m_task.getHandle().done()) {
+      return error;
+    }
+    /* Throw error from co_await of the suspended Task */
+    m_error = error;
+    m_hasError = true;
+    m_retry = nullptr;
+    return yieldTo(&AwaitCoroutine::act);
+  }
+  
+  /**
+   * Callback for child coroutines returning result. See &l:callback ();.
+   */
+  template<typename Arg>
+  Action onResult(Arg value) {
+    static_cast<std::optional<typename std::decay<Arg>::type>*>(m_result)->emplace(value);
+    return yieldTo(&AwaitCoroutine::act);
+  }
+  
+  /**
+   * Suspend Task. Called by awaiters.
+   * @param handle - Task being suspended.
+   * @param action - Action for Processor.
+   * @param retry - operation to re-check on resume. May be nullptr.
+   */
+  void suspend(std::coroutine_handle<> handle, const Action& action, Retry* retry = nullptr) {
+    m_current = handle;
+    m_action = action;
+    m_retry = retry;
+  }
+  
+  void setResultSlot(void* result) {
+    m_result = result;
+  }
+  
+  /**
+   * Throw error delivered by &l:AwaitCoroutine::handleError ();. Called by awaiters on resume.
+   */
+  void checkError() {
+    if(m_hasError) {
+      m_hasError = false;
+      throw m_error;
+    }
+  }
+  
+};
+
+inline void Task::FinalAwaiter::await_suspend(Handle handle) noexcept {
+  promise_type& promise = handle.promise();
+  if(promise.continuation) {
+    promise.coroutine->m_current = promise.continuation;
+    promise.coroutine->m_switchTask = true;
+  }
+}
+
+inline void Task::Awaiter::await_suspend(Handle parent) noexcept {
+  promise_type& promise = m_handle.promise();
+  promise.coroutine = parent.promise().coroutine;
+  promise.continuation = parent;
+  promise.coroutine->m_current = m_handle;
+  promise.coroutine->m_switchTask = true;
+}
+
+inline void Task::Awaiter::await_resume() {
+  if(m_handle.promise().exception) {
+    std::rethrow_exception(m_handle.promise().exception);
+  }
+}
+
+/**
+ * Awaiter which suspends Task with a fixed Action.
+ */
+class ActionAwaiter {
+private:
+  Action m_action;
+  AwaitCoroutine* m_coroutine;
+public:
+  
+  ActionAwaiter(const Action& action)
+    : m_action(action)
+    , m_coroutine(nullptr)
+  {}
+  
+  bool await_ready() noexcept {
+    return false;
+  }
+  
+  void await_suspend(Task::Handle handle) {
+    m_coroutine = handle.promise().coroutine;
+    m_coroutine->suspend(handle, m_action);
+  }
+  
+  void await_resume() {
+    m_coroutine->checkError();
+  }
+  
+};
+
+/**
+ * Let other coroutines run. Task is resumed on the next iteration.
+ */
+inline ActionAwaiter yield() {
+  return ActionAwaiter(Action::_REPEAT);
+}
+
+/**
+ * Suspend Task until I/O handle is ready.
+ * @param ioHandle - handle to wait on.
+ * @param ioEventType - Action::IO_EVENT_READ or Action::IO_EVENT_WRITE.
+ */
+inline ActionAwaiter waitForIO(data::v_io_handle ioHandle, v_int32 ioEventType) {
+  return ActionAwaiter(Action::createIOWaitAction(ioHandle, ioEventType));
+}
+
+/**
+ * Suspend Task for timeout.
+ * @param timeout - e.g. `std::chrono::milliseconds(50)`.
+ */
+inline ActionAwaiter waitFor(const std::chrono::duration<v_int64, std::micro>& timeout) {
+  return ActionAwaiter(Action::createWaitUntilAction(oatpp::base::Environment::getMicroTickCount() + timeout.count()));
+}
+
+/**
+ * Suspend Task until time point.
+ * @param timePointMicros - time point in microseconds. See &id:oatpp::base::Environment::getMicroTickCount;.
+ */
+inline ActionAwaiter waitUntil(v_int64 timePointMicros) {
+  return ActionAwaiter(Action::createWaitUntilAction(timePointMicros));
+}
+
+/**
+ * Awaiter of operation which may have to wait - see &l:retry ();.
+ */
+template<typename F>
+class RetryAwaiter : public AwaitCoroutine::Retry {
+private:
+  F m_function;
+  Action m_action;
+  AwaitCoroutine* m_coroutine;
+public:
+  
+  RetryAwaiter(F function)
+    : m_function(std::move(function))
+    , m_action(Action::_FINISH)
+    , m_coroutine(nullptr)
+  {}
+  
+  Action check() override {
+    m_action = m_function(Action::_FINISH);
+    return m_action;
+  }
+  
+  bool await_ready() {
+    return !AwaitCoroutine::isWaitAction(check());
+  }
+  
+  void await_suspend(Task::Handle handle) {
+    m_coroutine = handle.promise().coroutine;
+    m_coroutine->suspend(handle, m_action, this);
+  }
+  
+  Action await_resume() {
+    if(m_coroutine != nullptr) {
+      m_coroutine->checkError();
+    }
+    return m_action;
+  }
+  
+};
+
+/**
+ * Await operation of style `Action op(const Action& next)` which returns `next` when done,
+ * or an Action to wait on (e.g. I/O or wait list) after which it has to be repeated.
+ * Async primitives are of this style:
+ * ```
+ * co_await oatpp::async::retry([&](const Action& next) { return mutex->lock(next); });
+ * ```
+ * @param function - operation. Called with Action::_FINISH as `next`.
+ * @return - awaiter. `co_await` returns the last Action returned by the operation.
+ */
+template<typename F>
+RetryAwaiter<F> retry(F function) {
+  return RetryAwaiter<F>(std::move(function));
+}
+
+/**
+ * Awaiter of operation which returns to the Task through Action - see &l:action ();.
+ */
+template<typename F>
+class ActionCallAwaiter {
+private:
+  F m_function;
+  AwaitCoroutine* m_coroutine;
+public:
+  
+  ActionCallAwaiter(F function)
+    : m_function(std::move(function))
+    , m_coroutine(nullptr)
+  {}
+  
+  bool await_ready() noexcept {
+    return false;
+  }
+  
+  void await_suspend(Task::Handle handle) {
+    m_coroutine = handle.promise().coroutine;
+    m_coroutine->suspend(handle, m_function(m_coroutine, m_coroutine->yieldTo(&AwaitCoroutine::act)));
+  }
+  
+  void await_resume() {
+    m_coroutine->checkError();
+  }
+  
+};
+
+/**
+ * Await operation of style `Action op(AbstractCoroutine* parent, const Action& actionOnReturn, ...)`.
+ * ```
+ * co_await oatpp::async::action([&](AbstractCoroutine* parent, const Action& next) {
+ *   return oatpp::data::stream::transferAsync(parent, next, fromStream, toStream, 0, buffer);
+ * });
+ * ```
+ * @param function - `Action(AbstractCoroutine* parent, const Action& next)`.
+ */
+template<typename F>
+ActionCallAwaiter<F> action(F function) {
+  return ActionCallAwaiter<F>(std::move(function));
+}
+
+/**
+ * Awaiter of operation which returns result through callback - see &l:callback ();.
+ */
+template<typename Arg, typename F>
+class CallbackAwaiter {
+public:
+  typedef typename std::decay<Arg>::type Result;
+  typedef Action (AbstractCoroutine::*Callback)(Arg);
+private:
+  F m_function;
+  AwaitCoroutine* m_coroutine;
+  std::optional<Result> m_result;
+public:
+  
+  CallbackAwaiter(F function)
+    : m_function(std::move(function))
+    , m_coroutine(nullptr)
+  {}
+  
+  bool await_ready() noexcept {
+    return false;
+  }
+  
+  void await_suspend(Task::Handle handle) {
+    m_coroutine = handle.promise().coroutine;
+    m_coroutine->setResultSlot(&m_result);
+    Callback callback = static_cast<Callback>(&AwaitCoroutine::template onResult<Arg>);
+    m_coroutine->suspend(handle, m_function(m_coroutine, callback));
+  }
+  
+  Result await_resume() {
+    m_coroutine->checkError();
+    m_coroutine->setResultSlot(nullptr);
+    if(!m_result) {
+      throw Error("[oatpp::async::CallbackAwaiter::await_resume()]: Operation finished without result");
+    }
+    return std::move(*m_result);
+  }
+  
+};
+
+/**
+ * Await operation of style `Action op(AbstractCoroutine* parent, Callback callback, ...)`
+ * where `Callback` is `Action (AbstractCoroutine::*)(Arg)`.
+ * ```
+ * auto response = co_await oatpp::async::callback<const std::shared_ptr<Response>&>([&](AbstractCoroutine* parent, auto callback) {
+ *   return requestExecutor->executeAsync(parent, callback, "GET", "/", headers, nullptr);
+ * });
+ * ```
+ * @tparam Arg - argument type of the callback.
+ * @param function - `Action(AbstractCoroutine* parent, Callback callback)`.
+ * @return - awaiter. `co_await` returns the value passed to callback.
+ */
+template<typename Arg, typename F>
+CallbackAwaiter<Arg, F> callback(F function) {
+  return CallbackAwaiter<Arg, F>(std::move(function));
+}
+
+/**
+ * Run regular coroutine as child of the Task and await until it finishes.
+ * @tparam C - coroutine type.
+ * @param args - coroutine constructor arguments.
+ */
+template<typename C, typename ... Args>
+auto child(Args... args) {
+  return action([args...](AbstractCoroutine* parent, const Action& next) {
+    return parent->template startCoroutine<C>(next, args...);
+  });
+}
+
+}}
+
+#endif /* oatpp_async_Await_hpp */
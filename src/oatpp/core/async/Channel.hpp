@@ -0,0 +1,219 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Channel_hpp
+#define oatpp_async_Channel_hpp
+
+#include "./CoroutineWaitList.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace async {
+
+/**
+ * Bounded multi-producer multi-consumer channel for coroutines.
+ * Senders wait while channel is full, receivers wait while it's empty.
+ * Waiting coroutines are parked in &l:CoroutineWaitList; and take no processor time.
+ * Values may be sent and received from any thread with non-waiting &l:Channel::trySend (); and &l:Channel::tryReceive ();. <br>
+ * Usage:
+ * ```
+ * Action act() override {
+ *   return m_channel->receive(m_value, yieldTo(&MyCoroutine::onValue), finish());
+ * }
+ * ```
+ * @tparam T - value type. Should be default constructible and copy-assignable.
+ */
+template<typename T>
+class Channel : private CoroutineWaitList::Listener {
+public:
+  /**
+   * Value sent or received.
+   */
+  static constexpr const v_int32 RESULT_OK = 0;
+  
+  /**
+   * Channel is full (on send) or empty (on receive).
+   */
+  static constexpr const v_int32 RESULT_WOULD_BLOCK = 1;
+  
+  /**
+   * Channel is closed (on send) or closed and drained (on receive).
+   */
+  static constexpr const v_int32 RESULT_CLOSED = 2;
+private:
+  oatpp::concurrency::SpinLock::Atom m_atom;
+  std::vector<T> m_buffer;
+  v_int32 m_head;
+  v_int32 m_count;
+  bool m_closed;
+  CoroutineWaitList m_senders;
+  CoroutineWaitList m_receivers;
+private:
+  
+  void onNewItem(CoroutineWaitList& list) override {
+    bool ready;
+    bool closed;
+    {
+      oatpp::concurrency::SpinLock lock(m_atom);
+      closed = m_closed;
+      if(&list == &m_senders) {
+        ready = m_count < (v_int32) m_buffer.size();
+      } else {
+        ready = m_count > 0;
+      }
+    }
+    if(closed) {
+      list.notifyAll();
+    } else if(ready) {
+      list.notifyFirst();
+    }
+  }
+  
+public:
+  
+  /**
+   * Constructor.
+   * @param capacity - max number of values buffered in the channel.
+   */
+  Channel(v_int32 capacity)
+    : m_atom(false)
+    , m_buffer(capacity > 0 ? capacity : 1)
+    , m_head(0)
+    , m_count(0)
+    , m_closed(false)
+    , m_senders(this)
+    , m_receivers(this)
+  {}
+  
+  static std::shared_ptr<Channel> createShared(v_int32 capacity) {
+    return std::make_shared<Channel>(capacity);
+  }
+  
+  /**
+   * Send value if there is room in the channel. Doesn't wait.
+   * @param value
+   * @return - &l:Channel::RESULT_OK;, &l:Channel::RESULT_WOULD_BLOCK; or &l:Channel::RESULT_CLOSED;.
+   */
+  v_int32 trySend(const T& value) {
+    {
+      oatpp::concurrency::SpinLock lock(m_atom);
+      if(m_closed) {
+        return RESULT_CLOSED;
+      }
+      if(m_count == (v_int32) m_buffer.size()) {
+        return RESULT_WOULD_BLOCK;
+      }
+      m_buffer[(m_head + m_count) % m_buffer.size()] = value;
+      m_count ++;
+    }
+    m_receivers.notifyFirst();
+    return RESULT_OK;
+  }
+  
+  /**
+   * Receive value if channel is not empty. Doesn't wait.
+   * @param value - out parameter.
+   * @return - &l:Channel::RESULT_OK;, &l:Channel::RESULT_WOULD_BLOCK; or &l:Channel::RESULT_CLOSED;.
+   */
+  v_int32 tryReceive(T& value) {
+    {
+      oatpp::concurrency::SpinLock lock(m_atom);
+      if(m_count == 0) {
+        return m_closed ? RESULT_CLOSED : RESULT_WOULD_BLOCK;
+      }
+      value = std::move(m_buffer[m_head]);
+      m_buffer[m_head] = T();
+      m_head = (m_head + 1) % m_buffer.size();
+      m_count --;
+    }
+    m_senders.notifyFirst();
+    return RESULT_OK;
+  }
+  
+  /**
+   * Send value or park the coroutine until there is room in the channel.
+   * Parked coroutine repeats the calling function once notified.
+   * Actions should not start coroutines - they would be leaked on wait.
+   * @param value
+   * @param onSent - action to take once value is sent.
+   * @param onClosed - action to take if channel is closed.
+   * @return - one of the actions or wait action.
+   */
+  Action send(const T& value, const Action& onSent, const Action& onClosed) {
+    switch(trySend(value)) {
+      case RESULT_OK: return onSent;
+      case RESULT_CLOSED: return onClosed;
+      default: return Action::createWaitListAction(&m_senders);
+    }
+  }
+  
+  /**
+   * Receive value or park the coroutine until there is value in the channel.
+   * Parked coroutine repeats the calling function once notified.
+   * Actions should not start coroutines - they would be leaked on wait.
+   * @param value - out parameter.
+   * @param onReceived - action to take once value is received.
+   * @param onClosed - action to take if channel is closed and all values are received.
+   * @return - one of the actions or wait action.
+   */
+  Action receive(T& value, const Action& onReceived, const Action& onClosed) {
+    switch(tryReceive(value)) {
+      case RESULT_OK: return onReceived;
+      case RESULT_CLOSED: return onClosed;
+      default: return Action::createWaitListAction(&m_receivers);
+    }
+  }
+  
+  /**
+   * Close channel. Values can't be sent anymore, buffered values may still be received.
+   * All waiting coroutines are resumed.
+   */
+  void close() {
+    {
+      oatpp::concurrency::SpinLock lock(m_atom);
+      m_closed = true;
+    }
+    m_senders.notifyAll();
+    m_receivers.notifyAll();
+  }
+  
+  bool isClosed() {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    return m_closed;
+  }
+  
+  /**
+   * @return - number of buffered values.
+   */
+  v_int32 getCount() {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    return m_count;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Channel_hpp */
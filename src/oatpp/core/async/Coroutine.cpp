@@ -24,8 +24,19 @@
 
 #include "Coroutine.hpp"
 
+#include <cstdint>
+#include <cstring>
+
 namespace oatpp { namespace async {
   
+const char* const Error::TIMEOUT = "[oatpp::async::Error]: Deadline exceeded";
+const char* const Error::CANCELLED = "[oatpp::async::Error]: Cancelled";
+
+constexpr const v_int32 Priority::LATENCY;
+constexpr const v_int32 Priority::NORMAL;
+constexpr const v_int32 Priority::BULK;
+constexpr const v_int32 Priority::CLASSES_COUNT;
+  
 const Action Action::_WAIT_RETRY(TYPE_WAIT_RETRY, nullptr, nullptr);
 const Action Action::_REPEAT(TYPE_REPEAT, nullptr, nullptr);
 const Action Action::_FINISH(TYPE_FINISH, nullptr, nullptr);
@@ -38,6 +49,10 @@ Action::Action(v_int32 type,
   , m_coroutine(coroutine)
   , m_functionPtr(functionPtr)
   , m_error(Error(nullptr))
+  , m_ioHandle(-1)
+  , m_ioEventType(0)
+  , m_timePointMicros(0)
+  , m_waitList(nullptr)
 {}
 
 Action::Action(const Error& error)
@@ -45,8 +60,31 @@ Action::Action(const Error& error)
   , m_coroutine(nullptr)
   , m_functionPtr(nullptr)
   , m_error(error)
+  , m_ioHandle(-1)
+  , m_ioEventType(0)
+  , m_timePointMicros(0)
+  , m_waitList(nullptr)
 {}
 
+Action Action::createIOWaitAction(data::v_io_handle ioHandle, v_int32 ioEventType) {
+  Action action(TYPE_WAIT_FOR_IO, nullptr, nullptr);
+  action.m_ioHandle = ioHandle;
+  action.m_ioEventType = ioEventType;
+  return action;
+}
+
+Action Action::createWaitUntilAction(v_int64 timePointMicros) {
+  Action action(TYPE_WAIT_UNTIL, nullptr, nullptr);
+  action.m_timePointMicros = timePointMicros;
+  return action;
+}
+
+Action Action::createWaitListAction(CoroutineWaitList* waitList) {
+  Action action(TYPE_WAIT_LIST, nullptr, nullptr);
+  action.m_waitList = waitList;
+  return action;
+}
+
 bool Action::isError(){
   return m_type == TYPE_ERROR;
 }
@@ -58,4 +96,78 @@ void Action::free() {
   }
 }
   
+bool AbstractCoroutine::checkInterrupt(v_int64 currentMicros) {
+  AbstractCoroutine* curr = _CP;
+  while (curr != nullptr) {
+    if(curr->m_deadline > 0 && curr->m_deadline <= currentMicros) {
+      curr->m_deadline = 0;
+      _interruptError = Error::TIMEOUT;
+      return true;
+    }
+    if(curr->m_cancellationHandle && curr->m_cancellationHandle->isCancelled()) {
+      curr->m_cancellationHandle.reset();
+      _interruptError = Error::CANCELLED;
+      return true;
+    }
+    if(curr == this) {
+      break;
+    }
+    curr = curr->m_parent;
+  }
+  return false;
+}
+
+const void* AbstractCoroutine::getStepAddress(AbstractCoroutine* coroutine, FunctionPtr step) {
+#if defined(__GNUC__)
+  /* Itanium C++ ABI: pointer to member function is {ptr, adj}. For virtual function ptr is 1 + offset in vtable.
+   * ARM variant keeps the virtual flag in the lowest bit of adj. Coroutines use single inheritance -
+   * object address is the same for AbstractCoroutine and for the derived type */
+  struct {
+    std::uintptr_t ptr;
+    std::ptrdiff_t adj;
+  } repr;
+  static_assert(sizeof(repr) == sizeof(FunctionPtr), "Unexpected pointer to member function layout");
+  std::memcpy(&repr, &step, sizeof(repr));
+#if defined(__arm__) || defined(__aarch64__)
+  bool isVirtual = (repr.adj & 1) != 0;
+  std::uintptr_t vtableOffset = repr.ptr;
+  std::ptrdiff_t adj = repr.adj >> 1;
+#else
+  bool isVirtual = (repr.ptr & 1) != 0;
+  std::uintptr_t vtableOffset = repr.ptr - 1;
+  std::ptrdiff_t adj = repr.adj;
+#endif
+  if(isVirtual) {
+    const char* object = reinterpret_cast<const char*>(coroutine) + adj;
+    const char* vtable = *reinterpret_cast<const char* const*>(object);
+    return *reinterpret_cast<const void* const*>(vtable + vtableOffset);
+  }
+  return reinterpret_cast<const void*>(repr.ptr);
+#else
+  return nullptr;
+#endif
+}
+
+Action AbstractCoroutine::iterateProfiled() {
+  
+  AbstractCoroutine* coroutine = _CP;
+  FunctionPtr step = _FP;
+  
+  v_int64 startNanos = Profiler::getNanoTickCount();
+  Action action = Action::_REPEAT;
+  try {
+    action = _CP->call(_FP);
+  } catch (...) {
+    action = Action(Error("Exception", true));
+  }
+  Profiler::record(typeid(*coroutine), getStepAddress(coroutine, step), Profiler::getNanoTickCount() - startNanos);
+  
+  try {
+    return takeAction(action);
+  } catch (...) {
+    return takeAction(Action(Error("Exception", true)));
+  }
+  
+}
+  
 }}
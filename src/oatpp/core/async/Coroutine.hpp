@@ -25,16 +25,38 @@
 #ifndef oatpp_async_Coroutine_hpp
 #define oatpp_async_Coroutine_hpp
 
+#include "./FramePool.hpp"
+#include "./Profiler.hpp"
+
+#include "oatpp/core/data/IODefinitions.hpp"
 #include "oatpp/core/collection/FastQueue.hpp"
+#include "oatpp/core/collection/MPSCQueue.hpp"
+#include "oatpp/core/concurrency/SpinLock.hpp"
 #include "oatpp/core/base/memory/MemoryPool.hpp"
 #include "oatpp/core/base/Environment.hpp"
 
+#include <chrono>
+#include <atomic>
+#include <memory>
+
 namespace oatpp { namespace async {
 
 class AbstractCoroutine; // FWD
 class Processor; // FWD
+class TimerWheel; // FWD
+class CoroutineWaitList; // FWD
   
 class Error {
+public:
+  /**
+   * Message of the error passed to handleError() when deadline of the coroutine chain has passed.
+   */
+  static const char* const TIMEOUT;
+  
+  /**
+   * Message of the error passed to handleError() when coroutine chain was cancelled via &l:CancellationHandle;.
+   */
+  static const char* const CANCELLED;
 public:
 
   Error(const char* pMessage, bool pIsExceptionThrown = false)
@@ -45,6 +67,81 @@ public:
   const char* message;
   bool isExceptionThrown;
   
+  bool isTimeout() const {
+    return message == TIMEOUT;
+  }
+  
+  bool isCancelled() const {
+    return message == CANCELLED;
+  }
+  
+};
+  
+/**
+ * Handle to cancel coroutine chain from any thread.
+ * Once cancelled, coroutine chain is unwound through handleError() with &l:Error::CANCELLED; error.
+ */
+class CancellationHandle {
+private:
+  std::atomic<bool> m_cancelled;
+public:
+  
+  CancellationHandle()
+    : m_cancelled(false)
+  {}
+  
+  static std::shared_ptr<CancellationHandle> createShared() {
+    return std::make_shared<CancellationHandle>();
+  }
+  
+  void cancel() {
+    m_cancelled = true;
+  }
+  
+  bool isCancelled() const {
+    return m_cancelled;
+  }
+  
+};
+
+/**
+ * Scheduling classes of coroutines. <br>
+ * &l:Processor; shares its time between classes having runnable coroutines in proportion to class weights.
+ * Within the share, the class of higher priority runs first.
+ */
+class Priority {
+public:
+  /**
+   * Small latency-sensitive calls - health checks, metadata, etc.
+   */
+  static constexpr const v_int32 LATENCY = 0;
+  
+  /**
+   * Default class.
+   */
+  static constexpr const v_int32 NORMAL = 1;
+  
+  /**
+   * Large transfers and bulk processing.
+   */
+  static constexpr const v_int32 BULK = 2;
+  
+  static constexpr const v_int32 CLASSES_COUNT = 3;
+public:
+  
+  /**
+   * Get share weight of priority class.
+   * @param priority - &l:Priority::LATENCY;, &l:Priority::NORMAL; or &l:Priority::BULK;.
+   * @return - weight.
+   */
+  static v_int32 getWeight(v_int32 priority) {
+    switch (priority) {
+      case LATENCY: return 8;
+      case NORMAL: return 4;
+      default: return 1;
+    }
+  }
+  
 };
   
 class Action {
@@ -60,6 +157,12 @@ public:
   static constexpr const v_int32 TYPE_FINISH = 4;
   static constexpr const v_int32 TYPE_ABORT = 5;
   static constexpr const v_int32 TYPE_ERROR = 6;
+  static constexpr const v_int32 TYPE_WAIT_FOR_IO = 7;
+  static constexpr const v_int32 TYPE_WAIT_UNTIL = 8;
+  static constexpr const v_int32 TYPE_WAIT_LIST = 9;
+public:
+  static constexpr const v_int32 IO_EVENT_READ = 1;
+  static constexpr const v_int32 IO_EVENT_WRITE = 2;
 public:
   static const Action _WAIT_RETRY;
   static const Action _REPEAT;
@@ -70,6 +173,10 @@ private:
   AbstractCoroutine* m_coroutine;
   FunctionPtr m_functionPtr;
   Error m_error;
+  data::v_io_handle m_ioHandle;
+  v_int32 m_ioEventType;
+  v_int64 m_timePointMicros;
+  CoroutineWaitList* m_waitList;
 protected:
   void free();
 public:
@@ -79,13 +186,59 @@ public:
          FunctionPtr functionPtr);
   
   Action(const Error& error);
+  
+  /**
+   * Create action which parks coroutine until ioHandle is ready for ioEventType.
+   * Coroutine will repeat the same function once I/O is ready.
+   * @param ioHandle - handle to wait on.
+   * @param ioEventType - Action::IO_EVENT_READ or Action::IO_EVENT_WRITE.
+   */
+  static Action createIOWaitAction(data::v_io_handle ioHandle, v_int32 ioEventType);
+  
+  /**
+   * Create action which parks coroutine until timePointMicros.
+   * Coroutine will repeat the same function once time point is reached.
+   * @param timePointMicros - time point in microseconds. See &id:oatpp::base::Environment::getMicroTickCount;.
+   */
+  static Action createWaitUntilAction(v_int64 timePointMicros);
+  
+  /**
+   * Create action which parks coroutine in the wait list until the list notifies it.
+   * Coroutine will repeat the same function once notified.
+   * @param waitList - &id:oatpp::async::CoroutineWaitList;.
+   */
+  static Action createWaitListAction(CoroutineWaitList* waitList);
+  
   bool isError();
   
+  v_int32 getType() const {
+    return m_type;
+  }
+  
+  data::v_io_handle getIOHandle() const {
+    return m_ioHandle;
+  }
+  
+  v_int32 getIOEventType() const {
+    return m_ioEventType;
+  }
+  
+  v_int64 getTimePointMicros() const {
+    return m_timePointMicros;
+  }
+  
+  CoroutineWaitList* getWaitList() const {
+    return m_waitList;
+  }
+  
 };
   
 class AbstractCoroutine {
   friend oatpp::collection::FastQueue<AbstractCoroutine>;
+  friend oatpp::collection::MPSCQueue<AbstractCoroutine>;
   friend Processor;
+  friend TimerWheel;
+  friend CoroutineWaitList;
 public:
   typedef oatpp::async::Action Action;
   typedef Action (AbstractCoroutine::*FunctionPtr)();
@@ -112,6 +265,46 @@ private:
   AbstractCoroutine* _CP = this;
   FunctionPtr _FP = &AbstractCoroutine::act;
   AbstractCoroutine* _ref = nullptr;
+private:
+  /* Previous link of Processor's list of coroutines parked for I/O or of CoroutineWaitList. _ref is used as the next link */
+  AbstractCoroutine* _prevRef = nullptr;
+  data::v_io_handle _ioHandle = -1;
+  /* TimerWheel's bookkeeping. Tick at which coroutine should be resumed */
+  v_int64 _timerTick = 0;
+  /* Error to unwind the chain with on the next iteration. Set by Processor */
+  const char* _interruptError = nullptr;
+  /* Processor which runs the coroutine. Coroutines parked in a CoroutineWaitList are resumed on it */
+  Processor* _processor = nullptr;
+  /* Time coroutine entered processor's waiting queue or started to wait for I/O. Used for metrics */
+  v_int64 _waitStartMicros = 0;
+  /* Wait list the coroutine is parked in. Cleared by the list under _parkAtom once coroutine is notified */
+  CoroutineWaitList* _waitList = nullptr;
+  oatpp::concurrency::SpinLock::Atom _parkAtom {false};
+  /* Processor's list of coroutines parked in wait lists */
+  AbstractCoroutine* _parkedPrev = nullptr;
+  AbstractCoroutine* _parkedNext = nullptr;
+  
+  /**
+   * Check deadlines and cancellation handles of the chain from _CP up to this coroutine.
+   * If triggered, schedule unwinding of the chain on the next iteration. Triggered deadline/handle is cleared.
+   * @param currentMicros - current time.
+   * @return - true if chain has to be unwound.
+   */
+  bool checkInterrupt(v_int64 currentMicros);
+  
+  /**
+   * Get code address of the step function. Used by &l:Profiler;.
+   * @param coroutine - coroutine the step belongs to.
+   * @param step - step function.
+   * @return - code address or `nullptr` if it can't be resolved on this platform.
+   */
+  static const void* getStepAddress(AbstractCoroutine* coroutine, FunctionPtr step);
+  
+  /**
+   * Same as iterate() but measures the step and records it to &l:Profiler;.
+   * @return
+   */
+  Action iterateProfiled();
   
   Action takeAction(const Action& action){
     
@@ -180,11 +373,23 @@ private:
   
 private:
   AbstractCoroutine* m_parent = nullptr;
+  v_int64 m_deadline = 0;
+  v_int32 m_priority = Priority::NORMAL;
+  bool m_pinned = false;
+  std::shared_ptr<CancellationHandle> m_cancellationHandle;
 protected:
   Action m_parentReturnAction = Action::_FINISH;
 public:
   
   Action iterate() {
+    if(_interruptError != nullptr) {
+      Error error(_interruptError);
+      _interruptError = nullptr;
+      return takeAction(Action(error));
+    }
+    if(Profiler::isEnabled() && Profiler::takeSample()) {
+      return iterateProfiled();
+    }
     try {
       return takeAction(_CP->call(_FP));
     } catch (...) {
@@ -192,16 +397,23 @@ public:
     }
   };
   
-  /*Action iterate(v_int32 numIterations) {
-    Action action(Action::TYPE_FINISH, nullptr, nullptr);
-    for(v_int32 i = 0; i < numIterations; i++) {
-      action = takeAction(_CP->call(_FP));
-      if(action.m_type == Action::TYPE_WAIT_RETRY || _CP == nullptr) {
-        return action;
-      }
+  /**
+   * Burst execution. Iterate coroutine until it has to wait, finishes, or makes `maxSteps` steps.
+   * @param maxSteps - step budget.
+   * @param stepsCount - out parameter. Number of steps made.
+   * @return - action of the last step.
+   */
+  Action iterate(v_int32 maxSteps, v_int32& stepsCount) {
+    Action action = iterate();
+    stepsCount = 1;
+    while(stepsCount < maxSteps && _CP != nullptr &&
+          (action.m_type == Action::TYPE_YIELD_TO || action.m_type == Action::TYPE_REPEAT || action.m_type == Action::TYPE_COROUTINE))
+    {
+      action = iterate();
+      stepsCount ++;
     }
     return action;
-  };*/
+  }
   
   virtual ~AbstractCoroutine(){
     m_parentReturnAction.free();
@@ -211,9 +423,9 @@ public:
   virtual Action call(FunctionPtr ptr) = 0;
   
   /**
-   *  Internal function. Should free Coroutine on MemoryPool/Bench
+   *  Internal function. Should free Coroutine on &id:oatpp::async::FramePool;
    *  free() also calls virtual destructor:
-   *  Coroutine::free() --> Bench::free(Coroutine* coroutine) { ... coroutine->~Coroutine(); ... }
+   *  Coroutine::free() --> { coroutine->~Coroutine(); FramePool::free(coroutine); }
    */
   virtual void free() = 0;
   virtual MemberCaller getMemberCaller() const = 0;
@@ -249,16 +461,101 @@ public:
     return m_parent;
   }
   
+  /**
+   * Set deadline of this coroutine. Once deadline has passed, the chain from the currently running
+   * coroutine up to this coroutine and its parents is unwound through handleError() with &l:Error::TIMEOUT; error.
+   * Deadline is checked by Processor periodically - see &id:oatpp::async::Processor::INTERRUPTS_CHECK_INTERVAL_MICROS;.
+   * @param timePointMicros - time point in microseconds. See &id:oatpp::base::Environment::getMicroTickCount;. 0 - no deadline.
+   */
+  void setDeadline(v_int64 timePointMicros) {
+    m_deadline = timePointMicros;
+  }
+  
+  /**
+   * Set deadline relative to the current time.
+   * @param timeout - e.g. `std::chrono::seconds(30)`.
+   */
+  void setTimeout(const std::chrono::duration<v_int64, std::micro>& timeout) {
+    m_deadline = oatpp::base::Environment::getMicroTickCount() + timeout.count();
+  }
+  
+  v_int64 getDeadline() const {
+    return m_deadline;
+  }
+  
+  /**
+   * Set handle to cancel this coroutine (and its children) from any thread.
+   * @param handle - &l:CancellationHandle;.
+   */
+  void setCancellationHandle(const std::shared_ptr<CancellationHandle>& handle) {
+    m_cancellationHandle = handle;
+  }
+  
+  /**
+   * Set scheduling class of the coroutine chain. May be called by child coroutine -
+   * the class is set for the top-level coroutine which is scheduled by &l:Processor;.
+   * @param priority - &l:Priority::LATENCY;, &l:Priority::NORMAL; or &l:Priority::BULK;.
+   */
+  void setPriority(v_int32 priority) {
+    AbstractCoroutine* top = this;
+    while(top->m_parent != nullptr) {
+      top = top->m_parent;
+    }
+    if(priority < 0) {
+      priority = 0;
+    } else if(priority >= Priority::CLASSES_COUNT) {
+      priority = Priority::CLASSES_COUNT - 1;
+    }
+    top->m_priority = priority;
+  }
+  
+  /**
+   * Get scheduling class of the coroutine chain.
+   * @return - &l:Priority;.
+   */
+  v_int32 getPriority() const {
+    const AbstractCoroutine* top = this;
+    while(top->m_parent != nullptr) {
+      top = top->m_parent;
+    }
+    return top->m_priority;
+  }
+  
+  /**
+   * Keep the coroutine chain on the &l:Processor; which runs it. May be called by child coroutine -
+   * the flag is set for the top-level coroutine. <br>
+   * Pinned coroutine is not shared with idle processors and is not migrated when its processor retires.
+   * @param pinned
+   */
+  void setPinned(bool pinned) {
+    AbstractCoroutine* top = this;
+    while(top->m_parent != nullptr) {
+      top = top->m_parent;
+    }
+    top->m_pinned = pinned;
+  }
+  
+  /**
+   * @return - true if the coroutine chain is pinned to its processor. See &l:AbstractCoroutine::setPinned ();.
+   */
+  bool isPinned() const {
+    const AbstractCoroutine* top = this;
+    while(top->m_parent != nullptr) {
+      top = top->m_parent;
+    }
+    return top->m_pinned;
+  }
+  
 };
  
 template<class T>
 class Coroutine : public AbstractCoroutine {
 public:
   typedef Action (T::*Function)();
-  typedef oatpp::base::memory::Bench<T> Bench;
+  typedef oatpp::async::FrameBench<T> Bench;
 public:
   static Bench& getBench(){
-    static thread_local Bench bench(512);
+    static Bench bench;
     return bench;
   }
 public:
@@ -269,7 +566,9 @@ public:
   }
   
   void free() override {
-    Coroutine<T>::getBench().free(static_cast<T*>(this));
+    T* coroutine = static_cast<T*>(this);
+    coroutine->~T();
+    FramePool::free(coroutine);
   }
   
   MemberCaller getMemberCaller() const override {
@@ -284,6 +583,26 @@ public:
     return Action::_WAIT_RETRY;
   }
   
+  Action waitForIO(data::v_io_handle ioHandle, v_int32 ioEventType) const {
+    return Action::createIOWaitAction(ioHandle, ioEventType);
+  }
+  
+  /**
+   * Repeat current function once timeout has passed.
+   * @param timeout - e.g. `std::chrono::milliseconds(50)`.
+   */
+  Action waitFor(const std::chrono::duration<v_int64, std::micro>& timeout) const {
+    return Action::createWaitUntilAction(oatpp::base::Environment::getMicroTickCount() + timeout.count());
+  }
+  
+  /**
+   * Repeat current function once time point is reached.
+   * @param timePointMicros - time point in microseconds. See &id:oatpp::base::Environment::getMicroTickCount;.
+   */
+  Action waitUntil(v_int64 timePointMicros) const {
+    return Action::createWaitUntilAction(timePointMicros);
+  }
+  
   const Action& repeat() const {
     return Action::_REPEAT;
   }
@@ -307,10 +626,10 @@ class CoroutineWithResult : public AbstractCoroutine {
   friend AbstractCoroutine;
 public:
   typedef Action (T::*Function)();
-  typedef oatpp::base::memory::Bench<T> Bench;
+  typedef oatpp::async::FrameBench<T> Bench;
 public:
   static Bench& getBench(){
-    static thread_local Bench bench(512);
+    static Bench bench;
     return bench;
   }
 private:
@@ -323,7 +642,9 @@ public:
   }
   
   virtual void free() override {
-    CoroutineWithResult<T, Args...>::getBench().free(static_cast<T*>(this));
+    T* coroutine = static_cast<T*>(this);
+    coroutine->~T();
+    FramePool::free(coroutine);
   }
   
   MemberCaller getMemberCaller() const override {
@@ -338,6 +659,26 @@ public:
     return Action::_WAIT_RETRY;
   }
   
+  Action waitForIO(data::v_io_handle ioHandle, v_int32 ioEventType) const {
+    return Action::createIOWaitAction(ioHandle, ioEventType);
+  }
+  
+  /**
+   * Repeat current function once timeout has passed.
+   * @param timeout - e.g. `std::chrono::milliseconds(50)`.
+   */
+  Action waitFor(const std::chrono::duration<v_int64, std::micro>& timeout) const {
+    return Action::createWaitUntilAction(oatpp::base::Environment::getMicroTickCount() + timeout.count());
+  }
+  
+  /**
+   * Repeat current function once time point is reached.
+   * @param timePointMicros - time point in microseconds. See &id:oatpp::base::Environment::getMicroTickCount;.
+   */
+  Action waitUntil(v_int64 timePointMicros) const {
+    return Action::createWaitUntilAction(timePointMicros);
+  }
+  
   const Action& repeat() const {
     return Action::_REPEAT;
   }
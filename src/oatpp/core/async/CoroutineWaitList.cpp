@@ -0,0 +1,142 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "CoroutineWaitList.hpp"
+
+#include "./Processor.hpp"
+
+namespace oatpp { namespace async {
+
+CoroutineWaitList::CoroutineWaitList(Listener* listener)
+  : m_listener(listener)
+  , m_atom(false)
+  , m_first(nullptr)
+  , m_last(nullptr)
+{}
+
+CoroutineWaitList::~CoroutineWaitList() {
+  notifyAll();
+}
+
+void CoroutineWaitList::unlink(AbstractCoroutine* coroutine) {
+  if(coroutine->_prevRef != nullptr) {
+    coroutine->_prevRef->_ref = coroutine->_ref;
+  } else {
+    m_first = coroutine->_ref;
+  }
+  if(coroutine->_ref != nullptr) {
+    coroutine->_ref->_prevRef = coroutine->_prevRef;
+  } else {
+    m_last = coroutine->_prevRef;
+  }
+  coroutine->_ref = nullptr;
+  coroutine->_prevRef = nullptr;
+}
+
+void CoroutineWaitList::clearWaitList(AbstractCoroutine* coroutine) {
+  oatpp::concurrency::SpinLock lock(coroutine->_parkAtom);
+  coroutine->_waitList = nullptr;
+}
+
+void CoroutineWaitList::pushBack(AbstractCoroutine* coroutine) {
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    coroutine->_waitList = this;
+    coroutine->_ref = nullptr;
+    coroutine->_prevRef = m_last;
+    if(m_last != nullptr) {
+      m_last->_ref = coroutine;
+    } else {
+      m_first = coroutine;
+    }
+    m_last = coroutine;
+  }
+  if(m_listener != nullptr) {
+    m_listener->onNewItem(*this);
+  }
+}
+
+bool CoroutineWaitList::notifyFirst() {
+  AbstractCoroutine* coroutine;
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    coroutine = m_first;
+    if(coroutine == nullptr) {
+      return false;
+    }
+    unlink(coroutine);
+    clearWaitList(coroutine);
+  }
+  coroutine->_processor->resumeCoroutine(coroutine);
+  return true;
+}
+
+v_int32 CoroutineWaitList::notifyAll() {
+  AbstractCoroutine* curr;
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    curr = m_first;
+    m_first = nullptr;
+    m_last = nullptr;
+    AbstractCoroutine* coroutine = curr;
+    while(coroutine != nullptr) {
+      clearWaitList(coroutine);
+      coroutine = coroutine->_ref;
+    }
+  }
+  v_int32 count = 0;
+  while(curr != nullptr) {
+    /* _ref is reused by the processor's queue */
+    AbstractCoroutine* next = curr->_ref;
+    curr->_prevRef = nullptr;
+    curr->_processor->resumeCoroutine(curr);
+    curr = next;
+    count ++;
+  }
+  return count;
+}
+
+bool CoroutineWaitList::remove(AbstractCoroutine* coroutine) {
+  while(true) {
+    {
+      /* List can't be destroyed while coroutine is in it - the list has to take the coroutine's atom to let it go */
+      oatpp::concurrency::SpinLock coroutineLock(coroutine->_parkAtom);
+      CoroutineWaitList* list = coroutine->_waitList;
+      if(list == nullptr) {
+        return false;
+      }
+      /* Lists take the coroutine's atom under their own - don't block here */
+      if(oatpp::concurrency::SpinLock::tryLock(list->m_atom)) {
+        list->unlink(coroutine);
+        coroutine->_waitList = nullptr;
+        oatpp::concurrency::SpinLock::unlock(list->m_atom);
+        return true;
+      }
+    }
+    std::this_thread::yield();
+  }
+}
+  
+}}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_CoroutineWaitList_hpp
+#define oatpp_async_CoroutineWaitList_hpp
+
+#include "./Coroutine.hpp"
+
+#include "oatpp/core/concurrency/SpinLock.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * List of coroutines parked until some condition is signalled. <br>
+ * Coroutine parks itself by returning &l:Action::createWaitListAction (); - it is removed from the processor's queues
+ * and takes no processor time until notified. Once notified, it is handed back to its &id:oatpp::async::Processor;
+ * (which may run in another thread) and repeats the same function. <br>
+ * Deadlines and cancellation handles of parked coroutines are checked by the processor - interrupted coroutine is removed
+ * from the list and is unwound without being notified.
+ * Thread safe.
+ */
+class CoroutineWaitList {
+public:
+  
+  /**
+   * Owner of the wait list. Called after a coroutine is parked in the list.
+   * Condition may have been signalled while coroutine was on its way to the list - check it here and notify the list.
+   */
+  class Listener {
+  public:
+    virtual ~Listener() = default;
+    virtual void onNewItem(CoroutineWaitList& list) = 0;
+  };
+  
+private:
+  Listener* m_listener;
+  oatpp::concurrency::SpinLock::Atom m_atom;
+  /* Doubly linked with _ref and _prevRef - parked coroutine can be removed from the middle */
+  AbstractCoroutine* m_first;
+  AbstractCoroutine* m_last;
+private:
+  /* Called under m_atom */
+  void unlink(AbstractCoroutine* coroutine);
+  /* Called under m_atom. Tell processor of the coroutine that coroutine is not in the list anymore */
+  static void clearWaitList(AbstractCoroutine* coroutine);
+public:
+  
+  /**
+   * Constructor.
+   * @param listener - &l:CoroutineWaitList::Listener;. May be nullptr.
+   */
+  CoroutineWaitList(Listener* listener = nullptr);
+  
+  /**
+   * Non-virtual destructor. Notifies all parked coroutines.
+   */
+  ~CoroutineWaitList();
+  
+  CoroutineWaitList(const CoroutineWaitList&) = delete;
+  CoroutineWaitList& operator = (const CoroutineWaitList&) = delete;
+  
+  /**
+   * Park coroutine. Called by &id:oatpp::async::Processor;.
+   * @param coroutine
+   */
+  void pushBack(AbstractCoroutine* coroutine);
+  
+  /**
+   * Resume the longest waiting coroutine.
+   * @return - false if list is empty.
+   */
+  bool notifyFirst();
+  
+  /**
+   * Resume all parked coroutines.
+   * @return - number of resumed coroutines.
+   */
+  v_int32 notifyAll();
+  
+  /**
+   * Remove coroutine from the wait list it's parked in without notifying it. Called by &id:oatpp::async::Processor;
+   * of the coroutine to unwind interrupted coroutine.
+   * @param coroutine
+   * @return - true if coroutine was removed. false if coroutine was notified already and is on its way back to the processor.
+   */
+  static bool remove(AbstractCoroutine* coroutine);
+  
+};
+  
+}}
+
+#endif /* oatpp_async_CoroutineWaitList_hpp */
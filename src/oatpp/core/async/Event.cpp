@@ -0,0 +1,53 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Event.hpp"
+
+namespace oatpp { namespace async {
+
+Event::Event()
+  : m_isSet(false)
+  , m_waitList(this)
+{}
+
+void Event::onNewItem(CoroutineWaitList& list) {
+  if(m_isSet.load()) {
+    list.notifyAll();
+  }
+}
+
+void Event::set() {
+  m_isSet.store(true);
+  m_waitList.notifyAll();
+}
+
+Action Event::wait(const Action& next) {
+  if(m_isSet.load()) {
+    return next;
+  }
+  return Action::createWaitListAction(&m_waitList);
+}
+  
+}}
@@ -0,0 +1,79 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Event_hpp
+#define oatpp_async_Event_hpp
+
+#include "./CoroutineWaitList.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * One-shot event. Coroutines wait until the event is set. Once set, the event stays set.
+ * Waiting coroutines are parked in &l:CoroutineWaitList; and take no processor time.
+ * May be set from any thread. <br>
+ * Usage:
+ * ```
+ * Action act() override {
+ *   return m_event->wait(yieldTo(&MyCoroutine::onReady));
+ * }
+ * ```
+ */
+class Event : private CoroutineWaitList::Listener {
+private:
+  std::atomic<bool> m_isSet;
+  CoroutineWaitList m_waitList;
+private:
+  void onNewItem(CoroutineWaitList& list) override;
+public:
+  
+  Event();
+  
+  static std::shared_ptr<Event> createShared() {
+    return std::make_shared<Event>();
+  }
+  
+  /**
+   * Set event and resume all waiting coroutines.
+   */
+  void set();
+  
+  /**
+   * Continue if event is set or park the coroutine until it's set.
+   * Parked coroutine repeats the calling function once notified.
+   * @param next - action to take once event is set. Should not start coroutine - it would be leaked on wait.
+   * @return - `next` or wait action.
+   */
+  Action wait(const Action& next);
+  
+  bool isSet() const {
+    return m_isSet.load();
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Event_hpp */
@@ -24,94 +24,636 @@
 
 #include "Executor.hpp"
 
+#include <cstdio>
+
 namespace oatpp { namespace async {
 
 const v_int32 Executor::THREAD_NUM_DEFAULT = OATPP_ASYNC_EXECUTOR_THREAD_NUM_DEFAULT;
 
-Executor::SubmissionProcessor::SubmissionProcessor()
-  : m_atom(false)
+thread_local Executor::SubmissionProcessor* Executor::SubmissionProcessor::m_current = nullptr;
+
+bool Executor::ProcessorsGroup::forward(oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+  oatpp::concurrency::SpinLock lock(atom);
+  v_int32 count = processorsCount.load();
+  if(count == 0) {
+    return false;
+  }
+  while (queue.first != nullptr) {
+    processors[forwardBalancer % count]->pushTask(queue.popFront());
+    forwardBalancer ++;
+  }
+  return true;
+}
+
+void Executor::ProcessorsGroup::checkScaling() {
+
+  v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+  v_int64 elapsedMicros = currentMicros - scaler->lastCheckMicros;
+  if(elapsedMicros < scaler->config.checkIntervalMicros) {
+    return;
+  }
+  scaler->lastCheckMicros = currentMicros;
+
+  std::lock_guard<std::mutex> lock(threadsMutex);
+  if(!linked) {
+    return;
+  }
+
+  v_int32 count = processorsCount.load();
+  v_int64 utilizationSum = 0;
+  v_int64 latencyMicros = 0;
+
+  for(v_int32 i = 0; i < count; i ++) {
+    v_int64 idleMicros = processors[i]->getIdleMicros(currentMicros);
+    v_int64 idleDelta = idleMicros - scaler->idleSnapshots[i];
+    scaler->idleSnapshots[i] = idleMicros;
+    if(idleDelta > elapsedMicros) {
+      idleDelta = elapsedMicros;
+    } else if(idleDelta < 0) {
+      idleDelta = 0;
+    }
+    utilizationSum += 100 - idleDelta * 100 / elapsedMicros;
+    latencyMicros = std::max(latencyMicros, processors[i]->takeMaxPassMicros());
+  }
+
+  v_int32 utilization = (v_int32) (utilizationSum / count);
+  scaler->utilization.store(utilization, std::memory_order_relaxed);
+  scaler->latencyMicros.store(latencyMicros, std::memory_order_relaxed);
+
+  const ScalingConfig& config = scaler->config;
+  bool overloaded = utilization >= config.scaleUpUtilization || latencyMicros >= config.scaleUpLatencyMicros;
+
+  if(overloaded) {
+    scaler->lowUtilizationSinceMicros = 0;
+    if(count < maxProcessorsCount) {
+      startProcessor(count);
+    }
+  } else if(utilization <= config.scaleDownUtilization && count > config.minThreadsCount) {
+    if(scaler->lowUtilizationSinceMicros == 0) {
+      scaler->lowUtilizationSinceMicros = currentMicros;
+    } else if(currentMicros - scaler->lowUtilizationSinceMicros >= config.cooldownMicros) {
+      /* Next thread is retired after another cooldown */
+      scaler->lowUtilizationSinceMicros = 0;
+      retireProcessor();
+    }
+  } else {
+    scaler->lowUtilizationSinceMicros = 0;
+  }
+
+}
+
+void Executor::ProcessorsGroup::startProcessor(v_int32 index) {
+
+  SubmissionProcessor* processor = processors[index];
+
+  if(!processor->reactivate()) {
+    /* Thread has exited or was never started. Start new one */
+    if(threads[index] && !detached) {
+      threads[index]->join();
+    }
+    processor->restart();
+    threads[index] = oatpp::concurrency::Thread::createShared(processor->shared_from_this());
+    if(detached) {
+      threads[index]->detach();
+    }
+  }
+
+  scaler->idleSnapshots[index] = processor->getIdleMicros(oatpp::base::Environment::getMicroTickCount());
+  processor->takeMaxPassMicros();
+
+  {
+    oatpp::concurrency::SpinLock lock(atom);
+    processorsCount.store(index + 1);
+  }
+
+  scaler->scaleUpCount.fetch_add(1, std::memory_order_relaxed);
+
+}
+
+void Executor::ProcessorsGroup::retireProcessor() {
+
+  v_int32 index;
+  {
+    /* Processor isn't given new coroutines and isn't reached by stealing processors anymore */
+    oatpp::concurrency::SpinLock lock(atom);
+    index = processorsCount.load() - 1;
+    processorsCount.store(index);
+  }
+
+  processors[index]->retire();
+  scaler->scaleDownCount.fetch_add(1, std::memory_order_relaxed);
+
+}
+
+Executor::SubmissionProcessor::SubmissionProcessor(v_int32 ioEngine, v_int32 burstSize,
+                                                   const std::shared_ptr<ProcessorsGroup>& group, v_int32 index,
+                                                   v_int32 state)
+  : m_processor(ioEngine, burstSize)
+  , m_group(group)
+  , m_index(index)
+  , m_sharedAtom(false)
+  , m_sharedCount(0)
+  , m_tasksCount(0)
+  , m_stolenCount(0)
+  , m_idle(false)
+  , m_state(state)
+  , m_idleMicros(0)
+  , m_sleepStartMicros(0)
+  , m_maxPassMicros(0)
+  , m_submittedCount(0)
+  , m_consumedCount(0)
+  , m_busyMicros(0)
+  , m_passesCount(0)
   , m_isRunning(true)
 {}
 
 void Executor::SubmissionProcessor::consumeTasks() {
-  oatpp::concurrency::SpinLock lock(m_atom);
-  auto curr = m_pendingTasks.getFirstNode();
-  while (curr != nullptr) {
-    m_processor.addWaitingCoroutine(curr->getData()->createCoroutine());
-    curr = curr->getNext();
+  if(m_pendingTasks.isEmpty()) {
+    return;
+  }
+  oatpp::collection::FastQueue<AbstractCoroutine> tasks;
+  m_consumedCount.fetch_add(m_pendingTasks.popAll(tasks), std::memory_order_relaxed);
+  while (tasks.first != nullptr) {
+    m_processor.addWaitingCoroutine(tasks.popFront());
+  }
+}
+
+v_int64 Executor::SubmissionProcessor::getWaitTimeoutMicros(v_int64 maxMicros) {
+  if(m_index == 0 && m_group->scaler != nullptr) {
+    /* Wake up for the next load check */
+    v_int64 checkMicros = m_group->scaler->config.checkIntervalMicros;
+    if(maxMicros < 0 || checkMicros < maxMicros) {
+      maxMicros = checkMicros;
+    }
+  }
+  v_int64 timerMicros = m_processor.getNextTimerTimeoutMicros();
+  if(timerMicros >= 0 && (maxMicros < 0 || timerMicros < maxMicros)) {
+    return timerMicros;
+  }
+  return maxMicros;
+}
+
+void Executor::SubmissionProcessor::checkScaling() {
+  if(m_index == 0 && m_group->scaler != nullptr) {
+    m_group->checkScaling();
+  }
+}
+
+bool Executor::SubmissionProcessor::migrateWork() {
+
+  reclaimSharedWork();
+
+  /* Move resumed coroutines, coroutines whose I/O is ready and expired timers to the active queue */
+  m_processor.iterate(0);
+
+  oatpp::collection::FastQueue<AbstractCoroutine> coroutines;
+  v_int32 movedCount = m_processor.moveCoroutines(coroutines);
+  m_consumedCount.fetch_add(m_pendingTasks.popAll(coroutines), std::memory_order_relaxed);
+
+  if(!m_group->forward(coroutines)) {
+    /* Executor is destroyed. Nowhere to migrate - keep running coroutines here */
+    while (coroutines.first != nullptr) {
+      m_processor.addWaitingCoroutine(coroutines.popFront());
+    }
+    m_state.store(STATE_ACTIVE);
+    return false;
+  }
+
+  if(movedCount > 0 && m_group->scaler != nullptr) {
+    m_group->scaler->migratedCount.fetch_add(movedCount, std::memory_order_relaxed);
+  }
+
+  m_tasksCount.store(m_processor.getTasksCount(), std::memory_order_relaxed);
+
+  if(m_processor.getTasksCount() == 0) {
+    v_int32 expectedState = STATE_RETIRING;
+    if(m_state.compare_exchange_strong(expectedState, STATE_EXITED)) {
+      /* Pairs with submitters checking the state after the push. Whatever is pushed from now on is forwarded by submitters */
+      forwardPendingTasks();
+      return true;
+    }
+    /* Processor was taken back */
+    return false;
+  }
+
+  /* Only pinned coroutines, and coroutines waiting for timers or parked in wait lists are left.
+   * Pinned coroutines can't migrate - run them here. Wait for the rest to become runnable */
+  if(m_processor.iterate(1000)) {
+    return false;
+  }
+
+  m_idle.store(true);
+  if(m_pendingTasks.isEmpty() && m_state.load() == STATE_RETIRING) {
+    waitForWakeup(getWaitTimeoutMicros(Processor::INTERRUPTS_CHECK_INTERVAL_MICROS));
+  }
+  m_idle.store(false);
+
+  return false;
+
+}
+
+void Executor::SubmissionProcessor::forwardPendingTasks() {
+  oatpp::collection::FastQueue<AbstractCoroutine> tasks;
+  v_int32 count = m_pendingTasks.popAll(tasks);
+  if(count == 0) {
+    return;
+  }
+  if(m_group->forward(tasks)) {
+    m_consumedCount.fetch_add(count, std::memory_order_relaxed);
+  } else {
+    /* Executor is destroyed. Leave tasks to the processor */
+    while (tasks.first != nullptr) {
+      m_pendingTasks.push(tasks.popFront());
+    }
+  }
+}
+
+v_int64 Executor::SubmissionProcessor::onPassEnd(v_int64 passStartMicros) {
+  v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+  v_int64 passMicros = currentMicros - passStartMicros;
+  /* Newly submitted coroutine waits for the pass to end - that's the run-queue latency */
+  if(passMicros > m_maxPassMicros.load(std::memory_order_relaxed)) {
+    m_maxPassMicros.store(passMicros, std::memory_order_relaxed);
+  }
+  m_passHistogram.record(passMicros);
+  m_busyMicros.store(m_busyMicros.load(std::memory_order_relaxed) + passMicros, std::memory_order_relaxed);
+  m_passesCount.store(m_passesCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  return currentMicros;
+}
+
+ProcessorMetrics Executor::SubmissionProcessor::getMetrics() const {
+  ProcessorMetrics metrics;
+  m_processor.getMetrics(metrics);
+  metrics.submittedCount = m_submittedCount.load(std::memory_order_relaxed);
+  metrics.pendingCount = (v_int32) std::max<v_int64>(0, metrics.submittedCount - m_consumedCount.load(std::memory_order_relaxed));
+  metrics.passesCount = m_passesCount.load(std::memory_order_relaxed);
+  metrics.busyMicros = m_busyMicros.load(std::memory_order_relaxed);
+  metrics.idleMicros = getIdleMicros(oatpp::base::Environment::getMicroTickCount());
+  metrics.passMicros = m_passHistogram.getSnapshot();
+  return metrics;
+}
+
+v_int64 Executor::SubmissionProcessor::getIdleMicros(v_int64 currentMicros) const {
+  v_int64 idleMicros = m_idleMicros.load(std::memory_order_relaxed);
+  v_int64 sleepStartMicros = m_sleepStartMicros.load(std::memory_order_relaxed);
+  if(sleepStartMicros > 0) {
+    idleMicros += currentMicros - sleepStartMicros;
+  }
+  return idleMicros;
+}
+
+void Executor::SubmissionProcessor::shareWork() {
+
+  if(m_group->idleCount.load(std::memory_order_relaxed) == 0 || m_sharedCount.load(std::memory_order_relaxed) > 0) {
+    return;
+  }
+
+  v_int32 count;
+  {
+    oatpp::concurrency::SpinLock lock(m_sharedAtom);
+    count = m_processor.splitActiveQueue(m_sharedQueue);
+    /* Pairs with idle processor setting its idle flag before checking for shared work */
+    m_sharedCount.store(count);
+  }
+
+  if(count > 0) {
+    wakeIdleProcessor();
+  }
+
+}
+
+bool Executor::SubmissionProcessor::reclaimSharedWork() {
+
+  if(m_sharedCount.load(std::memory_order_relaxed) == 0) {
+    return false;
   }
-  m_pendingTasks.clear();
+
+  oatpp::concurrency::SpinLock lock(m_sharedAtom);
+  bool reclaimed = m_sharedQueue.first != nullptr;
+  while (m_sharedQueue.first != nullptr) {
+    m_processor.addCoroutine(m_sharedQueue.popFront());
+  }
+  m_sharedCount.store(0, std::memory_order_relaxed);
+  return reclaimed;
+
+}
+
+bool Executor::SubmissionProcessor::stealWork() {
+
+  oatpp::concurrency::SpinLock groupLock(m_group->atom);
+
+  for(v_int32 i = 1; i < m_group->processorsCount; i ++) {
+
+    SubmissionProcessor* victim = m_group->processors[(m_index + i) % m_group->processorsCount];
+    if(victim->m_sharedCount.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+
+    oatpp::concurrency::SpinLock lock(victim->m_sharedAtom);
+    v_int32 count = victim->m_sharedCount.load(std::memory_order_relaxed);
+    /* Leave some for other idle processors */
+    v_int32 stealCount = (count + 1) / 2;
+    for(v_int32 n = 0; n < stealCount && victim->m_sharedQueue.first != nullptr; n ++) {
+      m_processor.addCoroutine(victim->m_sharedQueue.popFront());
+    }
+    victim->m_sharedCount.store(count - stealCount, std::memory_order_relaxed);
+
+    if(stealCount > 0) {
+      m_stolenCount.fetch_add(stealCount, std::memory_order_relaxed);
+      return true;
+    }
+
+  }
+
+  return false;
+
+}
+
+void Executor::SubmissionProcessor::waitForWakeup(v_int64 timeoutMicros) {
+  /* Single wait for I/O events, timers, resumed coroutines and wakeups */
+  m_processor.waitForEvents(timeoutMicros);
+}
+
+void Executor::SubmissionProcessor::wakeup() {
+  m_processor.wakeup();
+}
+
+bool Executor::SubmissionProcessor::hasWorkToSteal() {
+  oatpp::concurrency::SpinLock groupLock(m_group->atom);
+  for(v_int32 i = 1; i < m_group->processorsCount; i ++) {
+    if(m_group->processors[(m_index + i) % m_group->processorsCount]->m_sharedCount.load() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Executor::SubmissionProcessor::wakeIdleProcessor() {
+  oatpp::concurrency::SpinLock groupLock(m_group->atom);
+  for(v_int32 i = 1; i < m_group->processorsCount; i ++) {
+    SubmissionProcessor* processor = m_group->processors[(m_index + i) % m_group->processorsCount];
+    if(processor->m_idle.load()) {
+      processor->wakeup();
+      return;
+    }
+  }
+}
+
+Executor::SubmissionProcessor* Executor::SubmissionProcessor::getCurrent() {
+  return m_current;
 }
 
 void Executor::SubmissionProcessor::run(){
   
+  /* Pin before the thread allocates anything - memory pools pick shards of the thread's node */
+  if(m_group->placementPolicy) {
+    m_group->placementPolicy->placeWorker(oatpp::concurrency::Thread::getCurrentNativeHandle(), m_index);
+  }
+  
+  m_current = this;
+  
   while(m_isRunning) {
     
+    if(m_state.load(std::memory_order_relaxed) == STATE_RETIRING) {
+      if(migrateWork()) {
+        m_current = nullptr;
+        return;
+      }
+      continue;
+    }
+    
     /* Load all waiting connections into processor */
     consumeTasks();
     
     /* Process all, and check for incoming connections once in 1000 iterations */
+    v_int64 passStartMicros = oatpp::base::Environment::getMicroTickCount();
     while (m_processor.iterate(1000)) {
       consumeTasks();
+      shareWork();
+      m_tasksCount.store(m_processor.getTasksCount(), std::memory_order_relaxed);
+      passStartMicros = onPassEnd(passStartMicros);
+      checkScaling();
     }
+    onPassEnd(passStartMicros);
+    
+    /* Nothing to run. Take back own coroutines nobody has stolen, or steal from busy processors */
+    if(reclaimSharedWork() || stealWork()) {
+      continue;
+    }
+    
+    m_tasksCount.store(m_processor.getTasksCount(), std::memory_order_relaxed);
     
-    std::unique_lock<std::mutex> lock(m_taskMutex);
-    if(m_processor.isEmpty()) {
-      /* No tasks in the processor. Wait for incoming connections */
-      m_taskCondition.wait_for(lock, std::chrono::milliseconds(500));
+    /* Submitters and sharing processors check the idle flag after publishing work.
+     * Check for work after setting it - no wakeup is missed */
+    m_idle.store(true);
+    m_group->idleCount.fetch_add(1, std::memory_order_relaxed);
+    
+    v_int64 sleepStartMicros = oatpp::base::Environment::getMicroTickCount();
+    m_sleepStartMicros.store(sleepStartMicros, std::memory_order_relaxed);
+    
+    if(!m_pendingTasks.isEmpty() || !m_isRunning || hasWorkToSteal() || m_state.load() != STATE_ACTIVE) {
+      /* Don't sleep - go back to processing */
+    } else if(m_processor.isEmpty()) {
+      /* No tasks in the processor. Sleep until a task is submitted or there is work to steal */
+      waitForWakeup(getWaitTimeoutMicros(-1));
+    } else if(m_processor.hasWaitingRetry()) {
+      /* There is still something in slow queue. Slow queue may contain NON-IO tasks which have to be re-checked */
+      /* Sleep until the next retry, I/O event, timer or wakeup */
+      waitForWakeup(getWaitTimeoutMicros(10 * 1000));
     } else {
-      /* There is still something in slow queue. Wait and get back to processing */
-      /* Waiting for IO is not Applicable here as slow queue may contain NON-IO tasks */
-      //OATPP_LOGD("proc", "waiting slow queue");
-      m_taskCondition.wait_for(lock, std::chrono::milliseconds(10));
+      /* All coroutines are waiting for I/O, timers or are parked. Sleep until I/O is ready, the next timer, deadlines check or wakeup */
+      waitForWakeup(getWaitTimeoutMicros(Processor::INTERRUPTS_CHECK_INTERVAL_MICROS));
     }
     
+    m_idleMicros.fetch_add(oatpp::base::Environment::getMicroTickCount() - sleepStartMicros, std::memory_order_relaxed);
+    m_sleepStartMicros.store(0, std::memory_order_relaxed);
+    
+    m_group->idleCount.fetch_sub(1, std::memory_order_relaxed);
+    m_idle.store(false);
+    
+    checkScaling();
+    
   }
   
+  m_current = nullptr;
+  
 }
 
 void Executor::SubmissionProcessor::stop() {
   m_isRunning = false;
+  wakeup();
 }
 
-void Executor::SubmissionProcessor::addTaskSubmission(const std::shared_ptr<TaskSubmission>& task){
-  oatpp::concurrency::SpinLock lock(m_atom);
-  m_pendingTasks.pushBack(task);
-  m_taskCondition.notify_one();
+void Executor::SubmissionProcessor::retire() {
+  v_int32 expectedState = STATE_ACTIVE;
+  if(m_state.compare_exchange_strong(expectedState, STATE_RETIRING)) {
+    wakeup();
+  }
+}
+
+bool Executor::SubmissionProcessor::reactivate() {
+  v_int32 expectedState = STATE_RETIRING;
+  return m_state.compare_exchange_strong(expectedState, STATE_ACTIVE);
 }
 
+void Executor::SubmissionProcessor::pushTask(AbstractCoroutine* coroutine) {
+  m_submittedCount.fetch_add(1, std::memory_order_relaxed);
+  /* If queue wasn't empty, whoever pushed the first task has already woken the processor */
+  if(m_pendingTasks.push(coroutine) && m_idle.load()) {
+    wakeup();
+  }
+  /* Submitter has picked retired processor which has exited already */
+  if(m_state.load() == STATE_EXITED) {
+    forwardPendingTasks();
+  }
+}
 
-Executor::Executor(v_int32 threadsCount)
-  : m_threadsCount(threadsCount)
-  , m_threads(new std::shared_ptr<oatpp::concurrency::Thread>[m_threadsCount])
-  , m_processors(new std::shared_ptr<SubmissionProcessor>[m_threadsCount])
+
+Executor::Executor(v_int32 threadsCount, v_int32 ioEngine, v_int32 burstSize,
+                   const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy)
+  : m_maxThreadsCount(threadsCount)
+  , m_processors(new std::shared_ptr<SubmissionProcessor>[threadsCount])
+  , m_group(std::make_shared<ProcessorsGroup>(threadsCount, threadsCount, nullptr, placementPolicy))
+  , m_balancer(0)
+{
+  start(threadsCount, ioEngine, burstSize);
+}
+
+Executor::Executor(const ScalingConfig& config, v_int32 ioEngine, v_int32 burstSize,
+                   const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy)
+  : m_maxThreadsCount(config.maxThreadsCount)
+  , m_processors(new std::shared_ptr<SubmissionProcessor>[config.maxThreadsCount])
+  , m_group(std::make_shared<ProcessorsGroup>(config.maxThreadsCount, config.minThreadsCount, new Scaler(config),
+                                              placementPolicy))
+  , m_balancer(0)
 {
-  for(v_int32 i = 0; i < m_threadsCount; i ++) {
-    auto processor = std::make_shared<SubmissionProcessor>();
-    m_processors[i] = processor;
-    m_threads[i] = oatpp::concurrency::Thread::createShared(processor);
+  if(config.minThreadsCount < 1 || config.minThreadsCount > config.maxThreadsCount) {
+    delete [] m_processors;
+    throw std::runtime_error("[oatpp::async::Executor::Executor()]: Error. Invalid threads count range.");
+  }
+  start(config.minThreadsCount, ioEngine, burstSize);
+}
+
+void Executor::start(v_int32 threadsCount, v_int32 ioEngine, v_int32 burstSize) {
+  /* Processors of all slots are created upfront - submitters may reach a processor at any time */
+  for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+    v_int32 state = i < threadsCount ? SubmissionProcessor::STATE_ACTIVE : SubmissionProcessor::STATE_EXITED;
+    m_processors[i] = std::make_shared<SubmissionProcessor>(ioEngine, burstSize, m_group, i, state);
+    m_group->processors[i] = m_processors[i].get();
+  }
+  std::lock_guard<std::mutex> lock(m_group->threadsMutex);
+  for(v_int32 i = 0; i < threadsCount; i ++) {
+    m_group->threads[i] = oatpp::concurrency::Thread::createShared(m_processors[i]);
   }
 }
 
 Executor::~Executor() {
+  setStallDetector(nullptr);
+  {
+    /* Stop scaling - it needs processors owned by executor */
+    std::lock_guard<std::mutex> lock(m_group->threadsMutex);
+    m_group->linked = false;
+  }
+  {
+    /* Detached threads may still run. Unlink processors so that they don't reach each other anymore */
+    oatpp::concurrency::SpinLock lock(m_group->atom);
+    m_group->processorsCount = 0;
+  }
   delete [] m_processors;
-  delete [] m_threads;
 }
 
 void Executor::join() {
-  for(v_int32 i = 0; i < m_threadsCount; i ++) {
-    m_threads[i]->join();
+  /* The first thread starts and retires other threads. Join it first - no thread is started after that */
+  m_group->threads[0]->join();
+  std::lock_guard<std::mutex> lock(m_group->threadsMutex);
+  for(v_int32 i = 1; i < m_maxThreadsCount; i ++) {
+    if(m_group->threads[i]) {
+      m_group->threads[i]->join();
+    }
   }
 }
 
 void Executor::detach() {
-  for(v_int32 i = 0; i < m_threadsCount; i ++) {
-    m_threads[i]->detach();
+  std::lock_guard<std::mutex> lock(m_group->threadsMutex);
+  m_group->detached = true;
+  for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+    if(m_group->threads[i]) {
+      m_group->threads[i]->detach();
+    }
+  }
+}
+
+Executor::ProcessorLoad Executor::getProcessorLoad(v_int32 threadIndex) const {
+  ProcessorLoad load;
+  load.tasksCount = m_processors[threadIndex]->getTasksCount();
+  load.sharedCount = m_processors[threadIndex]->getSharedCount();
+  load.stolenCount = m_processors[threadIndex]->getStolenCount();
+  return load;
+}
+
+Executor::ScalingStats Executor::getScalingStats() const {
+  ScalingStats stats;
+  stats.threadsCount = getThreadsCount();
+  stats.retiringCount = 0;
+  for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+    if(m_processors[i]->getState() == SubmissionProcessor::STATE_RETIRING) {
+      stats.retiringCount ++;
+    }
+  }
+  Scaler* scaler = m_group->scaler;
+  stats.scaleUpCount = scaler != nullptr ? scaler->scaleUpCount.load(std::memory_order_relaxed) : 0;
+  stats.scaleDownCount = scaler != nullptr ? scaler->scaleDownCount.load(std::memory_order_relaxed) : 0;
+  stats.migratedCount = scaler != nullptr ? scaler->migratedCount.load(std::memory_order_relaxed) : 0;
+  stats.utilization = scaler != nullptr ? scaler->utilization.load(std::memory_order_relaxed) : 0;
+  stats.latencyMicros = scaler != nullptr ? scaler->latencyMicros.load(std::memory_order_relaxed) : 0;
+  return stats;
+}
+
+v_float64 Executor::Metrics::getStepsPerSecond(const Metrics& previous) const {
+  v_int64 elapsedMicros = timestampMicros - previous.timestampMicros;
+  if(elapsedMicros <= 0) {
+    return 0;
+  }
+  return (v_float64) (total.stepsCount - previous.total.stepsCount) * 1000 * 1000 / elapsedMicros;
+}
+
+v_float64 Executor::Metrics::getBusyRatio(const Metrics& previous) const {
+  v_int64 elapsedMicros = timestampMicros - previous.timestampMicros;
+  if(elapsedMicros <= 0) {
+    return 0;
+  }
+  return (v_float64) (total.busyMicros - previous.total.busyMicros) / elapsedMicros;
+}
+
+Executor::Metrics Executor::getMetrics() const {
+  Metrics metrics;
+  metrics.timestampMicros = oatpp::base::Environment::getMicroTickCount();
+  metrics.processors.reserve(m_maxThreadsCount);
+  for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+    metrics.processors.push_back(m_processors[i]->getMetrics());
+    metrics.total.merge(metrics.processors.back());
+  }
+  return metrics;
+}
+
+void Executor::setStallDetector(const std::shared_ptr<StallDetector>& detector) {
+  if(m_stallDetector) {
+    for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+      m_stallDetector->unwatch(&m_processors[i]->getProcessor());
+    }
+  }
+  m_stallDetector = detector;
+  if(m_stallDetector) {
+    char name[64];
+    for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
+      snprintf(name, sizeof(name), "executor@%p[%d]", (void*) this, i);
+      m_stallDetector->watch(&m_processors[i]->getProcessor(), name);
+    }
   }
 }
 
 void Executor::stop() {
-  for(v_int32 i = 0; i < m_threadsCount; i ++) {
+  for(v_int32 i = 0; i < m_maxThreadsCount; i ++) {
     m_processors[i]->stop();
   }
 }
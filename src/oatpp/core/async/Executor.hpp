@@ -26,95 +26,551 @@
 #define oatpp_async_Executor_hpp
 
 #include "./Processor.hpp"
+#include "./StallDetector.hpp"
 
+#include "oatpp/core/concurrency/PlacementPolicy.hpp"
 #include "oatpp/core/concurrency/SpinLock.hpp"
 #include "oatpp/core/concurrency/Thread.hpp"
 
-#include "oatpp/core/collection/LinkedList.hpp"
+#include "oatpp/core/collection/MPSCQueue.hpp"
 
-#include <tuple>
+#include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <vector>
 
 namespace oatpp { namespace async {
   
+/**
+ * Executes coroutines in a pool of threads, each running its own &l:Processor;.
+ * New coroutines are distributed round-robin. Idle threads steal runnable coroutines from busy ones.
+ * In elastic mode (see &l:Executor::ScalingConfig;) threads are added under load and retired when they are idle.
+ */
 class Executor {
-private:
+public:
   
-  class TaskSubmission {
+  /**
+   * Config of elastic executor. Executor starts with `minThreadsCount` threads.
+   * Once in `checkIntervalMicros` the first thread checks load of all threads:
+   * <ul>
+   *   <li>If average utilization or run-queue latency exceeds its threshold - one thread is added, up to `maxThreadsCount`.</li>
+   *   <li>If average utilization stays below `scaleDownUtilization` for `cooldownMicros` - the last thread is retired,
+   *   down to `minThreadsCount`. Retired thread migrates its coroutines to other threads and exits once it holds none.
+   *   Pinned coroutines (see &id:oatpp::async::AbstractCoroutine::setPinned ();) are run by the retired thread until they finish.</li>
+   * </ul>
+   */
+  class ScalingConfig {
   public:
-    virtual ~TaskSubmission() {};
-    virtual AbstractCoroutine* createCoroutine() = 0;
+    
+    ScalingConfig(v_int32 pMinThreadsCount, v_int32 pMaxThreadsCount)
+      : minThreadsCount(pMinThreadsCount)
+      , maxThreadsCount(pMaxThreadsCount)
+      , checkIntervalMicros(100 * 1000)
+      , scaleUpUtilization(80)
+      , scaleUpLatencyMicros(10 * 1000)
+      , scaleDownUtilization(20)
+      , cooldownMicros(2 * 1000 * 1000)
+    {}
+    
+    /**
+     * Number of threads which are never retired. At least 1.
+     */
+    v_int32 minThreadsCount;
+    
+    /**
+     * Max number of threads.
+     */
+    v_int32 maxThreadsCount;
+    
+    /**
+     * How often the load is checked.
+     */
+    v_int64 checkIntervalMicros;
+    
+    /**
+     * Average utilization of threads, in percents, above which a thread is added.
+     */
+    v_int32 scaleUpUtilization;
+    
+    /**
+     * Run-queue latency above which a thread is added.
+     * Run-queue latency is the longest processing pass of a thread - a newly submitted coroutine waits for the pass to end.
+     */
+    v_int64 scaleUpLatencyMicros;
+    
+    /**
+     * Average utilization of threads, in percents, below which a thread is retired.
+     */
+    v_int32 scaleDownUtilization;
+    
+    /**
+     * How long utilization has to stay low before a thread is retired.
+     */
+    v_int64 cooldownMicros;
+    
   };
   
   /**
-   * Sequence generating templates
-   * used to convert tuple to parameters pack
-   * Example: expand SequenceGenerator<3>:
-   * // 2, 2, {} // 1, 1, {2} // 0, 0, {1, 2} // 0, {0, 1, 2}
-   * where {...} is int...S
+   * Scaling decisions of elastic executor and the load they were based on.
    */
-  template<int ...> struct IndexSequence {};
-  template<int N, int ...S> struct SequenceGenerator : SequenceGenerator <N - 1, N - 1, S...> {};
-  template<int ...S>
-  struct SequenceGenerator<0, S...> {
-    typedef IndexSequence<S...> type;
+  class ScalingStats {
+  public:
+    /**
+     * Number of threads coroutines are distributed to.
+     */
+    v_int32 threadsCount;
+    
+    /**
+     * Number of retired threads which still hold pinned coroutines, or coroutines waiting for timers or parked in wait lists.
+     */
+    v_int32 retiringCount;
+    
+    /**
+     * Number of times a thread was added.
+     */
+    v_int64 scaleUpCount;
+    
+    /**
+     * Number of times a thread was retired.
+     */
+    v_int64 scaleDownCount;
+    
+    /**
+     * Total number of coroutines migrated from retired threads.
+     */
+    v_int64 migratedCount;
+    
+    /**
+     * Average utilization of threads, in percents, measured by the last check.
+     */
+    v_int32 utilization;
+    
+    /**
+     * Run-queue latency measured by the last check.
+     */
+    v_int64 latencyMicros;
   };
   
-  template<typename CoroutineType, typename ... Args>
-  class SubmissionTemplate : public TaskSubmission {
-  private:
-    std::tuple<Args...> m_params;
+private:
+  
+  class SubmissionProcessor; // FWD
+  
+  /**
+   * Load measurements and scaling decisions of elastic executor. Accessed by the first processor's thread only,
+   * except for stats counters.
+   */
+  class Scaler {
   public:
     
-    SubmissionTemplate(Args... params)
-      : m_params(std::make_tuple(params...))
-    {}
+    Scaler(const ScalingConfig& pConfig)
+      : config(pConfig)
+      , idleSnapshots(new v_int64[pConfig.maxThreadsCount])
+      , lastCheckMicros(oatpp::base::Environment::getMicroTickCount())
+      , lowUtilizationSinceMicros(0)
+      , scaleUpCount(0)
+      , scaleDownCount(0)
+      , migratedCount(0)
+      , utilization(0)
+      , latencyMicros(0)
+    {
+      for(v_int32 i = 0; i < config.maxThreadsCount; i ++) {
+        idleSnapshots[i] = 0;
+      }
+    }
     
-    virtual AbstractCoroutine* createCoroutine() {
-      return creator(typename SequenceGenerator<sizeof...(Args)>::type());
+    ~Scaler() {
+      delete [] idleSnapshots;
     }
     
-    template<int ...S>
-    AbstractCoroutine* creator(IndexSequence<S...>) {
-      return CoroutineType::getBench().obtain(std::get<S>(m_params) ...);
+    const ScalingConfig config;
+    
+    /* Idle time of each processor at the last check */
+    v_int64* idleSnapshots;
+    v_int64 lastCheckMicros;
+    v_int64 lowUtilizationSinceMicros;
+    
+    std::atomic<v_int64> scaleUpCount;
+    std::atomic<v_int64> scaleDownCount;
+    std::atomic<v_int64> migratedCount;
+    std::atomic<v_int32> utilization;
+    std::atomic<v_int64> latencyMicros;
+    
+  };
+  
+  /**
+   * Processors of one executor. Used by processors to find each other for work stealing.
+   * Outlives executor if threads are detached - processors are unlinked in Executor's destructor.
+   */
+  class ProcessorsGroup {
+  public:
+    
+    ProcessorsGroup(v_int32 pMaxProcessorsCount, v_int32 pProcessorsCount, Scaler* pScaler,
+                    const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& pPlacementPolicy)
+      : atom(false)
+      , processors(new SubmissionProcessor*[pMaxProcessorsCount])
+      , processorsCount(pProcessorsCount)
+      , maxProcessorsCount(pMaxProcessorsCount)
+      , idleCount(0)
+      , forwardBalancer(0)
+      , threads(new std::shared_ptr<oatpp::concurrency::Thread>[pMaxProcessorsCount])
+      , detached(false)
+      , linked(true)
+      , scaler(pScaler)
+      , placementPolicy(pPlacementPolicy)
+    {}
+    
+    ~ProcessorsGroup() {
+      delete [] processors;
+      delete [] threads;
+      delete scaler;
     }
     
+    /**
+     * Forward coroutines to processors of the group round-robin.
+     * @param queue
+     * @return - `false` if processors were unlinked and coroutines were not forwarded.
+     */
+    bool forward(oatpp::collection::FastQueue<AbstractCoroutine>& queue);
+    
+    /**
+     * Add or retire a processor if load is out of bounds. Called by the first processor's thread.
+     */
+    void checkScaling();
+    
+    /**
+     * Start processor of the slot, or take it back if it is still retiring. `threadsMutex` must be locked.
+     */
+    void startProcessor(v_int32 index);
+    
+    /**
+     * Retire the last processor. `threadsMutex` must be locked.
+     */
+    void retireProcessor();
+    
+    oatpp::concurrency::SpinLock::Atom atom;
+    SubmissionProcessor** processors;
+    
+    /**
+     * Coroutines are distributed to processors [0, processorsCount). Changed under `atom`.
+     */
+    std::atomic<v_int32> processorsCount;
+    v_int32 maxProcessorsCount;
+    
+    /**
+     * Number of processors sleeping with no runnable coroutines.
+     */
+    std::atomic<v_int32> idleCount;
+    v_word32 forwardBalancer;
+    
+    /* Threads of processors. Thread is replaced when a retired processor is started again */
+    std::mutex threadsMutex;
+    std::shared_ptr<oatpp::concurrency::Thread>* threads;
+    bool detached;
+    /* Cleared by Executor's destructor */
+    bool linked;
+    
+    /* nullptr if executor is not elastic */
+    Scaler* scaler;
+    
+    /* nullptr if threads are not pinned */
+    std::shared_ptr<oatpp::concurrency::PlacementPolicy> placementPolicy;
+    
   };
   
-  class SubmissionProcessor : public oatpp::concurrency::Runnable {
-  private:
-    typedef oatpp::collection::LinkedList<std::shared_ptr<TaskSubmission>> Tasks;
+  class SubmissionProcessor : public oatpp::concurrency::Runnable, public std::enable_shared_from_this<SubmissionProcessor> {
+  public:
+    /**
+     * Processor's thread is running and processor gets coroutines.
+     */
+    static constexpr const v_int32 STATE_ACTIVE = 0;
+    
+    /**
+     * Processor doesn't get new coroutines and migrates its coroutines to other processors.
+     */
+    static constexpr const v_int32 STATE_RETIRING = 1;
+    
+    /**
+     * Processor's thread has exited or was never started.
+     */
+    static constexpr const v_int32 STATE_EXITED = 2;
   private:
     void consumeTasks();
+    v_int64 getWaitTimeoutMicros(v_int64 maxMicros);
+    void checkScaling();
+    
+    /**
+     * Account processing pass which has just ended.
+     * @param passStartMicros - time the pass started.
+     * @return - current time - start of the next pass.
+     */
+    v_int64 onPassEnd(v_int64 passStartMicros);
+    
+    /**
+     * Migrate coroutines to other processors. Exit once processor holds no coroutines.
+     * @return - `true` if processor has exited.
+     */
+    bool migrateWork();
+    
+    /**
+     * Forward coroutines submitted to the processor after it has exited.
+     */
+    void forwardPendingTasks();
+    
+    /**
+     * Publish half of runnable coroutines for stealing if some processor is idle.
+     */
+    void shareWork();
+    
+    /**
+     * Take back coroutines which were published for stealing but weren't stolen.
+     */
+    bool reclaimSharedWork();
+    
+    /**
+     * Steal coroutines published by other processors.
+     */
+    bool stealWork();
+    
+    /**
+     * Check if other processors have published coroutines for stealing.
+     */
+    bool hasWorkToSteal();
+    
+    void wakeIdleProcessor();
+    
+    /**
+     * Sleep until &l:Executor::SubmissionProcessor::wakeup (); is called, a task is submitted, I/O is ready,
+     * a parked coroutine is resumed, or timeout. See &l:Processor::waitForEvents ();.
+     * @param timeoutMicros - max time to sleep. -1 - no timeout.
+     */
+    void waitForWakeup(v_int64 timeoutMicros);
+    
+    /**
+     * Wake up processor's thread sleeping in &l:Executor::SubmissionProcessor::waitForWakeup ();. Thread safe.
+     */
+    void wakeup();
+  private:
+    /* Processor running in the current thread */
+    static thread_local SubmissionProcessor* m_current;
   private:
     oatpp::async::Processor m_processor;
-    oatpp::concurrency::SpinLock::Atom m_atom;
-    Tasks m_pendingTasks;
+    oatpp::collection::MPSCQueue<AbstractCoroutine> m_pendingTasks;
   private:
-    bool m_isRunning;
-    std::mutex m_taskMutex;
-    std::condition_variable m_taskCondition;
+    std::shared_ptr<ProcessorsGroup> m_group;
+    v_int32 m_index;
+    oatpp::concurrency::SpinLock::Atom m_sharedAtom;
+    oatpp::collection::FastQueue<AbstractCoroutine> m_sharedQueue;
+    std::atomic<v_int32> m_sharedCount;
+    std::atomic<v_int32> m_tasksCount;
+    std::atomic<v_int64> m_stolenCount;
+    std::atomic<bool> m_idle;
+  private:
+    std::atomic<v_int32> m_state;
+    std::atomic<v_int64> m_idleMicros;
+    std::atomic<v_int64> m_sleepStartMicros;
+    std::atomic<v_int64> m_maxPassMicros;
+  private:
+    /* Metrics. Submitted count is incremented by submitters, the rest - by processor's thread */
+    std::atomic<v_int64> m_submittedCount;
+    std::atomic<v_int64> m_consumedCount;
+    std::atomic<v_int64> m_busyMicros;
+    std::atomic<v_int64> m_passesCount;
+    Histogram m_passHistogram;
+  private:
+    std::atomic<bool> m_isRunning;
   public:
-    SubmissionProcessor();
+    SubmissionProcessor(v_int32 ioEngine, v_int32 burstSize, const std::shared_ptr<ProcessorsGroup>& group, v_int32 index,
+                        v_int32 state);
   public:
     
     void run() override;
     void stop();
-    void addTaskSubmission(const std::shared_ptr<TaskSubmission>& task);
+    
+    /**
+     * Stop giving coroutines to the processor. Processor migrates its coroutines to other processors and exits.
+     * Processor must be removed from the group first.
+     */
+    void retire();
+    
+    /**
+     * Take back retiring processor.
+     * @return - `false` if processor has already exited.
+     */
+    bool reactivate();
+    
+    /**
+     * Mark exited processor as active before its new thread is started.
+     */
+    void restart() {
+      m_state.store(STATE_ACTIVE);
+    }
+    
+    v_int32 getState() const {
+      return m_state.load();
+    }
+    
+    /**
+     * Total time the processor has slept with nothing to do, including the current sleep.
+     * @param currentMicros
+     * @return
+     */
+    v_int64 getIdleMicros(v_int64 currentMicros) const;
+    
+    /**
+     * Get the longest processing pass since the last call and reset it.
+     * @return
+     */
+    v_int64 takeMaxPassMicros() {
+      return m_maxPassMicros.exchange(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * Get runtime metrics of the processor. Thread safe.
+     * @return - &id:oatpp::async::ProcessorMetrics;.
+     */
+    ProcessorMetrics getMetrics() const;
+    
+    Processor& getProcessor() {
+      return m_processor;
+    }
+    
+    const ProcessorsGroup* getGroup() const {
+      return m_group.get();
+    }
+    
+    /**
+     * Get processor running in the calling thread.
+     * @return - `nullptr` if the calling thread is not a processing thread.
+     */
+    static SubmissionProcessor* getCurrent();
+    
+    /**
+     * Start coroutine on this processor. Must be called from the processor's thread.
+     * @param coroutine
+     */
+    void addLocalTask(AbstractCoroutine* coroutine) {
+      m_processor.addCoroutine(coroutine);
+    }
+    
+    /**
+     * Submit coroutine to the processor. Lock-free, may be called from any thread.
+     * Wakes the processor thread only if it is sleeping.
+     * @param coroutine
+     */
+    void pushTask(AbstractCoroutine* coroutine);
+    
+    v_int32 getTasksCount() const {
+      return m_tasksCount.load(std::memory_order_relaxed);
+    }
+    
+    v_int32 getSharedCount() const {
+      return m_sharedCount.load(std::memory_order_relaxed);
+    }
+    
+    v_int64 getStolenCount() const {
+      return m_stolenCount.load(std::memory_order_relaxed);
+    }
     
   };
 
+public:
+  
+  /**
+   * Load counters of one processing thread of the executor.
+   */
+  class ProcessorLoad {
+  public:
+    /**
+     * Coroutines held by the processor - runnable, waiting for I/O, for timers, for retry, or parked in wait lists.
+     */
+    v_int32 tasksCount;
+    
+    /**
+     * Runnable coroutines published by the processor for stealing by idle processors.
+     */
+    v_int32 sharedCount;
+    
+    /**
+     * Total number of coroutines the processor has stolen from other processors.
+     */
+    v_int64 stolenCount;
+  };
+  
+  /**
+   * Runtime metrics of all threads of the executor. See &id:oatpp::async::ProcessorMetrics;.
+   */
+  class Metrics {
+  public:
+    
+    /**
+     * Time the metrics were read at.
+     */
+    v_int64 timestampMicros;
+    
+    /**
+     * Metrics of each thread including threads which are not running.
+     */
+    std::vector<ProcessorMetrics> processors;
+    
+    /**
+     * Metrics of all threads merged.
+     */
+    ProcessorMetrics total;
+    
+    /**
+     * Get number of coroutine steps made by all threads per second.
+     * @param previous - metrics read earlier.
+     * @return
+     */
+    v_float64 getStepsPerSecond(const Metrics& previous) const;
+    
+    /**
+     * Get share of time threads were busy running coroutines.
+     * @param previous - metrics read earlier.
+     * @return - value in range [0, 1] per thread summed for all threads.
+     */
+    v_float64 getBusyRatio(const Metrics& previous) const;
+    
+  };
+  
 public:
   static const v_int32 THREAD_NUM_DEFAULT;
 private:
-  v_int32 m_threadsCount;
-  std::shared_ptr<oatpp::concurrency::Thread>* m_threads;
+  v_int32 m_maxThreadsCount;
   std::shared_ptr<SubmissionProcessor>* m_processors;
+  std::shared_ptr<ProcessorsGroup> m_group;
   std::atomic<v_word32> m_balancer;
+  std::shared_ptr<StallDetector> m_stallDetector;
+private:
+  void start(v_int32 threadsCount, v_int32 ioEngine, v_int32 burstSize);
 public:
   
-  Executor(v_int32 threadsCount = THREAD_NUM_DEFAULT);
+  /**
+   * Constructor.
+   * @param threadsCount - number of processing threads.
+   * @param ioEngine - I/O readiness engine used by processors. See &l:IOEventPoller::ENGINE_AUTO;.
+   * @param burstSize - max number of steps a coroutine makes in a row until it waits or finishes.
+   * See &l:Processor::BURST_SIZE_DEFAULT;.
+   * @param placementPolicy - &id:oatpp::concurrency::PlacementPolicy; to pin threads with. Thread index is the worker index.
+   * `nullptr` - threads are not pinned.
+   */
+  Executor(v_int32 threadsCount = THREAD_NUM_DEFAULT,
+           v_int32 ioEngine = IOEventPoller::ENGINE_AUTO,
+           v_int32 burstSize = Processor::BURST_SIZE_DEFAULT,
+           const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy = nullptr);
+  
+  /**
+   * Constructor of elastic executor.
+   * @param config - &l:Executor::ScalingConfig;.
+   * @param ioEngine - I/O readiness engine used by processors. See &l:IOEventPoller::ENGINE_AUTO;.
+   * @param burstSize - max number of steps a coroutine makes in a row until it waits or finishes.
+   * See &l:Processor::BURST_SIZE_DEFAULT;.
+   * @param placementPolicy - &id:oatpp::concurrency::PlacementPolicy; to pin threads with. Thread index is the worker index.
+   * `nullptr` - threads are not pinned.
+   */
+  Executor(const ScalingConfig& config,
+           v_int32 ioEngine = IOEventPoller::ENGINE_AUTO,
+           v_int32 burstSize = Processor::BURST_SIZE_DEFAULT,
+           const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy = nullptr);
   
   ~Executor();
   
@@ -124,14 +580,82 @@ public:
   
   void stop();
   
+  /**
+   * Get number of threads coroutines are distributed to. Changes over time if executor is elastic.
+   * @return
+   */
+  v_int32 getThreadsCount() const {
+    return m_group->processorsCount.load(std::memory_order_relaxed);
+  }
+  
+  /**
+   * Get max number of threads. Equal to &l:Executor::getThreadsCount (); if executor is not elastic.
+   * @return
+   */
+  v_int32 getMaxThreadsCount() const {
+    return m_maxThreadsCount;
+  }
+  
+  /**
+   * Get load counters of processing thread. Values are updated by the thread once per processing pass.
+   * @param threadIndex - index of the thread in range [0, getMaxThreadsCount()).
+   * @return - &l:Executor::ProcessorLoad;.
+   */
+  ProcessorLoad getProcessorLoad(v_int32 threadIndex) const;
+  
+  /**
+   * Get scaling decisions of elastic executor. Counters are zero if executor is not elastic.
+   * @return - &l:Executor::ScalingStats;.
+   */
+  ScalingStats getScalingStats() const;
+  
+  /**
+   * Read runtime metrics of all threads. Cheap enough to be called periodically in production -
+   * threads only update relaxed counters, the aggregation is done here.
+   * @return - &l:Executor::Metrics;.
+   */
+  Metrics getMetrics() const;
+  
+  /**
+   * Watch all threads of the executor for blocking coroutine steps.
+   * Threads are reported as `executor@<address>[<index>]`. Detected stalls are counted in &l:Executor::getMetrics ();.
+   * Should not be called concurrently with itself.
+   * @param detector - &id:oatpp::async::StallDetector;. `nullptr` - stop watching.
+   */
+  void setStallDetector(const std::shared_ptr<StallDetector>& detector);
+  
+  /**
+   * Execute coroutine. Coroutine is constructed right away in the calling thread's coroutine pool
+   * and is handed over to one of the processing threads without locks and without extra allocations.
+   * @tparam CoroutineType - type of the coroutine.
+   * @param params - coroutine constructor parameters.
+   */
   template<typename CoroutineType, typename ... Args>
-  void execute(Args... params) {
-    auto processor = m_processors[m_balancer % m_threadsCount];
-    
-    auto submission = std::make_shared<SubmissionTemplate<CoroutineType, Args...>>(params...);
-    processor->addTaskSubmission(submission);
-    
-    m_balancer ++;
+  void execute(Args&&... params) {
+    /* Balancing doesn't need to be exact. Don't pay for atomic increment */
+    v_word32 balancer = m_balancer.load(std::memory_order_relaxed);
+    m_balancer.store(balancer + 1, std::memory_order_relaxed);
+    m_processors[balancer % m_group->processorsCount.load(std::memory_order_relaxed)]->pushTask(CoroutineType::getBench().obtain(std::forward<Args>(params)...));
+  }
+  
+  /**
+   * Execute coroutine on the processor of the calling thread if called from a processing thread of this executor
+   * (from a coroutine step). The coroutine is started right away without handoff to another thread and without
+   * touching the submission queue. Idle threads may still steal it. <br>
+   * Called from any other thread it is the same as &l:Executor::execute ();.
+   * @tparam CoroutineType - type of the coroutine.
+   * @param params - coroutine constructor parameters.
+   */
+  template<typename CoroutineType, typename ... Args>
+  void executeLocal(Args&&... params) {
+    SubmissionProcessor* processor = SubmissionProcessor::getCurrent();
+    if(processor != nullptr && processor->getGroup() == m_group.get() &&
+       processor->getState() == SubmissionProcessor::STATE_ACTIVE)
+    {
+      processor->addLocalTask(CoroutineType::getBench().obtain(std::forward<Args>(params)...));
+    } else {
+      execute<CoroutineType>(std::forward<Args>(params)...);
+    }
   }
   
 };
@@ -0,0 +1,298 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Fiber.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+
+/*
+ * Push callee-saved registers, MXCSR and x87 control word on the current stack, store the stack pointer to *fromStackPointer,
+ * load toStackPointer and pop the same from there. Returns to the address on top of the new stack.
+ */
+extern "C" void oatpp_async_fiber_switch(void** fromStackPointer, void* toStackPointer);
+
+__asm__(
+  ".text\n"
+  ".globl oatpp_async_fiber_switch\n"
+  ".hidden oatpp_async_fiber_switch\n"
+  ".type oatpp_async_fiber_switch, @function\n"
+  ".p2align 4\n"
+  "oatpp_async_fiber_switch:\n"
+  "  pushq %rbp\n"
+  "  pushq %rbx\n"
+  "  pushq %r12\n"
+  "  pushq %r13\n"
+  "  pushq %r14\n"
+  "  pushq %r15\n"
+  "  subq $8, %rsp\n"
+  "  stmxcsr (%rsp)\n"
+  "  fnstcw 4(%rsp)\n"
+  "  movq %rsp, (%rdi)\n"
+  "  movq %rsi, %rsp\n"
+  "  ldmxcsr (%rsp)\n"
+  "  fldcw 4(%rsp)\n"
+  "  addq $8, %rsp\n"
+  "  popq %r15\n"
+  "  popq %r14\n"
+  "  popq %r13\n"
+  "  popq %r12\n"
+  "  popq %rbx\n"
+  "  popq %rbp\n"
+  "  ret\n"
+  ".size oatpp_async_fiber_switch, .-oatpp_async_fiber_switch\n"
+);
+
+#endif
+
+namespace oatpp { namespace async {
+
+namespace {
+
+  thread_local Fiber* CURRENT_FIBER = nullptr;
+
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+
+  /*
+   * Lay out the stack as if oatpp_async_fiber_switch() was called on it from the beginning of entry.
+   * entry() starts with the stack aligned as if it was called - and has nowhere to return.
+   */
+  void* prepareStack(p_char8 stack, v_int32 stackSize, void (*entry)()) {
+
+    std::uintptr_t top = ((std::uintptr_t) (stack + stackSize)) & ~((std::uintptr_t) 15);
+    v_word64* sp = (v_word64*) top - 9;
+
+    v_word32 mxcsr;
+    v_word16 fpuControlWord;
+    __asm__ __volatile__("stmxcsr %0" : "=m" (mxcsr));
+    __asm__ __volatile__("fnstcw %0" : "=m" (fpuControlWord));
+
+    sp[0] = 0;
+    std::memcpy(&sp[0], &mxcsr, sizeof(mxcsr));
+    std::memcpy((p_char8) &sp[0] + 4, &fpuControlWord, sizeof(fpuControlWord));
+    for(v_int32 i = 1; i <= 6; i ++) {
+      sp[i] = 0; // r15, r14, r13, r12, rbx, rbp
+    }
+    sp[7] = (v_word64) entry; // return address of oatpp_async_fiber_switch()
+    sp[8] = 0; // return address of entry()
+
+    return sp;
+
+  }
+
+#endif
+
+}
+
+Fiber::StackPool::StackPool(v_int32 stackSize, v_int32 maxCached)
+  : m_guardSize((v_int32) ::sysconf(_SC_PAGESIZE))
+  , m_maxCached(maxCached)
+  , m_atom(false)
+{
+  m_stackSize = ((stackSize + m_guardSize - 1) / m_guardSize) * m_guardSize;
+}
+
+Fiber::StackPool::~StackPool() {
+  for(p_char8 stack : m_stacks) {
+    ::munmap(stack - m_guardSize, m_stackSize + m_guardSize);
+  }
+}
+
+p_char8 Fiber::StackPool::obtain() {
+
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    if(m_stacks.size() > 0) {
+      p_char8 stack = m_stacks.back();
+      m_stacks.pop_back();
+      return stack;
+    }
+  }
+
+  v_int32 flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_STACK
+  flags |= MAP_STACK;
+#endif
+
+  void* memory = ::mmap(nullptr, m_stackSize + m_guardSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if(memory == MAP_FAILED) {
+    throw std::runtime_error("[oatpp::async::Fiber::StackPool::obtain()]: Error. Can't map fiber stack.");
+  }
+
+  /* stack grows down. Guard page is the lowest one */
+  ::mprotect(memory, m_guardSize, PROT_NONE);
+
+  return (p_char8) memory + m_guardSize;
+
+}
+
+void Fiber::StackPool::free(p_char8 stack) {
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    if((v_int32) m_stacks.size() < m_maxCached) {
+      m_stacks.push_back(stack);
+      return;
+    }
+  }
+  ::munmap(stack - m_guardSize, m_stackSize + m_guardSize);
+}
+
+v_int32 Fiber::StackPool::getStackSize() const {
+  return m_stackSize;
+}
+
+Fiber::Fiber(const std::shared_ptr<StackPool>& stackPool, const Function& function)
+  : m_stackPool(stackPool)
+  , m_stack(nullptr)
+  , m_function(function)
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+  , m_stackPointer(nullptr)
+  , m_callerStackPointer(nullptr)
+#endif
+  , m_action(Action::_FINISH)
+  , m_started(false)
+  , m_finished(false)
+  , m_cancelled(false)
+{}
+
+Fiber::~Fiber() {
+  if(m_started) {
+    if(!m_finished) {
+      /* cancelled fiber doesn't suspend, so one resume runs it to completion */
+      m_cancelled = true;
+      resume();
+    }
+    m_stackPool->free(m_stack);
+  }
+}
+
+void Fiber::entry() {
+
+  Fiber* fiber = CURRENT_FIBER;
+
+  try {
+    fiber->m_function();
+  } catch (...) {
+    fiber->m_exception = std::current_exception();
+  }
+
+  fiber->m_function = nullptr;
+  fiber->m_finished = true;
+  fiber->m_action = Action::_FINISH;
+
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+  oatpp_async_fiber_switch(&fiber->m_stackPointer, fiber->m_callerStackPointer);
+#else
+  ::setcontext(&fiber->m_callerContext);
+#endif
+
+}
+
+Fiber* Fiber::getCurrent() {
+  return CURRENT_FIBER;
+}
+
+Action Fiber::resume() {
+
+  if(m_finished) {
+    return Action::_FINISH;
+  }
+
+  if(!m_started) {
+    m_stack = m_stackPool->obtain();
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+    m_stackPointer = prepareStack(m_stack, m_stackPool->getStackSize(), &Fiber::entry);
+#else
+    ::getcontext(&m_context);
+    m_context.uc_stack.ss_sp = m_stack;
+    m_context.uc_stack.ss_size = m_stackPool->getStackSize();
+    m_context.uc_link = nullptr;
+    ::makecontext(&m_context, &Fiber::entry, 0);
+#endif
+    m_started = true;
+  }
+
+  Fiber* previous = CURRENT_FIBER;
+  CURRENT_FIBER = this;
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+  oatpp_async_fiber_switch(&m_callerStackPointer, m_stackPointer);
+#else
+  ::swapcontext(&m_callerContext, &m_context);
+#endif
+  CURRENT_FIBER = previous;
+
+  return m_action;
+
+}
+
+bool Fiber::suspend(const Action& action) {
+  if(m_cancelled) {
+    return false;
+  }
+  m_action = action;
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+  oatpp_async_fiber_switch(&m_stackPointer, m_callerStackPointer);
+#else
+  ::swapcontext(&m_context, &m_callerContext);
+#endif
+  return !m_cancelled;
+}
+
+bool Fiber::isFinished() const {
+  return m_finished;
+}
+
+std::exception_ptr Fiber::getException() const {
+  return m_exception;
+}
+
+FiberCoroutine::FiberCoroutine(const std::shared_ptr<Fiber::StackPool>& stackPool, const Fiber::Function& function)
+  : m_fiber(stackPool, function)
+{}
+
+Action FiberCoroutine::act() {
+  /* Code in fiber may hold addresses of thread-local data across suspension points */
+  setPinned(true);
+  return yieldTo(&FiberCoroutine::run);
+}
+
+Action FiberCoroutine::run() {
+  Action action = m_fiber.resume();
+  if(m_fiber.isFinished()) {
+    if(m_fiber.getException()) {
+      std::rethrow_exception(m_fiber.getException());
+    }
+    return finish();
+  }
+  return action;
+}
+
+}}
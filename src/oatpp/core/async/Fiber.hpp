@@ -0,0 +1,213 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_async_Fiber_hpp
+#define oatpp_async_Fiber_hpp
+
+#include "./Coroutine.hpp"
+
+#include "oatpp/core/concurrency/SpinLock.hpp"
+
+#include <functional>
+#include <exception>
+#include <vector>
+
+#if defined(__linux__) && defined(__x86_64__) && defined(__GNUC__)
+  /* Switch callee-saved registers and stack pointer only. No syscalls */
+  #define OATPP_ASYNC_FIBER_SWITCH_ASM
+#else
+  #include <ucontext.h>
+#endif
+
+namespace oatpp { namespace async {
+
+/**
+ * Stackful fiber. Runs blocking-style code on its own stack and lets it suspend with an &l:Action;
+ * which is then taken by the coroutine driving the fiber (see &l:FiberCoroutine;). <br>
+ * On x86-64 context is switched in user space - only callee-saved registers and the stack pointer are swapped.
+ * On other architectures `swapcontext` is used - it also saves and restores the signal mask, which takes a syscall per switch. <br>
+ * Fiber which is resumed on a different thread than the one it was suspended on should not keep pointers
+ * to thread-local data across suspension points. &l:FiberCoroutine; pins itself to its processor's thread.
+ */
+class Fiber {
+public:
+  typedef std::function<void()> Function;
+public:
+
+  /**
+   * Default stack size - 128 KB.
+   */
+  static constexpr const v_int32 STACK_SIZE_DEFAULT = 128 * 1024;
+
+  /**
+   * Default number of released stacks kept by &l:Fiber::StackPool; for reuse.
+   */
+  static constexpr const v_int32 STACK_POOL_MAX_CACHED_DEFAULT = 1024;
+
+public:
+
+  /**
+   * Pool of fiber stacks of the same size. <br>
+   * Stacks are mmap-ed with a guard page below the stack so that stack overflow crashes instead of corrupting memory.
+   * Released stacks are kept for reuse up to `maxCached`.
+   */
+  class StackPool {
+  private:
+    v_int32 m_stackSize;
+    v_int32 m_guardSize;
+    v_int32 m_maxCached;
+    oatpp::concurrency::SpinLock::Atom m_atom;
+    std::vector<p_char8> m_stacks;
+  public:
+
+    /**
+     * Constructor.
+     * @param stackSize - usable size of each stack. Rounded up to page size.
+     * @param maxCached - max number of released stacks kept for reuse.
+     */
+    StackPool(v_int32 stackSize = STACK_SIZE_DEFAULT, v_int32 maxCached = STACK_POOL_MAX_CACHED_DEFAULT);
+
+    ~StackPool();
+
+    static std::shared_ptr<StackPool> createShared(v_int32 stackSize = STACK_SIZE_DEFAULT,
+                                                   v_int32 maxCached = STACK_POOL_MAX_CACHED_DEFAULT)
+    {
+      return std::make_shared<StackPool>(stackSize, maxCached);
+    }
+
+    /**
+     * Get stack. Throws `std::runtime_error` if memory can't be mapped.
+     * @return - pointer to the lowest usable address of the stack.
+     */
+    p_char8 obtain();
+
+    /**
+     * Return stack to the pool.
+     * @param stack - stack obtained by &l:Fiber::StackPool::obtain ();.
+     */
+    void free(p_char8 stack);
+
+    /**
+     * @return - usable size of each stack.
+     */
+    v_int32 getStackSize() const;
+
+  };
+
+private:
+  static void entry();
+private:
+  std::shared_ptr<StackPool> m_stackPool;
+  p_char8 m_stack;
+  Function m_function;
+#if defined(OATPP_ASYNC_FIBER_SWITCH_ASM)
+  void* m_stackPointer;
+  void* m_callerStackPointer;
+#else
+  ucontext_t m_context;
+  ucontext_t m_callerContext;
+#endif
+  Action m_action;
+  bool m_started;
+  bool m_finished;
+  bool m_cancelled;
+  std::exception_ptr m_exception;
+public:
+
+  /**
+   * Constructor. Stack is taken from the pool lazily on the first &l:Fiber::resume ();.
+   * @param stackPool - pool to take the stack from.
+   * @param function - function to run in fiber.
+   */
+  Fiber(const std::shared_ptr<StackPool>& stackPool, const Function& function);
+
+  Fiber(const Fiber&) = delete;
+  Fiber& operator = (const Fiber&) = delete;
+
+  /**
+   * Destructor. If fiber was started but not finished, it is cancelled - resumed until its function returns.
+   * Cancelled fiber never suspends again - &l:Fiber::suspend (); returns `false` immediately.
+   */
+  ~Fiber();
+
+  /**
+   * Get fiber running on the current thread.
+   * @return - current fiber or `nullptr` if not called from fiber.
+   */
+  static Fiber* getCurrent();
+
+  /**
+   * Run fiber until it suspends or finishes. Should not be called from the fiber itself.
+   * @return - action fiber was suspended with. `Action::_FINISH` if fiber has finished.
+   */
+  Action resume();
+
+  /**
+   * Switch from fiber back to the caller of &l:Fiber::resume ();. Should be called from the fiber itself.
+   * @param action - action returned by &l:Fiber::resume ();. Usually wait action.
+   * @return - `true` if fiber was resumed normally. `false` if fiber is cancelled and should unwind.
+   */
+  bool suspend(const Action& action);
+
+  /**
+   * @return - `true` if fiber function has returned.
+   */
+  bool isFinished() const;
+
+  /**
+   * @return - exception thrown out of the fiber function, if any.
+   */
+  std::exception_ptr getException() const;
+
+};
+
+/**
+ * Coroutine which drives &l:Fiber;. Action the fiber is suspended with becomes the action of the coroutine.
+ * Exception thrown out of the fiber function is rethrown in the coroutine and turns into an error. <br>
+ * Coroutine chain is pinned to the processor which starts the fiber (see &l:AbstractCoroutine::setPinned ();) -
+ * fiber is always resumed on the same thread. <br>
+ * This allows to run blocking-style code on &id:oatpp::async::Executor;,
+ * as long as its I/O suspends the fiber instead of blocking the thread (see &id:oatpp::network::Connection;).
+ */
+class FiberCoroutine : public Coroutine<FiberCoroutine> {
+private:
+  Fiber m_fiber;
+private:
+  Action run();
+public:
+
+  /**
+   * Constructor.
+   * @param stackPool - pool to take fiber stack from.
+   * @param function - function to run in fiber.
+   */
+  FiberCoroutine(const std::shared_ptr<Fiber::StackPool>& stackPool, const Fiber::Function& function);
+
+  Action act() override;
+
+};
+
+}}
+
+#endif /* oatpp_async_Fiber_hpp */
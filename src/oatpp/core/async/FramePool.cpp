@@ -0,0 +1,407 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FramePool.hpp"
+
+#include "./Profiler.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace oatpp { namespace async {
+
+namespace {
+
+/* Releases pool of the thread on thread exit */
+class PoolHolder {
+public:
+  ~PoolHolder() {
+    FramePool::releaseThreadPool();
+  }
+};
+
+/* Frames larger than the last size class are prefixed with their allocation size */
+constexpr const v_int32 LARGE_PREFIX_SIZE = 16;
+
+}
+
+const v_int32 FramePool::SIZE_CLASSES[SIZE_CLASSES_COUNT] = {
+  64, 96, 128, 160, 192, 256, 320, 384, 512, 640, 768, 1024, 1536, 2048, 3072, MAX_POOLED_FRAME_SIZE
+};
+
+oatpp::concurrency::SpinLock::Atom FramePool::POOLS_ATOM(false);
+
+std::list<std::unique_ptr<FramePool>>& FramePool::getPools() {
+  /* Never destroyed - frames may be freed by threads which outlive static destructors */
+  static std::list<std::unique_ptr<FramePool>>* pools = new std::list<std::unique_ptr<FramePool>>();
+  return *pools;
+}
+
+FramePool*& FramePool::getThreadPoolPtr() {
+  static thread_local FramePool* pool = nullptr;
+  return pool;
+}
+
+FramePool::FramePool()
+  : m_remoteFreed(nullptr)
+  , m_owned(false)
+  , m_chunksCount(0)
+  , m_reservedBytes(0)
+  , m_lastGrowMicros(0)
+  , m_atom(false)
+{}
+
+FramePool::~FramePool() {
+  for(v_int32 i = 0; i < SIZE_CLASSES_COUNT; i ++) {
+    Chunk* chunk = m_classes[i].chunks;
+    while (chunk != nullptr) {
+      Chunk* next = chunk->next;
+      ::operator delete(chunk);
+      chunk = next;
+    }
+  }
+}
+
+FramePool& FramePool::getThreadPool() {
+  FramePool*& pool = getThreadPoolPtr();
+  if(pool == nullptr) {
+    static thread_local PoolHolder holder;
+    (void) holder;
+    oatpp::concurrency::SpinLock lock(POOLS_ATOM);
+    for(auto& p : getPools()) {
+      if(!p->m_owned.load(std::memory_order_acquire)) {
+        pool = p.get();
+        break;
+      }
+    }
+    if(pool == nullptr) {
+      getPools().push_back(std::unique_ptr<FramePool>(new FramePool()));
+      pool = getPools().back().get();
+    }
+    pool->m_owned.store(true, std::memory_order_relaxed);
+  }
+  return *pool;
+}
+
+void FramePool::releaseThreadPool() {
+  FramePool*& pool = getThreadPoolPtr();
+  if(pool != nullptr) {
+    pool->drainRemote();
+    pool->shrink(false);
+    pool->m_owned.store(false, std::memory_order_release);
+    pool = nullptr;
+  }
+}
+
+v_int32 FramePool::getClassIndex(v_int32 frameSize) {
+  for(v_int32 i = 0; i < SIZE_CLASSES_COUNT; i ++) {
+    if(frameSize <= SIZE_CLASSES[i]) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void FramePool::account(Counters* counters, v_int64 frames, v_int64 bytes) {
+  v_int64 inUseCount = counters->inUseCount.load(std::memory_order_relaxed) + frames;
+  counters->inUseCount.store(inUseCount, std::memory_order_relaxed);
+  counters->inUseBytes.store(counters->inUseBytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+  if(frames > 0) {
+    counters->allocatedCount.store(counters->allocatedCount.load(std::memory_order_relaxed) + frames, std::memory_order_relaxed);
+    if(inUseCount > counters->peakCount.load(std::memory_order_relaxed)) {
+      counters->peakCount.store(inUseCount, std::memory_order_relaxed);
+    }
+  }
+}
+
+FramePool::Counters* FramePool::getCounters(const std::type_info& type, v_int32 objectSize) {
+  auto it = m_counters.find(&type);
+  if(it != m_counters.end()) {
+    return &it->second;
+  }
+  oatpp::concurrency::SpinLock lock(m_atom);
+  auto result = m_counters.emplace(std::piecewise_construct,
+                                   std::forward_as_tuple(&type),
+                                   std::forward_as_tuple(this, &type, objectSize));
+  return &result.first->second;
+}
+
+void FramePool::grow(v_int32 classIndex) {
+  
+  v_int32 frameSize = SIZE_CLASSES[classIndex];
+  v_int32 framesCount = std::max<v_int32>(1, (CHUNK_SIZE - CHUNK_HEADER_SIZE) / frameSize);
+  v_int64 bytes = CHUNK_HEADER_SIZE + (v_int64) framesCount * frameSize;
+  
+  Chunk* chunk = static_cast<Chunk*>(::operator new(bytes));
+  chunk->classIndex = classIndex;
+  chunk->framesCount = framesCount;
+  chunk->usedCount = 0;
+  chunk->releasing = false;
+  
+  SizeClass& sizeClass = m_classes[classIndex];
+  chunk->next = sizeClass.chunks;
+  sizeClass.chunks = chunk;
+  sizeClass.chunksCount ++;
+  
+  /* Link frames so that they are taken in the address order */
+  p_char8 frames = reinterpret_cast<p_char8>(chunk) + CHUNK_HEADER_SIZE;
+  for(v_int32 i = framesCount - 1; i >= 0; i --) {
+    void* frame = frames + (v_int64) i * frameSize + HEADER_SIZE;
+    getHeader(frame)->chunk = chunk;
+    *static_cast<void**>(frame) = sizeClass.freeList;
+    sizeClass.freeList = frame;
+  }
+  
+  m_chunksCount.store(m_chunksCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  m_reservedBytes.store(m_reservedBytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+  m_lastGrowMicros = oatpp::base::Environment::getMicroTickCount();
+  
+}
+
+void* FramePool::allocate(Counters* counters, v_int32 size) {
+  
+  v_int32 classIndex = getClassIndex(size + HEADER_SIZE);
+  
+  if(classIndex < 0) {
+    v_int64 bytes = LARGE_PREFIX_SIZE + HEADER_SIZE + (v_int64) size;
+    p_char8 memory = static_cast<p_char8>(::operator new(bytes));
+    *reinterpret_cast<v_int64*>(memory) = bytes;
+    void* frame = memory + LARGE_PREFIX_SIZE + HEADER_SIZE;
+    Header* header = getHeader(frame);
+    header->chunk = nullptr;
+    header->counters = counters;
+    account(counters, 1, bytes);
+    m_reservedBytes.store(m_reservedBytes.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    return frame;
+  }
+  
+  SizeClass& sizeClass = m_classes[classIndex];
+  if(sizeClass.freeList == nullptr) {
+    drainRemote();
+    if(sizeClass.freeList == nullptr) {
+      grow(classIndex);
+    }
+  }
+  
+  void* frame = sizeClass.freeList;
+  sizeClass.freeList = *static_cast<void**>(frame);
+  Header* header = getHeader(frame);
+  header->counters = counters;
+  header->chunk->usedCount ++;
+  account(counters, 1, SIZE_CLASSES[classIndex]);
+  return frame;
+  
+}
+
+void FramePool::freeLocal(void* frame) {
+  
+  Header* header = getHeader(frame);
+  Chunk* chunk = header->chunk;
+  
+  if(chunk == nullptr) {
+    p_char8 memory = reinterpret_cast<p_char8>(frame) - HEADER_SIZE - LARGE_PREFIX_SIZE;
+    v_int64 bytes = *reinterpret_cast<v_int64*>(memory);
+    account(header->counters, -1, -bytes);
+    m_reservedBytes.store(m_reservedBytes.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+    ::operator delete(memory);
+    return;
+  }
+  
+  account(header->counters, -1, -SIZE_CLASSES[chunk->classIndex]);
+  chunk->usedCount --;
+  SizeClass& sizeClass = m_classes[chunk->classIndex];
+  *static_cast<void**>(frame) = sizeClass.freeList;
+  sizeClass.freeList = frame;
+  
+}
+
+void FramePool::freeRemote(void* frame) {
+  void* head = m_remoteFreed.load(std::memory_order_relaxed);
+  do {
+    *static_cast<void**>(frame) = head;
+  } while (!m_remoteFreed.compare_exchange_weak(head, frame, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void FramePool::drainRemote() {
+  void* frame = m_remoteFreed.exchange(nullptr, std::memory_order_acquire);
+  while (frame != nullptr) {
+    void* next = *static_cast<void**>(frame);
+    freeLocal(frame);
+    frame = next;
+  }
+}
+
+void FramePool::free(void* frame) {
+  FramePool* pool = getHeader(frame)->counters->pool;
+  if(pool == getThreadPoolPtr()) {
+    pool->freeLocal(frame);
+  } else {
+    pool->freeRemote(frame);
+  }
+}
+
+void FramePool::shrink(bool keepReserve) {
+  
+  for(v_int32 i = 0; i < SIZE_CLASSES_COUNT; i ++) {
+    
+    SizeClass& sizeClass = m_classes[i];
+    
+    v_int32 freeChunksCount = 0;
+    for(Chunk* chunk = sizeClass.chunks; chunk != nullptr; chunk = chunk->next) {
+      if(chunk->usedCount == 0) {
+        freeChunksCount ++;
+      }
+    }
+    
+    /* Keep one chunk if the class has no chunks in use - it's likely to be needed again */
+    v_int32 releaseCount = freeChunksCount;
+    if(keepReserve && freeChunksCount == sizeClass.chunksCount) {
+      releaseCount --;
+    }
+    if(releaseCount <= 0) {
+      continue;
+    }
+    
+    v_int32 marked = 0;
+    for(Chunk* chunk = sizeClass.chunks; chunk != nullptr && marked < releaseCount; chunk = chunk->next) {
+      if(chunk->usedCount == 0) {
+        chunk->releasing = true;
+        marked ++;
+      }
+    }
+    
+    /* Unlink free frames of released chunks */
+    void** link = &sizeClass.freeList;
+    while (*link != nullptr) {
+      void* frame = *link;
+      if(getHeader(frame)->chunk->releasing) {
+        *link = *static_cast<void**>(frame);
+      } else {
+        link = static_cast<void**>(frame);
+      }
+    }
+    
+    Chunk** chunkLink = &sizeClass.chunks;
+    while (*chunkLink != nullptr) {
+      Chunk* chunk = *chunkLink;
+      if(chunk->releasing) {
+        *chunkLink = chunk->next;
+        v_int64 bytes = CHUNK_HEADER_SIZE + (v_int64) chunk->framesCount * SIZE_CLASSES[i];
+        ::operator delete(chunk);
+        sizeClass.chunksCount --;
+        m_chunksCount.store(m_chunksCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        m_reservedBytes.store(m_reservedBytes.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+      } else {
+        chunkLink = &chunk->next;
+      }
+    }
+    
+  }
+  
+}
+
+v_int64 FramePool::onIdle(v_int64 currentMicros) {
+  
+  drainRemote();
+  
+  bool hasFreeChunks = false;
+  for(v_int32 i = 0; i < SIZE_CLASSES_COUNT && !hasFreeChunks; i ++) {
+    const SizeClass& sizeClass = m_classes[i];
+    v_int32 freeChunksCount = 0;
+    for(Chunk* chunk = sizeClass.chunks; chunk != nullptr; chunk = chunk->next) {
+      if(chunk->usedCount == 0) {
+        freeChunksCount ++;
+      }
+    }
+    hasFreeChunks = freeChunksCount > 0 && (freeChunksCount < sizeClass.chunksCount || freeChunksCount > 1);
+  }
+  
+  if(!hasFreeChunks) {
+    return -1;
+  }
+  
+  v_int64 elapsedMicros = currentMicros - m_lastGrowMicros;
+  if(elapsedMicros < SHRINK_DELAY_MICROS) {
+    return SHRINK_DELAY_MICROS - elapsedMicros;
+  }
+  
+  shrink(true);
+  return -1;
+  
+}
+
+FramePool::Stats FramePool::getStats() {
+  
+  Stats stats;
+  stats.poolsCount = 0;
+  stats.chunksCount = 0;
+  stats.reservedBytes = 0;
+  stats.inUseBytes = 0;
+  
+  std::unordered_map<const std::type_info*, TypeStats> types;
+  
+  {
+    oatpp::concurrency::SpinLock poolsLock(POOLS_ATOM);
+    for(auto& pool : getPools()) {
+      stats.poolsCount ++;
+      stats.chunksCount += pool->m_chunksCount.load(std::memory_order_relaxed);
+      stats.reservedBytes += pool->m_reservedBytes.load(std::memory_order_relaxed);
+      oatpp::concurrency::SpinLock lock(pool->m_atom);
+      for(auto& pair : pool->m_counters) {
+        const Counters& counters = pair.second;
+        auto it = types.find(pair.first);
+        if(it == types.end()) {
+          TypeStats typeStats;
+          typeStats.objectSize = counters.objectSize;
+          typeStats.inUseCount = 0;
+          typeStats.peakCount = 0;
+          typeStats.allocatedCount = 0;
+          typeStats.inUseBytes = 0;
+          it = types.insert({pair.first, typeStats}).first;
+        }
+        it->second.inUseCount += counters.inUseCount.load(std::memory_order_relaxed);
+        it->second.peakCount += counters.peakCount.load(std::memory_order_relaxed);
+        it->second.allocatedCount += counters.allocatedCount.load(std::memory_order_relaxed);
+        it->second.inUseBytes += counters.inUseBytes.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  
+  stats.types.reserve(types.size());
+  for(auto& pair : types) {
+    pair.second.typeName = Profiler::getTypeName(*pair.first);
+    stats.inUseBytes += pair.second.inUseBytes;
+    stats.types.push_back(pair.second);
+  }
+  
+  std::sort(stats.types.begin(), stats.types.end(), [](const TypeStats& a, const TypeStats& b) {
+    return a.inUseBytes > b.inUseBytes;
+  });
+  
+  return stats;
+  
+}
+  
+}}
@@ -0,0 +1,323 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_FramePool_hpp
+#define oatpp_async_FramePool_hpp
+
+#include "oatpp/core/concurrency/SpinLock.hpp"
+#include "oatpp/core/base/Environment.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace async {
+
+/**
+ * Allocator of coroutine frames. One pool per thread - for executor's threads it's the pool of the &l:Processor;. <br>
+ * Frames of all coroutine types share size classes. Each size class grows by chunks of &l:FramePool::CHUNK_SIZE; bytes.
+ * Chunks which have no frames in use are released once the thread is idle and the pool hasn't grown for
+ * &l:FramePool::SHRINK_DELAY_MICROS;. <br>
+ * Frame freed on another thread goes back to the pool it was taken from (lock-free).
+ * Such frames are reused by the owner thread once it runs out of free frames or goes idle. <br>
+ * Pool of an exited thread is reused by the next new thread. <br>
+ * Pools count frames in use per coroutine type - see &l:FramePool::getStats ();.
+ */
+class FramePool {
+public:
+  
+  /**
+   * Frame header size. Frame size includes the header.
+   */
+  static constexpr const v_int32 HEADER_SIZE = 16;
+  
+  /**
+   * Number of size classes.
+   */
+  static constexpr const v_int32 SIZE_CLASSES_COUNT = 16;
+  
+  /**
+   * Frame sizes of size classes. Frames larger than the last size class are allocated with operator new.
+   */
+  static const v_int32 SIZE_CLASSES[SIZE_CLASSES_COUNT];
+  
+  /**
+   * Frame size of the last size class.
+   */
+  static constexpr const v_int32 MAX_POOLED_FRAME_SIZE = 4096;
+  
+  /**
+   * Size of the memory chunk a size class grows with. Chunk holds at least one frame.
+   */
+  static constexpr const v_int32 CHUNK_SIZE = 16 * 1024;
+  
+  /**
+   * Free chunks are released once the pool hasn't grown for this time.
+   */
+  static constexpr const v_int64 SHRINK_DELAY_MICROS = 1000 * 1000;
+  
+public:
+  
+  /**
+   * Counters of one coroutine type in one pool. Written by the owner thread only.
+   */
+  class Counters {
+  public:
+    
+    Counters(FramePool* pPool, const std::type_info* pType, v_int32 pObjectSize)
+      : pool(pPool)
+      , type(pType)
+      , objectSize(pObjectSize)
+      , inUseCount(0)
+      , peakCount(0)
+      , allocatedCount(0)
+      , inUseBytes(0)
+    {}
+    
+    FramePool* const pool;
+    const std::type_info* const type;
+    const v_int32 objectSize;
+    std::atomic<v_int64> inUseCount;
+    std::atomic<v_int64> peakCount;
+    std::atomic<v_int64> allocatedCount;
+    std::atomic<v_int64> inUseBytes;
+  };
+  
+  /**
+   * Frames of one coroutine type in all pools.
+   */
+  class TypeStats {
+  public:
+    
+    /**
+     * Demangled name of the type.
+     */
+    std::string typeName;
+    
+    /**
+     * `sizeof` of the type. 0 - variable size (C++20 coroutine frames).
+     */
+    v_int32 objectSize;
+    
+    /**
+     * Number of frames in use.
+     */
+    v_int64 inUseCount;
+    
+    /**
+     * Sum of per-thread peaks of frames in use.
+     */
+    v_int64 peakCount;
+    
+    /**
+     * Total number of allocated frames.
+     */
+    v_int64 allocatedCount;
+    
+    /**
+     * Bytes of frames in use - including headers and size class rounding.
+     */
+    v_int64 inUseBytes;
+    
+  };
+  
+  /**
+   * Stats of all pools.
+   */
+  class Stats {
+  public:
+    
+    /**
+     * Number of threads' pools.
+     */
+    v_int32 poolsCount;
+    
+    /**
+     * Number of chunks.
+     */
+    v_int64 chunksCount;
+    
+    /**
+     * Memory held by chunks and by frames larger than the last size class.
+     */
+    v_int64 reservedBytes;
+    
+    /**
+     * Bytes of frames in use.
+     */
+    v_int64 inUseBytes;
+    
+    /**
+     * Per type stats sorted by &l:FramePool::TypeStats::inUseBytes;.
+     */
+    std::vector<TypeStats> types;
+    
+  };
+  
+private:
+  
+  class Chunk {
+  public:
+    Chunk* next;
+    v_int32 classIndex;
+    v_int32 framesCount;
+    v_int32 usedCount;
+    bool releasing;
+  };
+  
+  class Header {
+  public:
+    /* nullptr for frames larger than the last size class */
+    Chunk* chunk;
+    Counters* counters;
+  };
+  
+  class SizeClass {
+  public:
+    void* freeList = nullptr;
+    Chunk* chunks = nullptr;
+    v_int32 chunksCount = 0;
+  };
+  
+  static_assert(sizeof(Header) <= HEADER_SIZE, "Frame header doesn't fit");
+  
+private:
+  static constexpr const v_int32 CHUNK_HEADER_SIZE = (sizeof(Chunk) + 15) / 16 * 16;
+private:
+  static oatpp::concurrency::SpinLock::Atom POOLS_ATOM;
+  static std::list<std::unique_ptr<FramePool>>& getPools();
+  static FramePool*& getThreadPoolPtr();
+private:
+  SizeClass m_classes[SIZE_CLASSES_COUNT];
+  std::atomic<void*> m_remoteFreed;
+  std::atomic<bool> m_owned;
+  std::atomic<v_int64> m_chunksCount;
+  std::atomic<v_int64> m_reservedBytes;
+  v_int64 m_lastGrowMicros;
+  /* Guards insertion of counters */
+  oatpp::concurrency::SpinLock::Atom m_atom;
+  std::unordered_map<const std::type_info*, Counters> m_counters;
+private:
+  static Header* getHeader(void* frame) {
+    return reinterpret_cast<Header*>(static_cast<p_char8>(frame) - HEADER_SIZE);
+  }
+  static v_int32 getClassIndex(v_int32 frameSize);
+  static void account(Counters* counters, v_int64 frames, v_int64 bytes);
+  void grow(v_int32 classIndex);
+  void freeLocal(void* frame);
+  void freeRemote(void* frame);
+  void drainRemote();
+  void shrink(bool keepReserve);
+public:
+  
+  FramePool();
+  
+  ~FramePool();
+  
+  /**
+   * Get pool of the calling thread.
+   * @return
+   */
+  static FramePool& getThreadPool();
+  
+  /**
+   * Release pool of the calling thread. Called on thread exit. Free chunks are released and the pool
+   * is left for the next new thread.
+   */
+  static void releaseThreadPool();
+  
+  /**
+   * Get counters of the type. Pointer stays valid while the pool exists.
+   * Should be called by the owner thread.
+   * @param type - type of objects.
+   * @param objectSize - `sizeof` of the type. 0 - variable size.
+   * @return
+   */
+  Counters* getCounters(const std::type_info& type, v_int32 objectSize);
+  
+  /**
+   * Allocate frame. Should be called by the owner thread.
+   * @param counters - counters of the type. See &l:FramePool::getCounters ();.
+   * @param size - size of object. Memory is aligned by 16.
+   * @return
+   */
+  void* allocate(Counters* counters, v_int32 size);
+  
+  /**
+   * Free frame. May be called from any thread.
+   * @param frame - frame obtained with &l:FramePool::allocate ();.
+   */
+  static void free(void* frame);
+  
+  /**
+   * Called by the owner thread when it's going to sleep. Takes back frames freed by other threads and releases
+   * free chunks if the pool hasn't grown for &l:FramePool::SHRINK_DELAY_MICROS;.
+   * @param currentMicros - current time.
+   * @return - how long the thread may sleep before the next call is needed. -1 - nothing to release.
+   */
+  v_int64 onIdle(v_int64 currentMicros);
+  
+  /**
+   * Get stats of all pools.
+   * @return - &l:FramePool::Stats;.
+   */
+  static Stats getStats();
+  
+};
+
+/**
+ * Allocator of coroutines of type `T`. See &l:FramePool;.
+ * @tparam T - coroutine type.
+ */
+template<class T>
+class FrameBench {
+public:
+  
+  template<typename ... Args>
+  T* obtain(Args&&... args) {
+    static_assert(alignof(T) <= 16, "Coroutine alignment is not supported");
+    static thread_local FramePool::Counters* counters = nullptr;
+    FramePool& pool = FramePool::getThreadPool();
+    if(counters == nullptr) {
+      counters = pool.getCounters(typeid(T), sizeof(T));
+    }
+    void* frame = pool.allocate(counters, sizeof(T));
+    try {
+      return new (frame) T(std::forward<Args>(args)...);
+    } catch (...) {
+      FramePool::free(frame);
+      throw;
+    }
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_FramePool_hpp */
@@ -0,0 +1,849 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "IOEventPoller.hpp"
+
+#include <cstring>
+
+#if defined(__linux__)
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <unistd.h>
+  #include <errno.h>
+#endif
+
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  #include <linux/io_uring.h>
+  #include <sys/syscall.h>
+  #include <sys/mman.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+#endif
+
+namespace oatpp { namespace async {
+
+thread_local IOEventPoller* IOEventPoller::m_current = nullptr;
+
+IOEventPoller* IOEventPoller::getCurrent() {
+  return m_current;
+}
+
+IOEventPoller* IOEventPoller::setCurrent(IOEventPoller* poller) {
+  IOEventPoller* previous = m_current;
+  m_current = poller;
+  return previous;
+}
+
+IOEventPoller* IOEventPoller::createPoller(v_int32 engine) {
+#if defined(__linux__)
+  switch(engine) {
+    case ENGINE_AUTO:
+#if defined(OATPP_ASYNC_IO_URING)
+      {
+        IOEventPoller* poller = IOUringEventPoller::createPoller();
+        if(poller != nullptr) {
+          return poller;
+        }
+      }
+#endif
+      return EpollEventPoller::createPoller();
+    case ENGINE_EPOLL:
+      return EpollEventPoller::createPoller();
+#if defined(OATPP_ASYNC_IO_URING)
+    case ENGINE_IO_URING:
+      return IOUringEventPoller::createPoller();
+#endif
+  }
+#endif
+  return nullptr;
+}
+
+#if defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// EpollEventPoller
+
+EpollEventPoller::EpollEventPoller(data::v_io_handle epollHandle, data::v_io_handle wakeupHandle)
+  : m_epollHandle(epollHandle)
+  , m_wakeupHandle(wakeupHandle)
+{}
+
+EpollEventPoller::~EpollEventPoller() {
+  ::close(m_wakeupHandle);
+  ::close(m_epollHandle);
+}
+
+EpollEventPoller* EpollEventPoller::createPoller() {
+
+  data::v_io_handle handle = epoll_create1(EPOLL_CLOEXEC);
+  if(handle < 0) {
+    OATPP_LOGD("[oatpp::async::EpollEventPoller::createPoller()]", "Warning. Can't create epoll instance.");
+    return nullptr;
+  }
+
+  data::v_io_handle wakeupHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(wakeupHandle < 0) {
+    OATPP_LOGD("[oatpp::async::EpollEventPoller::createPoller()]", "Warning. Can't create eventfd.");
+    ::close(handle);
+    return nullptr;
+  }
+
+  /* Level-triggered. Stays ready until drained by pollEvents() */
+  struct epoll_event event;
+  event.data.fd = wakeupHandle;
+  event.events = EPOLLIN;
+  if(epoll_ctl(handle, EPOLL_CTL_ADD, wakeupHandle, &event) != 0) {
+    OATPP_LOGD("[oatpp::async::EpollEventPoller::createPoller()]", "Warning. Can't watch eventfd.");
+    ::close(wakeupHandle);
+    ::close(handle);
+    return nullptr;
+  }
+
+  return new EpollEventPoller(handle, wakeupHandle);
+
+}
+
+bool EpollEventPoller::arm(data::v_io_handle ioHandle, const Registration& registration) {
+
+  struct epoll_event event;
+  event.data.fd = ioHandle;
+  event.events = EPOLLONESHOT;
+  if(registration.reader != nullptr) {
+    event.events |= EPOLLIN | EPOLLRDHUP;
+  }
+  if(registration.writer != nullptr) {
+    event.events |= EPOLLOUT;
+  }
+
+  if(event.events == EPOLLONESHOT) {
+    epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, ioHandle, &event); // event for kernels before 2.6.9
+    return true;
+  }
+
+  /* Handle stays registered in the disarmed state after the one-shot event. Try to re-arm it first */
+  v_int32 res = epoll_ctl(m_epollHandle, EPOLL_CTL_MOD, ioHandle, &event);
+  if(res != 0 && errno == ENOENT) {
+    res = epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, ioHandle, &event);
+  }
+
+  return res == 0;
+
+}
+
+bool EpollEventPoller::watch(data::v_io_handle ioHandle, v_int32 ioEventType, AbstractCoroutine* coroutine) {
+
+  if(ioHandle == m_wakeupHandle) {
+    return false;
+  }
+
+  if(ioHandle >= (data::v_io_handle) m_registrations.size()) {
+    m_registrations.resize(ioHandle + 1, {nullptr, nullptr});
+  }
+
+  Registration& registration = m_registrations[ioHandle];
+  AbstractCoroutine*& slot = (ioEventType == Action::IO_EVENT_WRITE) ? registration.writer : registration.reader;
+  if(slot != nullptr && slot != coroutine) {
+    return false;
+  }
+
+  slot = coroutine;
+  if(!arm(ioHandle, registration)) {
+    slot = nullptr;
+    return false;
+  }
+
+  return true;
+
+}
+
+bool EpollEventPoller::unwatch(data::v_io_handle ioHandle, AbstractCoroutine* coroutine) {
+
+  if(ioHandle < 0 || ioHandle >= (data::v_io_handle) m_registrations.size()) {
+    return true;
+  }
+
+  Registration& registration = m_registrations[ioHandle];
+  if(registration.reader == coroutine) {
+    registration.reader = nullptr;
+  }
+  if(registration.writer == coroutine) {
+    registration.writer = nullptr;
+  }
+
+  /* The other waiter keeps waiting. Its readiness may have been consumed by the disarmed registration - arm it again */
+  arm(ioHandle, registration);
+  return true;
+
+}
+
+v_int32 EpollEventPoller::pollEvents(AbstractCoroutine** coroutines, v_int32 maxCount, v_int32 timeoutMillis) {
+
+  struct epoll_event events[EVENTS_BUFFER_SIZE];
+  if(maxCount > EVENTS_BUFFER_SIZE) {
+    maxCount = EVENTS_BUFFER_SIZE;
+  }
+  v_int32 eventsCount = epoll_wait(m_epollHandle, events, maxCount, timeoutMillis);
+
+  v_int32 count = 0;
+  for(v_int32 i = 0; i < eventsCount; i ++) {
+
+    data::v_io_handle ioHandle = events[i].data.fd;
+    if(ioHandle == m_wakeupHandle) {
+      eventfd_t value;
+      eventfd_read(m_wakeupHandle, &value);
+      continue;
+    }
+
+    if(ioHandle >= (data::v_io_handle) m_registrations.size()) {
+      continue;
+    }
+
+    Registration& registration = m_registrations[ioHandle];
+    v_word32 ready = events[i].events;
+
+    if(registration.reader != nullptr && (ready & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0 && count < maxCount) {
+      coroutines[count ++] = registration.reader;
+      registration.reader = nullptr;
+    }
+    if(registration.writer != nullptr && (ready & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0 && count < maxCount) {
+      coroutines[count ++] = registration.writer;
+      registration.writer = nullptr;
+    }
+
+    /* One-shot registration is disarmed. Coroutine which is not resumed yet waits for the next event */
+    if(registration.reader != nullptr || registration.writer != nullptr) {
+      arm(ioHandle, registration);
+    }
+
+  }
+
+  return count;
+
+}
+
+void EpollEventPoller::wakeup() {
+  eventfd_write(m_wakeupHandle, 1);
+}
+
+#if defined(OATPP_ASYNC_IO_URING)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// IOUringOperation
+
+namespace {
+
+  data::v_io_size getIOError(v_int32 error) {
+    if(error == -EINTR || error == -EAGAIN) {
+      return data::IOError::RETRY;
+    }
+    return data::IOError::BROKEN_PIPE;
+  }
+
+}
+
+IOUringOperation::IOUringOperation(data::v_io_handle handle, v_int32 ioEventType)
+  : m_handle(handle)
+  , m_ioEventType(ioEventType)
+  , m_state(STATE_IDLE)
+  , m_poller(nullptr)
+  , m_result(0)
+  , m_position(0)
+  , m_size(0)
+  , m_closeHandle(false)
+  , m_coroutine(nullptr)
+  , m_prev(nullptr)
+  , m_next(nullptr)
+{}
+
+bool IOUringOperation::release(IOUringOperation* operation, bool closeHandle) {
+  if(operation == nullptr) {
+    return false;
+  }
+  operation->m_closeHandle = closeHandle;
+  v_int32 expected = STATE_IN_FLIGHT;
+  if(operation->m_state.compare_exchange_strong(expected, STATE_ORPHANED, std::memory_order_acq_rel)) {
+    return closeHandle;
+  }
+  delete operation;
+  return false;
+}
+
+bool IOUringOperation::isInFlight() const {
+  return m_state.load(std::memory_order_acquire) == STATE_IN_FLIGHT;
+}
+
+bool IOUringOperation::isInFlightElsewhere(IOEventPoller* poller) const {
+  return isInFlight() && m_poller != poller;
+}
+
+bool IOUringOperation::read(IOUringEventPoller* poller, void* buffer, data::v_io_size count, data::v_io_size& result) {
+
+  v_int32 state = m_state.load(std::memory_order_acquire);
+  if(state == STATE_IN_FLIGHT) {
+    result = data::IOError::WAIT_RETRY;
+    return true;
+  }
+
+  if(state == STATE_COMPLETED) {
+    m_state.store(STATE_IDLE, std::memory_order_relaxed);
+    m_poller = nullptr;
+    m_position = 0;
+    if(m_result <= 0) {
+      m_size = 0;
+      result = m_result == 0 ? 0 : getIOError(m_result);
+      return true;
+    }
+    m_size = m_result;
+  }
+
+  if(m_position < m_size) {
+    data::v_io_size size = m_size - m_position;
+    if(size > count) {
+      size = count;
+    }
+    std::memcpy(buffer, &m_buffer[m_position], size);
+    m_position += size;
+    result = size;
+    return true;
+  }
+
+  if(poller == nullptr || count <= 0) {
+    return false;
+  }
+
+  m_position = 0;
+  m_size = 0;
+  if(!poller->submitOperation(this)) {
+    return false;
+  }
+  result = data::IOError::WAIT_RETRY;
+  return true;
+
+}
+
+data::v_io_size IOUringOperation::prepareWrite() {
+
+  v_int32 state = m_state.load(std::memory_order_acquire);
+  if(state == STATE_IN_FLIGHT) {
+    return data::IOError::WAIT_RETRY;
+  }
+
+  if(state == STATE_COMPLETED) {
+    m_state.store(STATE_IDLE, std::memory_order_relaxed);
+    m_poller = nullptr;
+    m_position = 0;
+    m_size = 0;
+    if(m_result < 0) {
+      /* Data of the failed send is lost - connection can't be written any more */
+      return data::IOError::BROKEN_PIPE;
+    }
+  }
+
+  return 0;
+
+}
+
+void IOUringOperation::append(const void* data, v_int32 count) {
+  std::memcpy(&m_buffer[m_size], data, count);
+  m_size += count;
+}
+
+v_int32 IOUringOperation::getAvailableSize() const {
+  return BUFFER_SIZE - m_size;
+}
+
+bool IOUringOperation::submitWrite(IOUringEventPoller* poller) {
+  m_position = 0;
+  if(!poller->submitOperation(this)) {
+    m_size = 0;
+    return false;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// IOUringEventPoller
+
+IOUringEventPoller::IOUringEventPoller()
+  : m_ringHandle(-1)
+  , m_ring(MAP_FAILED)
+  , m_ringSize(0)
+  , m_sqes(MAP_FAILED)
+  , m_sqesSize(0)
+  , m_sqHead(nullptr)
+  , m_sqTail(nullptr)
+  , m_sqMask(0)
+  , m_sqEntries(0)
+  , m_sqArray(nullptr)
+  , m_sqLocalTail(0)
+  , m_cqHead(nullptr)
+  , m_cqTail(nullptr)
+  , m_cqMask(0)
+  , m_cqes(nullptr)
+  , m_wakeupHandle(-1)
+  , m_wakeupArmed(false)
+  , m_wokenUp(false)
+  , m_operationsFirst(nullptr)
+{}
+
+IOUringEventPoller::~IOUringEventPoller() {
+  if(m_ringHandle >= 0 && m_ring != MAP_FAILED && m_sqes != MAP_FAILED) {
+    cancelOperations();
+  }
+  if(m_sqes != MAP_FAILED) {
+    munmap(m_sqes, m_sqesSize);
+  }
+  if(m_ring != MAP_FAILED) {
+    munmap(m_ring, m_ringSize);
+  }
+  if(m_ringHandle >= 0) {
+    ::close(m_ringHandle);
+  }
+  if(m_wakeupHandle >= 0) {
+    ::close(m_wakeupHandle);
+  }
+}
+
+IOUringEventPoller* IOUringEventPoller::createPoller() {
+  IOUringEventPoller* poller = new IOUringEventPoller();
+  if(!poller->init()) {
+    delete poller;
+    return nullptr;
+  }
+  return poller;
+}
+
+bool IOUringEventPoller::init() {
+
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = COMPLETION_QUEUE_SIZE;
+
+  m_ringHandle = (data::v_io_handle) syscall(__NR_io_uring_setup, SUBMISSION_QUEUE_SIZE, &params);
+  if(m_ringHandle < 0) {
+    OATPP_LOGD("[oatpp::async::IOUringEventPoller::init()]", "Warning. io_uring is not supported. errno=%d", errno);
+    return false;
+  }
+
+  /* Single ring mmap, no dropped completions and timed waits are required */
+  v_word32 requiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+  if((params.features & requiredFeatures) != requiredFeatures) {
+    OATPP_LOGD("[oatpp::async::IOUringEventPoller::init()]", "Warning. io_uring features required are not supported by kernel.");
+    return false;
+  }
+
+  v_int64 sqRingSize = params.sq_off.array + params.sq_entries * sizeof(v_word32);
+  v_int64 cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  m_ringSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+
+  m_ring = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringHandle, IORING_OFF_SQ_RING);
+  if(m_ring == MAP_FAILED) {
+    return false;
+  }
+
+  m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  m_sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringHandle, IORING_OFF_SQES);
+  if(m_sqes == MAP_FAILED) {
+    return false;
+  }
+
+  p_char8 ring = (p_char8) m_ring;
+
+  m_sqHead = (v_word32*) (ring + params.sq_off.head);
+  m_sqTail = (v_word32*) (ring + params.sq_off.tail);
+  m_sqMask = *(v_word32*) (ring + params.sq_off.ring_mask);
+  m_sqEntries = params.sq_entries;
+  m_sqArray = (v_word32*) (ring + params.sq_off.array);
+  m_sqLocalTail = *m_sqTail;
+
+  m_cqHead = (v_word32*) (ring + params.cq_off.head);
+  m_cqTail = (v_word32*) (ring + params.cq_off.tail);
+  m_cqMask = *(v_word32*) (ring + params.cq_off.ring_mask);
+  m_cqes = ring + params.cq_off.cqes;
+
+  m_wakeupHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(m_wakeupHandle < 0) {
+    OATPP_LOGD("[oatpp::async::IOUringEventPoller::init()]", "Warning. Can't create eventfd.");
+    return false;
+  }
+  armWakeup();
+
+  return true;
+
+}
+
+v_int32 IOUringEventPoller::submit(v_int32 minComplete, v_int32 timeoutMillis) {
+
+  __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+  v_word32 toSubmit = m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+
+  v_word32 flags = 0;
+  struct __kernel_timespec ts;
+  struct io_uring_getevents_arg arg;
+  std::memset(&arg, 0, sizeof(arg));
+
+  if(minComplete > 0) {
+    if(timeoutMillis >= 0) {
+      ts.tv_sec = timeoutMillis / 1000;
+      ts.tv_nsec = (timeoutMillis % 1000) * 1000000;
+      arg.ts = (v_word64) &ts;
+    }
+    flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+  } else if(toSubmit == 0) {
+    return 0;
+  }
+
+  v_int32 res = (v_int32) syscall(__NR_io_uring_enter, m_ringHandle, toSubmit, minComplete, flags,
+                                  flags == 0 ? nullptr : &arg, flags == 0 ? 0 : sizeof(arg));
+
+  /* ETIME, EINTR and EBUSY (completion queue is full) are handled by the next call */
+  return res;
+
+}
+
+v_int32 IOUringEventPoller::reap(AbstractCoroutine** coroutines, v_int32 maxCount) {
+
+  v_word32 head = *m_cqHead;
+  v_word32 tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+  struct io_uring_cqe* cqes = (struct io_uring_cqe*) m_cqes;
+
+  v_int32 count = 0;
+  while(head != tail && count < maxCount) {
+    /* Errors are not handled here - coroutine will get an error from the I/O call itself */
+    v_word64 userData = cqes[head & m_cqMask].user_data;
+    if(userData == WAKEUP_USER_DATA) {
+      eventfd_t value;
+      eventfd_read(m_wakeupHandle, &value);
+      m_wakeupArmed = false;
+      m_wokenUp = true;
+    } else if((userData & OPERATION_FLAG) != 0) {
+      AbstractCoroutine* coroutine = completeOperation((IOUringOperation*) (userData & ~OPERATION_FLAG),
+                                                       cqes[head & m_cqMask].res);
+      if(coroutine != nullptr) {
+        coroutines[count ++] = coroutine;
+      }
+    } else if(userData != 0) {
+      /* Completions of IORING_OP_POLL_REMOVE and IORING_OP_ASYNC_CANCEL have no coroutine */
+      coroutines[count ++] = (AbstractCoroutine*) userData;
+    }
+    head ++;
+  }
+
+  __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+
+  if(!m_wakeupArmed) {
+    /* Submitted together with the next batch - before the next blocking wait */
+    armWakeup();
+  }
+
+  return count;
+
+}
+
+struct io_uring_sqe* IOUringEventPoller::getSubmissionEntry() {
+
+  if(m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+    /* Submission queue is full - flush it */
+    submit(0, 0);
+    if(m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+      return nullptr;
+    }
+  }
+
+  v_word32 index = m_sqLocalTail & m_sqMask;
+  struct io_uring_sqe* sqe = &((struct io_uring_sqe*) m_sqes)[index];
+  std::memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+  m_sqArray[index] = index;
+  m_sqLocalTail ++;
+
+  return sqe;
+
+}
+
+void IOUringEventPoller::armWakeup() {
+
+  struct io_uring_sqe* sqe = getSubmissionEntry();
+  if(sqe == nullptr) {
+    /* Submission queue is full. Retried on the next reap */
+    return;
+  }
+
+  v_word32 events = POLLIN;
+#if __BYTE_ORDER == __BIG_ENDIAN
+  events = __swahw32(events);
+#endif
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = m_wakeupHandle;
+  sqe->poll32_events = events;
+  sqe->user_data = WAKEUP_USER_DATA;
+
+  m_wakeupArmed = true;
+
+}
+
+IOUringOperation*& IOUringEventPoller::getSlot(data::v_io_handle ioHandle, v_int32 ioEventType) {
+  if(ioHandle >= (data::v_io_handle) m_slots.size()) {
+    m_slots.resize(ioHandle + 1, {nullptr, nullptr});
+  }
+  OperationSlots& slots = m_slots[ioHandle];
+  return ioEventType == Action::IO_EVENT_WRITE ? slots.send : slots.receive;
+}
+
+bool IOUringEventPoller::queueOperation(IOUringOperation* operation) {
+
+  struct io_uring_sqe* sqe = getSubmissionEntry();
+  if(sqe == nullptr) {
+    return false;
+  }
+
+  if(operation->m_ioEventType == Action::IO_EVENT_WRITE) {
+    sqe->opcode = IORING_OP_SEND;
+    sqe->msg_flags = MSG_NOSIGNAL;
+  } else {
+    sqe->opcode = IORING_OP_RECV;
+  }
+  sqe->fd = operation->m_handle;
+  sqe->addr = (v_word64) &operation->m_buffer[operation->m_position];
+  sqe->len = operation->m_ioEventType == Action::IO_EVENT_WRITE ? operation->m_size - operation->m_position
+                                                                : IOUringOperation::BUFFER_SIZE;
+  sqe->user_data = ((v_word64) operation) | OPERATION_FLAG;
+
+  return true;
+
+}
+
+bool IOUringEventPoller::submitOperation(IOUringOperation* operation) {
+
+  if(!queueOperation(operation)) {
+    return false;
+  }
+
+  operation->m_poller = this;
+  operation->m_coroutine = nullptr;
+  operation->m_state.store(IOUringOperation::STATE_IN_FLIGHT, std::memory_order_release);
+
+  operation->m_prev = nullptr;
+  operation->m_next = m_operationsFirst;
+  if(m_operationsFirst != nullptr) {
+    m_operationsFirst->m_prev = operation;
+  }
+  m_operationsFirst = operation;
+
+  getSlot(operation->m_handle, operation->m_ioEventType) = operation;
+
+  return true;
+
+}
+
+AbstractCoroutine* IOUringEventPoller::completeOperation(IOUringOperation* operation, v_int32 result) {
+
+  if(operation->m_ioEventType == Action::IO_EVENT_WRITE && result > 0) {
+    operation->m_position += result;
+    if(operation->m_position < operation->m_size) {
+      /* Partial send. Handle stays open until the operation completes - even if the owner is gone */
+      if(queueOperation(operation)) {
+        return nullptr;
+      }
+      result = -ENOBUFS;
+    }
+  }
+
+  if(operation->m_prev != nullptr) {
+    operation->m_prev->m_next = operation->m_next;
+  } else {
+    m_operationsFirst = operation->m_next;
+  }
+  if(operation->m_next != nullptr) {
+    operation->m_next->m_prev = operation->m_prev;
+  }
+
+  IOUringOperation*& slot = getSlot(operation->m_handle, operation->m_ioEventType);
+  if(slot == operation) {
+    slot = nullptr;
+  }
+
+  AbstractCoroutine* coroutine = operation->m_coroutine;
+  operation->m_coroutine = nullptr;
+  operation->m_result = result;
+
+  v_int32 expected = IOUringOperation::STATE_IN_FLIGHT;
+  if(!operation->m_state.compare_exchange_strong(expected, IOUringOperation::STATE_COMPLETED, std::memory_order_acq_rel)) {
+    /* Owner is gone */
+    if(operation->m_closeHandle) {
+      ::close(operation->m_handle);
+    }
+    delete operation;
+  }
+
+  return coroutine;
+
+}
+
+void IOUringEventPoller::cancelOperations() {
+
+  IOUringOperation* curr = m_operationsFirst;
+  while(curr != nullptr) {
+    struct io_uring_sqe* sqe = getSubmissionEntry();
+    if(sqe != nullptr) {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->fd = -1;
+      sqe->addr = ((v_word64) curr) | OPERATION_FLAG;
+      sqe->user_data = 0;
+    }
+    curr = curr->m_next;
+  }
+
+  /* Coroutines resumed by completions are not run - processor is being destroyed */
+  AbstractCoroutine* coroutines[64];
+  v_int64 deadline = oatpp::base::Environment::getMicroTickCount() + CANCEL_TIMEOUT_MILLIS * 1000;
+  while(m_operationsFirst != nullptr) {
+    v_int64 timeout = deadline - oatpp::base::Environment::getMicroTickCount();
+    if(timeout <= 0) {
+      break;
+    }
+    submit(1, (v_int32) (timeout / 1000) + 1);
+    reap(coroutines, 64);
+  }
+
+  if(m_operationsFirst != nullptr) {
+    OATPP_LOGD("[oatpp::async::IOUringEventPoller::cancelOperations()]", "Warning. Operations are still in flight.");
+  }
+
+  /* Kernel still refers to their buffers - operations are not deleted */
+  while(m_operationsFirst != nullptr) {
+    IOUringOperation* operation = m_operationsFirst;
+    m_operationsFirst = operation->m_next;
+    operation->m_result = -ECANCELED;
+    v_int32 expected = IOUringOperation::STATE_IN_FLIGHT;
+    if(!operation->m_state.compare_exchange_strong(expected, IOUringOperation::STATE_COMPLETED, std::memory_order_acq_rel)) {
+      if(operation->m_closeHandle) {
+        ::close(operation->m_handle);
+      }
+    }
+  }
+
+}
+
+bool IOUringEventPoller::watch(data::v_io_handle ioHandle, v_int32 ioEventType, AbstractCoroutine* coroutine) {
+
+  if(ioHandle < (data::v_io_handle) m_slots.size()) {
+    /* Wait for completion of the operation in flight instead of readiness */
+    IOUringOperation* operation = getSlot(ioHandle, ioEventType);
+    if(operation != nullptr && operation->m_coroutine == nullptr &&
+       operation->m_state.load(std::memory_order_acquire) == IOUringOperation::STATE_IN_FLIGHT)
+    {
+      operation->m_coroutine = coroutine;
+      return true;
+    }
+  }
+
+  struct io_uring_sqe* sqe = getSubmissionEntry();
+  if(sqe == nullptr) {
+    return false;
+  }
+
+  v_word32 events;
+  if(ioEventType == Action::IO_EVENT_WRITE) {
+    events = POLLOUT;
+  } else {
+    events = POLLIN | POLLRDHUP;
+  }
+#if __BYTE_ORDER == __BIG_ENDIAN
+  events = __swahw32(events);
+#endif
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = ioHandle;
+  sqe->poll32_events = events;
+  sqe->user_data = (v_word64) coroutine;
+
+  return true;
+
+}
+
+bool IOUringEventPoller::unwatch(data::v_io_handle ioHandle, AbstractCoroutine* coroutine) {
+
+  if(ioHandle >= 0 && ioHandle < (data::v_io_handle) m_slots.size()) {
+    OperationSlots& slots = m_slots[ioHandle];
+    if(slots.receive != nullptr && slots.receive->m_coroutine == coroutine) {
+      slots.receive->m_coroutine = nullptr;
+      return true;
+    }
+    if(slots.send != nullptr && slots.send->m_coroutine == coroutine) {
+      slots.send->m_coroutine = nullptr;
+      return true;
+    }
+  }
+
+  struct io_uring_sqe* sqe = getSubmissionEntry();
+  if(sqe == nullptr) {
+    /* Can't cancel now. Coroutine will be returned once its I/O is ready */
+    return false;
+  }
+
+  /* Cancelled poll completes with -ECANCELED and returns coroutine to the processor */
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = (v_word64) coroutine;
+  sqe->user_data = 0;
+
+  return false;
+
+}
+
+v_int32 IOUringEventPoller::pollEvents(AbstractCoroutine** coroutines, v_int32 maxCount, v_int32 timeoutMillis) {
+
+  m_wokenUp = false;
+  v_int32 count = reap(coroutines, maxCount);
+
+  if(count > 0 || m_wokenUp || timeoutMillis == 0) {
+    submit(0, 0);
+    return count;
+  }
+
+  submit(1, timeoutMillis);
+  return reap(coroutines, maxCount);
+
+}
+
+void IOUringEventPoller::wakeup() {
+  eventfd_write(m_wakeupHandle, 1);
+}
+
+IOUringEventPoller* IOUringEventPoller::getCurrentRing() {
+  IOEventPoller* poller = getCurrent();
+  if(poller != nullptr && poller->getEngine() == ENGINE_IO_URING) {
+    return static_cast<IOUringEventPoller*>(poller);
+  }
+  return nullptr;
+}
+
+#endif
+
+#endif
+
+}}
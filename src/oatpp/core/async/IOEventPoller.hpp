@@ -0,0 +1,378 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_async_IOEventPoller_hpp
+#define oatpp_async_IOEventPoller_hpp
+
+#include "./Coroutine.hpp"
+
+#include <vector>
+#include <atomic>
+
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+struct io_uring_sqe; // FWD
+#endif
+
+namespace oatpp { namespace async {
+
+class IOUringEventPoller; // FWD
+
+/**
+ * I/O readiness notification engine.
+ * Used by Processor to park coroutines waiting for I/O until their I/O handle is ready.
+ */
+class IOEventPoller {
+public:
+  /**
+   * No I/O engine. Coroutines waiting for I/O are polled.
+   */
+  static constexpr const v_int32 ENGINE_NONE = -1;
+  
+  /**
+   * io_uring if built with OATPP_ASYNC_IO_URING and supported by kernel, else epoll.
+   */
+  static constexpr const v_int32 ENGINE_AUTO = 0;
+  
+  static constexpr const v_int32 ENGINE_EPOLL = 1;
+  static constexpr const v_int32 ENGINE_IO_URING = 2;
+private:
+  static thread_local IOEventPoller* m_current;
+public:
+  
+  /**
+   * Create poller.
+   * @param engine - ENGINE_AUTO, ENGINE_EPOLL or ENGINE_IO_URING.
+   * @return - new poller or nullptr if engine is not available on this platform/build/kernel.
+   */
+  static IOEventPoller* createPoller(v_int32 engine);
+  
+  /**
+   * Get poller of the &id:oatpp::async::Processor; which is running coroutines on this thread.
+   * @return - poller or `nullptr` if not called from a coroutine step.
+   */
+  static IOEventPoller* getCurrent();
+  
+  /**
+   * Set poller returned by &l:IOEventPoller::getCurrent ();. Called by &id:oatpp::async::Processor;.
+   * @param poller
+   * @return - previous poller.
+   */
+  static IOEventPoller* setCurrent(IOEventPoller* poller);
+  
+public:
+  
+  virtual ~IOEventPoller() = default;
+  
+  virtual v_int32 getEngine() const = 0;
+  
+  /**
+   * Request one-shot notification for ioHandle.
+   * Coroutine will be returned by pollEvents() once ioHandle is ready for ioEventType.
+   * @param ioHandle
+   * @param ioEventType - Action::IO_EVENT_READ or Action::IO_EVENT_WRITE.
+   * @param coroutine - coroutine to resume.
+   * @return - false if ioHandle can't be watched.
+   */
+  virtual bool watch(data::v_io_handle ioHandle, v_int32 ioEventType, AbstractCoroutine* coroutine) = 0;
+  
+  /**
+   * Cancel notification requested by watch().
+   * @param ioHandle
+   * @param coroutine
+   * @return - true if coroutine is released immediately and will not be returned by pollEvents().
+   * false if cancellation is asynchronous - coroutine will be returned by pollEvents() exactly once more.
+   */
+  virtual bool unwatch(data::v_io_handle ioHandle, AbstractCoroutine* coroutine) = 0;
+  
+  /**
+   * Get coroutines whose I/O is ready.
+   * @param coroutines - output array.
+   * @param maxCount - size of output array.
+   * @param timeoutMillis - max time to block if nothing is ready. 0 - don't block. -1 - block until I/O is ready or wakeup().
+   * @return - number of coroutines written to output array.
+   */
+  virtual v_int32 pollEvents(AbstractCoroutine** coroutines, v_int32 maxCount, v_int32 timeoutMillis) = 0;
+  
+  /**
+   * Interrupt pollEvents() blocked in another thread. Thread safe. <br>
+   * If no pollEvents() is blocked at the moment, the next blocking pollEvents() returns immediately.
+   */
+  virtual void wakeup() = 0;
+  
+};
+
+#if defined(__linux__)
+
+/**
+ * epoll-based poller. One-shot registrations are re-armed with EPOLL_CTL_MOD.
+ * Each handle has one registration with a reader and a writer slot. Registration is armed for the union of the slots' interests.
+ * Second coroutine waiting for the same event of the same handle can't be watched - it goes to the processor's waiting queue.
+ * Wakeups are delivered through an eventfd registered in the same epoll instance.
+ */
+class EpollEventPoller : public IOEventPoller {
+public:
+  static constexpr const v_int32 EVENTS_BUFFER_SIZE = 256;
+private:
+  /**
+   * Coroutines waiting for the handle. Indexed by handle.
+   */
+  struct Registration {
+    AbstractCoroutine* reader;
+    AbstractCoroutine* writer;
+  };
+private:
+  /* Re-arm the registration for the slots which are taken or delete it if both are empty */
+  bool arm(data::v_io_handle ioHandle, const Registration& registration);
+private:
+  data::v_io_handle m_epollHandle;
+  data::v_io_handle m_wakeupHandle;
+  std::vector<Registration> m_registrations;
+public:
+  
+  EpollEventPoller(data::v_io_handle epollHandle, data::v_io_handle wakeupHandle);
+  ~EpollEventPoller();
+  
+  static EpollEventPoller* createPoller();
+  
+  v_int32 getEngine() const override {
+    return ENGINE_EPOLL;
+  }
+  
+  bool watch(data::v_io_handle ioHandle, v_int32 ioEventType, AbstractCoroutine* coroutine) override;
+  bool unwatch(data::v_io_handle ioHandle, AbstractCoroutine* coroutine) override;
+  v_int32 pollEvents(AbstractCoroutine** coroutines, v_int32 maxCount, v_int32 timeoutMillis) override;
+  void wakeup() override;
+  
+};
+
+#if defined(OATPP_ASYNC_IO_URING)
+
+/**
+ * Completion-based receive (IORING_OP_RECV) or send (IORING_OP_SEND) of a connection with its own buffer.
+ * Used by &id:oatpp::network::Connection; when called from a coroutine of a processor with &l:IOUringEventPoller;. <br>
+ * Receive fills the buffer and the connection is read from it. Send takes a copy of the data, so the coroutine
+ * goes on without waiting and waits for the completion only on its next write. <br>
+ * Coroutine waits for the completion with `Action::createIOWaitAction(handle, ioEventType)` -
+ * the poller resumes it once the operation in flight on the handle completes.
+ */
+class IOUringOperation {
+  friend IOUringEventPoller;
+public:
+  static constexpr const v_int32 BUFFER_SIZE = 4096;
+private:
+  static constexpr const v_int32 STATE_IDLE = 0;
+  static constexpr const v_int32 STATE_IN_FLIGHT = 1;
+  static constexpr const v_int32 STATE_COMPLETED = 2;
+  /* Owner is gone. Operation is deleted by the poller once it completes */
+  static constexpr const v_int32 STATE_ORPHANED = 3;
+private:
+  data::v_io_handle m_handle;
+  v_int32 m_ioEventType;
+  std::atomic<v_int32> m_state;
+  /* Ring the operation was submitted to */
+  IOUringEventPoller* m_poller;
+  /* Result of the completion. Negative errno on error */
+  v_int32 m_result;
+  /* Receive - bytes consumed by reads. Send - bytes sent */
+  v_int32 m_position;
+  /* Receive - bytes received. Send - bytes to send */
+  v_int32 m_size;
+  /* Set when the owner is gone - handle is closed by the poller once the operation completes */
+  bool m_closeHandle;
+  /* Poller's bookkeeping. Used by poller's thread only */
+  AbstractCoroutine* m_coroutine;
+  IOUringOperation* m_prev;
+  IOUringOperation* m_next;
+  v_char8 m_buffer[BUFFER_SIZE];
+public:
+  
+  /**
+   * Constructor.
+   * @param handle - connection's handle.
+   * @param ioEventType - &id:oatpp::async::Action::IO_EVENT_READ; - receive, &id:oatpp::async::Action::IO_EVENT_WRITE; - send.
+   */
+  IOUringOperation(data::v_io_handle handle, v_int32 ioEventType);
+  
+  IOUringOperation(const IOUringOperation&) = delete;
+  IOUringOperation& operator = (const IOUringOperation&) = delete;
+  
+  /**
+   * Release operation owned by the connection. Thread safe.
+   * If operation is in flight it is deleted by the poller once it completes, otherwise it's deleted right away.
+   * @param operation - operation or `nullptr`.
+   * @param closeHandle - pass ownership of the handle to the operation if it is in flight.
+   * Handle of the operation in flight can't be closed by the owner - the number may be reused while the ring still refers to it.
+   * @return - `true` if operation has taken ownership of the handle.
+   */
+  static bool release(IOUringOperation* operation, bool closeHandle);
+  
+  /**
+   * @return - true if operation is in flight.
+   */
+  bool isInFlight() const;
+  
+  /**
+   * @param poller
+   * @return - true if operation is in flight on another poller - completion can't resume coroutines of this one.
+   */
+  bool isInFlightElsewhere(IOEventPoller* poller) const;
+  
+  /**
+   * Read received data or submit receive.
+   * @param poller - poller to submit receive to. May be `nullptr` - receive is not submitted.
+   * @param buffer
+   * @param count
+   * @param result - number of bytes read, 0 - end of stream, error, or IOError::WAIT_RETRY - wait for completion.
+   * @return - `false` if nothing is received and receive is not submitted - read with a syscall.
+   */
+  bool read(IOUringEventPoller* poller, void* buffer, data::v_io_size count, data::v_io_size& result);
+  
+  /**
+   * Check that the previous send has completed. Must be called before any other write to the connection.
+   * @return - 0 if connection can be written, error of the previous send, or IOError::WAIT_RETRY - previous send is in flight.
+   */
+  data::v_io_size prepareWrite();
+  
+  /**
+   * Copy data to the operation's buffer. Operation must be prepared with &l:IOUringOperation::prepareWrite ();.
+   * @param data
+   * @param count - number of bytes. Buffer must have enough space left.
+   */
+  void append(const void* data, v_int32 count);
+  
+  /**
+   * @return - number of bytes which can still be appended.
+   */
+  v_int32 getAvailableSize() const;
+  
+  /**
+   * Submit send of the appended data.
+   * @param poller
+   * @return - false if send can't be submitted. Appended data is discarded then.
+   */
+  bool submitWrite(IOUringEventPoller* poller);
+  
+};
+
+/**
+ * io_uring-based poller.
+ * Watch requests are queued as IORING_OP_POLL_ADD submissions (unwatch - as IORING_OP_POLL_REMOVE) and are submitted in one batch
+ * together with reaping of completions in pollEvents(). pollEvents() makes no syscall
+ * when there is nothing to submit and it is not asked to block. <br>
+ * Receives and sends of connections are submitted to the same ring (see &l:IOUringOperation;).
+ * Watch of a handle with an operation in flight waits for the completion of the operation instead of readiness.
+ * Wakeups are delivered through an eventfd watched with IORING_OP_POLL_ADD which is re-armed after each wakeup.
+ */
+class IOUringEventPoller : public IOEventPoller {
+  friend IOUringOperation;
+public:
+  static constexpr const v_int32 SUBMISSION_QUEUE_SIZE = 1024;
+  static constexpr const v_int32 COMPLETION_QUEUE_SIZE = 16384;
+  
+  /**
+   * How long destructor waits for cancelled operations to complete.
+   */
+  static constexpr const v_int32 CANCEL_TIMEOUT_MILLIS = 1000;
+private:
+  /**
+   * user_data of eventfd poll completions. Can't be a coroutine pointer.
+   */
+  static constexpr const v_word64 WAKEUP_USER_DATA = 1;
+  
+  /**
+   * Flag of user_data of operation completions. Coroutine and operation pointers are aligned - the bit is free.
+   */
+  static constexpr const v_word64 OPERATION_FLAG = 2;
+private:
+  /**
+   * Operations in flight on the handle. Indexed by handle.
+   */
+  struct OperationSlots {
+    IOUringOperation* receive;
+    IOUringOperation* send;
+  };
+private:
+  bool init();
+  void armWakeup();
+  struct io_uring_sqe* getSubmissionEntry();
+  v_int32 submit(v_int32 minComplete, v_int32 timeoutMillis);
+  v_int32 reap(AbstractCoroutine** coroutines, v_int32 maxCount);
+  IOUringOperation*& getSlot(data::v_io_handle ioHandle, v_int32 ioEventType);
+  bool queueOperation(IOUringOperation* operation);
+  bool submitOperation(IOUringOperation* operation);
+  /* Returns coroutine to resume or nullptr */
+  AbstractCoroutine* completeOperation(IOUringOperation* operation, v_int32 result);
+  void cancelOperations();
+private:
+  data::v_io_handle m_ringHandle;
+  void* m_ring;
+  v_int64 m_ringSize;
+  void* m_sqes;
+  v_int64 m_sqesSize;
+  v_word32* m_sqHead;
+  v_word32* m_sqTail;
+  v_word32 m_sqMask;
+  v_word32 m_sqEntries;
+  v_word32* m_sqArray;
+  v_word32 m_sqLocalTail;
+  v_word32* m_cqHead;
+  v_word32* m_cqTail;
+  v_word32 m_cqMask;
+  void* m_cqes;
+  data::v_io_handle m_wakeupHandle;
+  bool m_wakeupArmed;
+  bool m_wokenUp;
+  std::vector<OperationSlots> m_slots;
+  IOUringOperation* m_operationsFirst;
+public:
+  
+  IOUringEventPoller();
+  ~IOUringEventPoller();
+  
+  static IOUringEventPoller* createPoller();
+  
+  /**
+   * Get io_uring poller of the processor which is running coroutines on this thread.
+   * @return - poller or `nullptr` if not called from a coroutine step or processor uses another engine.
+   */
+  static IOUringEventPoller* getCurrentRing();
+  
+  v_int32 getEngine() const override {
+    return ENGINE_IO_URING;
+  }
+  
+  bool watch(data::v_io_handle ioHandle, v_int32 ioEventType, AbstractCoroutine* coroutine) override;
+  bool unwatch(data::v_io_handle ioHandle, AbstractCoroutine* coroutine) override;
+  v_int32 pollEvents(AbstractCoroutine** coroutines, v_int32 maxCount, v_int32 timeoutMillis) override;
+  void wakeup() override;
+  
+};
+
+#endif
+
+#endif
+
+}}
+
+#endif // oatpp_async_IOEventPoller_hpp
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Metrics.hpp"
+
+namespace oatpp { namespace async {
+
+Histogram::Snapshot::Snapshot()
+  : count(0)
+  , sumMicros(0)
+{
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    buckets[i] = 0;
+  }
+}
+
+void Histogram::Snapshot::merge(const Snapshot& other) {
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    buckets[i] += other.buckets[i];
+  }
+  count += other.count;
+  sumMicros += other.sumMicros;
+}
+
+v_int64 Histogram::Snapshot::getMeanMicros() const {
+  if(count == 0) {
+    return 0;
+  }
+  return sumMicros / count;
+}
+
+v_int64 Histogram::Snapshot::getPercentileMicros(v_float64 percentile) const {
+  v_int64 total = 0;
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    total += buckets[i];
+  }
+  if(total == 0) {
+    return 0;
+  }
+  v_int64 rank = (v_int64) (total * percentile / 100);
+  v_int64 accumulated = 0;
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    accumulated += buckets[i];
+    if(accumulated > rank || accumulated == total) {
+      return getBucketUpperBoundMicros(i);
+    }
+  }
+  return getBucketUpperBoundMicros(BUCKETS_COUNT - 1);
+}
+
+Histogram::Histogram()
+  : m_count(0)
+  , m_sumMicros(0)
+{
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    m_buckets[i] = 0;
+  }
+}
+
+v_int64 Histogram::getBucketUpperBoundMicros(v_int32 bucket) {
+  return ((v_int64) 1) << bucket;
+}
+
+Histogram::Snapshot Histogram::getSnapshot() const {
+  Snapshot snapshot;
+  for(v_int32 i = 0; i < BUCKETS_COUNT; i ++) {
+    snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+  }
+  snapshot.count = m_count.load(std::memory_order_relaxed);
+  snapshot.sumMicros = m_sumMicros.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+ProcessorMetrics::ProcessorMetrics()
+  : activeCount(0)
+  , waitingCount(0)
+  , ioWaitingCount(0)
+  , timersCount(0)
+  , parkedCount(0)
+  , pendingCount(0)
+  , submittedCount(0)
+  , finishedCount(0)
+  , stepsCount(0)
+  , passesCount(0)
+  , sleepsCount(0)
+  , wakeupsCount(0)
+  , busyMicros(0)
+  , idleMicros(0)
+  , stallsCount(0)
+{}
+
+void ProcessorMetrics::merge(const ProcessorMetrics& other) {
+  activeCount += other.activeCount;
+  waitingCount += other.waitingCount;
+  ioWaitingCount += other.ioWaitingCount;
+  timersCount += other.timersCount;
+  parkedCount += other.parkedCount;
+  pendingCount += other.pendingCount;
+  submittedCount += other.submittedCount;
+  finishedCount += other.finishedCount;
+  stepsCount += other.stepsCount;
+  passesCount += other.passesCount;
+  sleepsCount += other.sleepsCount;
+  wakeupsCount += other.wakeupsCount;
+  busyMicros += other.busyMicros;
+  idleMicros += other.idleMicros;
+  stallsCount += other.stallsCount;
+  passMicros.merge(other.passMicros);
+  waitingMicros.merge(other.waitingMicros);
+  ioWaitingMicros.merge(other.ioWaitingMicros);
+  stallMicros.merge(other.stallMicros);
+}
+  
+}}
@@ -0,0 +1,247 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_async_Metrics_hpp
+#define oatpp_async_Metrics_hpp
+
+#include "oatpp/core/base/Environment.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace async {
+
+/**
+ * Histogram of durations with power-of-two buckets. <br>
+ * Written by one thread, read by any thread. Writes are relaxed stores - cheap enough to be always on.
+ */
+class Histogram {
+public:
+  
+  /**
+   * Bucket 0 counts durations below 1 microsecond. Bucket `i` counts durations in range [2^(i-1), 2^i) microseconds.
+   * The last bucket counts all longer durations.
+   */
+  static constexpr const v_int32 BUCKETS_COUNT = 32;
+  
+  /**
+   * Values of histogram at some moment. Snapshots of several histograms may be merged.
+   */
+  class Snapshot {
+  public:
+    
+    Snapshot();
+    
+    v_int64 buckets[BUCKETS_COUNT];
+    
+    /**
+     * Number of recorded durations.
+     */
+    v_int64 count;
+    
+    /**
+     * Sum of recorded durations.
+     */
+    v_int64 sumMicros;
+    
+    /**
+     * Add counts of other snapshot.
+     * @param other
+     */
+    void merge(const Snapshot& other);
+    
+    /**
+     * @return - mean duration or 0 if nothing was recorded.
+     */
+    v_int64 getMeanMicros() const;
+    
+    /**
+     * Get upper bound of the bucket where the percentile falls.
+     * @param percentile - in range [0, 100].
+     * @return - microseconds or 0 if nothing was recorded.
+     */
+    v_int64 getPercentileMicros(v_float64 percentile) const;
+    
+  };
+  
+private:
+  std::atomic<v_int64> m_buckets[BUCKETS_COUNT];
+  std::atomic<v_int64> m_count;
+  std::atomic<v_int64> m_sumMicros;
+private:
+  static void add(std::atomic<v_int64>& counter, v_int64 value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+public:
+  
+  Histogram();
+  
+  /**
+   * Get upper bound of the bucket.
+   * @param bucket
+   * @return - microseconds.
+   */
+  static v_int64 getBucketUpperBoundMicros(v_int32 bucket);
+  
+  /**
+   * Record duration. Must be called by the owner thread only.
+   * @param micros
+   */
+  void record(v_int64 micros) {
+    if(micros < 0) {
+      micros = 0;
+    }
+    v_int32 bucket = 0;
+    while(micros >> bucket != 0 && bucket < BUCKETS_COUNT - 1) {
+      bucket ++;
+    }
+    add(m_buckets[bucket], 1);
+    add(m_count, 1);
+    add(m_sumMicros, micros);
+  }
+  
+  /**
+   * Read histogram. Thread safe.
+   * @return - &l:Histogram::Snapshot;.
+   */
+  Snapshot getSnapshot() const;
+  
+};
+
+/**
+ * Runtime metrics of one processing thread of &id:oatpp::async::Executor;. <br>
+ * Counters are cumulative. Rates are calculated from two snapshots. Queue lengths are updated once per processing pass.
+ * Metrics of several threads may be merged.
+ */
+class ProcessorMetrics {
+public:
+  
+  ProcessorMetrics();
+  
+  /**
+   * Runnable coroutines.
+   */
+  v_int32 activeCount;
+  
+  /**
+   * Coroutines in the waiting queue - waiting for retry or for I/O which can't be polled.
+   */
+  v_int32 waitingCount;
+  
+  /**
+   * Coroutines waiting for I/O events.
+   */
+  v_int32 ioWaitingCount;
+  
+  /**
+   * Coroutines waiting for timers.
+   */
+  v_int32 timersCount;
+  
+  /**
+   * Coroutines parked in wait lists.
+   */
+  v_int32 parkedCount;
+  
+  /**
+   * Coroutines submitted to the thread and not yet picked up.
+   */
+  v_int32 pendingCount;
+  
+  /**
+   * Total number of coroutines submitted to the thread.
+   */
+  v_int64 submittedCount;
+  
+  /**
+   * Total number of coroutines finished by the thread.
+   */
+  v_int64 finishedCount;
+  
+  /**
+   * Total number of coroutine steps made by the thread.
+   */
+  v_int64 stepsCount;
+  
+  /**
+   * Total number of processing passes. A pass makes up to 1000 steps.
+   */
+  v_int64 passesCount;
+  
+  /**
+   * Number of times the thread went to sleep with nothing to do.
+   */
+  v_int64 sleepsCount;
+  
+  /**
+   * Number of times the sleeping thread was woken up by other threads - by submissions, resumed coroutines, or work sharing.
+   */
+  v_int64 wakeupsCount;
+  
+  /**
+   * Total time spent in processing passes - running coroutines and scheduling them.
+   */
+  v_int64 busyMicros;
+  
+  /**
+   * Total time the thread slept with nothing to do.
+   */
+  v_int64 idleMicros;
+  
+  /**
+   * Number of steps which blocked the thread longer than the threshold of &id:oatpp::async::StallDetector;.
+   * Always 0 if the thread is not watched.
+   */
+  v_int64 stallsCount;
+  
+  /**
+   * Durations of processing passes.
+   */
+  Histogram::Snapshot passMicros;
+  
+  /**
+   * Time coroutines spent in the waiting queue before they were run again. Includes submitted coroutines waiting for their first step.
+   */
+  Histogram::Snapshot waitingMicros;
+  
+  /**
+   * Time coroutines waited for I/O events.
+   */
+  Histogram::Snapshot ioWaitingMicros;
+  
+  /**
+   * Durations of detected stalls. Measured with precision of the detector's check interval.
+   */
+  Histogram::Snapshot stallMicros;
+  
+  /**
+   * Add metrics of other thread.
+   * @param other
+   */
+  void merge(const ProcessorMetrics& other);
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Metrics_hpp */
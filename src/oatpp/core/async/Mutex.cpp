@@ -0,0 +1,57 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Mutex.hpp"
+
+namespace oatpp { namespace async {
+
+Mutex::Mutex()
+  : m_locked(false)
+  , m_waitList(this)
+{}
+
+void Mutex::onNewItem(CoroutineWaitList& list) {
+  if(!m_locked.load()) {
+    list.notifyFirst();
+  }
+}
+
+bool Mutex::tryLock() {
+  return !m_locked.exchange(true, std::memory_order_acquire);
+}
+
+Action Mutex::lock(const Action& next) {
+  if(tryLock()) {
+    return next;
+  }
+  return Action::createWaitListAction(&m_waitList);
+}
+
+void Mutex::unlock() {
+  m_locked.store(false);
+  m_waitList.notifyFirst();
+}
+  
+}}
@@ -0,0 +1,85 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Mutex_hpp
+#define oatpp_async_Mutex_hpp
+
+#include "./CoroutineWaitList.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * Mutex for coroutines. Lock may be held across coroutine steps and waits.
+ * Waiting coroutines are parked in &l:CoroutineWaitList; and take no processor time.
+ * Not reentrant. May be unlocked from any thread. <br>
+ * Usage:
+ * ```
+ * Action act() override {
+ *   return m_mutex->lock(yieldTo(&MyCoroutine::onLocked));
+ * }
+ * ```
+ */
+class Mutex : private CoroutineWaitList::Listener {
+private:
+  std::atomic<bool> m_locked;
+  CoroutineWaitList m_waitList;
+private:
+  void onNewItem(CoroutineWaitList& list) override;
+public:
+  
+  Mutex();
+  
+  static std::shared_ptr<Mutex> createShared() {
+    return std::make_shared<Mutex>();
+  }
+  
+  /**
+   * Lock if not locked. Doesn't wait.
+   * @return - true if locked.
+   */
+  bool tryLock();
+  
+  /**
+   * Lock or park the coroutine until the mutex is unlocked.
+   * Parked coroutine repeats the calling function once notified.
+   * @param next - action to take once locked. Should not start coroutine - it would be leaked on wait.
+   * @return - `next` or wait action.
+   */
+  Action lock(const Action& next);
+  
+  /**
+   * Unlock and resume one parked coroutine.
+   */
+  void unlock();
+  
+  bool isLocked() const {
+    return m_locked.load();
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Mutex_hpp */
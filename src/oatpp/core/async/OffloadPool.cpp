@@ -0,0 +1,147 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "OffloadPool.hpp"
+
+namespace oatpp { namespace async {
+
+OffloadPool::VoidCoroutine::VoidCoroutine(OffloadPool* pool, const std::function<void()>& task)
+  : m_pool(pool)
+  , m_job(std::make_shared<VoidJob>(task))
+{}
+
+Action OffloadPool::VoidCoroutine::act() {
+  return m_pool->m_capacity.acquire(yieldTo(&VoidCoroutine::submit));
+}
+
+Action OffloadPool::VoidCoroutine::submit() {
+  m_pool->submit(m_job);
+  return yieldTo(&VoidCoroutine::wait);
+}
+
+Action OffloadPool::VoidCoroutine::wait() {
+  return m_job->wait(yieldTo(&VoidCoroutine::onDone));
+}
+
+Action OffloadPool::VoidCoroutine::onDone() {
+  if(m_job->getException()) {
+    std::rethrow_exception(m_job->getException());
+  }
+  return finish();
+}
+
+OffloadPool::OffloadPool(const std::string& name, v_int32 threadsCount, v_int32 maxQueueSize)
+  : m_name(name)
+  , m_capacity(threadsCount + maxQueueSize)
+  , m_running(true)
+{
+  m_stats.queueSize = 0;
+  m_stats.peakQueueSize = 0;
+  m_stats.activeCount = 0;
+  m_stats.submittedCount = 0;
+  m_stats.completedCount = 0;
+  m_stats.queueMicros = 0;
+  m_stats.executionMicros = 0;
+  for(v_int32 i = 0; i < threadsCount; i ++) {
+    m_threads.push_back(std::thread(&OffloadPool::run, this));
+  }
+}
+
+OffloadPool::~OffloadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+  }
+  m_condition.notify_all();
+  for(auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void OffloadPool::submit(const std::shared_ptr<Job>& job) {
+  job->m_submitMicros = oatpp::base::Environment::getMicroTickCount();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(job);
+    m_stats.submittedCount ++;
+    m_stats.queueSize ++;
+    if(m_stats.queueSize > m_stats.peakQueueSize) {
+      m_stats.peakQueueSize = m_stats.queueSize;
+    }
+  }
+  m_condition.notify_one();
+}
+
+void OffloadPool::run() {
+
+  while(true) {
+
+    std::shared_ptr<Job> job;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(m_queue.empty() && m_running) {
+        m_condition.wait(lock);
+      }
+      if(m_queue.empty()) {
+        /* Stopped and all queued tasks are done */
+        return;
+      }
+      job = m_queue.front();
+      m_queue.pop_front();
+      m_stats.queueSize --;
+      m_stats.activeCount ++;
+      m_stats.queueMicros += oatpp::base::Environment::getMicroTickCount() - job->m_submitMicros;
+    }
+
+    v_int64 startMicros = oatpp::base::Environment::getMicroTickCount();
+    try {
+      job->execute();
+    } catch (...) {
+      job->m_exception = std::current_exception();
+    }
+    v_int64 executionMicros = oatpp::base::Environment::getMicroTickCount() - startMicros;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stats.activeCount --;
+      m_stats.completedCount ++;
+      m_stats.executionMicros += executionMicros;
+    }
+
+    /* Free the slot before resuming the caller - it may offload the next task right away */
+    m_capacity.release();
+    job->m_done.set();
+
+  }
+
+}
+
+OffloadPool::Stats OffloadPool::getStats() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+}}
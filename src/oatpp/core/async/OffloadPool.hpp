@@ -0,0 +1,325 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_OffloadPool_hpp
+#define oatpp_async_OffloadPool_hpp
+
+#include "./Event.hpp"
+#include "./Semaphore.hpp"
+
+#include <string>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <type_traits>
+
+namespace oatpp { namespace async {
+
+/**
+ * Pool of worker threads to run blocking code (legacy libraries, file I/O, CPU-heavy work) out of the executor threads.
+ * Calling coroutine is parked until the task is done and then is resumed on its own &l:Processor; with the result.
+ * Create separate pools for different workloads (e.g. "io" and "cpu") to size them separately. <br>
+ * Number of admitted tasks (running + queued) is bounded by `threadsCount + maxQueueSize`.
+ * When the pool is full, calling coroutines are parked until a task is done. <br>
+ * Usage:
+ * ```
+ * Action act() override {
+ *   return m_pool->offload(this, [] { return computeHash(); }, &MyCoroutine::onHash);
+ * }
+ *
+ * Action onHash(const oatpp::String& hash) {
+ *   ...
+ * }
+ * ```
+ */
+class OffloadPool {
+public:
+
+  /**
+   * Pool metrics. See &l:OffloadPool::getStats ();.
+   */
+  struct Stats {
+    /**
+     * Number of tasks waiting in the queue.
+     */
+    v_int32 queueSize;
+
+    /**
+     * Max observed number of tasks waiting in the queue.
+     */
+    v_int32 peakQueueSize;
+
+    /**
+     * Number of tasks being executed.
+     */
+    v_int32 activeCount;
+
+    /**
+     * Total number of tasks submitted.
+     */
+    v_int64 submittedCount;
+
+    /**
+     * Total number of tasks done.
+     */
+    v_int64 completedCount;
+
+    /**
+     * Total time tasks spent in the queue.
+     */
+    v_int64 queueMicros;
+
+    /**
+     * Total time tasks spent executing.
+     */
+    v_int64 executionMicros;
+  };
+
+public:
+
+  /**
+   * Task submitted to the pool.
+   */
+  class Job {
+    friend OffloadPool;
+  private:
+    Event m_done;
+    std::exception_ptr m_exception;
+    v_int64 m_submitMicros;
+  protected:
+    virtual void execute() = 0;
+  public:
+
+    virtual ~Job() = default;
+
+    /**
+     * Continue with `next` if job is done or park the coroutine until it's done.
+     * @param next - action to take once job is done.
+     * @return - `next` or wait action.
+     */
+    Action wait(const Action& next) {
+      return m_done.wait(next);
+    }
+
+    /**
+     * @return - exception thrown by the task, if any.
+     */
+    std::exception_ptr getException() const {
+      return m_exception;
+    }
+
+  };
+
+  /**
+   * Job with result of type `R`. `R` should be default constructible.
+   * @tparam R - result type.
+   */
+  template<typename R>
+  class ResultJob : public Job {
+  private:
+    std::function<R()> m_task;
+    R m_result;
+  protected:
+    void execute() override {
+      m_result = m_task();
+    }
+  public:
+
+    ResultJob(const std::function<R()>& task)
+      : m_task(task)
+    {}
+
+    const R& getResult() const {
+      return m_result;
+    }
+
+  };
+
+  /**
+   * Job without result.
+   */
+  class VoidJob : public Job {
+  private:
+    std::function<void()> m_task;
+  protected:
+    void execute() override {
+      m_task();
+    }
+  public:
+
+    VoidJob(const std::function<void()>& task)
+      : m_task(task)
+    {}
+
+  };
+
+public:
+
+  /**
+   * Coroutine which submits &l:OffloadPool::ResultJob; and returns its result to the parent.
+   * Exception thrown by the task is rethrown in the coroutine and turns into an error.
+   * @tparam R - type of the parent's callback parameter.
+   */
+  template<typename R>
+  class ResultCoroutine : public CoroutineWithResult<ResultCoroutine<R>, R> {
+  public:
+    typedef typename std::decay<R>::type ResultType;
+  private:
+    OffloadPool* m_pool;
+    std::shared_ptr<ResultJob<ResultType>> m_job;
+  public:
+
+    ResultCoroutine(OffloadPool* pool, const std::function<ResultType()>& task)
+      : m_pool(pool)
+      , m_job(std::make_shared<ResultJob<ResultType>>(task))
+    {}
+
+    Action act() override {
+      return m_pool->m_capacity.acquire(this->yieldTo(&ResultCoroutine::submit));
+    }
+
+    Action submit() {
+      m_pool->submit(m_job);
+      return this->yieldTo(&ResultCoroutine::wait);
+    }
+
+    Action wait() {
+      return m_job->wait(this->yieldTo(&ResultCoroutine::onDone));
+    }
+
+    Action onDone() {
+      if(m_job->getException()) {
+        std::rethrow_exception(m_job->getException());
+      }
+      return this->_return(m_job->getResult());
+    }
+
+  };
+
+  /**
+   * Coroutine which submits &l:OffloadPool::VoidJob; and finishes once it's done.
+   * Exception thrown by the task is rethrown in the coroutine and turns into an error.
+   */
+  class VoidCoroutine : public Coroutine<VoidCoroutine> {
+  private:
+    OffloadPool* m_pool;
+    std::shared_ptr<VoidJob> m_job;
+  public:
+
+    VoidCoroutine(OffloadPool* pool, const std::function<void()>& task);
+
+    Action act() override;
+
+    Action submit();
+
+    Action wait();
+
+    Action onDone();
+
+  };
+
+private:
+  std::string m_name;
+  Semaphore m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::list<std::shared_ptr<Job>> m_queue;
+  bool m_running;
+  std::vector<std::thread> m_threads;
+  Stats m_stats;
+private:
+  void submit(const std::shared_ptr<Job>& job);
+  void run();
+public:
+
+  /**
+   * Constructor. Starts worker threads.
+   * @param name - name of the pool. For logs and metrics.
+   * @param threadsCount - number of worker threads.
+   * @param maxQueueSize - max number of tasks waiting for a free worker.
+   */
+  OffloadPool(const std::string& name, v_int32 threadsCount, v_int32 maxQueueSize);
+
+  /**
+   * Destructor. Waits for queued tasks to complete and joins worker threads.
+   */
+  ~OffloadPool();
+
+  static std::shared_ptr<OffloadPool> createShared(const std::string& name, v_int32 threadsCount, v_int32 maxQueueSize) {
+    return std::make_shared<OffloadPool>(name, threadsCount, maxQueueSize);
+  }
+
+  /**
+   * Run task in the pool and call `callback` of the parent coroutine with the result.
+   * @tparam ParentCoroutineType - type of the calling coroutine.
+   * @tparam R - type of the callback parameter.
+   * @tparam F - task type. Callable returning the result.
+   * @param parent - calling coroutine. Usually `this`.
+   * @param task - task to run.
+   * @param callback - parent's method to call with the result. Takes the result by value
+   * (or by const reference for class types - same as other coroutine callbacks).
+   * @return - &l:Action;.
+   */
+  template<typename ParentCoroutineType, typename R, typename F>
+  Action offload(ParentCoroutineType* parent, F task, Action (ParentCoroutineType::*callback)(R)) {
+    typedef typename ResultCoroutine<R>::ResultType ResultType;
+    return parent->template startCoroutineForResult<ResultCoroutine<R>>(callback, this, std::function<ResultType()>(task));
+  }
+
+  /**
+   * Run task in the pool and take `next` action once it's done.
+   * @tparam ParentCoroutineType - type of the calling coroutine.
+   * @param parent - calling coroutine. Usually `this`.
+   * @param task - task to run.
+   * @param next - action to take once task is done. Should not be `repeat()` or `waitRetry()`.
+   * @return - &l:Action;.
+   */
+  template<typename ParentCoroutineType>
+  Action offload(ParentCoroutineType* parent, const std::function<void()>& task, const Action& next) {
+    return parent->template startCoroutine<VoidCoroutine>(next, this, task);
+  }
+
+  /**
+   * @return - name of the pool.
+   */
+  const std::string& getName() const {
+    return m_name;
+  }
+
+  /**
+   * Get snapshot of pool metrics.
+   * @return - &l:OffloadPool::Stats;.
+   */
+  Stats getStats();
+
+};
+
+}}
+
+#endif /* oatpp_async_OffloadPool_hpp */
@@ -24,84 +24,638 @@
 
 #include "Processor.hpp"
 
+#include "./CoroutineWaitList.hpp"
+
+#include "oatpp/core/concurrency/Thread.hpp"
+
+#include <algorithm>
+#include <limits>
+
 namespace oatpp { namespace async {
-  
+
+Processor::Processor(v_int32 ioEngine, v_int32 burstSize)
+  : m_burstSize(burstSize > 0 ? burstSize : 1)
+  , m_ioEventPoller(nullptr)
+  , m_ioWaitingFirst(nullptr)
+  , m_ioWaitingCount(0)
+  , m_parkedFirst(nullptr)
+  , m_parkedCount(0)
+  , m_timerWheel(oatpp::base::Environment::getMicroTickCount())
+  , m_sleeping(false)
+  , m_wakeupRequested(false)
+  , m_finishedCount(0)
+  , m_activeCountGauge(0)
+  , m_waitingCountGauge(0)
+  , m_ioWaitingCountGauge(0)
+  , m_timersCountGauge(0)
+  , m_parkedCountGauge(0)
+  , m_finishedCountGauge(0)
+  , m_stepsCount(0)
+  , m_sleepsCount(0)
+  , m_wakeupsCount(0)
+  , m_watched(false)
+  , m_stepSequence(0)
+  , m_stepType(nullptr)
+  , m_stepAddress(nullptr)
+  , m_stepThread(std::thread::native_handle_type())
+  , m_stallsCount(0)
+{
+  for(v_int32 i = 0; i < Priority::CLASSES_COUNT; i ++) {
+    m_credits[i] = 0;
+  }
+  m_ioEventPoller = IOEventPoller::createPoller(ioEngine);
+  if(m_ioEventPoller == nullptr && ioEngine != IOEventPoller::ENGINE_NONE) {
+    OATPP_LOGD("[oatpp::async::Processor::Processor()]", "Warning. I/O engine %d is not available. Falling back to I/O polling.", ioEngine);
+  }
+}
+
+Processor::~Processor() {
+  /* Delete poller first so that no pending notification refers to freed coroutine */
+  delete m_ioEventPoller;
+  AbstractCoroutine* curr = m_ioWaitingFirst;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_ref;
+    curr->free();
+    curr = next;
+  }
+}
+
 bool Processor::checkWaitingQueue() {
   bool hasActions = false;
-  AbstractCoroutine* curr = m_waitingQueue.first;
-  AbstractCoroutine* prev = nullptr;
-  while (curr != nullptr) {
+  /* Check each coroutine once per pass. Coroutines which are still waiting go to the back of the queue.
+   * Coroutines waiting for I/O which can't be polled also go back to this queue - don't re-check them in the same pass */
+  AbstractCoroutine* last = m_waitingQueue.last;
+  bool isLast = (last == nullptr);
+  bool watched = m_watched.load(std::memory_order_relaxed);
+  v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+  while (!isLast) {
+    AbstractCoroutine* curr = m_waitingQueue.popFront();
+    isLast = (curr == last);
+    if(watched) {
+      beginStep(curr);
+    }
     const Action& action = curr->iterate();
+    if(action.m_type == Action::TYPE_WAIT_RETRY) {
+      m_waitingQueue.pushBack(curr);
+      continue;
+    }
+    m_waitingHistogram.record(currentMicros - curr->_waitStartMicros);
     if(action.m_type == Action::TYPE_ABORT) {
-      m_waitingQueue.removeEntry(curr, prev);
-      if(prev != nullptr) {
-        curr = prev;
-      } else {
-        curr = m_waitingQueue.first;
-      }
-    } else if(action.m_type != Action::TYPE_WAIT_RETRY) {
-      oatpp::collection::FastQueue<AbstractCoroutine>::moveEntry(m_waitingQueue, m_activeQueue, curr, prev);
+      curr->free();
+      m_tasksCount --;
+      m_finishedCount ++;
+    } else if(action.m_type == Action::TYPE_WAIT_FOR_IO) {
+      addIOWaitingCoroutine(curr, action);
+    } else if(action.m_type == Action::TYPE_WAIT_UNTIL) {
+      addTimedCoroutine(curr, action);
+    } else if(action.m_type == Action::TYPE_WAIT_LIST) {
+      parkCoroutine(curr, action);
+    } else {
+      pushActive(curr);
       hasActions = true;
-      if(prev != nullptr) {
-        curr = prev;
-      } else {
-        curr = m_waitingQueue.first;
-      }
-    }
-    
-    prev = curr;
-    if(curr != nullptr) {
-      curr = curr->_ref;
     }
   }
+  if(watched) {
+    endSteps();
+  }
   return hasActions;
 }
 
 bool Processor::considerContinueImmediately() {
   
-  bool hasAction = checkWaitingQueue();
+  bool hasAction = consumeResumed();
+  hasAction = pollIOEvents(0) || hasAction;
+  hasAction = expireTimers() || hasAction;
+  hasAction = checkInterrupts() || hasAction;
+  
+  if(m_waitingQueue.first == nullptr) {
+    /* Nothing to poll. Everything else is resumed by I/O events and timers */
+    m_inactivityTick = 0;
+    return hasActive();
+  }
+  
+  hasAction = checkWaitingQueue() || hasAction;
   
   if(hasAction) {
     m_inactivityTick = 0;
   } else if(m_inactivityTick == 0) {
     m_inactivityTick = oatpp::base::Environment::getMicroTickCount();
   } else if(oatpp::base::Environment::getMicroTickCount() - m_inactivityTick > 1000 * 100 /* 100 millis */) {
-    return m_activeQueue.first != nullptr;
+    return hasActive();
   }
   
   return true;
   
 }
+
+void Processor::addIOWaitingCoroutine(AbstractCoroutine* coroutine, const Action& action) {
+
+  coroutine->_waitStartMicros = oatpp::base::Environment::getMicroTickCount();
+
+  if(m_ioEventPoller != nullptr && action.m_ioHandle >= 0 &&
+     m_ioEventPoller->watch(action.m_ioHandle, action.m_ioEventType, coroutine))
+  {
+    coroutine->_ioHandle = action.m_ioHandle;
+    coroutine->_prevRef = nullptr;
+    coroutine->_ref = m_ioWaitingFirst;
+    if(m_ioWaitingFirst != nullptr) {
+      m_ioWaitingFirst->_prevRef = coroutine;
+    }
+    m_ioWaitingFirst = coroutine;
+    m_ioWaitingCount ++;
+    return;
+  }
+
+  /* I/O handle can't be polled. Fallback to the waiting queue */
+  m_waitingQueue.pushBack(coroutine);
+
+}
+
+void Processor::removeIOWaitingCoroutine(AbstractCoroutine* coroutine) {
+  if(coroutine->_prevRef != nullptr) {
+    coroutine->_prevRef->_ref = coroutine->_ref;
+  } else {
+    m_ioWaitingFirst = coroutine->_ref;
+  }
+  if(coroutine->_ref != nullptr) {
+    coroutine->_ref->_prevRef = coroutine->_prevRef;
+  }
+  coroutine->_prevRef = nullptr;
+  m_ioWaitingCount --;
+}
+
+void Processor::addTimedCoroutine(AbstractCoroutine* coroutine, const Action& action) {
+  if(action.m_timePointMicros <= oatpp::base::Environment::getMicroTickCount()) {
+    pushActive(coroutine);
+  } else {
+    m_timerWheel.add(coroutine, action.m_timePointMicros);
+  }
+}
+
+void Processor::parkCoroutine(AbstractCoroutine* coroutine, const Action& action) {
+  coroutine->_parkedPrev = nullptr;
+  coroutine->_parkedNext = m_parkedFirst;
+  if(m_parkedFirst != nullptr) {
+    m_parkedFirst->_parkedPrev = coroutine;
+  }
+  m_parkedFirst = coroutine;
+  m_parkedCount ++;
+  /* Coroutine may be resumed by another thread right away. It comes back through m_resumedQueue */
+  action.m_waitList->pushBack(coroutine);
+}
+
+void Processor::removeParkedCoroutine(AbstractCoroutine* coroutine) {
+  if(coroutine->_parkedPrev != nullptr) {
+    coroutine->_parkedPrev->_parkedNext = coroutine->_parkedNext;
+  } else {
+    m_parkedFirst = coroutine->_parkedNext;
+  }
+  if(coroutine->_parkedNext != nullptr) {
+    coroutine->_parkedNext->_parkedPrev = coroutine->_parkedPrev;
+  }
+  coroutine->_parkedPrev = nullptr;
+  coroutine->_parkedNext = nullptr;
+  m_parkedCount --;
+}
+
+bool Processor::consumeResumed() {
+  if(m_resumedQueue.isEmpty()) {
+    return false;
+  }
+  oatpp::collection::FastQueue<AbstractCoroutine> resumed;
+  m_resumedQueue.popAll(resumed);
+  while (resumed.first != nullptr) {
+    AbstractCoroutine* coroutine = resumed.popFront();
+    removeParkedCoroutine(coroutine);
+    pushActive(coroutine);
+  }
+  return true;
+}
+
+void Processor::resumeCoroutine(AbstractCoroutine* coroutine) {
+  /* Pairs with sleeping thread setting the flag before checking the queue */
+  if(m_resumedQueue.push(coroutine) && m_sleeping.load()) {
+    wakeup();
+  }
+}
+
+bool Processor::expireTimers() {
+  if(m_timerWheel.getCount() == 0) {
+    return false;
+  }
+  oatpp::collection::FastQueue<AbstractCoroutine> expired;
+  v_int32 count = m_timerWheel.expire(oatpp::base::Environment::getMicroTickCount(), expired);
+  pushActive(expired);
+  return count > 0;
+}
+
+bool Processor::checkInterrupts() {
+
+  v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+  if(currentMicros - m_lastInterruptsCheck < INTERRUPTS_CHECK_INTERVAL_MICROS) {
+    return false;
+  }
+  m_lastInterruptsCheck = currentMicros;
+
+  /* Active and waiting coroutines are iterated anyway. Just schedule the unwinding */
+  AbstractCoroutine* curr;
+  for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+    curr = m_activeQueues[p].first;
+    while (curr != nullptr) {
+      curr->checkInterrupt(currentMicros);
+      curr = curr->_ref;
+    }
+  }
+
+  curr = m_waitingQueue.first;
+  while (curr != nullptr) {
+    curr->checkInterrupt(currentMicros);
+    curr = curr->_ref;
+  }
+
+  bool hasActions = false;
+
+  curr = m_ioWaitingFirst;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_ref;
+    if(curr->checkInterrupt(currentMicros) && m_ioEventPoller->unwatch(curr->_ioHandle, curr)) {
+      removeIOWaitingCoroutine(curr);
+      pushActive(curr);
+      hasActions = true;
+    }
+    curr = next;
+  }
+
+  /* Coroutine which is notified concurrently comes back through m_resumedQueue and is unwound there */
+  curr = m_parkedFirst;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_parkedNext;
+    if(curr->checkInterrupt(currentMicros) && CoroutineWaitList::remove(curr)) {
+      removeParkedCoroutine(curr);
+      pushActive(curr);
+      hasActions = true;
+    }
+    curr = next;
+  }
+
+  if(m_timerWheel.getCount() > 0) {
+    auto condition = [currentMicros](AbstractCoroutine* coroutine) {
+      return coroutine->checkInterrupt(currentMicros);
+    };
+    oatpp::collection::FastQueue<AbstractCoroutine> interrupted;
+    hasActions = m_timerWheel.moveIf(condition, interrupted) > 0 || hasActions;
+    pushActive(interrupted);
+  }
+
+  return hasActions;
+
+}
+
+bool Processor::pollIOEvents(v_int32 timeoutMillis) {
+
+  if(m_ioWaitingCount == 0) {
+    return false;
+  }
+
+  return consumeIOEvents(timeoutMillis) > 0;
+
+}
+
+v_int32 Processor::consumeIOEvents(v_int32 timeoutMillis) {
+
+  AbstractCoroutine* coroutines[IO_EVENTS_BATCH_SIZE];
+  v_int32 count = m_ioEventPoller->pollEvents(coroutines, IO_EVENTS_BATCH_SIZE, timeoutMillis);
+  v_int64 currentMicros = count > 0 ? oatpp::base::Environment::getMicroTickCount() : 0;
+
+  for(v_int32 i = 0; i < count; i ++) {
+
+    AbstractCoroutine* coroutine = coroutines[i];
+
+    removeIOWaitingCoroutine(coroutine);
+    pushActive(coroutine);
+    m_ioWaitingHistogram.record(currentMicros - coroutine->_waitStartMicros);
+
+  }
+
+  return count;
+
+}
+
+void Processor::waitForEvents(v_int64 timeoutMicros) {
+
+  /* Thread is going idle - take back frames freed by other threads and release unused memory */
+  v_int64 shrinkTimeoutMicros = FramePool::getThreadPool().onIdle(oatpp::base::Environment::getMicroTickCount());
+  if(shrinkTimeoutMicros >= 0 && (timeoutMicros < 0 || shrinkTimeoutMicros < timeoutMicros)) {
+    timeoutMicros = shrinkTimeoutMicros;
+  }
+
+  m_sleepsCount.store(m_sleepsCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  m_sleeping.store(true);
+
+  if(!m_resumedQueue.isEmpty()) {
+    /* Coroutine was resumed before the flag was set. Nobody is going to wake us up */
+    m_sleeping.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  if(m_ioEventPoller != nullptr) {
+    v_int32 timeoutMillis = -1;
+    if(timeoutMicros >= 0) {
+      /* Round up - don't wake up before the timer */
+      v_int64 millis = (timeoutMicros + 999) / 1000;
+      timeoutMillis = (v_int32) std::min<v_int64>(millis, std::numeric_limits<v_int32>::max());
+    }
+    consumeIOEvents(timeoutMillis);
+  } else {
+    std::unique_lock<std::mutex> lock(m_wakeupMutex);
+    auto predicate = [this] {
+      return m_wakeupRequested;
+    };
+    if(timeoutMicros < 0) {
+      m_wakeupCondition.wait(lock, predicate);
+    } else {
+      m_wakeupCondition.wait_for(lock, std::chrono::microseconds(timeoutMicros), predicate);
+    }
+    m_wakeupRequested = false;
+  }
+
+  m_sleeping.store(false, std::memory_order_relaxed);
+
+}
+
+void Processor::wakeup() {
+  m_wakeupsCount.fetch_add(1, std::memory_order_relaxed);
+  if(m_ioEventPoller != nullptr) {
+    m_ioEventPoller->wakeup();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_wakeupMutex);
+    m_wakeupRequested = true;
+  }
+  m_wakeupCondition.notify_one();
+}
   
+void Processor::pushActive(AbstractCoroutine* coroutine) {
+  m_activeQueues[coroutine->m_priority].pushBack(coroutine);
+}
+
+void Processor::pushActive(oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+  while (queue.first != nullptr) {
+    pushActive(queue.popFront());
+  }
+}
+
+bool Processor::hasActive() const {
+  for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+    if(m_activeQueues[p].first != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+v_int32 Processor::pickActiveQueue() {
+
+  for(v_int32 round = 0; round < 2; round ++) {
+
+    for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+      if(m_activeQueues[p].first != nullptr && m_credits[p] > 0) {
+        return p;
+      }
+    }
+
+    /* Every class with runnable coroutines has used its share. Start new round. Idle classes don't accumulate credits */
+    bool hasActive = false;
+    for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+      if(m_activeQueues[p].first != nullptr) {
+        m_credits[p] += Priority::getWeight(p) * m_burstSize;
+        hasActive = true;
+      } else {
+        m_credits[p] = 0;
+      }
+    }
+
+    if(!hasActive) {
+      return -1;
+    }
+
+  }
+
+  return -1;
+
+}
+
 void Processor::addCoroutine(AbstractCoroutine* coroutine) {
-  m_activeQueue.pushBack(coroutine);
+  coroutine->_processor = this;
+  pushActive(coroutine);
+  m_tasksCount ++;
 }
   
 void Processor::addWaitingCoroutine(AbstractCoroutine* coroutine) {
+  coroutine->_processor = this;
+  coroutine->_waitStartMicros = oatpp::base::Environment::getMicroTickCount();
   m_waitingQueue.pushBack(coroutine);
+  m_tasksCount ++;
+}
+
+v_int32 Processor::splitActiveQueue(oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+
+  v_int32 movedCount = 0;
+
+  for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+
+    oatpp::collection::FastQueue<AbstractCoroutine>& activeQueue = m_activeQueues[p];
+
+    v_int32 count = activeQueue.count;
+    if(count < 2) {
+      continue;
+    }
+
+    /* Keep the first half and pinned coroutines of the second half in order */
+    v_int32 keepCount = count - count / 2;
+    oatpp::collection::FastQueue<AbstractCoroutine> kept;
+    for(v_int32 i = 0; i < count; i ++) {
+      AbstractCoroutine* coroutine = activeQueue.popFront();
+      if(i >= keepCount && !coroutine->m_pinned) {
+        queue.pushBack(coroutine);
+        movedCount ++;
+      } else {
+        kept.pushBack(coroutine);
+      }
+    }
+
+    activeQueue.first = kept.first;
+    activeQueue.last = kept.last;
+    activeQueue.count = kept.count;
+    kept.first = nullptr;
+    kept.last = nullptr;
+    kept.count = 0;
+
+  }
+
+  m_tasksCount -= movedCount;
+  return movedCount;
+
+}
+
+void Processor::publishMetrics(v_int32 stepsCount) {
+  v_int32 activeCount = 0;
+  for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+    activeCount += m_activeQueues[p].count;
+  }
+  m_activeCountGauge.store(activeCount, std::memory_order_relaxed);
+  m_waitingCountGauge.store(m_waitingQueue.count, std::memory_order_relaxed);
+  m_ioWaitingCountGauge.store(m_ioWaitingCount, std::memory_order_relaxed);
+  m_timersCountGauge.store(m_timerWheel.getCount(), std::memory_order_relaxed);
+  m_parkedCountGauge.store(m_parkedCount, std::memory_order_relaxed);
+  m_finishedCountGauge.store(m_finishedCount, std::memory_order_relaxed);
+  m_stepsCount.store(m_stepsCount.load(std::memory_order_relaxed) + stepsCount, std::memory_order_relaxed);
+}
+
+void Processor::getMetrics(ProcessorMetrics& metrics) const {
+  metrics.activeCount = m_activeCountGauge.load(std::memory_order_relaxed);
+  metrics.waitingCount = m_waitingCountGauge.load(std::memory_order_relaxed);
+  metrics.ioWaitingCount = m_ioWaitingCountGauge.load(std::memory_order_relaxed);
+  metrics.timersCount = m_timersCountGauge.load(std::memory_order_relaxed);
+  metrics.parkedCount = m_parkedCountGauge.load(std::memory_order_relaxed);
+  metrics.finishedCount = m_finishedCountGauge.load(std::memory_order_relaxed);
+  metrics.stepsCount = m_stepsCount.load(std::memory_order_relaxed);
+  metrics.sleepsCount = m_sleepsCount.load(std::memory_order_relaxed);
+  metrics.wakeupsCount = m_wakeupsCount.load(std::memory_order_relaxed);
+  metrics.waitingMicros = m_waitingHistogram.getSnapshot();
+  metrics.ioWaitingMicros = m_ioWaitingHistogram.getSnapshot();
+  metrics.stallsCount = m_stallsCount.load(std::memory_order_relaxed);
+  metrics.stallMicros = m_stallHistogram.getSnapshot();
+}
+
+void Processor::beginStep(AbstractCoroutine* coroutine) {
+  m_stepType.store(&typeid(*coroutine->_CP), std::memory_order_relaxed);
+  m_stepAddress.store(AbstractCoroutine::getStepAddress(coroutine->_CP, coroutine->_FP), std::memory_order_relaxed);
+  m_stepThread.store(oatpp::concurrency::Thread::getCurrentNativeHandle(), std::memory_order_relaxed);
+  m_stepSequence.store((m_stepSequence.load(std::memory_order_relaxed) | 1) + 2, std::memory_order_release);
+}
+
+void Processor::endSteps() {
+  m_stepSequence.store((m_stepSequence.load(std::memory_order_relaxed) | 1) + 1, std::memory_order_release);
+}
+
+Action Processor::iterateWatched(AbstractCoroutine* coroutine, v_int32& stepsCount) {
+  Action action = Action::_REPEAT;
+  stepsCount = 0;
+  do {
+    beginStep(coroutine);
+    action = coroutine->iterate();
+    stepsCount ++;
+  } while(stepsCount < m_burstSize && !coroutine->finished() &&
+          (action.m_type == Action::TYPE_YIELD_TO || action.m_type == Action::TYPE_REPEAT || action.m_type == Action::TYPE_COROUTINE));
+  endSteps();
+  return action;
+}
+
+v_int32 Processor::moveCoroutines(oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+
+  v_int32 movedCount = 0;
+
+  for(v_int32 p = 0; p < Priority::CLASSES_COUNT; p ++) {
+    oatpp::collection::FastQueue<AbstractCoroutine>& activeQueue = m_activeQueues[p];
+    oatpp::collection::FastQueue<AbstractCoroutine> pinned;
+    while (activeQueue.first != nullptr) {
+      if(activeQueue.first->finished()) {
+        activeQueue.popFrontNoData();
+        m_tasksCount --;
+        m_finishedCount ++;
+      } else if(activeQueue.first->m_pinned) {
+        pinned.pushBack(activeQueue.popFront());
+      } else {
+        queue.pushBack(activeQueue.popFront());
+        movedCount ++;
+      }
+    }
+    pushActive(pinned);
+  }
+
+  oatpp::collection::FastQueue<AbstractCoroutine> pinned;
+  while (m_waitingQueue.first != nullptr) {
+    AbstractCoroutine* coroutine = m_waitingQueue.popFront();
+    if(coroutine->m_pinned) {
+      pinned.pushBack(coroutine);
+    } else {
+      queue.pushBack(coroutine);
+      movedCount ++;
+    }
+  }
+  while (pinned.first != nullptr) {
+    m_waitingQueue.pushBack(pinned.popFront());
+  }
+
+  /* I/O handle is re-watched by the new processor once the coroutine repeats its I/O call there */
+  AbstractCoroutine* curr = m_ioWaitingFirst;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_ref;
+    if(!curr->m_pinned && m_ioEventPoller->unwatch(curr->_ioHandle, curr)) {
+      removeIOWaitingCoroutine(curr);
+      queue.pushBack(curr);
+      movedCount ++;
+    }
+    curr = next;
+  }
+
+  m_tasksCount -= movedCount;
+  return movedCount;
+
 }
 
 bool Processor::iterate(v_int32 numIterations) {
   
-  for(v_int32 i = 0; i < numIterations; i++) {
+  /* Lets I/O of coroutines submit operations to the poller (see IOUringOperation) */
+  IOEventPoller* previousPoller = IOEventPoller::setCurrent(m_ioEventPoller);
+  
+  v_int32 i = 0;
+  while(i < numIterations) {
     
-    auto CP = m_activeQueue.first;
-    if(CP == nullptr) {
+    v_int32 priority = pickActiveQueue();
+    if(priority < 0) {
       break;
     }
+    
+    oatpp::collection::FastQueue<AbstractCoroutine>& queue = m_activeQueues[priority];
+    auto CP = queue.first;
+    
     if(!CP->finished()) {
-      const Action& action = CP->iterate();
+      /* Keep running the same coroutine while it's runnable - it stays hot in cache */
+      v_int32 stepsCount;
+      const Action& action = m_watched.load(std::memory_order_relaxed) ? iterateWatched(CP, stepsCount)
+                                                                       : CP->iterate(m_burstSize, stepsCount);
+      i += stepsCount;
+      m_credits[priority] -= stepsCount;
       if(action.m_type == Action::TYPE_WAIT_RETRY) {
-        m_waitingQueue.pushBack(m_activeQueue.popFront());
+        CP->_waitStartMicros = oatpp::base::Environment::getMicroTickCount();
+        m_waitingQueue.pushBack(queue.popFront());
+      } else if(action.m_type == Action::TYPE_WAIT_FOR_IO) {
+        addIOWaitingCoroutine(queue.popFront(), action);
+      } else if(action.m_type == Action::TYPE_WAIT_UNTIL) {
+        addTimedCoroutine(queue.popFront(), action);
+      } else if(action.m_type == Action::TYPE_WAIT_LIST) {
+        parkCoroutine(queue.popFront(), action);
+      } else if(CP->m_priority != priority) {
+        /* Coroutine changed its class */
+        pushActive(queue.popFront());
       } else {
-        m_activeQueue.round();
+        queue.round();
       }
     } else {
-      m_activeQueue.popFrontNoData();
+      queue.popFrontNoData();
+      m_tasksCount --;
+      m_finishedCount ++;
+      i ++;
     }
   }
   
-  return considerContinueImmediately();
+  bool hasActions = considerContinueImmediately();
+  IOEventPoller::setCurrent(previousPoller);
+  publishMetrics(i);
+  return hasActions;
   
 }
   
@@ -25,29 +25,311 @@
 #ifndef oatpp_async_Processor_hpp
 #define oatpp_async_Processor_hpp
 
+#include "./IOEventPoller.hpp"
+#include "./Metrics.hpp"
+#include "./TimerWheel.hpp"
 #include "./Coroutine.hpp"
 #include "oatpp/core/collection/FastQueue.hpp"
+#include "oatpp/core/collection/MPSCQueue.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <typeinfo>
 
 namespace oatpp { namespace async {
+
+class StallDetector; // FWD
   
+/**
+ * Processor executes coroutines in one thread.
+ * Coroutines which returned Action::TYPE_WAIT_FOR_IO are parked in the I/O event queue (see &l:IOEventPoller;)
+ * and are resumed only when the kernel reports readiness of their I/O handle.
+ * Coroutines which returned Action::TYPE_WAIT_UNTIL are parked in the &l:TimerWheel; until their time point.
+ * Coroutines which returned Action::_WAIT_RETRY are kept in the waiting queue and are re-checked on each pass.
+ * Coroutines which returned Action::TYPE_WAIT_LIST are handed over to their &l:CoroutineWaitList; and are not run by processor
+ * until the list resumes them - possibly from another thread. Processor keeps track of them to check their interrupts.
+ * Runnable coroutines are queued per &l:Priority; class and classes share processor time in proportion to their weights.
+ */
 class Processor {
+  friend StallDetector;
+public:
+  /**
+   * Max number of I/O events consumed by one pollIOEvents() call.
+   */
+  static constexpr const v_int32 IO_EVENTS_BATCH_SIZE = 256;
+  
+  /**
+   * How often deadlines and cancellation handles of coroutines are checked.
+   */
+  static constexpr const v_int64 INTERRUPTS_CHECK_INTERVAL_MICROS = 100 * 1000;
+  
+  /**
+   * Default max number of steps a coroutine makes in a row before it is moved to the back of the active queue.
+   */
+  static constexpr const v_int32 BURST_SIZE_DEFAULT = 16;
 private:
   
   bool checkWaitingQueue();
   bool considerContinueImmediately();
+  bool expireTimers();
+  
+  /**
+   * Check deadlines and cancellation handles of all coroutines.
+   * Interrupted coroutines parked for I/O, timers, or in wait lists are moved to the active queue to be unwound.
+   */
+  bool checkInterrupts();
+  
+  /**
+   * Park coroutine until its I/O handle is ready.
+   * If I/O handle can't be polled, coroutine goes to the waiting queue.
+   */
+  void addIOWaitingCoroutine(AbstractCoroutine* coroutine, const Action& action);
+  
+  /**
+   * Unlink coroutine from the list of coroutines parked for I/O.
+   */
+  void removeIOWaitingCoroutine(AbstractCoroutine* coroutine);
+  
+  /**
+   * Poll I/O events and move coroutines whose I/O is ready to the active queue.
+   * @return - number of resumed coroutines.
+   */
+  v_int32 consumeIOEvents(v_int32 timeoutMillis);
+  
+  /**
+   * Park coroutine until action's time point.
+   */
+  void addTimedCoroutine(AbstractCoroutine* coroutine, const Action& action);
+  
+  /**
+   * Hand coroutine over to the wait list of the action.
+   */
+  void parkCoroutine(AbstractCoroutine* coroutine, const Action& action);
+  
+  /**
+   * Unlink coroutine from the list of coroutines parked in wait lists.
+   */
+  void removeParkedCoroutine(AbstractCoroutine* coroutine);
+  
+  /**
+   * Move coroutines resumed by wait lists to the active queue.
+   * @return - true if at least one coroutine was resumed.
+   */
+  bool consumeResumed();
+  
+  /**
+   * Add coroutine to the active queue of its priority class.
+   */
+  void pushActive(AbstractCoroutine* coroutine);
+  void pushActive(oatpp::collection::FastQueue<AbstractCoroutine>& queue);
+  bool hasActive() const;
+  
+  /**
+   * Weighted-fair choice of the priority class to run next. Deficit round-robin over steps.
+   * @return - priority class or -1 if there are no runnable coroutines.
+   */
+  v_int32 pickActiveQueue();
+  
+  /**
+   * Publish queue lengths and counters for &l:Processor::getMetrics ();.
+   */
+  void publishMetrics(v_int32 stepsCount);
+  
+  /**
+   * Publish the step which is about to run for &id:oatpp::async::StallDetector;.
+   */
+  void beginStep(AbstractCoroutine* coroutine);
+  
+  /**
+   * Publish that processor's thread is not running coroutine steps.
+   */
+  void endSteps();
+  
+  /**
+   * Same as AbstractCoroutine::iterate(maxSteps, stepsCount) but each step is published with beginStep().
+   */
+  Action iterateWatched(AbstractCoroutine* coroutine, v_int32& stepsCount);
   
 private:
-  oatpp::collection::FastQueue<AbstractCoroutine> m_activeQueue;
+  /* Runnable coroutines per &l:Priority; class */
+  oatpp::collection::FastQueue<AbstractCoroutine> m_activeQueues[Priority::CLASSES_COUNT];
+  /* Steps each class may still make in the current scheduling round */
+  v_int32 m_credits[Priority::CLASSES_COUNT];
   oatpp::collection::FastQueue<AbstractCoroutine> m_waitingQueue;
+  /* Coroutines resumed by wait lists. Pushed from any thread */
+  oatpp::collection::MPSCQueue<AbstractCoroutine> m_resumedQueue;
 private:
+  v_int32 m_burstSize;
   v_int64 m_inactivityTick = 0;
+  v_int64 m_lastInterruptsCheck = 0;
+  v_int32 m_tasksCount = 0;
+private:
+  IOEventPoller* m_ioEventPoller;
+  AbstractCoroutine* m_ioWaitingFirst;
+  v_int32 m_ioWaitingCount;
+private:
+  /* Coroutines parked in wait lists. Linked with _parkedNext and _parkedPrev */
+  AbstractCoroutine* m_parkedFirst;
+  v_int32 m_parkedCount;
+private:
+  TimerWheel m_timerWheel;
+private:
+  /* Set while processor's thread is blocked in waitForEvents() */
+  std::atomic<bool> m_sleeping;
+  /* Used to sleep if there is no IOEventPoller */
+  bool m_wakeupRequested;
+  std::mutex m_wakeupMutex;
+  std::condition_variable m_wakeupCondition;
+  
+  /* Metrics. Written by processor's thread with relaxed stores, read by any thread */
+  v_int64 m_finishedCount;
+  std::atomic<v_int32> m_activeCountGauge;
+  std::atomic<v_int32> m_waitingCountGauge;
+  std::atomic<v_int32> m_ioWaitingCountGauge;
+  std::atomic<v_int32> m_timersCountGauge;
+  std::atomic<v_int32> m_parkedCountGauge;
+  std::atomic<v_int64> m_finishedCountGauge;
+  std::atomic<v_int64> m_stepsCount;
+  std::atomic<v_int64> m_sleepsCount;
+  std::atomic<v_int64> m_wakeupsCount;
+  Histogram m_waitingHistogram;
+  Histogram m_ioWaitingHistogram;
+private:
+  /*
+   * Step being run - published only while processor is watched by StallDetector.
+   * Sequence is odd while a step is running and changes with each step.
+   */
+  std::atomic<bool> m_watched;
+  std::atomic<v_int64> m_stepSequence;
+  std::atomic<const std::type_info*> m_stepType;
+  std::atomic<const void*> m_stepAddress;
+  std::atomic<std::thread::native_handle_type> m_stepThread;
+  /* Written by StallDetector's thread */
+  std::atomic<v_int64> m_stallsCount;
+  Histogram m_stallHistogram;
 public:
+  
+  /**
+   * Constructor.
+   * @param ioEngine - I/O readiness engine. See &l:IOEventPoller::ENGINE_AUTO;.
+   * If engine is not available coroutines waiting for I/O are polled.
+   * @param burstSize - max number of steps a coroutine makes in a row until it waits or finishes.
+   * 1 - round-robin coroutines after each step.
+   */
+  Processor(v_int32 ioEngine = IOEventPoller::ENGINE_AUTO, v_int32 burstSize = BURST_SIZE_DEFAULT);
+  ~Processor();
+  
+  Processor(const Processor&) = delete;
+  Processor& operator = (const Processor&) = delete;
 
   void addCoroutine(AbstractCoroutine* coroutine);
   void addWaitingCoroutine(AbstractCoroutine* coroutine);
+  
+  /**
+   * Run active coroutines.
+   * @param numIterations - max number of coroutine steps to make.
+   * @return - true if there are coroutines to run right away.
+   */
   bool iterate(v_int32 numIterations);
+  
+  /**
+   * Move coroutines whose I/O is ready to the active queue.
+   * @param timeoutMillis - max time to block waiting for I/O events. 0 - don't block.
+   * @return - true if at least one coroutine was resumed.
+   */
+  bool pollIOEvents(v_int32 timeoutMillis);
+  
+  /**
+   * Block until I/O of a parked coroutine is ready, a coroutine is resumed by its wait list,
+   * &l:Processor::wakeup (); is called, or timeout.
+   * Coroutines whose I/O is ready are moved to the active queue.
+   * Blocks in the kernel if processor has &l:IOEventPoller;. Otherwise waits on condition variable.
+   * @param timeoutMicros - max time to block. -1 - no timeout.
+   */
+  void waitForEvents(v_int64 timeoutMicros);
+  
+  /**
+   * Interrupt &l:Processor::waitForEvents (); blocked in another thread. Thread safe.
+   */
+  void wakeup();
+  
+  /**
+   * Hand coroutine parked in a &l:CoroutineWaitList; back to the processor. Thread safe.
+   * Wakes processor's thread only if it's sleeping.
+   * @param coroutine
+   */
+  void resumeCoroutine(AbstractCoroutine* coroutine);
+  
+  /**
+   * Move the second half of runnable coroutines to the queue. Used for work stealing.
+   * Pinned coroutines stay (see &l:AbstractCoroutine::setPinned ();). Moved coroutines are not counted by the processor anymore.
+   * @param queue - queue to move coroutines to.
+   * @return - number of moved coroutines.
+   */
+  v_int32 splitActiveQueue(oatpp::collection::FastQueue<AbstractCoroutine>& queue);
+  
+  /**
+   * Move all runnable coroutines, coroutines waiting for retry, and coroutines waiting for I/O to the queue.
+   * Used to migrate coroutines to another processor. Coroutines waiting for timers, coroutines parked in wait lists,
+   * and pinned coroutines stay.
+   * Moved coroutines are not counted by the processor anymore. Finished coroutines are freed.
+   * Moved coroutines repeat their current step once they are picked up by another processor.
+   * @param queue - queue to move coroutines to.
+   * @return - number of moved coroutines.
+   */
+  v_int32 moveCoroutines(oatpp::collection::FastQueue<AbstractCoroutine>& queue);
+  
+  /**
+   * Get queue lengths, counters and wait times of the processor. Thread safe.
+   * Queue lengths and counters are updated once per &l:Processor::iterate (); call.
+   * @param metrics - &l:ProcessorMetrics; to fill. Fields which processor doesn't know about are not touched.
+   */
+  void getMetrics(ProcessorMetrics& metrics) const;
+  
+  /**
+   * @return - number of coroutines held by processor - runnable, waiting for I/O, for timers, for retry,
+   * or parked in wait lists.
+   */
+  v_int32 getTasksCount() const {
+    return m_tasksCount;
+  }
+  
+  /**
+   * @return - I/O engine in use or IOEventPoller::ENGINE_NONE.
+   */
+  v_int32 getIOEngine() const {
+    return m_ioEventPoller != nullptr ? m_ioEventPoller->getEngine() : IOEventPoller::ENGINE_NONE;
+  }
+  
+  /**
+   * Get time until the next timer of a coroutine waiting for a time point.
+   * @return - microseconds or -1 if there are no timers.
+   */
+  v_int64 getNextTimerTimeoutMicros() const {
+    return m_timerWheel.getNextTimeoutMicros(oatpp::base::Environment::getMicroTickCount());
+  }
+  
+  /**
+   * @return - true if there are coroutines waiting for I/O events.
+   */
+  bool hasIOWaiting() const {
+    return m_ioWaitingCount > 0;
+  }
+  
+  /**
+   * @return - true if processor holds no coroutines. Coroutines parked in wait lists count - their interrupts are checked.
+   */
   bool isEmpty() {
-    return m_activeQueue.first == nullptr && m_waitingQueue.first == nullptr;
+    return !hasActive() && m_waitingQueue.first == nullptr && m_ioWaitingCount == 0 &&
+           m_timerWheel.getCount() == 0 && m_parkedCount == 0 && m_resumedQueue.isEmpty();
+  }
+  
+  /**
+   * @return - true if there are coroutines which can't be resumed by I/O events and have to be polled.
+   */
+  bool hasWaitingRetry() {
+    return m_waitingQueue.first != nullptr;
   }
   
 };
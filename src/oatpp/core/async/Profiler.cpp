@@ -0,0 +1,282 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dlfcn.h>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+namespace oatpp { namespace async {
+
+namespace {
+
+/* Marks thread's table as free when thread exits. Table is reused by the next new thread */
+class TableHolder {
+public:
+  std::atomic<bool>* owned = nullptr;
+  void* table = nullptr;
+  ~TableHolder() {
+    if(owned != nullptr) {
+      owned->store(false, std::memory_order_release);
+    }
+  }
+};
+
+void add(std::atomic<v_int64>& counter, v_int64 value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+}
+
+std::atomic<bool> Profiler::ENABLED(false);
+std::atomic<v_int32> Profiler::SAMPLING_INTERVAL(1);
+std::atomic<v_int64> Profiler::EPOCH(0);
+oatpp::concurrency::SpinLock::Atom Profiler::TABLES_ATOM(false);
+
+std::list<std::unique_ptr<Profiler::Table>>& Profiler::getTables() {
+  static std::list<std::unique_ptr<Table>> tables;
+  return tables;
+}
+
+Profiler::Table& Profiler::getThreadTable() {
+  static thread_local TableHolder holder;
+  if(holder.table == nullptr) {
+    oatpp::concurrency::SpinLock lock(TABLES_ATOM);
+    Table* table = nullptr;
+    for(auto& t : getTables()) {
+      if(!t->owned.load(std::memory_order_acquire)) {
+        table = t.get();
+        break;
+      }
+    }
+    if(table == nullptr) {
+      getTables().push_back(std::unique_ptr<Table>(new Table()));
+      table = getTables().back().get();
+    }
+    table->owned.store(true, std::memory_order_relaxed);
+    holder.owned = &table->owned;
+    holder.table = table;
+  }
+  return *static_cast<Table*>(holder.table);
+}
+
+std::string Profiler::getTypeName(const std::type_info& type) {
+#if defined(__GNUC__)
+  int status = 0;
+  char* name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+  if(status == 0 && name != nullptr) {
+    std::string result(name);
+    std::free(name);
+    return result;
+  }
+#endif
+  return type.name();
+}
+
+std::string Profiler::getSymbolName(const void* address) {
+  
+  char buffer[64];
+  if(address == nullptr) {
+    return "<unknown>";
+  }
+  
+  Dl_info info;
+  if(dladdr(address, &info) == 0) {
+    std::snprintf(buffer, sizeof(buffer), "%p", address);
+    return buffer;
+  }
+  
+  if(info.dli_sname != nullptr && info.dli_saddr == address) {
+#if defined(__GNUC__)
+    int status = 0;
+    char* name = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    if(status == 0 && name != nullptr) {
+      std::string result(name);
+      std::free(name);
+      return result;
+    }
+#endif
+    return info.dli_sname;
+  }
+  
+  /* No symbol exported (static linkage) - print module offset for addr2line */
+  std::string module = info.dli_fname != nullptr ? info.dli_fname : "";
+  auto pos = module.find_last_of('/');
+  if(pos != std::string::npos) {
+    module = module.substr(pos + 1);
+  }
+  std::snprintf(buffer, sizeof(buffer), "+0x%lx",
+                (unsigned long) ((const char*) address - (const char*) info.dli_fbase));
+  return module + buffer;
+  
+}
+
+void Profiler::start(v_int32 samplingInterval) {
+  if(samplingInterval < 1) {
+    samplingInterval = 1;
+  }
+  SAMPLING_INTERVAL.store(samplingInterval, std::memory_order_relaxed);
+  ENABLED.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stop() {
+  ENABLED.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::reset() {
+  /* Threads drop their samples once they see the new epoch */
+  EPOCH.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Profiler::takeSample() {
+  static thread_local v_int32 countdown = 0;
+  if(countdown > 0) {
+    countdown --;
+    return false;
+  }
+  countdown = SAMPLING_INTERVAL.load(std::memory_order_relaxed) - 1;
+  return true;
+}
+
+v_int64 Profiler::getNanoTickCount() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const std::type_info& coroutineType, const void* stepAddress, v_int64 nanos) {
+  
+  Table& table = getThreadTable();
+  
+  v_int64 epoch = EPOCH.load(std::memory_order_relaxed);
+  if(table.epoch.load(std::memory_order_relaxed) != epoch) {
+    oatpp::concurrency::SpinLock lock(table.atom);
+    table.entries.clear();
+    table.epoch.store(epoch, std::memory_order_relaxed);
+  }
+  
+  Key key = {&coroutineType, stepAddress};
+  auto it = table.entries.find(key);
+  Entry* entry;
+  if(it != table.entries.end()) {
+    entry = &it->second;
+  } else {
+    oatpp::concurrency::SpinLock lock(table.atom);
+    entry = &table.entries[key];
+  }
+  
+  v_int32 interval = SAMPLING_INTERVAL.load(std::memory_order_relaxed);
+  add(entry->count, interval);
+  add(entry->totalNanos, nanos * interval);
+  if(nanos > entry->maxNanos.load(std::memory_order_relaxed)) {
+    entry->maxNanos.store(nanos, std::memory_order_relaxed);
+  }
+  
+}
+
+std::vector<Profiler::StepStats> Profiler::getStats() {
+  
+  std::unordered_map<Key, StepStats, KeyHash> merged;
+  v_int64 epoch = EPOCH.load(std::memory_order_relaxed);
+  
+  {
+    oatpp::concurrency::SpinLock tablesLock(TABLES_ATOM);
+    for(auto& table : getTables()) {
+      oatpp::concurrency::SpinLock lock(table->atom);
+      if(table->epoch.load(std::memory_order_relaxed) != epoch) {
+        continue;
+      }
+      for(auto& pair : table->entries) {
+        auto it = merged.find(pair.first);
+        if(it == merged.end()) {
+          StepStats stats;
+          stats.count = 0;
+          stats.totalNanos = 0;
+          stats.maxNanos = 0;
+          it = merged.insert({pair.first, stats}).first;
+        }
+        StepStats& stats = it->second;
+        stats.count += pair.second.count.load(std::memory_order_relaxed);
+        stats.totalNanos += pair.second.totalNanos.load(std::memory_order_relaxed);
+        stats.maxNanos = std::max(stats.maxNanos, pair.second.maxNanos.load(std::memory_order_relaxed));
+      }
+    }
+  }
+  
+  std::vector<StepStats> result;
+  result.reserve(merged.size());
+  for(auto& pair : merged) {
+    pair.second.coroutineName = getTypeName(*pair.first.type);
+    pair.second.stepName = getSymbolName(pair.first.step);
+    result.push_back(pair.second);
+  }
+  
+  std::sort(result.begin(), result.end(), [](const StepStats& a, const StepStats& b) {
+    return a.totalNanos > b.totalNanos;
+  });
+  
+  return result;
+  
+}
+
+std::string Profiler::dump(v_int32 maxEntries) {
+  
+  auto stats = getStats();
+  
+  v_int64 totalNanos = 0;
+  for(auto& s : stats) {
+    totalNanos += s.totalNanos;
+  }
+  
+  char buffer[128];
+  std::string result;
+  std::snprintf(buffer, sizeof(buffer), "%7s %14s %12s %10s %10s  %s\n", "time%", "total(ns)", "count", "mean(ns)", "max(ns)", "coroutine :: step");
+  result += buffer;
+  
+  v_int32 printed = 0;
+  for(auto& s : stats) {
+    if(printed ++ == maxEntries) {
+      break;
+    }
+    std::snprintf(buffer, sizeof(buffer), "%6.2f%% %14lld %12lld %10lld %10lld  ",
+                  totalNanos > 0 ? s.totalNanos * 100.0 / totalNanos : 0.0,
+                  (long long) s.totalNanos, (long long) s.count,
+                  (long long) (s.count > 0 ? s.totalNanos / s.count : 0), (long long) s.maxNanos);
+    result += buffer;
+    result += s.coroutineName + " :: " + s.stepName + "\n";
+  }
+  
+  return result;
+  
+}
+  
+}}
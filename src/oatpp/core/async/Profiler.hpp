@@ -0,0 +1,221 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Profiler_hpp
+#define oatpp_async_Profiler_hpp
+
+#include "oatpp/core/concurrency/SpinLock.hpp"
+#include "oatpp/core/base/Environment.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace oatpp { namespace async {
+
+/**
+ * Sampling profiler of coroutine steps. <br>
+ * Attributes wall time and number of invocations to (coroutine type, step function) pairs.
+ * Off by default. When off, it costs one relaxed atomic load per coroutine step. <br>
+ * Each thread collects its own samples, so profiling doesn't add contention between executor threads.
+ * Symbolization is done only when stats are read.
+ */
+class Profiler {
+public:
+  
+  /**
+   * Stats of one step function of one coroutine type.
+   * If sampling interval is greater than 1, counts and time are estimates - sampled values multiplied by the interval.
+   */
+  class StepStats {
+  public:
+    
+    /**
+     * Demangled name of coroutine type.
+     */
+    std::string coroutineName;
+    
+    /**
+     * Name of step function. If there is no symbol for the function - `module+0xoffset` suitable for `addr2line`.
+     */
+    std::string stepName;
+    
+    /**
+     * Number of invocations.
+     */
+    v_int64 count;
+    
+    /**
+     * Total wall time of invocations.
+     */
+    v_int64 totalNanos;
+    
+    /**
+     * Longest sampled invocation.
+     */
+    v_int64 maxNanos;
+    
+  };
+  
+private:
+  
+  class Key {
+  public:
+    const std::type_info* type;
+    const void* step;
+    
+    bool operator == (const Key& other) const {
+      return type == other.type && step == other.step;
+    }
+  };
+  
+  class KeyHash {
+  public:
+    std::size_t operator () (const Key& key) const {
+      return std::hash<const void*>()(key.type) * 31 + std::hash<const void*>()(key.step);
+    }
+  };
+  
+  class Entry {
+  public:
+    Entry()
+      : count(0)
+      , totalNanos(0)
+      , maxNanos(0)
+    {}
+    std::atomic<v_int64> count;
+    std::atomic<v_int64> totalNanos;
+    std::atomic<v_int64> maxNanos;
+  };
+  
+  /*
+   * Samples of one thread. Written by the owner thread only.
+   * Entries are inserted under the lock, so that the table may be read by other threads.
+   * Table of exited thread is reused by the next new thread.
+   */
+  class Table {
+  public:
+    Table()
+      : owned(false)
+      , epoch(0)
+      , atom(false)
+    {}
+    std::atomic<bool> owned;
+    std::atomic<v_int64> epoch;
+    oatpp::concurrency::SpinLock::Atom atom;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+  };
+  
+private:
+  static std::atomic<bool> ENABLED;
+  static std::atomic<v_int32> SAMPLING_INTERVAL;
+  static std::atomic<v_int64> EPOCH;
+private:
+  static oatpp::concurrency::SpinLock::Atom TABLES_ATOM;
+  static std::list<std::unique_ptr<Table>>& getTables();
+  static Table& getThreadTable();
+public:
+  
+  /**
+   * Get demangled name of the type.
+   * @param type
+   * @return
+   */
+  static std::string getTypeName(const std::type_info& type);
+  
+  /**
+   * Get name of the function at the code address. If there is no symbol - `module+0xoffset` suitable for `addr2line`.
+   * @param address
+   * @return
+   */
+  static std::string getSymbolName(const void* address);
+  
+  
+  /**
+   * Start profiling.
+   * @param samplingInterval - profile every N-th step of each thread. 1 - profile every step.
+   */
+  static void start(v_int32 samplingInterval = 1);
+  
+  /**
+   * Stop profiling. Collected stats are kept.
+   */
+  static void stop();
+  
+  /**
+   * Drop collected stats.
+   */
+  static void reset();
+  
+  /**
+   * Check if profiling is on.
+   * @return
+   */
+  static bool isEnabled() {
+    return ENABLED.load(std::memory_order_relaxed);
+  }
+  
+  /**
+   * Decide if the current step of the calling thread should be profiled. Called by &l:AbstractCoroutine; when profiling is on.
+   * @return
+   */
+  static bool takeSample();
+  
+  /**
+   * Get monotonic time in nanoseconds.
+   * @return
+   */
+  static v_int64 getNanoTickCount();
+  
+  /**
+   * Record invocation of the coroutine step.
+   * @param coroutineType - type of the coroutine.
+   * @param stepAddress - code address of the step function.
+   * @param nanos - wall time of the step.
+   */
+  static void record(const std::type_info& coroutineType, const void* stepAddress, v_int64 nanos);
+  
+  /**
+   * Get stats of all threads merged, sorted by total time - hottest steps first.
+   * @return - list of &l:Profiler::StepStats;.
+   */
+  static std::vector<StepStats> getStats();
+  
+  /**
+   * Format the hottest steps as a table.
+   * @param maxEntries - max number of steps to print.
+   * @return
+   */
+  static std::string dump(v_int32 maxEntries = 20);
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Profiler_hpp */
@@ -0,0 +1,75 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "Semaphore.hpp"
+
+namespace oatpp { namespace async {
+
+Semaphore::Semaphore(v_int32 permits)
+  : m_atom(false)
+  , m_permits(permits)
+  , m_waitList(this)
+{}
+
+void Semaphore::onNewItem(CoroutineWaitList& list) {
+  if(getPermits() > 0) {
+    list.notifyFirst();
+  }
+}
+
+bool Semaphore::tryAcquire() {
+  oatpp::concurrency::SpinLock lock(m_atom);
+  if(m_permits > 0) {
+    m_permits --;
+    return true;
+  }
+  return false;
+}
+
+Action Semaphore::acquire(const Action& next) {
+  if(tryAcquire()) {
+    return next;
+  }
+  return Action::createWaitListAction(&m_waitList);
+}
+
+void Semaphore::release(v_int32 count) {
+  {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    m_permits += count;
+  }
+  for(v_int32 i = 0; i < count; i ++) {
+    if(!m_waitList.notifyFirst()) {
+      break;
+    }
+  }
+}
+
+v_int32 Semaphore::getPermits() {
+  oatpp::concurrency::SpinLock lock(m_atom);
+  return m_permits;
+}
+  
+}}
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_Semaphore_hpp
+#define oatpp_async_Semaphore_hpp
+
+#include "./CoroutineWaitList.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * Counting semaphore for coroutines. Waiting coroutines are parked in &l:CoroutineWaitList; and take no processor time.
+ * Permits may be released from any thread. <br>
+ * Usage:
+ * ```
+ * Action act() override {
+ *   return m_semaphore->acquire(yieldTo(&MyCoroutine::onAcquired));
+ * }
+ * ```
+ */
+class Semaphore : private CoroutineWaitList::Listener {
+private:
+  oatpp::concurrency::SpinLock::Atom m_atom;
+  v_int32 m_permits;
+  CoroutineWaitList m_waitList;
+private:
+  void onNewItem(CoroutineWaitList& list) override;
+public:
+  
+  /**
+   * Constructor.
+   * @param permits - initial number of permits.
+   */
+  Semaphore(v_int32 permits);
+  
+  static std::shared_ptr<Semaphore> createShared(v_int32 permits) {
+    return std::make_shared<Semaphore>(permits);
+  }
+  
+  /**
+   * Take permit if there is one. Doesn't wait.
+   * @return - true if permit was taken.
+   */
+  bool tryAcquire();
+  
+  /**
+   * Take permit or park the coroutine until a permit is released.
+   * Parked coroutine repeats the calling function once notified.
+   * @param next - action to take once permit is taken. Should not start coroutine - it would be leaked on wait.
+   * @return - `next` or wait action.
+   */
+  Action acquire(const Action& next);
+  
+  /**
+   * Return permits. Resumes one parked coroutine per permit.
+   * @param count - number of permits.
+   */
+  void release(v_int32 count = 1);
+  
+  /**
+   * @return - number of available permits.
+   */
+  v_int32 getPermits();
+  
+};
+  
+}}
+
+#endif /* oatpp_async_Semaphore_hpp */
@@ -0,0 +1,281 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "StallDetector.hpp"
+
+#include "./Profiler.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+#include <signal.h>
+#include <pthread.h>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define OATPP_ASYNC_STALL_BACKTRACE
+#endif
+
+namespace oatpp { namespace async {
+
+const int StallDetector::SIGNAL_DEFAULT = SIGURG;
+
+namespace {
+
+constexpr const v_int32 BACKTRACE_MAX_FRAMES = 64;
+constexpr const v_int64 BACKTRACE_TIMEOUT_MICROS = 100 * 1000;
+
+/* One capture at a time. Filled by signal handler on the blocked thread */
+struct BacktraceSlot {
+  void* frames[BACKTRACE_MAX_FRAMES];
+  std::atomic<v_int32> size;
+  std::atomic<bool> done;
+};
+
+BacktraceSlot g_backtraceSlot;
+std::atomic<BacktraceSlot*> g_backtraceTarget(nullptr);
+std::mutex g_backtraceMutex;
+
+void onBacktraceSignal(int) {
+  BacktraceSlot* slot = g_backtraceTarget.exchange(nullptr);
+  if(slot == nullptr) {
+    return;
+  }
+#ifdef OATPP_ASYNC_STALL_BACKTRACE
+  slot->size.store(::backtrace(slot->frames, BACKTRACE_MAX_FRAMES), std::memory_order_relaxed);
+#endif
+  slot->done.store(true, std::memory_order_release);
+}
+
+}
+
+StallDetector::StallDetector(const Config& config, const Listener& listener)
+  : m_config(config)
+  , m_listener(listener)
+  , m_running(true)
+{
+  
+  if(m_config.checkIntervalMicros < 1) {
+    m_config.checkIntervalMicros = 1;
+  }
+  
+  if(m_config.captureBacktrace) {
+#ifdef OATPP_ASYNC_STALL_BACKTRACE
+    /* First call of backtrace() may allocate - don't let it happen in signal handler */
+    void* frames[1];
+    ::backtrace(frames, 1);
+#endif
+    struct sigaction action;
+    action.sa_handler = &onBacktraceSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if(sigaction(m_config.backtraceSignal, &action, nullptr) != 0) {
+      throw std::runtime_error("[oatpp::async::StallDetector::StallDetector()]: Error. Can't install signal handler.");
+    }
+  }
+  
+  m_thread = std::thread(&StallDetector::run, this);
+  
+}
+
+StallDetector::~StallDetector() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    for(auto& watched : m_watched) {
+      watched.processor->m_watched.store(false, std::memory_order_relaxed);
+    }
+    m_watched.clear();
+  }
+  m_condition.notify_all();
+  m_thread.join();
+}
+
+void StallDetector::watch(Processor* processor, const std::string& name) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(processor->m_watched.load(std::memory_order_relaxed)) {
+    throw std::runtime_error("[oatpp::async::StallDetector::watch()]: Error. Processor is already watched.");
+  }
+  Watched watched;
+  watched.processor = processor;
+  watched.name = name;
+  watched.sequence = processor->m_stepSequence.load(std::memory_order_acquire);
+  watched.sequenceSeenMicros = oatpp::base::Environment::getMicroTickCount();
+  watched.reported = false;
+  watched.type = nullptr;
+  watched.step = nullptr;
+  m_watched.push_back(watched);
+  processor->m_watched.store(true, std::memory_order_relaxed);
+}
+
+void StallDetector::unwatch(Processor* processor) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(auto it = m_watched.begin(); it != m_watched.end(); it ++) {
+    if(it->processor == processor) {
+      processor->m_watched.store(false, std::memory_order_relaxed);
+      m_watched.erase(it);
+      return;
+    }
+  }
+}
+
+void StallDetector::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(m_running) {
+    m_condition.wait_for(lock, std::chrono::microseconds(m_config.checkIntervalMicros));
+    v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+    for(auto& watched : m_watched) {
+      check(watched, currentMicros);
+    }
+  }
+}
+
+void StallDetector::check(Watched& watched, v_int64 currentMicros) {
+  
+  Processor* processor = watched.processor;
+  v_int64 sequence = processor->m_stepSequence.load(std::memory_order_acquire);
+  
+  if(sequence != watched.sequence) {
+    if(watched.reported) {
+      v_int64 durationMicros = currentMicros - watched.sequenceSeenMicros;
+      processor->m_stallHistogram.record(durationMicros);
+      report(watched, durationMicros, true, std::vector<std::string>());
+    }
+    watched.sequence = sequence;
+    watched.sequenceSeenMicros = currentMicros;
+    watched.reported = false;
+    return;
+  }
+  
+  /* Even sequence - processor's thread is not running a step */
+  if((sequence & 1) == 0 || watched.reported) {
+    return;
+  }
+  
+  v_int64 durationMicros = currentMicros - watched.sequenceSeenMicros;
+  if(durationMicros < m_config.thresholdMicros) {
+    return;
+  }
+  
+  const std::type_info* type = processor->m_stepType.load(std::memory_order_relaxed);
+  const void* step = processor->m_stepAddress.load(std::memory_order_relaxed);
+  std::thread::native_handle_type thread = processor->m_stepThread.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if(processor->m_stepSequence.load(std::memory_order_relaxed) != sequence) {
+    /* Step has returned while we were reading it */
+    return;
+  }
+  
+  watched.reported = true;
+  watched.type = type;
+  watched.step = step;
+  processor->m_stallsCount.store(processor->m_stallsCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  
+  std::vector<std::string> backtrace;
+  if(m_config.captureBacktrace) {
+    backtrace = captureBacktrace(thread, m_config.backtraceSignal);
+    /* Don't show a backtrace of some other step */
+    if(processor->m_stepSequence.load(std::memory_order_acquire) != sequence) {
+      backtrace.clear();
+    }
+  }
+  
+  report(watched, durationMicros, false, backtrace);
+  
+}
+
+void StallDetector::report(const Watched& watched, v_int64 durationMicros, bool ended, const std::vector<std::string>& backtrace) {
+  
+  Stall stall;
+  stall.processorName = watched.name;
+  stall.coroutineName = watched.type != nullptr ? Profiler::getTypeName(*watched.type) : "<unknown>";
+  stall.stepName = Profiler::getSymbolName(watched.step);
+  stall.durationMicros = durationMicros;
+  stall.ended = ended;
+  stall.backtrace = backtrace;
+  
+  if(m_listener) {
+    m_listener(stall);
+    return;
+  }
+  
+  if(ended) {
+    OATPP_LOGE("[oatpp::async::StallDetector]", "Stall ended. '%s' was blocked for %lld micros by %s :: %s",
+               stall.processorName.c_str(), stall.durationMicros, stall.coroutineName.c_str(), stall.stepName.c_str());
+  } else {
+    OATPP_LOGE("[oatpp::async::StallDetector]", "Stall detected. '%s' is blocked for %lld micros by %s :: %s",
+               stall.processorName.c_str(), stall.durationMicros, stall.coroutineName.c_str(), stall.stepName.c_str());
+    for(auto& frame : stall.backtrace) {
+      OATPP_LOGE("[oatpp::async::StallDetector]", "    %s", frame.c_str());
+    }
+  }
+  
+}
+
+std::vector<std::string> StallDetector::captureBacktrace(std::thread::native_handle_type thread, int signal) {
+  
+  std::vector<std::string> result;
+  
+#ifdef OATPP_ASYNC_STALL_BACKTRACE
+  
+  std::lock_guard<std::mutex> lock(g_backtraceMutex);
+  
+  g_backtraceSlot.size.store(0, std::memory_order_relaxed);
+  g_backtraceSlot.done.store(false, std::memory_order_relaxed);
+  g_backtraceTarget.store(&g_backtraceSlot);
+  
+  if(pthread_kill(thread, signal) != 0) {
+    g_backtraceTarget.store(nullptr);
+    return result;
+  }
+  
+  v_int64 startMicros = oatpp::base::Environment::getMicroTickCount();
+  while(!g_backtraceSlot.done.load(std::memory_order_acquire)) {
+    if(oatpp::base::Environment::getMicroTickCount() - startMicros > BACKTRACE_TIMEOUT_MICROS) {
+      /* If the handler hasn't taken the slot yet - it won't write it */
+      if(g_backtraceTarget.exchange(nullptr) != nullptr) {
+        return result;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  
+  v_int32 size = g_backtraceSlot.size.load(std::memory_order_relaxed);
+  char** symbols = ::backtrace_symbols(g_backtraceSlot.frames, size);
+  if(symbols != nullptr) {
+    /* Skip the frames of signal handler */
+    for(v_int32 i = 2; i < size; i ++) {
+      result.push_back(symbols[i]);
+    }
+    std::free(symbols);
+  }
+  
+#endif
+  
+  return result;
+  
+}
+  
+}}
@@ -0,0 +1,209 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_async_StallDetector_hpp
+#define oatpp_async_StallDetector_hpp
+
+#include "./Processor.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace async {
+
+/**
+ * Watchdog detecting coroutine steps which block processor's thread. <br>
+ * While one step blocks (ex.: synchronous DNS lookup, blocking interceptor, heavy serialization)
+ * all other coroutines of the processor wait. Detector checks watched processors from its own thread
+ * and reports steps which run longer than the threshold - coroutine type, step function and duration.
+ * Optionally, it captures the backtrace of the blocked thread. <br>
+ * Stalls are counted in &id:oatpp::async::ProcessorMetrics;. <br>
+ * Watched processor publishes each step with a few relaxed stores, and runs steps one by one
+ * instead of the inlined burst loop. Processors which are not watched don't pay anything.
+ */
+class StallDetector {
+public:
+  
+  /**
+   * Config of the detector.
+   */
+  class Config {
+  public:
+    
+    Config(v_int64 pThresholdMicros = 100 * 1000)
+      : thresholdMicros(pThresholdMicros)
+      , checkIntervalMicros(pThresholdMicros / 4 > 0 ? pThresholdMicros / 4 : 1)
+      , captureBacktrace(false)
+      , backtraceSignal(SIGNAL_DEFAULT)
+    {}
+    
+    /**
+     * Step running longer than the threshold is reported as a stall.
+     */
+    v_int64 thresholdMicros;
+    
+    /**
+     * How often processors are checked. Durations are measured with this precision.
+     */
+    v_int64 checkIntervalMicros;
+    
+    /**
+     * Capture backtrace of the blocked thread. Backtrace is captured by signal handler on the blocked thread.
+     */
+    bool captureBacktrace;
+    
+    /**
+     * Signal used to capture backtraces. Handler is installed only if &l:StallDetector::Config::captureBacktrace; is set.
+     */
+    int backtraceSignal;
+    
+  };
+  
+  /**
+   * Reported stall.
+   */
+  class Stall {
+  public:
+    
+    /**
+     * Name of the processor given to &l:StallDetector::watch ();.
+     */
+    std::string processorName;
+    
+    /**
+     * Demangled name of coroutine type.
+     */
+    std::string coroutineName;
+    
+    /**
+     * Name of step function. See &id:oatpp::async::Profiler::getSymbolName;.
+     */
+    std::string stepName;
+    
+    /**
+     * How long the step has been running.
+     */
+    v_int64 durationMicros;
+    
+    /**
+     * `false` - step is still running, `true` - step has returned.
+     */
+    bool ended;
+    
+    /**
+     * Frames of blocked thread if &l:StallDetector::Config::captureBacktrace; is set. Empty for ended stalls.
+     */
+    std::vector<std::string> backtrace;
+    
+  };
+  
+  /**
+   * Called from detector's thread once stall is detected and once it has ended.
+   * Must not call &l:StallDetector::watch (); or &l:StallDetector::unwatch ();.
+   */
+  typedef std::function<void(const Stall&)> Listener;
+  
+public:
+  /**
+   * Default signal to capture backtraces with - `SIGURG`. It is ignored by default, so a stray signal does no harm.
+   */
+  static const int SIGNAL_DEFAULT;
+private:
+  
+  class Watched {
+  public:
+    Processor* processor;
+    std::string name;
+    v_int64 sequence;
+    v_int64 sequenceSeenMicros;
+    bool reported;
+    const std::type_info* type;
+    const void* step;
+  };
+  
+private:
+  void run();
+  void check(Watched& watched, v_int64 currentMicros);
+  void report(const Watched& watched, v_int64 durationMicros, bool ended, const std::vector<std::string>& backtrace);
+  static std::vector<std::string> captureBacktrace(std::thread::native_handle_type thread, int signal);
+private:
+  Config m_config;
+  Listener m_listener;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::list<Watched> m_watched;
+  bool m_running;
+  std::thread m_thread;
+public:
+  
+  /**
+   * Constructor. Starts detector's thread.
+   * @param config - &l:StallDetector::Config;.
+   * @param listener - &l:StallDetector::Listener;. If not set, stalls are logged.
+   */
+  StallDetector(const Config& config = Config(), const Listener& listener = nullptr);
+  
+  /**
+   * Stops detector's thread and unwatches all processors.
+   */
+  ~StallDetector();
+  
+  static std::shared_ptr<StallDetector> createShared(const Config& config = Config(), const Listener& listener = nullptr) {
+    return std::make_shared<StallDetector>(config, listener);
+  }
+  
+  /**
+   * Start watching the processor. Processor must be unwatched before it is destroyed.
+   * Processor can be watched by one detector only.
+   * @param processor - &id:oatpp::async::Processor;.
+   * @param name - name to report stalls with.
+   */
+  void watch(Processor* processor, const std::string& name);
+  
+  /**
+   * Stop watching the processor. Once it returns, detector doesn't access the processor.
+   * @param processor - &id:oatpp::async::Processor;.
+   */
+  void unwatch(Processor* processor);
+  
+  /**
+   * Get config of the detector.
+   * @return - &l:StallDetector::Config;.
+   */
+  const Config& getConfig() const {
+    return m_config;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_StallDetector_hpp */
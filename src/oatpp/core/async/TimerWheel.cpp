@@ -0,0 +1,174 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "TimerWheel.hpp"
+
+namespace oatpp { namespace async {
+
+TimerWheel::TimerWheel(v_int64 currentMicros)
+  : m_currentTick(currentMicros / TICK_MICROS)
+  , m_count(0)
+{
+  for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+    for(v_int32 slot = 0; slot < SLOTS_COUNT; slot ++) {
+      m_slots[level][slot] = nullptr;
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+    for(v_int32 slot = 0; slot < SLOTS_COUNT; slot ++) {
+      AbstractCoroutine* curr = m_slots[level][slot];
+      while (curr != nullptr) {
+        AbstractCoroutine* next = curr->_ref;
+        curr->free();
+        curr = next;
+      }
+    }
+  }
+}
+
+void TimerWheel::insert(AbstractCoroutine* coroutine) {
+
+  v_int64 tick = coroutine->_timerTick;
+  if(tick - m_currentTick > MAX_TICKS) {
+    tick = m_currentTick + MAX_TICKS;
+  }
+
+  v_int64 delta = tick - m_currentTick;
+  v_int32 level = 0;
+  while(level < LEVELS_COUNT - 1 && delta >= ((v_int64) 1 << (SLOT_BITS * (level + 1)))) {
+    level ++;
+  }
+
+  v_int32 slot = (v_int32) ((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+  coroutine->_ref = m_slots[level][slot];
+  m_slots[level][slot] = coroutine;
+
+}
+
+void TimerWheel::cascade(v_int32 level) {
+  v_int32 slot = (v_int32) ((m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+  AbstractCoroutine* curr = m_slots[level][slot];
+  m_slots[level][slot] = nullptr;
+  while (curr != nullptr) {
+    AbstractCoroutine* next = curr->_ref;
+    insert(curr);
+    curr = next;
+  }
+}
+
+void TimerWheel::add(AbstractCoroutine* coroutine, v_int64 timePointMicros) {
+  /* Round up - coroutine should never be resumed earlier than requested */
+  v_int64 tick = (timePointMicros + TICK_MICROS - 1) / TICK_MICROS;
+  if(tick <= m_currentTick) {
+    tick = m_currentTick + 1;
+  }
+  coroutine->_timerTick = tick;
+  insert(coroutine);
+  m_count ++;
+}
+
+v_int32 TimerWheel::expire(v_int64 currentMicros, oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+
+  v_int64 targetTick = currentMicros / TICK_MICROS;
+
+  if(m_count == 0) {
+    if(targetTick > m_currentTick) {
+      m_currentTick = targetTick;
+    }
+    return 0;
+  }
+
+  v_int32 expiredCount = 0;
+
+  while(m_currentTick < targetTick && m_count > 0) {
+
+    m_currentTick ++;
+
+    /* Higher levels first - they may cascade timers down to the slot being expired */
+    v_int32 cascadeLevel = 0;
+    while(cascadeLevel < LEVELS_COUNT - 1 && (m_currentTick & (((v_int64) 1 << (SLOT_BITS * (cascadeLevel + 1))) - 1)) == 0) {
+      cascadeLevel ++;
+    }
+    for(v_int32 level = cascadeLevel; level > 0; level --) {
+      cascade(level);
+    }
+
+    v_int32 slot = (v_int32) (m_currentTick & SLOT_MASK);
+    AbstractCoroutine* curr = m_slots[0][slot];
+    m_slots[0][slot] = nullptr;
+    while (curr != nullptr) {
+      AbstractCoroutine* next = curr->_ref;
+      if(curr->_timerTick > m_currentTick) {
+        /* Timer was farther than MAX_TICKS */
+        insert(curr);
+      } else {
+        queue.pushBack(curr);
+        m_count --;
+        expiredCount ++;
+      }
+      curr = next;
+    }
+
+  }
+
+  if(m_currentTick < targetTick) {
+    m_currentTick = targetTick;
+  }
+
+  return expiredCount;
+
+}
+
+v_int64 TimerWheel::getNextTimeoutMicros(v_int64 currentMicros) const {
+
+  if(m_count == 0) {
+    return -1;
+  }
+
+  v_int64 nextTick = -1;
+
+  for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+    v_int32 shift = SLOT_BITS * level;
+    v_int64 base = m_currentTick >> shift;
+    for(v_int32 i = 1; i <= SLOTS_COUNT; i ++) {
+      if(m_slots[level][(base + i) & SLOT_MASK] != nullptr) {
+        /* Level-0 slot expires at its tick. Higher-level slot cascades at its first tick */
+        v_int64 tick = (base + i) << shift;
+        if(nextTick < 0 || tick < nextTick) {
+          nextTick = tick;
+        }
+        break;
+      }
+    }
+  }
+
+  v_int64 timeout = nextTick * TICK_MICROS - currentMicros;
+  return timeout > 0 ? timeout : 0;
+
+}
+  
+}}
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_async_TimerWheel_hpp
+#define oatpp_async_TimerWheel_hpp
+
+#include "./Coroutine.hpp"
+#include "oatpp/core/collection/FastQueue.hpp"
+
+namespace oatpp { namespace async {
+
+/**
+ * Hierarchical timing wheel of coroutines waiting for a time point.
+ * Insertion and expiration of a timer are O(1). Timers which don't fit the lowest level
+ * are cascaded down level by level as time advances.
+ * Coroutines are linked through their intrusive _ref pointer. Wheel is not thread-safe.
+ */
+class TimerWheel {
+public:
+  /**
+   * Resolution of the wheel in microseconds.
+   */
+  static constexpr const v_int64 TICK_MICROS = 1000;
+  
+  static constexpr const v_int32 LEVELS_COUNT = 4;
+  static constexpr const v_int32 SLOT_BITS = 6;
+  static constexpr const v_int32 SLOTS_COUNT = 1 << SLOT_BITS;
+  static constexpr const v_int64 SLOT_MASK = SLOTS_COUNT - 1;
+  
+  /**
+   * Max distance (in ticks) of a timer from the current tick. Farther timers are parked
+   * at the top level and are re-inserted when they come down.
+   */
+  static constexpr const v_int64 MAX_TICKS = ((v_int64) 1 << (SLOT_BITS * LEVELS_COUNT)) - 1;
+private:
+  void insert(AbstractCoroutine* coroutine);
+  void cascade(v_int32 level);
+private:
+  AbstractCoroutine* m_slots[LEVELS_COUNT][SLOTS_COUNT];
+  v_int64 m_currentTick;
+  v_int32 m_count;
+public:
+  
+  /**
+   * Constructor.
+   * @param currentMicros - current time. See &id:oatpp::base::Environment::getMicroTickCount;.
+   */
+  TimerWheel(v_int64 currentMicros);
+  
+  /**
+   * Free all coroutines remaining in the wheel.
+   */
+  ~TimerWheel();
+  
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator = (const TimerWheel&) = delete;
+  
+  /**
+   * Add coroutine to the wheel.
+   * @param coroutine
+   * @param timePointMicros - time point at which coroutine should be resumed.
+   */
+  void add(AbstractCoroutine* coroutine, v_int64 timePointMicros);
+  
+  /**
+   * Advance wheel to the current time and move all expired coroutines to the queue.
+   * @param currentMicros - current time.
+   * @param queue - queue to push expired coroutines to.
+   * @return - number of expired coroutines.
+   */
+  v_int32 expire(v_int64 currentMicros, oatpp::collection::FastQueue<AbstractCoroutine>& queue);
+  
+  /**
+   * Get time until wheel has to be advanced next.
+   * This is exact for timers closer than SLOTS_COUNT ticks and a lower bound for farther timers.
+   * @param currentMicros - current time.
+   * @return - microseconds or -1 if wheel is empty.
+   */
+  v_int64 getNextTimeoutMicros(v_int64 currentMicros) const;
+  
+  /**
+   * Remove all coroutines matching condition from the wheel and push them to the queue.
+   * O(n) - walks all slots.
+   * @param condition - `bool(AbstractCoroutine*)`.
+   * @param queue - queue to push removed coroutines to.
+   * @return - number of removed coroutines.
+   */
+  template<typename Condition>
+  v_int32 moveIf(Condition condition, oatpp::collection::FastQueue<AbstractCoroutine>& queue) {
+    v_int32 movedCount = 0;
+    for(v_int32 level = 0; level < LEVELS_COUNT; level ++) {
+      for(v_int32 slot = 0; slot < SLOTS_COUNT; slot ++) {
+        AbstractCoroutine* prev = nullptr;
+        AbstractCoroutine* curr = m_slots[level][slot];
+        while (curr != nullptr) {
+          AbstractCoroutine* next = curr->_ref;
+          if(condition(curr)) {
+            if(prev == nullptr) {
+              m_slots[level][slot] = next;
+            } else {
+              prev->_ref = next;
+            }
+            queue.pushBack(curr);
+            movedCount ++;
+          } else {
+            prev = curr;
+          }
+          curr = next;
+        }
+      }
+    }
+    m_count -= movedCount;
+    return movedCount;
+  }
+  
+  v_int32 getCount() const {
+    return m_count;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_async_TimerWheel_hpp */
@@ -43,6 +43,12 @@
  */
 //#define OATPP_DISABLE_POOL_ALLOCATIONS
 
+/**
+ * Define this to build io_uring I/O engine for oatpp::async::Processor (Linux only).
+ * If kernel doesn't support io_uring, Processor falls back to epoll.
+ */
+//#define OATPP_ASYNC_IO_URING
+
 /**
  * Predefined value for function oatpp::concurrency::Thread::getHardwareConcurrency();
  */
@@ -124,6 +124,10 @@ void Environment::printCompilationConfig() {
   OATPP_LOGD("oatpp/Config", "OATPP_DISABLE_POOL_ALLOCATIONS");
 #endif
 
+#ifdef OATPP_ASYNC_IO_URING
+  OATPP_LOGD("oatpp/Config", "OATPP_ASYNC_IO_URING");
+#endif
+
 #ifdef OATPP_THREAD_HARDWARE_CONCURRENCY
   OATPP_LOGD("oatpp/Config", "OATPP_THREAD_HARDWARE_CONCURRENCY=%d", OATPP_THREAD_HARDWARE_CONCURRENCY);
 #endif
@@ -26,6 +26,7 @@
 #define oatpp_base_memory_Allocator_hpp
 
 #include "./MemoryPool.hpp"
+#include <memory>
 
 namespace oatpp { namespace base { namespace memory {
 
@@ -25,6 +25,9 @@
 #include "MemoryPool.hpp"
 #include "oatpp/core/utils/ConversionUtils.hpp"
 #include "oatpp/core/concurrency/Thread.hpp"
+#include "oatpp/core/concurrency/Topology.hpp"
+
+#include <algorithm>
 
 namespace oatpp { namespace base { namespace  memory {
 
@@ -135,6 +138,8 @@ const v_int32 ThreadDistributedMemoryPool::SHARDS_COUNT_DEFAULT = OATPP_THREAD_D
 ThreadDistributedMemoryPool::ThreadDistributedMemoryPool(const std::string& name, v_int32 entrySize, v_int32 chunkSize, v_int32 shardsCount)
   : m_shardsCount(shardsCount)
   , m_shards(new MemoryPool*[m_shardsCount])
+  , m_nodesCount(std::max(1, std::min(oatpp::concurrency::Topology::getInstance().getNodesCount(), shardsCount)))
+  , m_nodeShardsCount(shardsCount / m_nodesCount)
 {
   for(v_int32 i = 0; i < m_shardsCount; i++){
     m_shards[i] = new MemoryPool(name + "_" + oatpp::utils::conversion::int32ToStdStr(i), entrySize, chunkSize);
@@ -150,8 +155,12 @@ ThreadDistributedMemoryPool::~ThreadDistributedMemoryPool(){
 
 void* ThreadDistributedMemoryPool::obtain() {
   static std::atomic<v_word16> base(0);
-  static thread_local v_int16 index = (++base) % m_shardsCount;
-  return m_shards[index]->obtain();
+  static thread_local v_word16 index = ++base;
+  static thread_local v_int32 node = oatpp::concurrency::Topology::getInstance().getCurrentNode();
+  if(m_nodesCount == 1) {
+    return m_shards[index % m_shardsCount]->obtain();
+  }
+  return m_shards[(node % m_nodesCount) * m_nodeShardsCount + index % m_nodeShardsCount]->obtain();
 }
   
 }}}
@@ -32,6 +32,7 @@
 #include <list>
 #include <unordered_map>
 #include <cstring>
+#include <utility>
 
 namespace oatpp { namespace base { namespace  memory {
   
@@ -109,10 +110,20 @@ public:
   
 };
   
+/**
+ * Memory pool split into shards. Each thread obtains entries from its own shard. <br>
+ * Shards are split between NUMA nodes (see &l:concurrency::Topology;) and a thread gets a shard of the node it runs on
+ * when it first obtains an entry. Chunk memory is first touched by the thread which allocates it - with the default
+ * first-touch policy of the kernel it's allocated on the thread's node.
+ * Threads pinned with &l:concurrency::PlacementPolicy; get node-local memory.
+ */
 class ThreadDistributedMemoryPool {
 private:
   v_int32 m_shardsCount;
   MemoryPool** m_shards;
+  /* Number of nodes shards are split between and number of shards of each node */
+  v_int32 m_nodesCount;
+  v_int32 m_nodeShardsCount;
 public:
   static const v_int32 SHARDS_COUNT_DEFAULT;
 public:
@@ -142,7 +153,7 @@ private:
     
     v_int32 newSize = m_size + m_growSize;
     T** newIndex = new T*[newSize];
-    std::memcpy(newIndex, m_index, m_size);
+    std::memcpy(newIndex, m_index, m_size * sizeof(T*));
     
     Block* b = new Block(new v_char8 [m_growSize * sizeof(T)], m_blocks);
     m_blocks = b;
@@ -156,12 +167,25 @@ private:
     
   }
   
+  /**
+   * Take back entries freed by other threads.
+   */
+  void drainRemote() {
+    T* entry = m_remoteFreed.exchange(nullptr, std::memory_order_acquire);
+    while (entry != nullptr) {
+      T* next = *reinterpret_cast<T**>(entry);
+      m_index[--m_indexPosition] = entry;
+      entry = next;
+    }
+  }
+  
 private:
   v_int32 m_growSize;
   v_int32 m_size;
   v_int32 m_indexPosition;
   Block* m_blocks;
   T** m_index;
+  std::atomic<T*> m_remoteFreed;
 public:
   
   Bench(v_int32 growSize)
@@ -170,7 +194,9 @@ public:
     , m_indexPosition(0)
     , m_blocks(nullptr)
     , m_index(nullptr)
+    , m_remoteFreed(nullptr)
   {
+    static_assert(sizeof(T) >= sizeof(T*), "Entry should fit a pointer");
     grow();
   }
   
@@ -178,6 +204,7 @@ public:
     auto curr = m_blocks;
     while (curr != nullptr) {
       auto next = curr->next;
+      delete [] curr->memory;
       delete curr;
       curr = next;
     }
@@ -185,18 +212,71 @@ public:
   }
   
   template<typename ... Args>
-  T* obtain(Args... args) {
+  T* obtain(Args&&... args) {
     if(m_indexPosition == m_size) {
-      grow();
+      drainRemote();
+      if(m_indexPosition == m_size) {
+        grow();
+      }
     }
-    return new (m_index[m_indexPosition ++]) T(args...);
+    return new (m_index[m_indexPosition ++]) T(std::forward<Args>(args)...);
   }
   
+  /**
+   * Free entry. Should be called from the thread owning the Bench.
+   */
   void free(T* entry) {
     entry->~T();
     m_index[--m_indexPosition] = entry;
   }
   
+  /**
+   * Free entry obtained from this Bench on another thread. Lock-free.
+   * Entry will be reused by the owning thread.
+   */
+  void freeRemote(T* entry) {
+    entry->~T();
+    T* head = m_remoteFreed.load(std::memory_order_relaxed);
+    do {
+      *reinterpret_cast<T**>(entry) = head;
+    } while (!m_remoteFreed.compare_exchange_weak(head, entry, std::memory_order_release, std::memory_order_relaxed));
+  }
+  
+  /**
+   * Called when owning thread exits.
+   * Bench is deleted if all its entries are free. Otherwise it is left alive for entries which are still
+   * in use on other threads.
+   */
+  static void release(Bench* bench) {
+    bench->drainRemote();
+    if(bench->m_indexPosition == 0) {
+      delete bench;
+    }
+  }
+  
+};
+  
+/**
+ * Owner of the thread's &l:Bench;. To be used as `thread_local`.
+ */
+template<typename T>
+class BenchHolder {
+private:
+  Bench<T>* m_bench;
+public:
+  
+  BenchHolder(v_int32 growSize)
+    : m_bench(new Bench<T>(growSize))
+  {}
+  
+  ~BenchHolder() {
+    Bench<T>::release(m_bench);
+  }
+  
+  Bench<T>& get() {
+    return *m_bench;
+  }
+  
 };
   
 }}}
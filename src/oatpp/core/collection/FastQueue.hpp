@@ -37,6 +37,7 @@ public:
   FastQueue()
     : first(nullptr)
     , last(nullptr)
+    , count(0)
   {}
   
   ~FastQueue(){
@@ -45,6 +46,7 @@ public:
   
   T* first;
   T* last;
+  v_int32 count;
   
   void pushFront(T* entry) {
     entry->_ref = first;
@@ -52,6 +54,7 @@ public:
     if(last == nullptr) {
       last = first;
     }
+    ++ count;
   }
   
   void pushBack(T* entry) {
@@ -63,6 +66,7 @@ public:
       last->_ref = entry;
       last = entry;
     }
+    ++ count;
   }
   
   void round(){
@@ -78,6 +82,7 @@ public:
     if(first == nullptr) {
       last = nullptr;
     }
+    -- count;
     return result;
   }
   
@@ -87,6 +92,7 @@ public:
     if(first == nullptr) {
       last = nullptr;
     }
+    -- count;
     result->free();
   }
   
@@ -97,13 +103,33 @@ public:
     } else if(entry->_ref == nullptr) {
       prevEntry->_ref = nullptr;
       last = prevEntry;
+      -- count;
       entry->free();
     } else {
       prevEntry->_ref = entry->_ref;
+      -- count;
       entry->free();
     }
   }
   
+  /**
+   * Unlink entry from the queue without freeing it.
+   */
+  void cutEntry(T* entry, T* prevEntry){
+    
+    if(prevEntry == nullptr) {
+      popFront();
+    } else if(entry->_ref == nullptr) {
+      prevEntry->_ref = nullptr;
+      last = prevEntry;
+      -- count;
+    } else {
+      prevEntry->_ref = entry->_ref;
+      -- count;
+    }
+    entry->_ref = nullptr;
+  }
+  
   static void moveEntry(FastQueue& fromQueue, FastQueue& toQueue, T* entry, T* prevEntry){
 
     if(prevEntry == nullptr) {
@@ -112,9 +138,11 @@ public:
       toQueue.pushBack(entry);
       fromQueue.last = prevEntry;
       prevEntry->_ref = nullptr;
+      -- fromQueue.count;
     } else {
       prevEntry->_ref = entry->_ref;
       toQueue.pushBack(entry);
+      -- fromQueue.count;
     }
     
   }
@@ -128,6 +156,7 @@ public:
     }
     first = nullptr;
     last = nullptr;
+    count = 0;
   }
   
 };
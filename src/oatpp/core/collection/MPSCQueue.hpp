@@ -0,0 +1,120 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_collection_MPSCQueue_hpp
+#define oatpp_collection_MPSCQueue_hpp
+
+#include "./FastQueue.hpp"
+
+#include <atomic>
+
+namespace oatpp { namespace collection {
+
+/**
+ * Lock-free intrusive multi-producer single-consumer queue. <br>
+ * Entries are linked through their `_ref` field, same as in &l:FastQueue;. <br>
+ * Producers push with a single CAS. Consumer takes all entries at once with a single exchange.
+ * @tparam T - entry type. Must have `T* _ref` field and `free()` method.
+ */
+template<typename T>
+class MPSCQueue {
+private:
+  /* Entries pushed so far, newest first */
+  std::atomic<T*> m_head;
+public:
+
+  MPSCQueue()
+    : m_head(nullptr)
+  {}
+
+  ~MPSCQueue() {
+    T* curr = m_head.exchange(nullptr);
+    while (curr != nullptr) {
+      T* next = curr->_ref;
+      curr->free();
+      curr = next;
+    }
+  }
+
+  /**
+   * Push entry. Thread safe, may be called by any thread.
+   * @param entry
+   * @return - `true` if queue was empty before the push.
+   */
+  bool push(T* entry) {
+    T* head = m_head.load(std::memory_order_relaxed);
+    do {
+      entry->_ref = head;
+    } while(!m_head.compare_exchange_weak(head, entry, std::memory_order_seq_cst, std::memory_order_relaxed));
+    return head == nullptr;
+  }
+
+  /**
+   * Move all pushed entries to the back of the queue in the order they were pushed. <br>
+   * Meant to be called by the consumer thread. Concurrent calls are safe - each call takes its own batch of entries.
+   * @param queue - &l:FastQueue; to move entries to.
+   * @return - number of entries moved.
+   */
+  v_int32 popAll(FastQueue<T>& queue) {
+
+    T* curr = m_head.exchange(nullptr, std::memory_order_acquire);
+    if(curr == nullptr) {
+      return 0;
+    }
+
+    /* Reverse to get entries in the order they were pushed */
+    T* reversed = nullptr;
+    while (curr != nullptr) {
+      T* next = curr->_ref;
+      curr->_ref = reversed;
+      reversed = curr;
+      curr = next;
+    }
+
+    v_int32 count = 0;
+    while (reversed != nullptr) {
+      T* next = reversed->_ref;
+      queue.pushBack(reversed);
+      reversed = next;
+      count ++;
+    }
+    return count;
+
+  }
+
+  /**
+   * Check if queue is empty. Result is a snapshot and may be outdated right away unless called by the consumer
+   * when no producers are active.
+   * @return
+   */
+  bool isEmpty() const {
+    return m_head.load() == nullptr;
+  }
+
+};
+
+}}
+
+#endif /* oatpp_collection_MPSCQueue_hpp */
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PlacementPolicy.hpp"
+
+#include "./Thread.hpp"
+
+namespace oatpp { namespace concurrency {
+
+PlacementPolicy::PlacementPolicy(v_int32 mode, v_int32 reservedCpusCount, const Topology& topology)
+  : m_mode(mode)
+  , m_connectionBalancer(0)
+{
+
+  v_int32 cpusCount = topology.getCpusCount();
+  if(reservedCpusCount < 0) {
+    reservedCpusCount = 0;
+  } else if(reservedCpusCount > cpusCount - 1) {
+    reservedCpusCount = cpusCount - 1;
+  }
+
+  /* Reserve CPUs from the end of the last node */
+  v_int32 workerCpusCount = cpusCount - reservedCpusCount;
+  for(v_int32 node = 0; node < topology.getNodesCount(); node ++) {
+    std::vector<v_int32> nodeCpus;
+    for(v_int32 cpu : topology.getNodeCpus(node)) {
+      if((v_int32) m_workerCpus.size() < workerCpusCount) {
+        m_workerCpus.push_back(cpu);
+        nodeCpus.push_back(cpu);
+      } else {
+        m_reservedCpus.push_back(cpu);
+      }
+    }
+    if(!nodeCpus.empty()) {
+      m_nodeCpus.push_back(nodeCpus);
+    }
+  }
+
+}
+
+std::shared_ptr<PlacementPolicy> PlacementPolicy::createShared(v_int32 mode, v_int32 reservedCpusCount) {
+  return std::make_shared<PlacementPolicy>(mode, reservedCpusCount);
+}
+
+v_int32 PlacementPolicy::setAffinity(std::thread::native_handle_type nativeHandle, const std::vector<v_int32>& cpus) const {
+  if(cpus.empty()) {
+    return 0;
+  }
+  return Thread::setThreadAffinityToCpus(nativeHandle, cpus);
+}
+
+std::vector<v_int32> PlacementPolicy::getWorkerCpus(v_int32 workerIndex) const {
+  if(m_mode == PIN_CORE && !m_workerCpus.empty()) {
+    /* Worker CPUs are ordered node by node */
+    return {m_workerCpus[workerIndex % m_workerCpus.size()]};
+  }
+  if(m_mode == PIN_NODE && !m_nodeCpus.empty()) {
+    return m_nodeCpus[workerIndex % m_nodeCpus.size()];
+  }
+  return m_workerCpus;
+}
+
+v_int32 PlacementPolicy::placeWorker(std::thread::native_handle_type nativeHandle, v_int32 workerIndex) const {
+  return setAffinity(nativeHandle, getWorkerCpus(workerIndex));
+}
+
+v_int32 PlacementPolicy::placeConnectionThread(std::thread::native_handle_type nativeHandle) {
+  if(m_mode == PIN_NONE || m_nodeCpus.empty()) {
+    return setAffinity(nativeHandle, m_workerCpus);
+  }
+  /* Balancing doesn't need to be exact */
+  v_word32 balancer = m_connectionBalancer.load(std::memory_order_relaxed);
+  m_connectionBalancer.store(balancer + 1, std::memory_order_relaxed);
+  return setAffinity(nativeHandle, m_nodeCpus[balancer % m_nodeCpus.size()]);
+}
+
+v_int32 PlacementPolicy::placeAcceptor(std::thread::native_handle_type nativeHandle) const {
+  return setAffinity(nativeHandle, m_reservedCpus);
+}
+  
+}}
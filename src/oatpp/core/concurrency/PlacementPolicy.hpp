@@ -0,0 +1,140 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_concurrency_PlacementPolicy_hpp
+#define oatpp_concurrency_PlacementPolicy_hpp
+
+#include "./Topology.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace oatpp { namespace concurrency {
+
+/**
+ * Placement of threads on CPUs. <br>
+ * The last `reservedCpusCount` CPUs are reserved for accepting connections and IRQ handling - workers don't run there.
+ * Worker threads (executor threads) are pinned according to the mode. Connection threads are pinned to worker CPUs.
+ * Acceptor thread is pinned to the reserved CPUs.
+ */
+class PlacementPolicy {
+public:
+  
+  /**
+   * Workers are not pinned to particular CPUs - they run on any worker CPU.
+   */
+  static constexpr const v_int32 PIN_NONE = 0;
+  
+  /**
+   * Each worker is pinned to one CPU. Workers fill CPUs node by node.
+   */
+  static constexpr const v_int32 PIN_CORE = 1;
+  
+  /**
+   * Each worker is pinned to worker CPUs of one node. Workers are distributed over nodes round-robin.
+   */
+  static constexpr const v_int32 PIN_NODE = 2;
+  
+private:
+  v_int32 setAffinity(std::thread::native_handle_type nativeHandle, const std::vector<v_int32>& cpus) const;
+private:
+  v_int32 m_mode;
+  /* Worker CPUs of each node. Nodes without worker CPUs are skipped */
+  std::vector<std::vector<v_int32>> m_nodeCpus;
+  std::vector<v_int32> m_workerCpus;
+  std::vector<v_int32> m_reservedCpus;
+  std::atomic<v_word32> m_connectionBalancer;
+public:
+  
+  /**
+   * Constructor.
+   * @param mode - &l:PlacementPolicy::PIN_NONE;, &l:PlacementPolicy::PIN_CORE; or &l:PlacementPolicy::PIN_NODE;.
+   * @param reservedCpusCount - number of CPUs reserved for accepting connections and IRQ handling.
+   * At least one CPU is always left to workers.
+   * @param topology - &l:Topology;.
+   */
+  PlacementPolicy(v_int32 mode, v_int32 reservedCpusCount, const Topology& topology = Topology::getInstance());
+  
+  /**
+   * Create shared PlacementPolicy.
+   * @param mode - &l:PlacementPolicy::PIN_NONE;, &l:PlacementPolicy::PIN_CORE; or &l:PlacementPolicy::PIN_NODE;.
+   * @param reservedCpusCount - number of CPUs reserved for accepting connections and IRQ handling.
+   * @return - `std::shared_ptr` to PlacementPolicy.
+   */
+  static std::shared_ptr<PlacementPolicy> createShared(v_int32 mode, v_int32 reservedCpusCount);
+  
+  /**
+   * Get CPUs the worker is pinned to.
+   * @param workerIndex - index of worker thread, for example index of executor thread.
+   * @return
+   */
+  std::vector<v_int32> getWorkerCpus(v_int32 workerIndex) const;
+  
+  /**
+   * Pin worker thread.
+   * @param nativeHandle - native handle of the thread.
+   * @param workerIndex - index of worker thread, for example index of executor thread.
+   * @return - 0 on success. Error code otherwise.
+   */
+  v_int32 placeWorker(std::thread::native_handle_type nativeHandle, v_int32 workerIndex) const;
+  
+  /**
+   * Pin thread serving one connection. Connection threads are distributed over nodes round-robin
+   * if workers are pinned, and may run on any worker CPU otherwise.
+   * @param nativeHandle - native handle of the thread.
+   * @return - 0 on success. Error code otherwise.
+   */
+  v_int32 placeConnectionThread(std::thread::native_handle_type nativeHandle);
+  
+  /**
+   * Pin thread accepting connections to the reserved CPUs. Does nothing if no CPU is reserved.
+   * @param nativeHandle - native handle of the thread.
+   * @return - 0 on success. Error code otherwise.
+   */
+  v_int32 placeAcceptor(std::thread::native_handle_type nativeHandle) const;
+  
+  v_int32 getMode() const {
+    return m_mode;
+  }
+  
+  /**
+   * @return - CPUs workers may run on.
+   */
+  const std::vector<v_int32>& getWorkerCpus() const {
+    return m_workerCpus;
+  }
+  
+  /**
+   * @return - CPUs reserved for accepting connections and IRQ handling.
+   */
+  const std::vector<v_int32>& getReservedCpus() const {
+    return m_reservedCpus;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_concurrency_PlacementPolicy_hpp */
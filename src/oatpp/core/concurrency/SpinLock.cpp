@@ -50,5 +50,9 @@ void SpinLock::lock(Atom& atom) {
 void SpinLock::unlock(Atom& atom) {
   std::atomic_store_explicit(&atom, false, std::memory_order_release);
 }
+
+bool SpinLock::tryLock(Atom& atom) {
+  return !std::atomic_exchange_explicit(&atom, true, std::memory_order_acquire);
+}
   
 }}
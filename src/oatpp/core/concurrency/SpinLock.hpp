@@ -43,6 +43,13 @@ public:
   static void lock(Atom& atom);
   static void unlock(Atom& atom);
   
+  /**
+   * Lock the atom if it's not locked.
+   * @param atom
+   * @return - true if the atom was locked by this call.
+   */
+  static bool tryLock(Atom& atom);
+  
 };
   
 }}
@@ -56,6 +56,36 @@ v_int32 Thread::setThreadAffinityToCpuRange(std::thread::native_handle_type nati
 #endif
 }
   
+v_int32 Thread::setThreadAffinityToCpus(std::thread::native_handle_type nativeHandle, const std::vector<v_int32>& cpus) {
+#if defined(_GNU_SOURCE)
+  
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  
+  for(v_int32 cpu : cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  
+  v_int32 result = pthread_setaffinity_np(nativeHandle, sizeof(cpu_set_t), &cpuset);
+  
+  if (result != 0) {
+    OATPP_LOGD("[oatpp::concurrency::Thread::setThreadAffinityToCpus(...)]", "error code - %d", result);
+  }
+  
+  return result;
+#else
+  return -1;
+#endif
+}
+  
+std::thread::native_handle_type Thread::getCurrentNativeHandle() {
+#if defined(_GNU_SOURCE)
+  return pthread_self();
+#else
+  return std::thread::native_handle_type();
+#endif
+}
+  
 v_int32 Thread::calcHardwareConcurrency() {
 #if !defined(OATPP_THREAD_HARDWARE_CONCURRENCY)
   v_int32 concurrency = std::thread::hardware_concurrency();
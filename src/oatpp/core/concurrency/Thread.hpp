@@ -31,6 +31,7 @@
 #include "oatpp/core/base/Countable.hpp"
 
 #include <thread>
+#include <vector>
 
 namespace oatpp { namespace concurrency {
   
@@ -53,6 +54,16 @@ public:
    */
   static v_int32 setThreadAffinityToCpuRange(std::thread::native_handle_type nativeHandle, v_int32 fromCpu, v_int32 toCpu);
   
+  /**
+   * Set thread affinity to the list of CPUs.
+   */
+  static v_int32 setThreadAffinityToCpus(std::thread::native_handle_type nativeHandle, const std::vector<v_int32>& cpus);
+  
+  /**
+   * Get native handle of the calling thread.
+   */
+  static std::thread::native_handle_type getCurrentNativeHandle();
+  
   /**
    * returns OATPP_THREAD_HARDWARE_CONCURRENCY config value if set.
    * else return std::thread::hardware_concurrency()
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "Topology.hpp"
+
+#include "./Thread.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(_GNU_SOURCE)
+  #include <sched.h>
+#endif
+
+namespace oatpp { namespace concurrency {
+
+std::vector<v_int32> Topology::parseCpuList(const std::string& cpuList) {
+  /* Format: "0-3,8,10-11" */
+  std::vector<v_int32> cpus;
+  std::stringstream stream(cpuList);
+  std::string range;
+  while(std::getline(stream, range, ',')) {
+    if(range.empty() || range[0] < '0' || range[0] > '9') {
+      continue;
+    }
+    v_int32 from = std::atoi(range.c_str());
+    v_int32 to = from;
+    size_t dash = range.find('-');
+    if(dash != std::string::npos) {
+      to = std::atoi(range.c_str() + dash + 1);
+    }
+    for(v_int32 cpu = from; cpu <= to; cpu ++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<v_int32> Topology::getAllowedCpus() {
+  std::vector<v_int32> cpus;
+#if defined(_GNU_SOURCE)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if(sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for(v_int32 cpu = 0; cpu < CPU_SETSIZE; cpu ++) {
+      if(CPU_ISSET(cpu, &cpuset)) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+#endif
+  v_int32 concurrency = Thread::getHardwareConcurrency();
+  for(v_int32 cpu = 0; cpu < concurrency; cpu ++) {
+    cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+Topology::Topology() {
+
+  std::vector<v_int32> allowedCpus = getAllowedCpus();
+  std::vector<std::vector<v_int32>> nodes;
+
+  /* Node indexes may have gaps. Stop after a long run of missing nodes */
+  for(v_int32 node = 0, missing = 0; missing < 64; node ++) {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if(!file.is_open()) {
+      missing ++;
+      continue;
+    }
+    missing = 0;
+    std::string cpuList;
+    std::getline(file, cpuList);
+    std::vector<v_int32> nodeCpus;
+    for(v_int32 cpu : parseCpuList(cpuList)) {
+      if(std::binary_search(allowedCpus.begin(), allowedCpus.end(), cpu)) {
+        nodeCpus.push_back(cpu);
+      }
+    }
+    nodes.push_back(nodeCpus);
+  }
+
+  *this = Topology(nodes);
+
+  if(m_nodes.empty()) {
+    /* No NUMA information */
+    *this = Topology({allowedCpus});
+  }
+
+}
+
+Topology::Topology(const std::vector<std::vector<v_int32>>& nodes) {
+  for(const std::vector<v_int32>& cpus : nodes) {
+    if(cpus.empty()) {
+      continue;
+    }
+    std::vector<v_int32> sortedCpus(cpus);
+    std::sort(sortedCpus.begin(), sortedCpus.end());
+    for(v_int32 cpu : sortedCpus) {
+      if(cpu >= (v_int32) m_cpuNodes.size()) {
+        m_cpuNodes.resize(cpu + 1, 0);
+      }
+      m_cpuNodes[cpu] = (v_int32) m_nodes.size();
+    }
+    m_nodes.push_back(sortedCpus);
+  }
+}
+
+const Topology& Topology::getInstance() {
+  static Topology topology;
+  return topology;
+}
+
+v_int32 Topology::getCurrentCpu() {
+#if defined(_GNU_SOURCE)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+v_int32 Topology::getCurrentNode() const {
+  return getNodeOfCpu(getCurrentCpu());
+}
+
+v_int32 Topology::getNodeOfCpu(v_int32 cpu) const {
+  if(cpu < 0 || cpu >= (v_int32) m_cpuNodes.size()) {
+    return 0;
+  }
+  return m_cpuNodes[cpu];
+}
+
+v_int32 Topology::getCpusCount() const {
+  v_int32 count = 0;
+  for(const std::vector<v_int32>& cpus : m_nodes) {
+    count += (v_int32) cpus.size();
+  }
+  return count;
+}
+  
+}}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#ifndef oatpp_concurrency_Topology_hpp
+#define oatpp_concurrency_Topology_hpp
+
+#include "oatpp/core/base/Environment.hpp"
+
+#include <vector>
+
+namespace oatpp { namespace concurrency {
+
+/**
+ * CPUs available to the process grouped by NUMA node. <br>
+ * On Linux nodes are read from `/sys/devices/system/node`. CPUs excluded by the process affinity mask are skipped.
+ * If NUMA information is not available all CPUs belong to node 0.
+ */
+class Topology {
+private:
+  static std::vector<v_int32> parseCpuList(const std::string& cpuList);
+  static std::vector<v_int32> getAllowedCpus();
+private:
+  std::vector<std::vector<v_int32>> m_nodes;
+  std::vector<v_int32> m_cpuNodes;
+public:
+  
+  /**
+   * Detect topology of the current machine.
+   */
+  Topology();
+  
+  /**
+   * Constructor. Used to describe a topology explicitly.
+   * @param nodes - CPUs of each node. Empty nodes are skipped.
+   */
+  Topology(const std::vector<std::vector<v_int32>>& nodes);
+  
+  /**
+   * Get topology of the current machine. Detected once.
+   * @return
+   */
+  static const Topology& getInstance();
+  
+  /**
+   * Get CPU the calling thread is running on.
+   * @return - CPU index or -1 if not available.
+   */
+  static v_int32 getCurrentCpu();
+  
+  /**
+   * Get node of the CPU the calling thread is running on.
+   * @return - node index or 0 if not available.
+   */
+  v_int32 getCurrentNode() const;
+  
+  v_int32 getNodesCount() const {
+    return (v_int32) m_nodes.size();
+  }
+  
+  /**
+   * @param node - node index in range [0, getNodesCount()).
+   * @return - CPUs of the node in ascending order.
+   */
+  const std::vector<v_int32>& getNodeCpus(v_int32 node) const {
+    return m_nodes[node];
+  }
+  
+  /**
+   * @param cpu
+   * @return - node of the CPU or 0 if CPU is unknown.
+   */
+  v_int32 getNodeOfCpu(v_int32 cpu) const;
+  
+  /**
+   * @return - number of CPUs in all nodes.
+   */
+  v_int32 getCpusCount() const;
+  
+};
+  
+}}
+
+#endif /* oatpp_concurrency_Topology_hpp */
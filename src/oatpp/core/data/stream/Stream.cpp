@@ -25,12 +25,86 @@
 #include "./Stream.hpp"
 #include "oatpp/core/utils/ConversionUtils.hpp"
 
+#include <unistd.h>
+#include <cerrno>
+
 namespace oatpp { namespace data{ namespace stream {
 
 const char* const Errors::ERROR_ASYNC_BROKEN_PIPE = "[oatpp::data::stream{}]: Error. AsyncIO. Broken pipe.";
 const char* const Errors::ERROR_ASYNC_BAD_RESULT = "[oatpp::data::stream{}]: Error. AsyncIO. Bad result code. Operation returned 0.";
 const char* const Errors::ERROR_ASYNC_UNKNOWN_CODE = "[oatpp::data::stream{}]: Error. AsyncIO. Unknown error code returned";
+
+namespace {
+
+  oatpp::async::Action asyncActionOnIOError(data::v_io_size res) {
+    switch (res) {
+      case IOError::WAIT_RETRY:
+        return oatpp::async::Action::_WAIT_RETRY;
+      case IOError::RETRY:
+        return oatpp::async::Action::_REPEAT;
+      case IOError::BROKEN_PIPE:
+        return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_BROKEN_PIPE));
+      case IOError::ZERO_VALUE:
+        return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_BAD_RESULT));
+    }
+    return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_UNKNOWN_CODE));
+  }
+
+  /**
+   * Skip fully written vectors and advance the partially written one.
+   */
+  void consumeVectors(IOVector*& vectors, v_int32& count, data::v_io_size bytesWritten) {
+    while(count > 0 && bytesWritten >= vectors->size) {
+      bytesWritten -= vectors->size;
+      vectors ++;
+      count --;
+    }
+    if(count > 0 && bytesWritten > 0) {
+      vectors->data = &((p_char8) vectors->data)[bytesWritten];
+      vectors->size -= bytesWritten;
+    }
+  }
+
+}
+
+data::v_io_size OutputStream::writev(const IOVector* vectors, v_int32 count) {
+  data::v_io_size progress = 0;
+  for(v_int32 i = 0; i < count; i ++) {
+    if(vectors[i].size == 0) {
+      continue;
+    }
+    auto res = write(vectors[i].data, vectors[i].size);
+    if(res <= 0) {
+      return progress > 0 ? progress : res;
+    }
+    progress += res;
+    if(res < vectors[i].size) {
+      break;
+    }
+  }
+  return progress;
+}
+
   
+data::v_io_size OutputStream::writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) {
+
+  v_char8 buffer[4096];
+  if(count > (data::v_io_size) sizeof(buffer)) {
+    count = sizeof(buffer);
+  }
+
+  auto readResult = ::pread(fileHandle, buffer, (size_t) count, (off_t) offset);
+  if(readResult <= 0) {
+    if(readResult < 0 && errno == EINTR) {
+      return data::IOError::RETRY;
+    }
+    return data::IOError::BROKEN_PIPE; // read error or file is shorter than expected
+  }
+
+  return write(buffer, readResult);
+
+}
+
 data::v_io_size OutputStream::writeAsString(v_int32 value){
   v_char8 a[100];
   v_int32 size = utils::conversion::int32ToCharSequence(value, &a[0]);
@@ -75,6 +149,14 @@ data::v_io_size OutputStream::writeAsString(bool value) {
   }
 }
   
+oatpp::async::Action OutputStream::suggestOutputStreamAction(data::v_io_size ioResult) {
+  return asyncActionOnIOError(ioResult);
+}
+
+oatpp::async::Action InputStream::suggestInputStreamAction(data::v_io_size ioResult) {
+  return asyncActionOnIOError(ioResult);
+}
+  
 // Functions
   
 OutputStream& operator << (OutputStream& s, const oatpp::String& str) {
@@ -304,23 +386,6 @@ oatpp::async::Action transferAsync(oatpp::async::AbstractCoroutine* parentCorout
   
 }
 
-namespace {
-
-  oatpp::async::Action asyncActionOnIOError(data::v_io_size res) {
-    switch (res) {
-      case IOError::WAIT_RETRY:
-        return oatpp::async::Action::_WAIT_RETRY;
-      case IOError::RETRY:
-        return oatpp::async::Action::_REPEAT;
-      case IOError::BROKEN_PIPE:
-        return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_BROKEN_PIPE));
-      case IOError::ZERO_VALUE:
-        return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_BAD_RESULT));
-    }
-    return oatpp::async::Action(oatpp::async::Error(Errors::ERROR_ASYNC_UNKNOWN_CODE));
-  }
-
-}
   
 oatpp::async::Action writeExactSizeDataAsyncInline(oatpp::data::stream::OutputStream* stream,
                                                    const void*& data,
@@ -335,7 +400,27 @@ oatpp::async::Action writeExactSizeDataAsyncInline(oatpp::data::stream::OutputSt
         return oatpp::async::Action::_REPEAT;
       }
     } else {
-      return asyncActionOnIOError(res);
+      return stream->suggestOutputStreamAction(res);
+    }
+  }
+  return nextAction;
+
+}
+
+oatpp::async::Action writeExactSizeDataVAsyncInline(oatpp::data::stream::OutputStream* stream,
+                                                    IOVector*& vectors,
+                                                    v_int32& count,
+                                                    const oatpp::async::Action& nextAction) {
+  consumeVectors(vectors, count, 0);
+  if(count > 0) {
+    auto res = stream->writev(vectors, count);
+    if(res > 0) {
+      consumeVectors(vectors, count, res);
+      if (count > 0) {
+        return oatpp::async::Action::_REPEAT;
+      }
+    } else {
+      return stream->suggestOutputStreamAction(res);
     }
   }
   return nextAction;
@@ -353,7 +438,7 @@ oatpp::async::Action readSomeDataAsyncInline(oatpp::data::stream::InputStream* s
       data = &((p_char8) data)[res];
       size -= res;
     } else {
-      return asyncActionOnIOError(res);
+      return stream->suggestInputStreamAction(res);
     }
   }
   return nextAction;
@@ -373,7 +458,7 @@ oatpp::async::Action readExactSizeDataAsyncInline(oatpp::data::stream::InputStre
         return oatpp::async::Action::_REPEAT;
       }
     } else {
-      return asyncActionOnIOError(res);
+      return stream->suggestInputStreamAction(res);
     }
   }
   return nextAction;
@@ -426,4 +511,28 @@ oatpp::data::v_io_size writeExactSizeData(oatpp::data::stream::OutputStream* str
   return progress;
 }
   
+oatpp::data::v_io_size writeExactSizeDataV(oatpp::data::stream::OutputStream* stream, IOVector* vectors, v_int32 count) {
+
+  oatpp::data::v_io_size progress = 0;
+  consumeVectors(vectors, count, 0);
+
+  while (count > 0) {
+
+    auto res = stream->writev(vectors, count);
+
+    if(res > 0) {
+      progress += res;
+      consumeVectors(vectors, count, res);
+    } else { // if res == 0 then probably stream handles writev() error incorrectly. return.
+      if(res == data::IOError::RETRY || res == data::IOError::WAIT_RETRY) {
+        continue;
+      }
+      return progress;
+    }
+
+  }
+
+  return progress;
+}
+
 }}}
@@ -52,6 +52,14 @@ public:
 
 };
   
+/**
+ * Reference to a contiguous block of data for gather-write - &l:OutputStream::writev ();.
+ */
+struct IOVector {
+  const void* data;
+  data::v_io_size size;
+};
+
 class OutputStream {
 public:
   
@@ -60,6 +68,31 @@ public:
    * It is a legal case if return result < count. Caller should handle this!
    */
   virtual data::v_io_size write(const void *data, data::v_io_size count) = 0;
+
+  /**
+   * Gather-write. Write data of vectors in order up to the total size of vectors,
+   * and return number of bytes actually written.
+   * It is a legal case if return result < total size. Caller should handle this!
+   * Default implementation calls write() for each vector and returns on the first partial write.
+   * Streams backed by I/O handle should override it with a single system call.
+   * @param vectors - array of vectors.
+   * @param count - number of vectors.
+   * @return - [1..total size], IOErrors.
+   */
+  virtual data::v_io_size writev(const IOVector* vectors, v_int32 count);
+
+  /**
+   * Write up to count bytes of file starting at offset, and return number of bytes actually written.
+   * It is a legal case if return result < count. Caller should handle this!
+   * File position of fileHandle is not changed.
+   * Default implementation reads file with `pread` and calls write().
+   * Streams backed by socket should override it with `sendfile`.
+   * @param fileHandle - handle of a regular file.
+   * @param offset - file offset to write data from.
+   * @param count - number of bytes to write.
+   * @return - [1..count], IOErrors.
+   */
+  virtual data::v_io_size writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count);
   
   data::v_io_size write(const char* data){
     return write((p_char8)data, std::strlen(data));
@@ -73,6 +106,15 @@ public:
     return write(&c, 1);
   }
   
+  /**
+   * Get async action which coroutine should take when write() returned an error.
+   * Default implementation has no I/O handle to wait on - IOError::WAIT_RETRY is mapped to Action::_WAIT_RETRY.
+   * Streams backed by I/O handle should return Action::createIOWaitAction(...) instead.
+   * @param ioResult - error returned by write().
+   * @return - async action.
+   */
+  virtual oatpp::async::Action suggestOutputStreamAction(data::v_io_size ioResult);
+  
   data::v_io_size writeAsString(v_int32 value);
   data::v_io_size writeAsString(v_int64 value);
   data::v_io_size writeAsString(v_float32 value);
@@ -88,6 +130,15 @@ public:
    * It is a legal case if return result < count. Caller should handle this!
    */
   virtual data::v_io_size read(void *data, data::v_io_size count) = 0;
+  
+  /**
+   * Get async action which coroutine should take when read() returned an error.
+   * Default implementation has no I/O handle to wait on - IOError::WAIT_RETRY is mapped to Action::_WAIT_RETRY.
+   * Streams backed by I/O handle should return Action::createIOWaitAction(...) instead.
+   * @param ioResult - error returned by read().
+   * @return - async action.
+   */
+  virtual oatpp::async::Action suggestInputStreamAction(data::v_io_size ioResult);
 };
   
 class IOStream : public InputStream, public OutputStream {
@@ -118,10 +169,26 @@ public:
   data::v_io_size write(const void *data, data::v_io_size count) override {
     return m_outputStream->write(data, count);
   }
+
+  data::v_io_size writev(const IOVector* vectors, v_int32 count) override {
+    return m_outputStream->writev(vectors, count);
+  }
+
+  data::v_io_size writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) override {
+    return m_outputStream->writeFile(fileHandle, offset, count);
+  }
   
   data::v_io_size read(void *data, data::v_io_size count) override {
     return m_inputStream->read(data, count);
   }
+  
+  oatpp::async::Action suggestOutputStreamAction(data::v_io_size ioResult) override {
+    return m_outputStream->suggestOutputStreamAction(ioResult);
+  }
+  
+  oatpp::async::Action suggestInputStreamAction(data::v_io_size ioResult) override {
+    return m_inputStream->suggestInputStreamAction(ioResult);
+  }
     
 };
   
@@ -170,6 +237,15 @@ oatpp::async::Action writeExactSizeDataAsyncInline(oatpp::data::stream::OutputSt
                                                    data::v_io_size& size,
                                                    const oatpp::async::Action& nextAction);
 
+/**
+ * Same as writeExactSizeDataAsyncInline but for gather-write.
+ * vectors and count are advanced as data is written - vectors are modified in place.
+ */
+oatpp::async::Action writeExactSizeDataVAsyncInline(oatpp::data::stream::OutputStream* stream,
+                                                    IOVector*& vectors,
+                                                    v_int32& count,
+                                                    const oatpp::async::Action& nextAction);
+
 oatpp::async::Action readSomeDataAsyncInline(oatpp::data::stream::InputStream* stream,
                                              void*& data,
                                              data::v_io_size& bytesLeftToRead,
@@ -193,6 +269,14 @@ oatpp::data::v_io_size readExactSizeData(oatpp::data::stream::InputStream* strea
  * return result can be < size only in case of some disaster like broken pipe
  */
 oatpp::data::v_io_size writeExactSizeData(oatpp::data::stream::OutputStream* stream, const void* data, data::v_io_size size);
+
+/**
+ * Write all data of vectors to stream using gather-write.
+ * vectors are modified in place as data is written.
+ * returns exact amount of bytes was written.
+ * return result can be < total size only in case of some disaster like broken pipe
+ */
+oatpp::data::v_io_size writeExactSizeDataV(oatpp::data::stream::OutputStream* stream, IOVector* vectors, v_int32 count);
   
 }}}
 
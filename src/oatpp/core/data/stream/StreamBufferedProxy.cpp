@@ -38,6 +38,34 @@ data::v_io_size OutputStreamBufferedProxy::write(const void *data, data::v_io_si
   }
 }
 
+data::v_io_size OutputStreamBufferedProxy::writev(const IOVector* vectors, v_int32 count) {
+  auto bytesBuffered = m_buffer.availableToRead();
+  if(bytesBuffered > 0) {
+    auto bytesFlushed = m_buffer.readAndWriteToStream(*m_outputStream, bytesBuffered);
+    if(bytesFlushed > 0) {
+      return data::IOError::RETRY;
+    }
+    return bytesFlushed;
+  }
+  return m_outputStream->writev(vectors, count);
+}
+
+data::v_io_size OutputStreamBufferedProxy::writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) {
+  auto bytesBuffered = m_buffer.availableToRead();
+  if(bytesBuffered > 0) {
+    auto bytesFlushed = m_buffer.readAndWriteToStream(*m_outputStream, bytesBuffered);
+    if(bytesFlushed > 0) {
+      return data::IOError::RETRY;
+    }
+    return bytesFlushed;
+  }
+  return m_outputStream->writeFile(fileHandle, offset, count);
+}
+
+oatpp::async::Action OutputStreamBufferedProxy::suggestOutputStreamAction(data::v_io_size ioResult) {
+  return m_outputStream->suggestOutputStreamAction(ioResult);
+}
+
 data::v_io_size OutputStreamBufferedProxy::flush() {
   return m_buffer.flushToStream(*m_outputStream);
 }
@@ -60,5 +88,9 @@ data::v_io_size InputStreamBufferedProxy::read(void *data, data::v_io_size count
   }
   
 }
+
+oatpp::async::Action InputStreamBufferedProxy::suggestInputStreamAction(data::v_io_size ioResult) {
+  return m_inputStream->suggestInputStreamAction(ioResult);
+}
   
 }}}
@@ -73,6 +73,19 @@ public:
   }
   
   data::v_io_size write(const void *data, data::v_io_size count) override;
+
+  /**
+   * Pass vectors directly to the underlying stream without copying them to the buffer.
+   * If the buffer is not empty, buffered data is flushed first and IOError::RETRY is returned.
+   */
+  data::v_io_size writev(const IOVector* vectors, v_int32 count) override;
+
+  /**
+   * Pass file directly to the underlying stream. Buffered data is flushed first - same as for writev().
+   */
+  data::v_io_size writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) override;
+
+  oatpp::async::Action suggestOutputStreamAction(data::v_io_size ioResult) override;
   data::v_io_size flush();
   oatpp::async::Action flushAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                    const oatpp::async::Action& actionOnFinish);
@@ -160,6 +173,7 @@ public:
   }
   
   data::v_io_size read(void *data, data::v_io_size count) override;
+  oatpp::async::Action suggestInputStreamAction(data::v_io_size ioResult) override;
 
   void setBufferPosition(data::v_io_size readPosition, data::v_io_size writePosition, bool canRead) {
     m_buffer.setBufferPosition(readPosition, writePosition, canRead);
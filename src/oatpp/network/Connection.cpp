@@ -24,15 +24,135 @@
 
 #include "./Connection.hpp"
 
+#include "oatpp/core/async/Fiber.hpp"
+#include "oatpp/core/async/IOEventPoller.hpp"
+
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+
+#if defined(__linux__)
+  #include <sys/sendfile.h>
+  #include <signal.h>
+  #include <pthread.h>
+  #include <ctime>
+#endif
+
 #include <thread>
 #include <chrono>
+#include <cstring>
 
 namespace oatpp { namespace network {
 
+#if defined(__linux__)
+namespace {
+
+  /**
+   * Check if SIGPIPE can't interrupt the calling thread - it's ignored by the process or blocked for the thread.
+   * Checked once per thread - application is expected to set up SIGPIPE handling before it starts the I/O.
+   */
+  bool isPipeSignalSuppressed() {
+    static thread_local const bool suppressed = [] {
+      struct sigaction action;
+      if(sigaction(SIGPIPE, nullptr, &action) == 0 && action.sa_handler == SIG_IGN) {
+        return true;
+      }
+      sigset_t currentSet;
+      return pthread_sigmask(SIG_BLOCK, nullptr, &currentSet) == 0 && sigismember(&currentSet, SIGPIPE) == 1;
+    }();
+    return suppressed;
+  }
+
+  /**
+   * There is no MSG_NOSIGNAL for `sendfile`. Block SIGPIPE for the calling thread during the call,
+   * and discard SIGPIPE raised by the call - same as MSG_NOSIGNAL for `send`.
+   * Signal mask is not touched if SIGPIPE is suppressed already (see isPipeSignalSuppressed()).
+   */
+  ssize_t sendFileNoSignal(data::v_io_handle outHandle, data::v_io_handle fileHandle, off_t* offset, size_t count) {
+
+    if(isPipeSignalSuppressed()) {
+      return ::sendfile(outHandle, fileHandle, offset, count);
+    }
+
+    sigset_t pipeSet;
+    sigset_t oldSet;
+    sigemptyset(&pipeSet);
+    sigaddset(&pipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+
+    auto result = ::sendfile(outHandle, fileHandle, offset, count);
+    auto e = errno;
+
+    if(result < 0 && e == EPIPE && !sigismember(&oldSet, SIGPIPE)) {
+      struct timespec zeroTimeout = {0, 0};
+      while(sigtimedwait(&pipeSet, nullptr, &zeroTimeout) < 0 && errno == EINTR) {}
+    }
+
+    pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
+    errno = e;
+    return result;
+
+  }
+
+}
+#endif
+
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+namespace {
+
+  /**
+   * Copy data to the send operation and submit it if called from a coroutine of io_uring processor.
+   * Previous send has to complete first - data goes out in order.
+   * @return - `false` if data should be written with a syscall.
+   */
+  bool writeThroughRing(oatpp::async::IOUringOperation*& operation, data::v_io_handle handle,
+                        const data::stream::IOVector* vectors, v_int32 count, data::v_io_size& result)
+  {
+
+    auto ring = oatpp::async::IOUringEventPoller::getCurrentRing();
+    if(operation == nullptr) {
+      if(ring == nullptr) {
+        return false;
+      }
+      operation = new oatpp::async::IOUringOperation(handle, oatpp::async::Action::IO_EVENT_WRITE);
+    }
+
+    result = operation->prepareWrite();
+    if(result != 0) {
+      return true;
+    }
+
+    if(ring == nullptr) {
+      return false;
+    }
+
+    data::v_io_size size = 0;
+    for(v_int32 i = 0; i < count; i ++) {
+      size += vectors[i].size;
+    }
+    if(size <= 0 || size > operation->getAvailableSize()) {
+      return false;
+    }
+
+    for(v_int32 i = 0; i < count; i ++) {
+      operation->append(vectors[i].data, (v_int32) vectors[i].size);
+    }
+    if(!operation->submitWrite(ring)) {
+      return false;
+    }
+
+    result = size;
+    return true;
+
+  }
+
+}
+#endif
+
 Connection::Connection(data::v_io_handle handle)
   : m_handle(handle)
+  , m_readOperation(nullptr)
+  , m_writeOperation(nullptr)
 {
 }
 
@@ -40,8 +160,38 @@ Connection::~Connection(){
   close();
 }
 
+data::v_io_size Connection::waitInFiber(v_int32 ioEventType) {
+  oatpp::async::Fiber* fiber = oatpp::async::Fiber::getCurrent();
+  if(fiber == nullptr) {
+    return data::IOError::WAIT_RETRY; // For async io. In case socket is non_blocking
+  }
+  if(fiber->suspend(getWaitAction(ioEventType))) {
+    return data::IOError::RETRY;
+  }
+  return data::IOError::BROKEN_PIPE;
+}
+
+oatpp::async::Action Connection::getWaitAction(v_int32 ioEventType) {
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  auto operation = ioEventType == oatpp::async::Action::IO_EVENT_WRITE ? m_writeOperation : m_readOperation;
+  if(operation != nullptr && operation->isInFlightElsewhere(oatpp::async::IOEventPoller::getCurrent())) {
+    /* Coroutine has moved to another processor. Completion can't resume it here */
+    return oatpp::async::Action::_WAIT_RETRY;
+  }
+#endif
+  return oatpp::async::Action::createIOWaitAction(m_handle, ioEventType);
+}
+
 data::v_io_size Connection::write(const void *buff, data::v_io_size count){
 
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  data::stream::IOVector vector = {buff, count};
+  data::v_io_size submitted;
+  if(writeThroughRing(m_writeOperation, m_handle, &vector, 1, submitted)) {
+    return submitted == data::IOError::WAIT_RETRY ? waitInFiber(oatpp::async::Action::IO_EVENT_WRITE) : submitted;
+  }
+#endif
+
   errno = 0;
 
   v_int32 flags = 0;
@@ -53,7 +203,7 @@ data::v_io_size Connection::write(const void *buff, data::v_io_size count){
   if(result <= 0) {
     auto e = errno;
     if(e == EAGAIN || e == EWOULDBLOCK){
-      return data::IOError::WAIT_RETRY; // For async io. In case socket is non_blocking
+      return waitInFiber(oatpp::async::Action::IO_EVENT_WRITE);
     } else if(e == EINTR) {
       return data::IOError::RETRY;
     } else if(e == EPIPE) {
@@ -65,13 +215,112 @@ data::v_io_size Connection::write(const void *buff, data::v_io_size count){
   return result;
 }
 
+data::v_io_size Connection::writev(const data::stream::IOVector* vectors, v_int32 count) {
+
+  if(count > MAX_VECTORS_PER_CALL) {
+    count = MAX_VECTORS_PER_CALL;
+  }
+
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  data::v_io_size submitted;
+  if(writeThroughRing(m_writeOperation, m_handle, vectors, count, submitted)) {
+    return submitted == data::IOError::WAIT_RETRY ? waitInFiber(oatpp::async::Action::IO_EVENT_WRITE) : submitted;
+  }
+#endif
+
+  struct iovec iov[MAX_VECTORS_PER_CALL];
+  for(v_int32 i = 0; i < count; i ++) {
+    iov[i].iov_base = (void*) vectors[i].data;
+    iov[i].iov_len = (size_t) vectors[i].size;
+  }
+
+  struct msghdr message;
+  std::memset(&message, 0, sizeof(message));
+  message.msg_iov = iov;
+  message.msg_iovlen = count;
+
+  errno = 0;
+
+  v_int32 flags = 0;
+#ifdef MSG_NOSIGNAL
+  flags |= MSG_NOSIGNAL;
+#endif
+  auto result = ::sendmsg(m_handle, &message, flags);
+
+  if(result <= 0) {
+    auto e = errno;
+    if(e == EAGAIN || e == EWOULDBLOCK){
+      return waitInFiber(oatpp::async::Action::IO_EVENT_WRITE);
+    } else if(e == EINTR) {
+      return data::IOError::RETRY;
+    } else if(e == EPIPE) {
+      return data::IOError::BROKEN_PIPE;
+    }
+  }
+  return result;
+}
+
+data::v_io_size Connection::writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) {
+
+#if defined(__linux__)
+
+#if defined(OATPP_ASYNC_IO_URING)
+  if(m_writeOperation != nullptr) {
+    auto res = m_writeOperation->prepareWrite();
+    if(res == data::IOError::WAIT_RETRY) {
+      return waitInFiber(oatpp::async::Action::IO_EVENT_WRITE);
+    } else if(res != 0) {
+      return res;
+    }
+  }
+#endif
+
+  errno = 0;
+
+  off_t fileOffset = (off_t) offset;
+  auto result = sendFileNoSignal(m_handle, fileHandle, &fileOffset, (size_t) count);
+
+  if(result <= 0) {
+    auto e = errno;
+    if(e == EAGAIN || e == EWOULDBLOCK){
+      return waitInFiber(oatpp::async::Action::IO_EVENT_WRITE);
+    } else if(e == EINTR) {
+      return data::IOError::RETRY;
+    } else if(e == EPIPE) {
+      return data::IOError::BROKEN_PIPE;
+    } else if(e == EINVAL || e == ENOSYS) {
+      return OutputStream::writeFile(fileHandle, offset, count); // file can't be sent by sendfile
+    } else if(result == 0) {
+      return data::IOError::BROKEN_PIPE; // file is shorter than expected
+    }
+  }
+  return result;
+
+#else
+  return OutputStream::writeFile(fileHandle, offset, count);
+#endif
+
+}
+
 data::v_io_size Connection::read(void *buff, data::v_io_size count){
+
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  auto ring = oatpp::async::IOUringEventPoller::getCurrentRing();
+  if(m_readOperation == nullptr && ring != nullptr) {
+    m_readOperation = new oatpp::async::IOUringOperation(m_handle, oatpp::async::Action::IO_EVENT_READ);
+  }
+  data::v_io_size received;
+  if(m_readOperation != nullptr && m_readOperation->read(ring, buff, count, received)) {
+    return received == data::IOError::WAIT_RETRY ? waitInFiber(oatpp::async::Action::IO_EVENT_READ) : received;
+  }
+#endif
+
   errno = 0;
   auto result = ::read(m_handle, buff, count);
   if(result <= 0) {
     auto e = errno;
     if(e == EAGAIN || e == EWOULDBLOCK){
-      return data::IOError::WAIT_RETRY; // For async io. In case socket is non_blocking
+      return waitInFiber(oatpp::async::Action::IO_EVENT_READ);
     } else if(e == EINTR) {
       return data::IOError::RETRY;
     } else if(e == ECONNRESET) {
@@ -83,7 +332,34 @@ data::v_io_size Connection::read(void *buff, data::v_io_size count){
   return result;
 }
 
+oatpp::async::Action Connection::suggestOutputStreamAction(data::v_io_size ioResult) {
+  if(ioResult == data::IOError::WAIT_RETRY) {
+    return getWaitAction(oatpp::async::Action::IO_EVENT_WRITE);
+  }
+  return OutputStream::suggestOutputStreamAction(ioResult);
+}
+
+oatpp::async::Action Connection::suggestInputStreamAction(data::v_io_size ioResult) {
+  if(ioResult == data::IOError::WAIT_RETRY) {
+    return getWaitAction(oatpp::async::Action::IO_EVENT_READ);
+  }
+  return InputStream::suggestInputStreamAction(ioResult);
+}
+
 void Connection::close(){
+#if defined(__linux__) && defined(OATPP_ASYNC_IO_URING)
+  if(m_readOperation != nullptr && m_readOperation->isInFlight()) {
+    ::shutdown(m_handle, SHUT_RD); // completes receive in flight
+  }
+  /* Handle of the operation still in flight is closed by the poller once the operation completes */
+  bool handleReleased = oatpp::async::IOUringOperation::release(m_writeOperation, true);
+  handleReleased = oatpp::async::IOUringOperation::release(m_readOperation, !handleReleased) || handleReleased;
+  m_readOperation = nullptr;
+  m_writeOperation = nullptr;
+  if(handleReleased) {
+    return;
+  }
+#endif
   ::close(m_handle);
 }
 
@@ -28,14 +28,44 @@
 #include "oatpp/core/base/memory/ObjectPool.hpp"
 #include "oatpp/core/data/stream/Stream.hpp"
 
+namespace oatpp { namespace async {
+
+class IOUringOperation; // FWD
+
+}}
+
 namespace oatpp { namespace network {
-  
+
+/**
+ * Socket connection. <br>
+ * When built with `OATPP_ASYNC_IO_URING` and called from a coroutine of a processor with io_uring engine,
+ * reads and writes are submitted to the ring as receives and sends (see &id:oatpp::async::IOUringOperation;):
+ * <ul>
+ *   <li>Read of a connection with no received data submits a receive to the ring and returns IOError::WAIT_RETRY.
+ *   Coroutine is resumed once the receive completes. Next reads are served from the received data.</li>
+ *   <li>Write of up to &id:oatpp::async::IOUringOperation::BUFFER_SIZE; bytes copies data and submits a send.
+ *   Next write returns IOError::WAIT_RETRY until the send completes. Larger writes are made with a syscall.</li>
+ *   <li>Send in flight when the connection is closed still completes - the handle is closed once it's done.</li>
+ * </ul>
+ */
 class Connection : public oatpp::base::Countable, public oatpp::data::stream::IOStream {
 public:
   OBJECT_POOL(Connection_Pool, Connection, 32);
   SHARED_OBJECT_POOL(Shared_Connection_Pool, Connection, 32);
+private:
+  /**
+   * Max number of vectors passed to a single `sendmsg` call.
+   */
+  static constexpr const v_int32 MAX_VECTORS_PER_CALL = 64;
 private:
   data::v_io_handle m_handle;
+  oatpp::async::IOUringOperation* m_readOperation;
+  oatpp::async::IOUringOperation* m_writeOperation;
+private:
+  /* Action to wait until I/O call can be repeated */
+  oatpp::async::Action getWaitAction(v_int32 ioEventType);
+  /* Called on EAGAIN. If running in &id:oatpp::async::Fiber; - suspend fiber until ready and return RETRY */
+  data::v_io_size waitInFiber(v_int32 ioEventType);
 public:
   Connection(data::v_io_handle handle);
 public:
@@ -46,9 +76,41 @@ public:
   
   ~Connection();
   
+  /**
+   * Write data to connection. If connection is non-blocking and is not writable:
+   * when called from &id:oatpp::async::Fiber; - fiber is suspended until connection is writable and IOError::RETRY is returned,
+   * otherwise IOError::WAIT_RETRY is returned.
+   */
   data::v_io_size write(const void *buff, data::v_io_size count) override;
+
+  /**
+   * Gather-write data of vectors with a single `sendmsg` call. Non-blocking behavior is the same as for write().
+   */
+  data::v_io_size writev(const data::stream::IOVector* vectors, v_int32 count) override;
+
+  /**
+   * Write file data with `sendfile` - without copying it to user space. Non-blocking behavior is the same as for write().
+   * Falls back to default &id:oatpp::data::stream::OutputStream::writeFile; where `sendfile` is not available.
+   */
+  data::v_io_size writeFile(data::v_io_handle fileHandle, v_int64 offset, data::v_io_size count) override;
+  
+  /**
+   * Read data from connection. If connection is non-blocking and is not readable:
+   * when called from &id:oatpp::async::Fiber; - fiber is suspended until connection is readable and IOError::RETRY is returned,
+   * otherwise IOError::WAIT_RETRY is returned.
+   */
   data::v_io_size read(void *buff, data::v_io_size count) override;
   
+  /**
+   * IOError::WAIT_RETRY - wait until connection is writable or send in flight completes.
+   */
+  oatpp::async::Action suggestOutputStreamAction(data::v_io_size ioResult) override;
+  
+  /**
+   * IOError::WAIT_RETRY - wait until connection is readable or receive in flight completes.
+   */
+  oatpp::async::Action suggestInputStreamAction(data::v_io_size ioResult) override;
+  
   void close();
   
   data::v_io_handle getHandle(){
@@ -0,0 +1,174 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "SocketOptions.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace oatpp { namespace network {
+
+namespace {
+
+void setOption(data::v_io_handle handle, int level, int name, int value, const char* optionName) {
+  v_int32 ret = setsockopt(handle, level, name, &value, sizeof(int));
+  if(ret < 0) {
+    OATPP_LOGD("[oatpp::network::SocketOptions::setOption()]", "Warning. Failed to set %s for socket", optionName);
+  }
+}
+
+#if (!defined(TCP_KEEPIDLE) && !defined(TCP_KEEPALIVE)) || !defined(TCP_KEEPINTVL) || !defined(TCP_KEEPCNT) || \
+    !defined(TCP_DEFER_ACCEPT) || !defined(TCP_FASTOPEN) || !defined(TCP_QUICKACK) || !defined(TCP_FASTOPEN_CONNECT)
+
+void warnNotSupported(const char* optionName) {
+  OATPP_LOGD("[oatpp::network::SocketOptions::setOption()]", "Warning. %s is not supported on this platform", optionName);
+}
+
+#endif
+
+void applyConnectionOptions(const SocketOptions& options, data::v_io_handle handle) {
+  
+  if(options.tcpNoDelay) {
+    setOption(handle, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+  }
+  
+  if(options.receiveBufferSize > 0) {
+    setOption(handle, SOL_SOCKET, SO_RCVBUF, options.receiveBufferSize, "SO_RCVBUF");
+  }
+  
+  if(options.sendBufferSize > 0) {
+    setOption(handle, SOL_SOCKET, SO_SNDBUF, options.sendBufferSize, "SO_SNDBUF");
+  }
+  
+  if(options.keepAlive) {
+    setOption(handle, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+    if(options.keepAliveIdleSeconds > 0) {
+#if defined(TCP_KEEPIDLE)
+      setOption(handle, IPPROTO_TCP, TCP_KEEPIDLE, options.keepAliveIdleSeconds, "TCP_KEEPIDLE");
+#elif defined(TCP_KEEPALIVE)
+      setOption(handle, IPPROTO_TCP, TCP_KEEPALIVE, options.keepAliveIdleSeconds, "TCP_KEEPALIVE");
+#else
+      warnNotSupported("TCP_KEEPIDLE");
+#endif
+    }
+    if(options.keepAliveIntervalSeconds > 0) {
+#if defined(TCP_KEEPINTVL)
+      setOption(handle, IPPROTO_TCP, TCP_KEEPINTVL, options.keepAliveIntervalSeconds, "TCP_KEEPINTVL");
+#else
+      warnNotSupported("TCP_KEEPINTVL");
+#endif
+    }
+    if(options.keepAliveProbesCount > 0) {
+#if defined(TCP_KEEPCNT)
+      setOption(handle, IPPROTO_TCP, TCP_KEEPCNT, options.keepAliveProbesCount, "TCP_KEEPCNT");
+#else
+      warnNotSupported("TCP_KEEPCNT");
+#endif
+    }
+  }
+  
+}
+
+}
+
+SocketOptions::SocketOptions()
+  : listenBacklog(10000)
+  , reuseAddress(true)
+  , reusePort(false)
+  , tcpNoDelay(false)
+  , receiveBufferSize(0)
+  , sendBufferSize(0)
+  , keepAlive(false)
+  , keepAliveIdleSeconds(0)
+  , keepAliveIntervalSeconds(0)
+  , keepAliveProbesCount(0)
+  , quickAck(false)
+  , deferAcceptSeconds(0)
+  , fastOpenQueueLength(0)
+  , fastOpenConnect(false)
+{}
+
+void SocketOptions::applyToServerSocket(data::v_io_handle handle) const {
+  
+  if(reuseAddress) {
+    setOption(handle, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+  }
+  
+  /* Set on the listening socket - accepted connections inherit them. Buffer sizes have to be set before listen() -
+   * TCP window scale is negotiated during the handshake */
+  applyConnectionOptions(*this, handle);
+  
+  if(deferAcceptSeconds > 0) {
+#if defined(TCP_DEFER_ACCEPT)
+    setOption(handle, IPPROTO_TCP, TCP_DEFER_ACCEPT, deferAcceptSeconds, "TCP_DEFER_ACCEPT");
+#else
+    warnNotSupported("TCP_DEFER_ACCEPT");
+#endif
+  }
+  
+  if(fastOpenQueueLength > 0) {
+#if defined(TCP_FASTOPEN)
+    setOption(handle, IPPROTO_TCP, TCP_FASTOPEN, fastOpenQueueLength, "TCP_FASTOPEN");
+#else
+    warnNotSupported("TCP_FASTOPEN");
+#endif
+  }
+  
+}
+
+void SocketOptions::applyToAcceptedSocket(data::v_io_handle handle) const {
+  if(quickAck) {
+#if defined(TCP_QUICKACK)
+    setOption(handle, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+#else
+    warnNotSupported("TCP_QUICKACK");
+#endif
+  }
+}
+
+void SocketOptions::applyToClientSocket(data::v_io_handle handle) const {
+  
+  applyConnectionOptions(*this, handle);
+  
+  if(quickAck) {
+#if defined(TCP_QUICKACK)
+    setOption(handle, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+#else
+    warnNotSupported("TCP_QUICKACK");
+#endif
+  }
+  
+  if(fastOpenConnect) {
+#if defined(TCP_FASTOPEN_CONNECT)
+    setOption(handle, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "TCP_FASTOPEN_CONNECT");
+#else
+    warnNotSupported("TCP_FASTOPEN_CONNECT");
+#endif
+  }
+  
+}
+
+}}
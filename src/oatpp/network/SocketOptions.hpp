@@ -0,0 +1,153 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_network_SocketOptions_hpp
+#define oatpp_network_SocketOptions_hpp
+
+#include "oatpp/core/data/IODefinitions.hpp"
+#include "oatpp/core/Types.hpp"
+
+namespace oatpp { namespace network {
+
+/**
+ * Options of TCP sockets for &id:oatpp::network::server::SimpleTCPConnectionProvider; and
+ * &id:oatpp::network::client::SimpleTCPConnectionProvider;. <br>
+ * Default values keep system defaults. Options not supported by the platform are skipped with a warning. <br>
+ * Server sets the options on the listening socket - accepted connections inherit them.
+ * Only `TCP_QUICKACK` which is not inherited is set per accepted connection.
+ */
+class SocketOptions {
+public:
+  
+  /**
+   * Server. Max length of the queue of connections waiting to be accepted. Default - 10000.
+   */
+  v_int32 listenBacklog;
+  
+  /**
+   * Server. `SO_REUSEADDR` - bind while connections of the previous server are in TIME_WAIT. Default - `true`.
+   */
+  bool reuseAddress;
+  
+  /**
+   * Server. `SO_REUSEPORT` - several listening sockets on the same port. See &id:oatpp::network::server::ShardedServer;.
+   */
+  bool reusePort;
+  
+  /**
+   * `TCP_NODELAY` - disable Nagle's algorithm. Small responses are sent right away instead of waiting
+   * for the ACK of the previous segment.
+   */
+  bool tcpNoDelay;
+  
+  /**
+   * `SO_RCVBUF` in bytes. 0 - system default.
+   */
+  v_int32 receiveBufferSize;
+  
+  /**
+   * `SO_SNDBUF` in bytes. 0 - system default.
+   */
+  v_int32 sendBufferSize;
+  
+  /**
+   * `SO_KEEPALIVE` - detect dead peers of idle connections.
+   */
+  bool keepAlive;
+  
+  /**
+   * `TCP_KEEPIDLE` - idle time before the first keep-alive probe. 0 - system default.
+   */
+  v_int32 keepAliveIdleSeconds;
+  
+  /**
+   * `TCP_KEEPINTVL` - interval between keep-alive probes. 0 - system default.
+   */
+  v_int32 keepAliveIntervalSeconds;
+  
+  /**
+   * `TCP_KEEPCNT` - number of unanswered probes before the connection is dropped. 0 - system default.
+   */
+  v_int32 keepAliveProbesCount;
+  
+  /**
+   * `TCP_QUICKACK` (Linux) - acknowledge right away at the beginning of the connection instead of delaying ACKs.
+   */
+  bool quickAck;
+  
+  /**
+   * Server. `TCP_DEFER_ACCEPT` (Linux) - connection is accepted only once the first data arrives,
+   * within the given time. 0 - off.
+   */
+  v_int32 deferAcceptSeconds;
+  
+  /**
+   * Server. `TCP_FASTOPEN` - max length of the queue of TFO connections not yet accepted. 0 - off.
+   */
+  v_int32 fastOpenQueueLength;
+  
+  /**
+   * Client. `TCP_FASTOPEN_CONNECT` (Linux) - send the first data with SYN when the server supports TCP Fast Open.
+   */
+  bool fastOpenConnect;
+  
+public:
+  
+  /**
+   * Constructor. Options are set to defaults.
+   */
+  SocketOptions();
+  
+  /**
+   * Set options of the listening socket before bind().
+   * @param handle - socket.
+   */
+  void applyToServerSocket(data::v_io_handle handle) const;
+  
+  /**
+   * Set options which accepted connection doesn't inherit from the listening socket.
+   * @param handle - accepted socket.
+   */
+  void applyToAcceptedSocket(data::v_io_handle handle) const;
+  
+  /**
+   * Set options of the client socket before connect().
+   * @param handle - socket.
+   */
+  void applyToClientSocket(data::v_io_handle handle) const;
+  
+  /**
+   * Check if some option has to be set on each accepted connection.
+   * @return
+   */
+  bool hasAcceptedSocketOptions() const {
+    return quickAck;
+  }
+  
+};
+  
+}}
+
+#endif /* oatpp_network_SocketOptions_hpp */
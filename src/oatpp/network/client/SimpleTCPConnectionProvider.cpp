@@ -43,6 +43,15 @@ SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(const oatpp::String& ho
   setProperty(PROPERTY_HOST, m_host);
   setProperty(PROPERTY_PORT, oatpp::utils::conversion::int32ToStr(port));
 }
+
+SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(const oatpp::String& host, v_word16 port, const SocketOptions& options)
+  : m_host(host)
+  , m_port(port)
+  , m_options(options)
+{
+  setProperty(PROPERTY_HOST, m_host);
+  setProperty(PROPERTY_PORT, oatpp::utils::conversion::int32ToStr(port));
+}
   
 std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getConnection(){
   
@@ -74,6 +83,8 @@ std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getC
   }
 #endif
   
+  m_options.applyToClientSocket(clientHandle);
+  
   if (connect(clientHandle, (struct sockaddr *)&client, sizeof(client)) != 0 ) {
     ::close(clientHandle);
     OATPP_LOGD("[oatpp::network::client::SimpleTCPConnectionProvider::getConnection()]", "Error. Could not connect.");
@@ -91,13 +102,15 @@ oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::asyn
   private:
     oatpp::String m_host;
     v_int32 m_port;
+    SocketOptions m_options;
     oatpp::data::v_io_handle m_clientHandle;
     struct sockaddr_in m_client;
   public:
     
-    ConnectCoroutine(const oatpp::String& host, v_int32 port)
+    ConnectCoroutine(const oatpp::String& host, v_int32 port, const SocketOptions& options)
       : m_host(host)
       , m_port(port)
+      , m_options(options)
     {}
     
     Action act() override {
@@ -129,6 +142,8 @@ oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::asyn
       }
 #endif
       
+      m_options.applyToClientSocket(m_clientHandle);
+      
       return yieldTo(&ConnectCoroutine::doConnect);
       
     }
@@ -140,7 +155,7 @@ oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::asyn
         return _return(oatpp::network::Connection::createShared(m_clientHandle));
       }
       if(errno == EALREADY || errno == EINPROGRESS) {
-        return waitRetry();
+        return waitForIO(m_clientHandle, oatpp::async::Action::IO_EVENT_WRITE);
       } else if(errno == EINTR) {
         return repeat();
       }
@@ -150,7 +165,7 @@ oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::asyn
     
   };
   
-  return parentCoroutine->startCoroutineForResult<ConnectCoroutine>(callback, m_host, m_port);
+  return parentCoroutine->startCoroutineForResult<ConnectCoroutine>(callback, m_host, m_port, m_options);
   
 }
   
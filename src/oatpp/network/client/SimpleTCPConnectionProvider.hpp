@@ -26,6 +26,7 @@
 #define oatpp_netword_client_SimpleTCPConnectionProvider_hpp
 
 #include "oatpp/network/ConnectionProvider.hpp"
+#include "oatpp/network/SocketOptions.hpp"
 
 #include "oatpp/core/data/stream/Stream.hpp"
 #include "oatpp/core/Types.hpp"
@@ -36,13 +37,26 @@ class SimpleTCPConnectionProvider : public base::Countable, public ClientConnect
 protected:
   oatpp::String m_host;
   v_word16 m_port;
+  SocketOptions m_options;
 public:
   SimpleTCPConnectionProvider(const oatpp::String& host, v_word16 port);
+  
+  /**
+   * Constructor.
+   * @param host - host to connect to.
+   * @param port - port to connect to.
+   * @param options - &id:oatpp::network::SocketOptions; set on each connection. Server-only options are ignored.
+   */
+  SimpleTCPConnectionProvider(const oatpp::String& host, v_word16 port, const SocketOptions& options);
 public:
   
   static std::shared_ptr<SimpleTCPConnectionProvider> createShared(const oatpp::String& host, v_word16 port){
     return std::make_shared<SimpleTCPConnectionProvider>(host, port);
   }
+  
+  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(const oatpp::String& host, v_word16 port, const SocketOptions& options){
+    return std::make_shared<SimpleTCPConnectionProvider>(host, port, options);
+  }
 
   void close() override {
     // DO NOTHING
@@ -59,6 +73,10 @@ public:
     return m_port;
   }
   
+  const SocketOptions& getSocketOptions() {
+    return m_options;
+  }
+  
 };
   
 }}}
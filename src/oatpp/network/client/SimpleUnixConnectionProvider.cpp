@@ -0,0 +1,178 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "./SimpleUnixConnectionProvider.hpp"
+
+#include "oatpp/network/Connection.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <cstddef>
+
+namespace oatpp { namespace network { namespace client {
+
+namespace {
+
+/**
+ * Fill address. Path starting with '@' is an address in the abstract namespace.
+ * @return - length of the address. 0 if path doesn't fit or abstract namespace is not supported.
+ */
+socklen_t createAddress(const oatpp::String& path, struct sockaddr_un& addr) {
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  v_int32 size = path->getSize();
+  if(size == 0 || size >= (v_int32) sizeof(addr.sun_path)) {
+    return 0;
+  }
+  std::memcpy(addr.sun_path, path->getData(), size);
+  if(addr.sun_path[0] == '@') {
+#if defined(__linux__)
+    addr.sun_path[0] = 0;
+    return offsetof(struct sockaddr_un, sun_path) + size;
+#else
+    return 0;
+#endif
+  }
+  return sizeof(addr);
+}
+
+oatpp::data::v_io_handle createSocket(bool nonBlocking) {
+#if defined(__linux__)
+  int type = SOCK_STREAM | SOCK_CLOEXEC;
+  if(nonBlocking) {
+    type |= SOCK_NONBLOCK;
+  }
+  return socket(AF_UNIX, type, 0);
+#else
+  oatpp::data::v_io_handle handle = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(handle >= 0) {
+    if(nonBlocking) {
+      fcntl(handle, F_SETFL, O_NONBLOCK);
+    }
+    fcntl(handle, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int yes = 1;
+    setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(int));
+#endif
+  }
+  return handle;
+#endif
+}
+
+}
+
+SimpleUnixConnectionProvider::SimpleUnixConnectionProvider(const oatpp::String& path)
+  : m_path(path)
+{
+  setProperty(PROPERTY_HOST, "localhost");
+  setProperty(PROPERTY_PORT, "0");
+}
+
+std::shared_ptr<oatpp::data::stream::IOStream> SimpleUnixConnectionProvider::getConnection() {
+  
+  struct sockaddr_un addr;
+  socklen_t addrLength = createAddress(m_path, addr);
+  if(addrLength == 0) {
+    OATPP_LOGD("[oatpp::network::client::SimpleUnixConnectionProvider::getConnection()]", "Error. Invalid path.");
+    return nullptr;
+  }
+  
+  oatpp::data::v_io_handle clientHandle = createSocket(false);
+  if(clientHandle < 0) {
+    OATPP_LOGD("[oatpp::network::client::SimpleUnixConnectionProvider::getConnection()]", "Error. Can't create socket.");
+    return nullptr;
+  }
+  
+  if(connect(clientHandle, (struct sockaddr *)&addr, addrLength) != 0) {
+    ::close(clientHandle);
+    OATPP_LOGD("[oatpp::network::client::SimpleUnixConnectionProvider::getConnection()]", "Error. Could not connect.");
+    return nullptr;
+  }
+  
+  return oatpp::network::Connection::createShared(clientHandle);
+  
+}
+
+oatpp::async::Action SimpleUnixConnectionProvider::getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                                      AsyncCallback callback) {
+  
+  class ConnectCoroutine : public oatpp::async::CoroutineWithResult<ConnectCoroutine, std::shared_ptr<oatpp::data::stream::IOStream>> {
+  private:
+    oatpp::String m_path;
+    oatpp::data::v_io_handle m_clientHandle;
+    struct sockaddr_un m_addr;
+    socklen_t m_addrLength;
+  public:
+    
+    ConnectCoroutine(const oatpp::String& path)
+      : m_path(path)
+      , m_clientHandle(-1)
+    {}
+    
+    Action act() override {
+      
+      m_addrLength = createAddress(m_path, m_addr);
+      if(m_addrLength == 0) {
+        return error("[oatpp::network::client::SimpleUnixConnectionProvider::getConnectionAsync()]: Error. Invalid path.");
+      }
+      
+      m_clientHandle = createSocket(true);
+      if(m_clientHandle < 0) {
+        return error("[oatpp::network::client::SimpleUnixConnectionProvider::getConnectionAsync()]: Error. Can't create socket.");
+      }
+      
+      return yieldTo(&ConnectCoroutine::doConnect);
+      
+    }
+    
+    Action doConnect() {
+      errno = 0;
+      auto res = connect(m_clientHandle, (struct sockaddr *)&m_addr, m_addrLength);
+      if(res == 0 || errno == EISCONN) {
+        return _return(oatpp::network::Connection::createShared(m_clientHandle));
+      }
+      if(errno == EALREADY || errno == EINPROGRESS) {
+        return waitForIO(m_clientHandle, oatpp::async::Action::IO_EVENT_WRITE);
+      } else if(errno == EAGAIN) {
+        /* Accept queue of the server is full - Unix sockets don't wait for it on non-blocking connect */
+        return waitUntil(oatpp::base::Environment::getMicroTickCount() + 1000);
+      } else if(errno == EINTR) {
+        return repeat();
+      }
+      ::close(m_clientHandle);
+      return error("[oatpp::network::client::SimpleUnixConnectionProvider::getConnectionAsync()]: Error. Can't connect.");
+    }
+    
+  };
+  
+  return parentCoroutine->startCoroutineForResult<ConnectCoroutine>(callback, m_path);
+  
+}
+
+}}}
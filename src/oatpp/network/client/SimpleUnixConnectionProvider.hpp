@@ -0,0 +1,72 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_network_client_SimpleUnixConnectionProvider_hpp
+#define oatpp_network_client_SimpleUnixConnectionProvider_hpp
+
+#include "oatpp/network/ConnectionProvider.hpp"
+
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/Types.hpp"
+
+namespace oatpp { namespace network { namespace client {
+
+/**
+ * Client connection provider for Unix domain stream sockets (AF_UNIX).
+ * Connections are &id:oatpp::network::Connection; as for TCP - &id:oatpp::web::client::ApiClient; works unchanged.
+ */
+class SimpleUnixConnectionProvider : public base::Countable, public ClientConnectionProvider {
+private:
+  oatpp::String m_path;
+public:
+  
+  /**
+   * Constructor.
+   * @param path - path of the socket file. Path starting with `@` is an address in the abstract namespace (Linux).
+   */
+  SimpleUnixConnectionProvider(const oatpp::String& path);
+  
+public:
+  
+  static std::shared_ptr<SimpleUnixConnectionProvider> createShared(const oatpp::String& path) {
+    return std::make_shared<SimpleUnixConnectionProvider>(path);
+  }
+  
+  void close() override {
+    // DO NOTHING
+  }
+  
+  std::shared_ptr<IOStream> getConnection() override;
+  Action getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine, AsyncCallback callback) override;
+  
+  oatpp::String getPath() {
+    return m_path;
+  }
+  
+};
+  
+}}}
+
+#endif /* oatpp_network_client_SimpleUnixConnectionProvider_hpp */
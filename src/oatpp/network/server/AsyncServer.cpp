@@ -0,0 +1,116 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "AsyncServer.hpp"
+
+namespace oatpp { namespace network { namespace server {
+
+namespace {
+
+class AcceptCoroutine : public oatpp::async::Coroutine<AcceptCoroutine> {
+private:
+  std::shared_ptr<ServerConnectionProvider> m_connectionProvider;
+  std::shared_ptr<ConnectionHandler> m_connectionHandler;
+  v_int64 m_retryIntervalMicros;
+  v_int64 m_retryTime;
+public:
+  
+  AcceptCoroutine(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+                  const std::shared_ptr<ConnectionHandler>& connectionHandler,
+                  const std::shared_ptr<oatpp::async::CancellationHandle>& cancellationHandle)
+    : m_connectionProvider(connectionProvider)
+    , m_connectionHandler(connectionHandler)
+    , m_retryIntervalMicros(0)
+    , m_retryTime(0)
+  {
+    setCancellationHandle(cancellationHandle);
+  }
+  
+  ~AcceptCoroutine() {
+    /* Listening socket is closed only once the coroutine doesn't wait for it anymore */
+    m_connectionProvider->close();
+  }
+  
+  Action act() override {
+    ServerConnectionProvider::AsyncCallback callback =
+    static_cast<ServerConnectionProvider::AsyncCallback>(&AcceptCoroutine::onConnection);
+    return m_connectionProvider->getConnectionAsync(this, callback);
+  }
+  
+  Action onConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+    m_retryIntervalMicros = 0;
+    m_connectionHandler->handleConnection(connection);
+    return yieldTo(&AcceptCoroutine::act);
+  }
+  
+  Action retry() {
+    if(oatpp::base::Environment::getMicroTickCount() < m_retryTime) {
+      return waitUntil(m_retryTime);
+    }
+    return yieldTo(&AcceptCoroutine::act);
+  }
+  
+  Action handleError(const oatpp::async::Error& error) override {
+    if(error.isCancelled()) {
+      return error;
+    }
+    /* Server keeps accepting. Back off so that a persistent error doesn't spin the processor */
+    if(m_retryIntervalMicros == 0) {
+      m_retryIntervalMicros = AsyncServer::ACCEPT_RETRY_MIN_INTERVAL_MICROS;
+    } else if(m_retryIntervalMicros < AsyncServer::ACCEPT_RETRY_MAX_INTERVAL_MICROS / 2) {
+      m_retryIntervalMicros *= 2;
+    } else {
+      m_retryIntervalMicros = AsyncServer::ACCEPT_RETRY_MAX_INTERVAL_MICROS;
+    }
+    OATPP_LOGE("[oatpp::network::server::AsyncServer::AcceptCoroutine::handleError()]", "Error. %s Retry in %lld micros.",
+               error.message, m_retryIntervalMicros);
+    m_retryTime = oatpp::base::Environment::getMicroTickCount() + m_retryIntervalMicros;
+    return yieldTo(&AcceptCoroutine::retry);
+  }
+  
+};
+  
+}
+
+AsyncServer::AsyncServer(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+                         const std::shared_ptr<ConnectionHandler>& connectionHandler,
+                         const std::shared_ptr<oatpp::async::Executor>& executor)
+  : m_connectionProvider(connectionProvider)
+  , m_connectionHandler(connectionHandler)
+  , m_executor(executor)
+{}
+
+void AsyncServer::start() {
+  m_cancellationHandle = oatpp::async::CancellationHandle::createShared();
+  m_executor->execute<AcceptCoroutine>(m_connectionProvider, m_connectionHandler, m_cancellationHandle);
+}
+
+void AsyncServer::stop() {
+  if(m_cancellationHandle) {
+    m_cancellationHandle->cancel();
+  }
+}
+
+}}}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef network_server_AsyncServer_hpp
+#define network_server_AsyncServer_hpp
+
+#include "./ConnectionHandler.hpp"
+
+#include "oatpp/network/ConnectionProvider.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include "oatpp/core/base/Countable.hpp"
+
+namespace oatpp { namespace network { namespace server {
+
+/**
+ * Server accepting connections by a coroutine running in the executor - no thread is parked in accept(). <br>
+ * The accept coroutine drains the accept queue via &id:oatpp::network::ConnectionProvider::getConnectionAsync;
+ * and waits for the listening socket to become readable once it is empty.
+ * Accepted connections are passed to the connection handler right in the processor's thread.
+ * &id:oatpp::web::server::AsyncHttpConnectionHandler; running on the same executor then starts the connection
+ * coroutine on the accepting processor - no handoff between threads. <br>
+ * To spread accepting over threads use several servers with providers bound with `SO_REUSEPORT`. <br>
+ * Accept errors don't stop the server - the error is logged and accept is retried after a pause
+ * which doubles with each consecutive error, from &l:AsyncServer::ACCEPT_RETRY_MIN_INTERVAL_MICROS;
+ * up to &l:AsyncServer::ACCEPT_RETRY_MAX_INTERVAL_MICROS;.
+ */
+class AsyncServer : public base::Countable {
+public:
+  static constexpr const v_int64 ACCEPT_RETRY_MIN_INTERVAL_MICROS = 10 * 1000;
+  static constexpr const v_int64 ACCEPT_RETRY_MAX_INTERVAL_MICROS = 1000 * 1000;
+private:
+  std::shared_ptr<ServerConnectionProvider> m_connectionProvider;
+  std::shared_ptr<ConnectionHandler> m_connectionHandler;
+  std::shared_ptr<oatpp::async::Executor> m_executor;
+  std::shared_ptr<oatpp::async::CancellationHandle> m_cancellationHandle;
+public:
+  
+  /**
+   * Constructor.
+   * @param connectionProvider - &id:oatpp::network::ServerConnectionProvider; implementing `getConnectionAsync()`,
+   * for example &id:oatpp::network::server::SimpleTCPConnectionProvider;.
+   * @param connectionHandler - &id:oatpp::network::server::ConnectionHandler;.
+   * @param executor - &id:oatpp::async::Executor; to run the accept coroutine. Should be the executor of the connection handler.
+   */
+  AsyncServer(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+              const std::shared_ptr<ConnectionHandler>& connectionHandler,
+              const std::shared_ptr<oatpp::async::Executor>& executor);
+  
+  static std::shared_ptr<AsyncServer> createShared(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+                                                   const std::shared_ptr<ConnectionHandler>& connectionHandler,
+                                                   const std::shared_ptr<oatpp::async::Executor>& executor)
+  {
+    return std::make_shared<AsyncServer>(connectionProvider, connectionHandler, executor);
+  }
+  
+  /**
+   * Start accepting connections. Non-blocking.
+   */
+  void start();
+  
+  /**
+   * Stop accepting connections. The accept coroutine is cancelled and closes the connection provider
+   * once it is unwound - within &id:oatpp::async::Processor::INTERRUPTS_CHECK_INTERVAL_MICROS;.
+   * Doesn't stop the connection handler.
+   */
+  void stop();
+  
+};
+  
+}}}
+
+#endif /* network_server_AsyncServer_hpp */
@@ -24,6 +24,8 @@
 
 #include "Server.hpp"
 
+#include "oatpp/core/concurrency/Thread.hpp"
+
 #include <thread>
 #include <chrono>
 
@@ -38,6 +40,10 @@ void Server::mainLoop(){
   
   setStatus(STATUS_CREATED, STATUS_RUNNING);
   
+  if(m_placementPolicy) {
+    m_placementPolicy->placeAcceptor(concurrency::Thread::getCurrentNativeHandle());
+  }
+  
   while(getStatus() == STATUS_RUNNING) {
     
     auto connection = m_connectionProvider->getConnection();
@@ -29,6 +29,7 @@
 
 #include "oatpp/network/ConnectionProvider.hpp"
 
+#include "oatpp/core/concurrency/PlacementPolicy.hpp"
 #include "oatpp/core/concurrency/Runnable.hpp"
 
 #include "oatpp/core/Types.hpp"
@@ -56,6 +57,7 @@ private:
   
   std::shared_ptr<ServerConnectionProvider> m_connectionProvider;
   std::shared_ptr<ConnectionHandler> m_connectionHandler;
+  std::shared_ptr<concurrency::PlacementPolicy> m_placementPolicy;
   
 public:
   
@@ -80,6 +82,15 @@ public:
     return std::make_shared<Server>(connectionProvider, connectionHandler);
   }
   
+  /**
+   * Pin the thread accepting connections to the reserved CPUs of the policy once &l:Server::run (); is called.
+   * See &id:oatpp::concurrency::PlacementPolicy::placeAcceptor;.
+   * @param placementPolicy - &id:oatpp::concurrency::PlacementPolicy;.
+   */
+  void setPlacementPolicy(const std::shared_ptr<concurrency::PlacementPolicy>& placementPolicy) {
+    m_placementPolicy = placementPolicy;
+  }
+  
   void run() override;
   
   void stop();
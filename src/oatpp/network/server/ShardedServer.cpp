@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ShardedServer.hpp"
+
+#include "./SimpleTCPConnectionProvider.hpp"
+
+#include "oatpp/core/concurrency/Thread.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace network { namespace server {
+
+std::shared_ptr<ShardedServer> ShardedServer::createTCPShared(v_word16 port,
+                                                              v_int32 shardsCount,
+                                                              const ConnectionHandlerFactory& connectionHandlerFactory,
+                                                              bool nonBlocking,
+                                                              const SocketOptions& options)
+{
+  if(shardsCount < 1) {
+    throw std::runtime_error("[oatpp::network::server::ShardedServer::createTCPShared()]: Error. Invalid shardsCount.");
+  }
+  SocketOptions shardOptions = options;
+  shardOptions.reusePort = true;
+  auto server = createShared();
+  for(v_int32 i = 0; i < shardsCount; i ++) {
+    auto provider = SimpleTCPConnectionProvider::createShared(port, shardOptions, nonBlocking);
+    port = provider->getPort();
+    server->addShard(provider, connectionHandlerFactory(i));
+  }
+  return server;
+}
+
+void ShardedServer::addShard(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+                             const std::shared_ptr<ConnectionHandler>& connectionHandler)
+{
+  Shard shard;
+  shard.connectionProvider = connectionProvider;
+  shard.connectionHandler = connectionHandler;
+  shard.server = Server::createShared(connectionProvider, connectionHandler);
+  m_shards.push_back(shard);
+}
+
+void ShardedServer::run() {
+  
+  std::vector<std::thread> threads;
+  threads.reserve(m_shards.size());
+  
+  for(v_int32 i = 0; i < (v_int32) m_shards.size(); i ++) {
+    threads.push_back(std::thread([this, i] {
+      if(m_placementPolicy) {
+        m_placementPolicy->placeWorker(concurrency::Thread::getCurrentNativeHandle(), i);
+      }
+      m_shards[i].server->run();
+    }));
+  }
+  
+  for(auto& thread : threads) {
+    thread.join();
+  }
+  
+}
+
+void ShardedServer::stop() {
+  for(auto& shard : m_shards) {
+    shard.server->stop();
+    shard.connectionProvider->close();
+    shard.connectionHandler->stop();
+  }
+}
+
+}}}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef network_server_ShardedServer_hpp
+#define network_server_ShardedServer_hpp
+
+#include "./Server.hpp"
+
+#include "oatpp/network/SocketOptions.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace oatpp { namespace network { namespace server {
+
+/**
+ * Server with several independent shards. <br>
+ * Each shard owns its connection provider, its accept loop running in its own thread and its connection handler
+ * (with its own executor or threads). Shards share nothing. <br>
+ * Use &l:ShardedServer::createTCPShared (); to create shards listening on the same port with `SO_REUSEPORT` -
+ * the kernel then balances incoming connections between the shards.
+ */
+class ShardedServer : public base::Countable, public concurrency::Runnable {
+public:
+  
+  /**
+   * Create connection handler of the shard.
+   * Shard index is passed as the argument.
+   */
+  typedef std::function<std::shared_ptr<ConnectionHandler>(v_int32)> ConnectionHandlerFactory;
+  
+private:
+  
+  struct Shard {
+    std::shared_ptr<ServerConnectionProvider> connectionProvider;
+    std::shared_ptr<ConnectionHandler> connectionHandler;
+    std::shared_ptr<Server> server;
+  };
+  
+private:
+  std::vector<Shard> m_shards;
+  std::shared_ptr<concurrency::PlacementPolicy> m_placementPolicy;
+public:
+  
+  ShardedServer() = default;
+  
+  static std::shared_ptr<ShardedServer> createShared() {
+    return std::make_shared<ShardedServer>();
+  }
+  
+  /**
+   * Create server with `shardsCount` shards each listening on `port` with its own
+   * &id:oatpp::network::server::SimpleTCPConnectionProvider; bound with `SO_REUSEPORT`.
+   * @param port - port to listen on. 0 - any free port. Then all shards listen on the port chosen for the first shard.
+   * @param shardsCount - number of shards. Usually the number of CPU cores.
+   * @param connectionHandlerFactory - &l:ShardedServer::ConnectionHandlerFactory;.
+   * @param nonBlocking - put accepted connections to non-blocking mode. Use `true` for async connection handlers.
+   * @param options - &id:oatpp::network::SocketOptions; of each shard. `reusePort` is always set.
+   * @return - `std::shared_ptr` to ShardedServer.
+   */
+  static std::shared_ptr<ShardedServer> createTCPShared(v_word16 port,
+                                                        v_int32 shardsCount,
+                                                        const ConnectionHandlerFactory& connectionHandlerFactory,
+                                                        bool nonBlocking = false,
+                                                        const SocketOptions& options = SocketOptions());
+  
+  /**
+   * Add shard. Shards must be added before &l:ShardedServer::run (); is called.
+   * @param connectionProvider - &id:oatpp::network::ServerConnectionProvider; owned by the shard.
+   * @param connectionHandler - &id:oatpp::network::server::ConnectionHandler; owned by the shard.
+   */
+  void addShard(const std::shared_ptr<ServerConnectionProvider>& connectionProvider,
+                const std::shared_ptr<ConnectionHandler>& connectionHandler);
+  
+  /**
+   * Pin the thread accepting connections of the shard `i` to CPUs of the worker `i` of the policy.
+   * See &id:oatpp::concurrency::PlacementPolicy::placeWorker;.
+   * @param placementPolicy - &id:oatpp::concurrency::PlacementPolicy;.
+   */
+  void setPlacementPolicy(const std::shared_ptr<concurrency::PlacementPolicy>& placementPolicy) {
+    m_placementPolicy = placementPolicy;
+  }
+  
+  /**
+   * Run accept loops of all shards. Blocks until all of them are stopped.
+   */
+  void run() override;
+  
+  /**
+   * Stop accept loops, close connection providers and stop connection handlers of all shards.
+   */
+  void stop();
+  
+  v_int32 getShardsCount() const {
+    return (v_int32) m_shards.size();
+  }
+  
+  std::shared_ptr<ServerConnectionProvider> getConnectionProvider(v_int32 shardIndex) const {
+    return m_shards[shardIndex].connectionProvider;
+  }
+  
+  std::shared_ptr<ConnectionHandler> getConnectionHandler(v_int32 shardIndex) const {
+    return m_shards[shardIndex].connectionHandler;
+  }
+  
+};
+  
+}}}
+
+#endif /* network_server_ShardedServer_hpp */
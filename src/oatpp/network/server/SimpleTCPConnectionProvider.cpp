@@ -23,8 +23,7 @@
  ***************************************************************************/
 
 #include "./SimpleTCPConnectionProvider.hpp"
-
-#include "oatpp/network/Connection.hpp"
+#include "./SocketAcceptor.hpp"
 
 #include "oatpp/core/utils/ConversionUtils.hpp"
 
@@ -37,14 +36,28 @@
 
 namespace oatpp { namespace network { namespace server {
 
-SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking)
+SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking, bool reusePort)
+  : m_port(port)
+  , m_nonBlocking(nonBlocking)
+  , m_closed(false)
+  , m_listenerNonBlocking(false)
+{
+  m_options.reusePort = reusePort;
+  m_serverHandle = instantiateServer();
+  setProperty(PROPERTY_HOST, "localhost");
+  setProperty(PROPERTY_PORT, oatpp::utils::conversion::int32ToStr(m_port));
+}
+
+SimpleTCPConnectionProvider::SimpleTCPConnectionProvider(v_word16 port, const SocketOptions& options, bool nonBlocking)
   : m_port(port)
   , m_nonBlocking(nonBlocking)
+  , m_options(options)
   , m_closed(false)
+  , m_listenerNonBlocking(false)
 {
   m_serverHandle = instantiateServer();
   setProperty(PROPERTY_HOST, "localhost");
-  setProperty(PROPERTY_PORT, oatpp::utils::conversion::int32ToStr(port));
+  setProperty(PROPERTY_PORT, oatpp::utils::conversion::int32ToStr(m_port));
 }
 
 SimpleTCPConnectionProvider::~SimpleTCPConnectionProvider() {
@@ -54,6 +67,8 @@ SimpleTCPConnectionProvider::~SimpleTCPConnectionProvider() {
 void SimpleTCPConnectionProvider::close() {
   if(!m_closed) {
     m_closed = true;
+    // shutdown() wakes up the thread blocked in accept(). close() alone doesn't
+    ::shutdown(m_serverHandle, SHUT_RDWR);
     ::close(m_serverHandle);
   }
 }
@@ -62,7 +77,6 @@ oatpp::data::v_io_handle SimpleTCPConnectionProvider::instantiateServer(){
   
   oatpp::data::v_io_handle serverHandle;
   v_int32 ret;
-  int yes = 1;
   
   struct sockaddr_in6 addr;
   
@@ -76,9 +90,20 @@ oatpp::data::v_io_handle SimpleTCPConnectionProvider::instantiateServer(){
     return -1;
   }
   
-  ret = setsockopt(serverHandle, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int));
-  if(ret < 0) {
-    OATPP_LOGD("[oatpp::network::server::SimpleTCPConnectionProvider::instantiateServer()]", "Warning. Failed to set %s for accepting socket", "SO_REUSEADDR");
+  m_options.applyToServerSocket(serverHandle);
+  
+  if(m_options.reusePort) {
+#ifdef SO_REUSEPORT
+    int yes = 1;
+    ret = setsockopt(serverHandle, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(int));
+    if(ret < 0) {
+      ::close(serverHandle);
+      throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::instantiateServer()]: Error. Failed to set SO_REUSEPORT for accepting socket.");
+    }
+#else
+    ::close(serverHandle);
+    throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::instantiateServer()]: Error. SO_REUSEPORT is not supported.");
+#endif
   }
   
   ret = bind(serverHandle, (struct sockaddr *)&addr, sizeof(addr));
@@ -89,7 +114,14 @@ oatpp::data::v_io_handle SimpleTCPConnectionProvider::instantiateServer(){
     return -1 ;
   }
   
-  ret = listen(serverHandle, 10000);
+  if(m_port == 0) {
+    socklen_t addrLength = sizeof(addr);
+    if(getsockname(serverHandle, (struct sockaddr *)&addr, &addrLength) == 0) {
+      m_port = ntohs(addr.sin6_port);
+    }
+  }
+  
+  ret = listen(serverHandle, m_options.listenBacklog);
   if(ret < 0) {
     ::close(serverHandle);
     return -1 ;
@@ -102,38 +134,20 @@ oatpp::data::v_io_handle SimpleTCPConnectionProvider::instantiateServer(){
 }
   
 std::shared_ptr<oatpp::data::stream::IOStream> SimpleTCPConnectionProvider::getConnection(){
+  return SocketAcceptor::acceptConnection(m_serverHandle, m_nonBlocking, &m_options, m_closed,
+                                          "[oatpp::network::server::SimpleTCPConnectionProvider::getConnection()]");
+}
 
-  oatpp::data::v_io_handle handle = accept(m_serverHandle, nullptr, nullptr);
-  
-  if (handle < 0) {
-    v_int32 error = errno;
-    if(error == EAGAIN || error == EWOULDBLOCK){
-      return nullptr;
-    } else {
-      if(!m_closed) { // m_serverHandle==0 if ConnectionProvider was closed. Not an error.
-        OATPP_LOGD("[oatpp::network::server::SimpleTCPConnectionProvider::getConnection()]", "Error. %d", error);
-      }
-      return nullptr;
-    }
-  }
-  
-#ifdef SO_NOSIGPIPE
-  int yes = 1;
-  v_int32 ret = setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(int));
-  if(ret < 0) {
-    OATPP_LOGD("[oatpp::network::server::SimpleTCPConnectionProvider::getConnection()]", "Warning. Failed to set %s for socket", "SO_NOSIGPIPE");
-  }
-#endif
-  
-  int flags = 0;
-  if(m_nonBlocking) {
-    flags |= O_NONBLOCK;
+oatpp::async::Action SimpleTCPConnectionProvider::getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                                     AsyncCallback callback) {
+
+  if(!m_listenerNonBlocking) {
+    fcntl(m_serverHandle, F_SETFL, O_NONBLOCK);
+    m_listenerNonBlocking = true;
   }
-  
-  fcntl(handle, F_SETFL, flags);
-  
-  return Connection::createShared(handle);
-  
+
+  return SocketAcceptor::acceptConnectionAsync(parentCoroutine, callback, m_serverHandle, m_nonBlocking, &m_options);
+
 }
 
 }}}
@@ -26,6 +26,7 @@
 #define oatpp_netword_server_SimpleTCPConnectionProvider_hpp
 
 #include "oatpp/network/ConnectionProvider.hpp"
+#include "oatpp/network/SocketOptions.hpp"
 
 #include "oatpp/core/data/stream/Stream.hpp"
 #include "oatpp/core/Types.hpp"
@@ -36,16 +37,38 @@ class SimpleTCPConnectionProvider : public base::Countable, public ServerConnect
 private:
   v_word16 m_port;
   bool m_nonBlocking;
+  SocketOptions m_options;
   bool m_closed;
+  bool m_listenerNonBlocking;
   oatpp::data::v_io_handle m_serverHandle;
 private:
   oatpp::data::v_io_handle instantiateServer();
 public:
-  SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking = false);
+  
+  /**
+   * Constructor.
+   * @param port - port to listen on. 0 - any free port, see &l:SimpleTCPConnectionProvider::getPort ();.
+   * @param nonBlocking - put accepted connections to non-blocking mode.
+   * @param reusePort - bind with `SO_REUSEPORT` so that several providers may listen on the same port.
+   * The kernel then distributes incoming connections between them. See &id:oatpp::network::server::ShardedServer;.
+   */
+  SimpleTCPConnectionProvider(v_word16 port, bool nonBlocking = false, bool reusePort = false);
+  
+  /**
+   * Constructor.
+   * @param port - port to listen on. 0 - any free port, see &l:SimpleTCPConnectionProvider::getPort ();.
+   * @param options - &id:oatpp::network::SocketOptions;.
+   * @param nonBlocking - put accepted connections to non-blocking mode.
+   */
+  SimpleTCPConnectionProvider(v_word16 port, const SocketOptions& options, bool nonBlocking = false);
 public:
   
-  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(v_word16 port, bool nonBlocking = false){
-    return std::make_shared<SimpleTCPConnectionProvider>(port, nonBlocking);
+  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(v_word16 port, bool nonBlocking = false, bool reusePort = false){
+    return std::make_shared<SimpleTCPConnectionProvider>(port, nonBlocking, reusePort);
+  }
+  
+  static std::shared_ptr<SimpleTCPConnectionProvider> createShared(v_word16 port, const SocketOptions& options, bool nonBlocking = false){
+    return std::make_shared<SimpleTCPConnectionProvider>(port, options, nonBlocking);
   }
   
   ~SimpleTCPConnectionProvider();
@@ -54,23 +77,36 @@ public:
   
   std::shared_ptr<IOStream> getConnection() override;
   
+  /**
+   * Accept connection in the executor instead of a thread blocked in accept(). <br>
+   * Connections are accepted while there are pending ones (with `accept4()` where available - one syscall per connection).
+   * The coroutine waits for the listening socket to become readable only once the accept queue is empty. <br>
+   * On the first call the listening socket is switched to non-blocking mode -
+   * do not mix with &l:SimpleTCPConnectionProvider::getConnection (); afterwards.
+   * See &id:oatpp::network::server::AsyncServer;.
+   * @param parentCoroutine - caller coroutine.
+   * @param callback - called with the accepted connection.
+   * @return - &id:oatpp::async::Action;.
+   */
   Action getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
-                            AsyncCallback callback) override {
-    /**
-     *  No need to implement this.
-     *  For Asynchronous IO in oatpp it is considered to be a good practice
-     *  to accept connections in a seperate thread with the blocking accept()
-     *  and then process connections in Asynchronous manner with non-blocking read/write
-     *
-     *  It may be implemented later
-     */
-    throw std::runtime_error("[oatpp::network::server::SimpleTCPConnectionProvider::getConnectionAsync()]: Error. Not implemented.");
-  }
+                            AsyncCallback callback) override;
   
+  /**
+   * Get port the provider listens on. If the provider was created with port 0 this is the port chosen by the system.
+   * @return - port.
+   */
   v_word16 getPort(){
     return m_port;
   }
   
+  bool isReusePort() {
+    return m_options.reusePort;
+  }
+  
+  const SocketOptions& getSocketOptions() {
+    return m_options;
+  }
+  
 };
   
 }}}
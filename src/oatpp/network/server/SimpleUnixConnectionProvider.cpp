@@ -0,0 +1,179 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "./SimpleUnixConnectionProvider.hpp"
+#include "./SocketAcceptor.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <cstddef>
+
+namespace oatpp { namespace network { namespace server {
+
+namespace {
+
+/**
+ * Fill address. Path starting with '@' is an address in the abstract namespace.
+ * @return - length of the address. 0 if path doesn't fit or abstract namespace is not supported.
+ */
+socklen_t createAddress(const oatpp::String& path, struct sockaddr_un& addr) {
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  v_int32 size = path->getSize();
+  if(size == 0 || size >= (v_int32) sizeof(addr.sun_path)) {
+    return 0;
+  }
+  std::memcpy(addr.sun_path, path->getData(), size);
+  if(addr.sun_path[0] == '@') {
+#if defined(__linux__)
+    addr.sun_path[0] = 0;
+    return offsetof(struct sockaddr_un, sun_path) + size;
+#else
+    return 0;
+#endif
+  }
+  return sizeof(addr);
+}
+
+bool isAbstract(const oatpp::String& path) {
+  return path->getSize() > 0 && path->getData()[0] == '@';
+}
+
+}
+
+SimpleUnixConnectionProvider::SimpleUnixConnectionProvider(const oatpp::String& path, bool nonBlocking, v_int32 permissions)
+  : m_path(path)
+  , m_nonBlocking(nonBlocking)
+  , m_permissions(permissions)
+  , m_closed(false)
+  , m_listenerNonBlocking(false)
+{
+  m_serverHandle = instantiateServer();
+  setProperty(PROPERTY_HOST, "localhost");
+  setProperty(PROPERTY_PORT, "0");
+}
+
+SimpleUnixConnectionProvider::SimpleUnixConnectionProvider(const oatpp::String& path,
+                                                           const SocketOptions& options,
+                                                           bool nonBlocking,
+                                                           v_int32 permissions)
+  : m_path(path)
+  , m_nonBlocking(nonBlocking)
+  , m_permissions(permissions)
+  , m_options(options)
+  , m_closed(false)
+  , m_listenerNonBlocking(false)
+{
+  m_serverHandle = instantiateServer();
+  setProperty(PROPERTY_HOST, "localhost");
+  setProperty(PROPERTY_PORT, "0");
+}
+
+SimpleUnixConnectionProvider::~SimpleUnixConnectionProvider() {
+  close();
+}
+
+void SimpleUnixConnectionProvider::close() {
+  if(!m_closed) {
+    m_closed = true;
+    ::shutdown(m_serverHandle, SHUT_RDWR);
+    ::close(m_serverHandle);
+    if(!isAbstract(m_path)) {
+      ::unlink((const char*) m_path->getData());
+    }
+  }
+}
+
+oatpp::data::v_io_handle SimpleUnixConnectionProvider::instantiateServer() {
+  
+  struct sockaddr_un addr;
+  socklen_t addrLength = createAddress(m_path, addr);
+  if(addrLength == 0) {
+    throw std::runtime_error("[oatpp::network::server::SimpleUnixConnectionProvider::instantiateServer()]: Error. Invalid path.");
+  }
+  
+  oatpp::data::v_io_handle serverHandle = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(serverHandle < 0) {
+    throw std::runtime_error("[oatpp::network::server::SimpleUnixConnectionProvider::instantiateServer()]: Error. Can't create socket.");
+  }
+  
+  if(!isAbstract(m_path)) {
+    /* Remove socket file left by the previous server. Don't touch anything which is not a socket */
+    struct stat fileStat;
+    if(lstat((const char*) m_path->getData(), &fileStat) == 0 && S_ISSOCK(fileStat.st_mode)) {
+      ::unlink((const char*) m_path->getData());
+    }
+  }
+  
+  if(bind(serverHandle, (struct sockaddr *)&addr, addrLength) != 0) {
+    ::close(serverHandle);
+    throw std::runtime_error("[oatpp::network::server::SimpleUnixConnectionProvider::instantiateServer()]: Error. Can't bind to address.");
+  }
+  
+  /* Nobody can connect before listen() - permissions are in place by then */
+  if(m_permissions != PERMISSIONS_DEFAULT && !isAbstract(m_path)) {
+    if(chmod((const char*) m_path->getData(), (mode_t) m_permissions) != 0) {
+      ::close(serverHandle);
+      ::unlink((const char*) m_path->getData());
+      throw std::runtime_error("[oatpp::network::server::SimpleUnixConnectionProvider::instantiateServer()]: Error. Can't set permissions.");
+    }
+  }
+  
+  if(listen(serverHandle, m_options.listenBacklog) != 0) {
+    ::close(serverHandle);
+    if(!isAbstract(m_path)) {
+      ::unlink((const char*) m_path->getData());
+    }
+    throw std::runtime_error("[oatpp::network::server::SimpleUnixConnectionProvider::instantiateServer()]: Error. Can't listen.");
+  }
+  
+  return serverHandle;
+  
+}
+
+std::shared_ptr<oatpp::data::stream::IOStream> SimpleUnixConnectionProvider::getConnection() {
+  /* Options of accepted TCP connections don't apply */
+  return SocketAcceptor::acceptConnection(m_serverHandle, m_nonBlocking, nullptr, m_closed,
+                                          "[oatpp::network::server::SimpleUnixConnectionProvider::getConnection()]");
+}
+
+oatpp::async::Action SimpleUnixConnectionProvider::getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                                      AsyncCallback callback) {
+  
+  if(!m_listenerNonBlocking) {
+    fcntl(m_serverHandle, F_SETFL, O_NONBLOCK);
+    m_listenerNonBlocking = true;
+  }
+  
+  return SocketAcceptor::acceptConnectionAsync(parentCoroutine, callback, m_serverHandle, m_nonBlocking, nullptr);
+  
+}
+
+}}}
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_network_server_SimpleUnixConnectionProvider_hpp
+#define oatpp_network_server_SimpleUnixConnectionProvider_hpp
+
+#include "oatpp/network/ConnectionProvider.hpp"
+#include "oatpp/network/SocketOptions.hpp"
+
+#include "oatpp/core/data/stream/Stream.hpp"
+#include "oatpp/core/Types.hpp"
+
+namespace oatpp { namespace network { namespace server {
+
+/**
+ * Server connection provider for Unix domain stream sockets (AF_UNIX). <br>
+ * For local callers it skips the TCP stack. Connections are &id:oatpp::network::Connection; as for TCP -
+ * &id:oatpp::web::server::HttpConnectionHandler; and &id:oatpp::web::server::AsyncHttpConnectionHandler; work unchanged.
+ */
+class SimpleUnixConnectionProvider : public base::Countable, public ServerConnectionProvider {
+public:
+  
+  /**
+   * Keep permissions of the socket file given by the process umask.
+   */
+  static constexpr const v_int32 PERMISSIONS_DEFAULT = -1;
+  
+private:
+  oatpp::String m_path;
+  bool m_nonBlocking;
+  v_int32 m_permissions;
+  SocketOptions m_options;
+  bool m_closed;
+  bool m_listenerNonBlocking;
+  oatpp::data::v_io_handle m_serverHandle;
+private:
+  oatpp::data::v_io_handle instantiateServer();
+public:
+  
+  /**
+   * Constructor.
+   * @param path - path of the socket file. Stale socket file left by the previous server is removed. <br>
+   * Path starting with `@` is an address in the abstract namespace (Linux) - no file is created.
+   * @param nonBlocking - put accepted connections to non-blocking mode.
+   * @param permissions - permissions of the socket file, e.g. `0660`. Connecting requires write permission.
+   * &l:SimpleUnixConnectionProvider::PERMISSIONS_DEFAULT; - leave as set by umask.
+   */
+  SimpleUnixConnectionProvider(const oatpp::String& path, bool nonBlocking = false, v_int32 permissions = PERMISSIONS_DEFAULT);
+  
+  /**
+   * Constructor.
+   * @param path - path of the socket file. See the constructor above.
+   * @param options - &id:oatpp::network::SocketOptions;. Only `listenBacklog` applies to Unix domain sockets.
+   * @param nonBlocking - put accepted connections to non-blocking mode.
+   * @param permissions - permissions of the socket file. See the constructor above.
+   */
+  SimpleUnixConnectionProvider(const oatpp::String& path,
+                               const SocketOptions& options,
+                               bool nonBlocking = false,
+                               v_int32 permissions = PERMISSIONS_DEFAULT);
+  
+public:
+  
+  static std::shared_ptr<SimpleUnixConnectionProvider> createShared(const oatpp::String& path,
+                                                                    bool nonBlocking = false,
+                                                                    v_int32 permissions = PERMISSIONS_DEFAULT)
+  {
+    return std::make_shared<SimpleUnixConnectionProvider>(path, nonBlocking, permissions);
+  }
+  
+  static std::shared_ptr<SimpleUnixConnectionProvider> createShared(const oatpp::String& path,
+                                                                    const SocketOptions& options,
+                                                                    bool nonBlocking = false,
+                                                                    v_int32 permissions = PERMISSIONS_DEFAULT)
+  {
+    return std::make_shared<SimpleUnixConnectionProvider>(path, options, nonBlocking, permissions);
+  }
+  
+  ~SimpleUnixConnectionProvider();
+  
+  /**
+   * Close listening socket and remove the socket file.
+   */
+  void close() override;
+  
+  std::shared_ptr<IOStream> getConnection() override;
+  
+  /**
+   * Accept connection in the executor. Same as &id:oatpp::network::server::SimpleTCPConnectionProvider::getConnectionAsync;.
+   * @param parentCoroutine - caller coroutine.
+   * @param callback - called with the accepted connection.
+   * @return - &id:oatpp::async::Action;.
+   */
+  Action getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                            AsyncCallback callback) override;
+  
+  oatpp::String getPath() {
+    return m_path;
+  }
+  
+};
+  
+}}}
+
+#endif /* oatpp_network_server_SimpleUnixConnectionProvider_hpp */
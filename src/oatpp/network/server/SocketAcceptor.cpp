@@ -0,0 +1,148 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "./SocketAcceptor.hpp"
+
+#include "oatpp/network/Connection.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace oatpp { namespace network { namespace server {
+
+data::v_io_handle SocketAcceptor::acceptSocket(data::v_io_handle serverHandle, bool nonBlocking, const SocketOptions* options) {
+
+#if defined(__linux__)
+  /* Accepted socket gets its flags right away - no fcntl() calls per connection */
+  int flags = SOCK_CLOEXEC;
+  if(nonBlocking) {
+    flags |= SOCK_NONBLOCK;
+  }
+  data::v_io_handle handle = accept4(serverHandle, nullptr, nullptr, flags);
+  if(handle < 0) {
+    return handle;
+  }
+#else
+  data::v_io_handle handle = accept(serverHandle, nullptr, nullptr);
+  if(handle < 0) {
+    return handle;
+  }
+  int flags = 0;
+  if(nonBlocking) {
+    flags |= O_NONBLOCK;
+  }
+  fcntl(handle, F_SETFL, flags);
+  fcntl(handle, F_SETFD, FD_CLOEXEC);
+#endif
+
+#ifdef SO_NOSIGPIPE
+  int yes = 1;
+  v_int32 ret = setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(int));
+  if(ret < 0) {
+    OATPP_LOGD("[oatpp::network::server::SocketAcceptor::acceptSocket()]", "Warning. Failed to set %s for socket", "SO_NOSIGPIPE");
+  }
+#endif
+
+  if(options != nullptr && options->hasAcceptedSocketOptions()) {
+    options->applyToAcceptedSocket(handle);
+  }
+
+  return handle;
+
+}
+
+std::shared_ptr<data::stream::IOStream> SocketAcceptor::acceptConnection(data::v_io_handle serverHandle,
+                                                                         bool nonBlocking,
+                                                                         const SocketOptions* options,
+                                                                         bool closed,
+                                                                         const char* tag)
+{
+
+  data::v_io_handle handle = acceptSocket(serverHandle, nonBlocking, options);
+
+  if (handle < 0) {
+    v_int32 error = errno;
+    if(error != EAGAIN && error != EWOULDBLOCK && !closed) { // Error is expected once provider is closed
+      OATPP_LOGD(tag, "Error. %d", error);
+    }
+    return nullptr;
+  }
+
+  return Connection::createShared(handle);
+
+}
+
+oatpp::async::Action SocketAcceptor::acceptConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                           ConnectionProvider::AsyncCallback callback,
+                                                           data::v_io_handle serverHandle,
+                                                           bool nonBlocking,
+                                                           const SocketOptions* options)
+{
+
+  class AcceptCoroutine : public oatpp::async::CoroutineWithResult<AcceptCoroutine, std::shared_ptr<oatpp::data::stream::IOStream>> {
+  private:
+    data::v_io_handle m_serverHandle;
+    bool m_nonBlocking;
+    const SocketOptions* m_options;
+  public:
+
+    AcceptCoroutine(data::v_io_handle serverHandle, bool nonBlocking, const SocketOptions* options)
+      : m_serverHandle(serverHandle)
+      , m_nonBlocking(nonBlocking)
+      , m_options(options)
+    {}
+
+    Action act() override {
+
+      data::v_io_handle handle = acceptSocket(m_serverHandle, m_nonBlocking, m_options);
+
+      if(handle >= 0) {
+        return _return(Connection::createShared(handle));
+      }
+
+      v_int32 errorCode = errno;
+      if(errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+        /* Accept queue is drained. Wait for the next batch */
+        return waitForIO(m_serverHandle, oatpp::async::Action::IO_EVENT_READ);
+      } else if(errorCode == EINTR || errorCode == ECONNABORTED) {
+        return repeat();
+      } else if(errorCode == EMFILE || errorCode == ENFILE || errorCode == ENOBUFS || errorCode == ENOMEM) {
+        /* Out of resources. Pending connections stay in the accept queue - retry later instead of spinning */
+        OATPP_LOGD("[oatpp::network::server::SocketAcceptor::acceptConnectionAsync()]", "Error. %d. Retry in 10ms.", errorCode);
+        return waitUntil(oatpp::base::Environment::getMicroTickCount() + 10 * 1000);
+      }
+
+      return error("[oatpp::network::server::SocketAcceptor::acceptConnectionAsync()]: Error. Can't accept connection.");
+
+    }
+
+  };
+
+  return parentCoroutine->startCoroutineForResult<AcceptCoroutine>(callback, serverHandle, nonBlocking, options);
+
+}
+
+}}}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_network_server_SocketAcceptor_hpp
+#define oatpp_network_server_SocketAcceptor_hpp
+
+#include "oatpp/network/ConnectionProvider.hpp"
+#include "oatpp/network/SocketOptions.hpp"
+
+namespace oatpp { namespace network { namespace server {
+
+/**
+ * Accept loop shared by server connection providers listening on a stream socket -
+ * &id:oatpp::network::server::SimpleTCPConnectionProvider; and &id:oatpp::network::server::SimpleUnixConnectionProvider;.
+ */
+class SocketAcceptor {
+public:
+  
+  /**
+   * Accept socket. Accepted socket gets close-on-exec and non-blocking flags right away where `accept4` is available.
+   * @param serverHandle - listening socket.
+   * @param nonBlocking - put accepted socket to non-blocking mode.
+   * @param options - &id:oatpp::network::SocketOptions; to apply to the accepted socket. May be `nullptr`.
+   * @return - accepted socket or negative value with `errno` set.
+   */
+  static data::v_io_handle acceptSocket(data::v_io_handle serverHandle, bool nonBlocking, const SocketOptions* options);
+  
+  /**
+   * Accept connection. Blocks if listening socket is blocking.
+   * @param serverHandle - listening socket.
+   * @param nonBlocking - put accepted connection to non-blocking mode.
+   * @param options - &id:oatpp::network::SocketOptions; to apply to the accepted socket. May be `nullptr`.
+   * @param closed - listening socket is closed by the provider - error is expected and is not logged.
+   * @param tag - tag of the provider to log errors with.
+   * @return - &id:oatpp::network::Connection; or `nullptr`.
+   */
+  static std::shared_ptr<data::stream::IOStream> acceptConnection(data::v_io_handle serverHandle,
+                                                                  bool nonBlocking,
+                                                                  const SocketOptions* options,
+                                                                  bool closed,
+                                                                  const char* tag);
+  
+  /**
+   * Accept connection in the executor. Drains the accept queue and waits for the listening socket to become readable once it is empty.
+   * On out of resources (`EMFILE`, `ENFILE`, `ENOBUFS`, `ENOMEM`) accept is retried in 10 milliseconds -
+   * pending connections stay in the accept queue. Other errors end the accept coroutine with error.
+   * @param parentCoroutine - caller coroutine.
+   * @param callback - called with the accepted connection.
+   * @param serverHandle - listening socket. Must be non-blocking.
+   * @param nonBlocking - put accepted connection to non-blocking mode.
+   * @param options - &id:oatpp::network::SocketOptions; to apply to the accepted socket. May be `nullptr`.
+   * Should live as long as the provider.
+   * @return - &id:oatpp::async::Action;.
+   */
+  static oatpp::async::Action acceptConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                                    ConnectionProvider::AsyncCallback callback,
+                                                    data::v_io_handle serverHandle,
+                                                    bool nonBlocking,
+                                                    const SocketOptions* options);
+  
+};
+  
+}}}
+
+#endif /* oatpp_network_server_SocketAcceptor_hpp */
@@ -65,11 +65,16 @@ data::v_io_size Pipe::Reader::read(void *data, data::v_io_size count) {
   }
   
   pipe.m_conditionWrite.notify_one();
+  pipe.m_writeWaitList.notifyAll();
   
   return result;
   
 }
 
+oatpp::async::CoroutineWaitList* Pipe::Reader::getWaitList() {
+  return &m_pipe->m_readWaitList;
+}
+
 void Pipe::Writer::setMaxAvailableToWrite(data::v_io_size maxAvailableToWrite) {
   m_maxAvailableToWrtie = maxAvailableToWrite;
 }
@@ -109,9 +114,30 @@ data::v_io_size Pipe::Writer::write(const void *data, data::v_io_size count) {
   }
   
   pipe.m_conditionRead.notify_one();
+  pipe.m_readWaitList.notifyAll();
   
   return result;
   
 }
+
+oatpp::async::CoroutineWaitList* Pipe::Writer::getWaitList() {
+  return &m_pipe->m_writeWaitList;
+}
+
+void Pipe::onNewItem(oatpp::async::CoroutineWaitList& list) {
+  /* Coroutine may be parked after the pipe became ready. Check again and resume it */
+  bool ready;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(&list == &m_readWaitList) {
+      ready = !m_open || m_fifo.availableToRead() > 0;
+    } else {
+      ready = !m_open || m_fifo.availableToWrite() > 0;
+    }
+  }
+  if(ready) {
+    list.notifyAll();
+  }
+}
   
 }}}
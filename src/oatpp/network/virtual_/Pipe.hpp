@@ -30,6 +30,7 @@
 #include "oatpp/core/data/buffer/FIFOBuffer.hpp"
 #include "oatpp/core/data/buffer/IOBuffer.hpp"
 
+#include "oatpp/core/async/CoroutineWaitList.hpp"
 #include "oatpp/core/concurrency/SpinLock.hpp"
 
 #include <mutex>
@@ -37,7 +38,7 @@
 
 namespace oatpp { namespace network { namespace virtual_ {
 
-class Pipe : public oatpp::base::Countable {
+class Pipe : public oatpp::base::Countable, private oatpp::async::CoroutineWaitList::Listener {
 public:
   
   class Reader : public oatpp::data::stream::InputStream {
@@ -69,6 +70,12 @@ public:
     
     data::v_io_size read(void *data, data::v_io_size count) override;
     
+    /**
+     * Coroutines parked in this list are resumed once pipe has data to read or is closed.
+     * @return - &id:oatpp::async::CoroutineWaitList;.
+     */
+    oatpp::async::CoroutineWaitList* getWaitList();
+    
   };
   
   class Writer : public oatpp::data::stream::OutputStream {
@@ -100,6 +107,12 @@ public:
     
     data::v_io_size write(const void *data, data::v_io_size count) override;
     
+    /**
+     * Coroutines parked in this list are resumed once pipe has space to write or is closed.
+     * @return - &id:oatpp::async::CoroutineWaitList;.
+     */
+    oatpp::async::CoroutineWaitList* getWaitList();
+    
   };
   
 private:
@@ -113,6 +126,11 @@ private:
   std::mutex m_mutex;
   std::condition_variable m_conditionRead;
   std::condition_variable m_conditionWrite;
+  
+  oatpp::async::CoroutineWaitList m_readWaitList;
+  oatpp::async::CoroutineWaitList m_writeWaitList;
+private:
+  void onNewItem(oatpp::async::CoroutineWaitList& list) override;
 public:
   
   Pipe()
@@ -121,6 +139,8 @@ public:
     , m_reader(this)
     , m_buffer()
     , m_fifo(m_buffer.getData(), m_buffer.getSize())
+    , m_readWaitList(this)
+    , m_writeWaitList(this)
   {}
   
   static std::shared_ptr<Pipe> createShared(){
@@ -142,6 +162,8 @@ public:
     }
     m_conditionRead.notify_one();
     m_conditionWrite.notify_one();
+    m_readWaitList.notifyAll();
+    m_writeWaitList.notifyAll();
   }
   
 };
@@ -24,6 +24,8 @@
 
 #include "Socket.hpp"
 
+#include "oatpp/core/async/Fiber.hpp"
+
 namespace oatpp { namespace network { namespace virtual_ {
   
 void Socket::setMaxAvailableToReadWrtie(data::v_io_size maxToRead, data::v_io_size maxToWrite) {
@@ -31,12 +33,27 @@ void Socket::setMaxAvailableToReadWrtie(data::v_io_size maxToRead, data::v_io_si
   m_pipeOut->getWriter()->setMaxAvailableToWrite(maxToWrite);
 }
   
+data::v_io_size Socket::waitInFiber(data::v_io_size ioResult, oatpp::async::CoroutineWaitList* waitList) {
+  if(ioResult == data::IOError::WAIT_RETRY) {
+    oatpp::async::Fiber* fiber = oatpp::async::Fiber::getCurrent();
+    if(fiber != nullptr) {
+      if(fiber->suspend(oatpp::async::Action::createWaitListAction(waitList))) {
+        return data::IOError::RETRY;
+      }
+      return data::IOError::BROKEN_PIPE;
+    }
+  }
+  return ioResult;
+}
+
 data::v_io_size Socket::read(void *data, data::v_io_size count) {
-  return m_pipeIn->getReader()->read(data, count);
+  auto reader = m_pipeIn->getReader();
+  return waitInFiber(reader->read(data, count), reader->getWaitList());
 }
 
 data::v_io_size Socket::write(const void *data, data::v_io_size count) {
-  return m_pipeOut->getWriter()->write(data, count);
+  auto writer = m_pipeOut->getWriter();
+  return waitInFiber(writer->write(data, count), writer->getWaitList());
 }
 
 void Socket::setNonBlocking(bool nonBlocking) {
@@ -33,6 +33,9 @@ class Socket : public oatpp::base::Countable, public oatpp::data::stream::IOStre
 private:
   std::shared_ptr<Pipe> m_pipeIn;
   std::shared_ptr<Pipe> m_pipeOut;
+private:
+  /* If running in &id:oatpp::async::Fiber; - turn IOError::WAIT_RETRY into fiber suspension in the pipe's wait list and IOError::RETRY */
+  data::v_io_size waitInFiber(data::v_io_size ioResult, oatpp::async::CoroutineWaitList* waitList);
 public:
   Socket(const std::shared_ptr<Pipe>& pipeIn, const std::shared_ptr<Pipe>& pipeOut)
     : m_pipeIn(pipeIn)
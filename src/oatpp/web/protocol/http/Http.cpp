@@ -108,6 +108,7 @@ const char* const Header::Value::TRANSFER_ENCODING_CHUNKED = "chunked";
 const char* const Header::Value::CONTENT_TYPE_APPLICATION_JSON = "application/json";
   
 const char* const Header::ACCEPT = "Accept";
+const char* const Header::ACCEPT_RANGES = "Accept-Ranges";
 const char* const Header::AUTHORIZATION = "Authorization";
 const char* const Header::CONNECTION = "Connection";
 const char* const Header::TRANSFER_ENCODING = "Transfer-Encoding";
@@ -128,12 +129,35 @@ oatpp::String Range::toString() const {
   oatpp::data::stream::ChunkedBuffer stream;
   stream.write(units->getData(), units->getSize());
   stream.write("=", 1);
-  stream.writeAsString((v_int64) start);
+  if(start >= 0) {
+    stream.writeAsString((v_int64) start);
+  }
   stream.write("-", 1);
-  stream.writeAsString((v_int64) end);
+  if(end >= 0) {
+    stream.writeAsString((v_int64) end);
+  }
   return stream.toString();
 }
 
+namespace {
+
+  /**
+   * Range position is one or more digits. Positions which don't fit v_int64 are not valid.
+   */
+  bool isRangePosition(p_char8 data, v_int32 size) {
+    if(size < 1 || size > 18) {
+      return false;
+    }
+    for(v_int32 i = 0; i < size; i ++) {
+      if(data[i] < '0' || data[i] > '9') {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
+
 Range Range::parse(oatpp::parser::Caret& caret) {
 
   auto unitsLabel = caret.putLabel();
@@ -158,8 +182,29 @@ Range Range::parse(oatpp::parser::Caret& caret) {
   caret.findRN();
   endLabel.end();
   
-  oatpp::data::v_io_size start = oatpp::utils::conversion::strToInt64((const char*) startLabel.getData());
-  oatpp::data::v_io_size end = oatpp::utils::conversion::strToInt64((const char*) endLabel.getData());
+  if((startLabel.getSize() > 0 && !isRangePosition(startLabel.getData(), startLabel.getSize())) ||
+     (endLabel.getSize() > 0 && !isRangePosition(endLabel.getData(), endLabel.getSize())))
+  {
+    caret.setError("Invalid range position");
+    return Range();
+  }
+  
+  oatpp::data::v_io_size start = -1;
+  oatpp::data::v_io_size end = -1;
+  if(startLabel.getSize() > 0) {
+    start = oatpp::utils::conversion::strToInt64((const char*) startLabel.getData());
+  }
+  if(endLabel.getSize() > 0) {
+    end = oatpp::utils::conversion::strToInt64((const char*) endLabel.getData());
+  }
+  if(start < 0 && end < 0) {
+    caret.setError("Range position expected");
+    return Range();
+  }
+  if(start >= 0 && end >= 0 && end < start) {
+    caret.setError("Last range position is less than first position");
+    return Range();
+  }
   return Range(unitsLabel.toString(true), start, end);
   
 }
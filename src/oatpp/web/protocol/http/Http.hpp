@@ -164,6 +164,7 @@ public:
   };
 public:
   static const char* const ACCEPT;              // "Accept"
+  static const char* const ACCEPT_RANGES;       // "Accept-Ranges"
   static const char* const AUTHORIZATION;       // "Authorization"
   static const char* const CONNECTION;          // "Connection"
   static const char* const TRANSFER_ENCODING;   // "Transfer-Encoding"
@@ -196,7 +197,15 @@ public:
   {}
   
   oatpp::String units;
+  
+  /**
+   * First position. -1 for suffix range ("bytes=-500") - then `end` is the suffix length.
+   */
   oatpp::data::v_io_size start;
+  
+  /**
+   * Last position (inclusive). -1 for open range ("bytes=100-").
+   */
   oatpp::data::v_io_size end;
   
   oatpp::String toString() const;
@@ -146,10 +146,10 @@ RequestHeadersReader::Action RequestHeadersReader::readHeadersAsync(oatpp::async
           }
         }
         
-        return waitRetry();
+        return repeat();
         
       } else if(res == data::IOError::WAIT_RETRY || res == data::IOError::RETRY) {
-        return waitRetry();
+        return m_connection->suggestInputStreamAction(res);
       } else {
         return abort();
       }
@@ -146,10 +146,10 @@ ResponseHeadersReader::Action ResponseHeadersReader::readHeadersAsync(oatpp::asy
           }
         }
         
-        return waitRetry();
+        return repeat();
         
       } else if(res == data::IOError::WAIT_RETRY || res == data::IOError::RETRY) {
-        return waitRetry();
+        return m_connection->suggestInputStreamAction(res);
       } else {
         return abort();
       }
@@ -152,10 +152,8 @@ oatpp::async::Action SimpleBodyDecoder::doChunkedDecodingAsync(oatpp::async::Abs
     
     Action readLineChar() {
       auto res = m_fromStream->read(&m_lineChar, 1);
-      if(res == data::IOError::WAIT_RETRY) {
-        return oatpp::async::Action::_WAIT_RETRY;
-      } else if(res == data::IOError::RETRY) {
-        return oatpp::async::Action::_REPEAT;
+      if(res == data::IOError::WAIT_RETRY || res == data::IOError::RETRY) {
+        return m_fromStream->suggestInputStreamAction(res);
       } else if( res < 0) {
         return error("[BodyDecoder::ChunkedDecoder] Can't read line char");
       }
@@ -31,6 +31,8 @@
 #include "oatpp/core/collection/ListMap.hpp"
 #include "oatpp/core/async/Coroutine.hpp"
 
+#include <vector>
+
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
   
 class Body {
@@ -55,6 +57,17 @@ public:
                                     const Action& actionOnReturn,
                                     const std::shared_ptr<OutputStream>& stream) = 0;
   
+  /**
+   * Append references to in-memory body data to vectors, so that body can be sent together with headers by one gather-write.
+   * Called after declareHeaders(). Data must stay valid while body object is alive.
+   * Default implementation appends nothing - body is written by writeToStream().
+   * @param vectors - vectors to append to.
+   * @return - `true` if body data was appended.
+   */
+  virtual bool appendDataVectors(std::vector<oatpp::data::stream::IOVector>& /* vectors */) noexcept {
+    return false;
+  }
+  
 };
   
 }}}}}
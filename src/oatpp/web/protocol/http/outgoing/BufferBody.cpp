@@ -54,6 +54,10 @@ void BufferBody::writeToStream(const std::shared_ptr<OutputStream>& stream) noex
   oatpp::data::stream::writeExactSizeData(stream.get(), m_buffer->getData(), m_buffer->getSize());
 }
 
+bool BufferBody::appendDataVectors(std::vector<oatpp::data::stream::IOVector>& vectors) noexcept {
+  vectors.push_back({m_buffer->getData(), m_buffer->getSize()});
+  return true;
+}
 
 async::Action BufferBody::writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
                                              const Action& actionOnReturn,
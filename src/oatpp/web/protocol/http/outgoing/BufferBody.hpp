@@ -44,6 +44,7 @@ public:
   static std::shared_ptr<BufferBody> createShared(const oatpp::String& buffer);
   void declareHeaders(Headers& headers) noexcept override;
   void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override;
+  bool appendDataVectors(std::vector<oatpp::data::stream::IOVector>& vectors) noexcept override;
   
 public:
   
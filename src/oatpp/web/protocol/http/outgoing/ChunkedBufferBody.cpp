@@ -67,6 +67,19 @@ void ChunkedBufferBody::writeToStream(const std::shared_ptr<OutputStream>& strea
   }
 }
 
+bool ChunkedBufferBody::appendDataVectors(std::vector<oatpp::data::stream::IOVector>& vectors) noexcept {
+  if(m_chunked) {
+    return false;
+  }
+  auto chunks = m_buffer->getChunks();
+  auto curr = chunks->getFirstNode();
+  while (curr != nullptr) {
+    vectors.push_back({curr->getData()->data, curr->getData()->size});
+    curr = curr->getNext();
+  }
+  return true;
+}
+
 ChunkedBufferBody::WriteToStreamCoroutine::WriteToStreamCoroutine(const std::shared_ptr<ChunkedBufferBody>& body,
                                                                   const std::shared_ptr<OutputStream>& stream)
   : m_body(body)
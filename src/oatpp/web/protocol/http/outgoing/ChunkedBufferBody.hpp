@@ -53,6 +53,11 @@ public:
   
   void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override;
   
+  /**
+   * Append chunks of the buffer. Not supported for chunked transfer-encoding.
+   */
+  bool appendDataVectors(std::vector<oatpp::data::stream::IOVector>& vectors) noexcept override;
+  
 public:
   
   class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
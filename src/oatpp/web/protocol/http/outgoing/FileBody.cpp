@@ -0,0 +1,161 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FileBody.hpp"
+
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+
+FileBody::WriteToStreamCoroutine::WriteToStreamCoroutine(const std::shared_ptr<FileBody>& body,
+                                                         const std::shared_ptr<OutputStream>& stream)
+  : m_body(body)
+  , m_stream(stream)
+  , m_offset(body->m_rangeStart)
+  , m_bytesLeft(body->m_rangeSize)
+{}
+
+async::Action FileBody::WriteToStreamCoroutine::act() {
+  if(m_bytesLeft > 0) {
+    auto res = m_stream->writeFile(m_body->m_handle, m_offset, m_bytesLeft);
+    if(res > 0) {
+      m_offset += res;
+      m_bytesLeft -= res;
+      if(m_bytesLeft > 0) {
+        return repeat();
+      }
+    } else {
+      return m_stream->suggestOutputStreamAction(res);
+    }
+  }
+  return finish();
+}
+
+FileBody::FileBody(data::v_io_handle handle, data::v_io_size fileSize)
+  : m_handle(handle)
+  , m_fileSize(fileSize)
+  , m_rangeStart(0)
+  , m_rangeSize(fileSize)
+  , m_partial(false)
+{}
+
+FileBody::~FileBody() {
+  ::close(m_handle);
+}
+
+std::shared_ptr<FileBody> FileBody::createShared(const char* filename) {
+  
+  data::v_io_handle handle = ::open(filename, O_RDONLY | O_CLOEXEC);
+  if(handle < 0) {
+    return nullptr;
+  }
+  
+  struct stat info;
+  if(::fstat(handle, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(handle);
+    return nullptr;
+  }
+  
+  return Shared_Http_Outgoing_FileBody_Pool::allocateShared(handle, (data::v_io_size) info.st_size);
+  
+}
+
+bool FileBody::setRange(const Range& range) {
+  
+  if(!range.isValid() || !range.units->equals(Range::UNIT_BYTES)) {
+    return false;
+  }
+  
+  data::v_io_size start;
+  data::v_io_size end = m_fileSize - 1;
+  
+  if(range.start < 0) { // suffix range - last range.end bytes
+    if(range.end <= 0) {
+      return false;
+    }
+    start = range.end < m_fileSize ? m_fileSize - range.end : 0;
+  } else {
+    start = range.start;
+    if(range.end >= 0 && range.end < end) {
+      end = range.end;
+    }
+  }
+  
+  if(start >= m_fileSize || start > end) {
+    return false;
+  }
+  
+  m_rangeStart = start;
+  m_rangeSize = end - start + 1;
+  m_partial = true;
+  return true;
+  
+}
+
+bool FileBody::isPartial() const {
+  return m_partial;
+}
+
+data::v_io_size FileBody::getFileSize() const {
+  return m_fileSize;
+}
+
+void FileBody::declareHeaders(Headers& headers) noexcept {
+  headers[oatpp::web::protocol::http::Header::ACCEPT_RANGES] = Range::UNIT_BYTES;
+  headers[oatpp::web::protocol::http::Header::CONTENT_LENGTH] = oatpp::utils::conversion::int64ToStr(m_rangeSize);
+  if(m_partial) {
+    ContentRange contentRange(Range::UNIT_BYTES, m_rangeStart, m_rangeStart + m_rangeSize - 1, m_fileSize, true);
+    headers[oatpp::web::protocol::http::Header::CONTENT_RANGE] = contentRange.toString();
+  }
+}
+
+void FileBody::writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept {
+  
+  data::v_io_size offset = m_rangeStart;
+  data::v_io_size bytesLeft = m_rangeSize;
+  
+  while(bytesLeft > 0) {
+    auto res = stream->writeFile(m_handle, offset, bytesLeft);
+    if(res > 0) {
+      offset += res;
+      bytesLeft -= res;
+    } else if(res != data::IOError::RETRY && res != data::IOError::WAIT_RETRY) {
+      return;
+    }
+  }
+  
+}
+
+async::Action FileBody::writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                                           const Action& actionOnReturn,
+                                           const std::shared_ptr<OutputStream>& stream) {
+  return parentCoroutine->startCoroutine<WriteToStreamCoroutine>(actionOnReturn, shared_from_this(), stream);
+}
+
+}}}}}
@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_web_protocol_http_outgoing_FileBody_hpp
+#define oatpp_web_protocol_http_outgoing_FileBody_hpp
+
+#include "./Body.hpp"
+#include "oatpp/web/protocol/http/Http.hpp"
+
+namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
+
+/**
+ * Body serving a regular file. File data is written by &id:oatpp::data::stream::OutputStream::writeFile;
+ * which is `sendfile` for &id:oatpp::network::Connection; - without copying data to user space.
+ * Body may be restricted to a byte range for `206 Partial Content` responses. See &l:FileBody::setRange ();.
+ */
+class FileBody : public oatpp::base::Countable, public Body, public std::enable_shared_from_this<FileBody> {
+public:
+  OBJECT_POOL(Http_Outgoing_FileBody_Pool, FileBody, 32)
+  SHARED_OBJECT_POOL(Shared_Http_Outgoing_FileBody_Pool, FileBody, 32)
+private:
+  data::v_io_handle m_handle;
+  data::v_io_size m_fileSize;
+  data::v_io_size m_rangeStart;
+  data::v_io_size m_rangeSize;
+  bool m_partial;
+public:
+  /**
+   * Constructor. Body takes ownership of the file handle - handle is closed in destructor.
+   * @param handle - handle of a regular file opened for reading.
+   * @param fileSize - size of the file.
+   */
+  FileBody(data::v_io_handle handle, data::v_io_size fileSize);
+  ~FileBody();
+public:
+  
+  /**
+   * Open file.
+   * @param filename
+   * @return - body, or `nullptr` if file can't be opened or is not a regular file.
+   */
+  static std::shared_ptr<FileBody> createShared(const char* filename);
+  
+  /**
+   * Restrict body to the range of file. `Content-Range` header is declared for the range.
+   * Open ("bytes=100-") and suffix ("bytes=-500") ranges are supported. Last position is clamped to the file size.
+   * @param range - &id:oatpp::web::protocol::http::Range;.
+   * @return - `false` if range units are not bytes, or range is not satisfiable. Body is not changed in this case.
+   */
+  bool setRange(const Range& range);
+  
+  /**
+   * Body is restricted to a range of file.
+   * @return
+   */
+  bool isPartial() const;
+  
+  data::v_io_size getFileSize() const;
+  
+  void declareHeaders(Headers& headers) noexcept override;
+  void writeToStream(const std::shared_ptr<OutputStream>& stream) noexcept override;
+  
+public:
+  
+  class WriteToStreamCoroutine : public oatpp::async::Coroutine<WriteToStreamCoroutine> {
+  private:
+    std::shared_ptr<FileBody> m_body;
+    std::shared_ptr<OutputStream> m_stream;
+    data::v_io_size m_offset;
+    data::v_io_size m_bytesLeft;
+  public:
+    
+    WriteToStreamCoroutine(const std::shared_ptr<FileBody>& body,
+                           const std::shared_ptr<OutputStream>& stream);
+    
+    Action act() override;
+    
+  };
+  
+public:
+  
+  Action writeToStreamAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
+                            const Action& actionOnReturn,
+                            const std::shared_ptr<OutputStream>& stream) override;
+  
+};
+  
+}}}}}
+
+#endif /* oatpp_web_protocol_http_outgoing_FileBody_hpp */
@@ -24,7 +24,9 @@
 
 #include "./Response.hpp"
 
-#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <cstring>
 
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
 
@@ -68,34 +70,65 @@ std::shared_ptr<oatpp::network::server::ConnectionHandler> Response::getConnecti
   return m_connectionUpgradeHandler;
 }
 
-void Response::send(const std::shared_ptr<data::stream::OutputStream>& stream) {
-  
+oatpp::String Response::createHeadersBlock() {
+
   if(m_body){
     m_body->declareHeaders(m_headers);
   } else {
     m_headers[Header::CONTENT_LENGTH] = "0";
   }
+
+  v_char8 code[16];
+  v_int32 codeSize = oatpp::utils::conversion::int32ToCharSequence(m_status.code, code);
+  v_int32 descriptionSize = m_status.description == nullptr ? 0 : (v_int32) std::strlen(m_status.description);
+
+  v_int32 size = 9 + codeSize + 1 + descriptionSize + 2 + 2;
+  for(auto it = m_headers.begin(); it != m_headers.end(); it ++) {
+    size += it->first.getSize() + 2 + it->second.getSize() + 2;
+  }
+
+  auto block = oatpp::String(size);
+  p_char8 data = block->getData();
+  v_int32 pos = 0;
+
+  std::memcpy(&data[pos], "HTTP/1.1 ", 9); pos += 9;
+  std::memcpy(&data[pos], code, codeSize); pos += codeSize;
+  data[pos ++] = ' ';
+  std::memcpy(&data[pos], m_status.description, descriptionSize); pos += descriptionSize;
+  data[pos ++] = '\r';
+  data[pos ++] = '\n';
+
+  for(auto it = m_headers.begin(); it != m_headers.end(); it ++) {
+    std::memcpy(&data[pos], it->first.getData(), it->first.getSize()); pos += it->first.getSize();
+    data[pos ++] = ':';
+    data[pos ++] = ' ';
+    std::memcpy(&data[pos], it->second.getData(), it->second.getSize()); pos += it->second.getSize();
+    data[pos ++] = '\r';
+    data[pos ++] = '\n';
+  }
+
+  data[pos ++] = '\r';
+  data[pos ++] = '\n';
+
+  return block;
+
+}
+
+void Response::send(const std::shared_ptr<data::stream::OutputStream>& stream) {
   
-  stream->write("HTTP/1.1 ", 9);
-  stream->writeAsString(m_status.code);
-  stream->write(" ", 1);
-  stream->OutputStream::write(m_status.description);
-  stream->write("\r\n", 2);
+  auto headers = createHeadersBlock();
   
-  auto it = m_headers.begin();
-  while(it != m_headers.end()) {
-    stream->write(it->first.getData(), it->first.getSize());
-    stream->write(": ", 2);
-    stream->write(it->second.getData(), it->second.getSize());
-    stream->write("\r\n", 2);
-    it ++;
-  }
+  std::vector<data::stream::IOVector> vectors;
+  vectors.push_back({headers->getData(), headers->getSize()});
   
-  stream->write("\r\n", 2);
-  if(m_body) {
+  if(m_body && !m_body->appendDataVectors(vectors)) {
+    data::stream::writeExactSizeData(stream.get(), headers->getData(), headers->getSize());
     m_body->writeToStream(stream);
+    return;
   }
   
+  data::stream::writeExactSizeDataV(stream.get(), vectors.data(), (v_int32) vectors.size());
+  
 }
   
 oatpp::async::Action Response::sendAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
@@ -106,47 +139,43 @@ oatpp::async::Action Response::sendAsync(oatpp::async::AbstractCoroutine* parent
   private:
     std::shared_ptr<Response> m_response;
     std::shared_ptr<data::stream::OutputStream> m_stream;
-    std::shared_ptr<oatpp::data::stream::ChunkedBuffer> m_buffer;
+    oatpp::String m_headersBlock;
+    std::vector<data::stream::IOVector> m_vectors;
+    data::stream::IOVector* m_currVectors;
+    v_int32 m_currVectorsCount;
+    const void* m_currData;
+    data::v_io_size m_currDataSize;
   public:
     
     SendAsyncCoroutine(const std::shared_ptr<Response>& response,
                        const std::shared_ptr<data::stream::OutputStream>& stream)
       : m_response(response)
       , m_stream(stream)
-      , m_buffer(oatpp::data::stream::ChunkedBuffer::createShared())
     {}
     
     Action act() {
     
-      if(m_response->m_body){
-        m_response->m_body->declareHeaders(m_response->m_headers);
-      } else {
-        m_response->m_headers[Header::CONTENT_LENGTH] = "0";
-      }
-      
-      m_buffer->write("HTTP/1.1 ", 9);
-      m_buffer->writeAsString(m_response->m_status.code);
-      m_buffer->write(" ", 1);
-      m_buffer->OutputStream::write(m_response->m_status.description);
-      m_buffer->write("\r\n", 2);
+      m_headersBlock = m_response->createHeadersBlock();
+      m_vectors.push_back({m_headersBlock->getData(), m_headersBlock->getSize()});
       
-      auto it = m_response->m_headers.begin();
-      while(it != m_response->m_headers.end()) {
-        m_buffer->write(it->first.getData(), it->first.getSize());
-        m_buffer->write(": ", 2);
-        m_buffer->write(it->second.getData(), it->second.getSize());
-        m_buffer->write("\r\n", 2);
-        it ++;
+      if(m_response->m_body && !m_response->m_body->appendDataVectors(m_vectors)) {
+        m_currData = m_headersBlock->getData();
+        m_currDataSize = m_headersBlock->getSize();
+        return yieldTo(&SendAsyncCoroutine::writeHeaders);
       }
       
-      m_buffer->write("\r\n", 2);
-      
-      return yieldTo(&SendAsyncCoroutine::writeHeaders);
+      m_currVectors = m_vectors.data();
+      m_currVectorsCount = (v_int32) m_vectors.size();
+      return yieldTo(&SendAsyncCoroutine::writeVectors);
+    
+    }
     
+    Action writeVectors() {
+      return data::stream::writeExactSizeDataVAsyncInline(m_stream.get(), m_currVectors, m_currVectorsCount, finish());
     }
     
     Action writeHeaders() {
-      return m_buffer->flushToStreamAsync(this, yieldTo(&SendAsyncCoroutine::writeBody), m_stream);
+      return data::stream::writeExactSizeDataAsyncInline(m_stream.get(), m_currData, m_currDataSize, yieldTo(&SendAsyncCoroutine::writeBody));
     }
     
     Action writeBody() {
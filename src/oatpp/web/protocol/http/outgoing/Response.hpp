@@ -43,6 +43,11 @@ private:
   Headers m_headers;
   std::shared_ptr<Body> m_body;
   std::shared_ptr<oatpp::network::server::ConnectionHandler> m_connectionUpgradeHandler;
+private:
+  /**
+   * Declare body headers and serialize status line and headers into one contiguous block.
+   */
+  oatpp::String createHeadersBlock();
 public:
   Response(const Status& status, const std::shared_ptr<Body>& body);
 public:
@@ -61,6 +66,12 @@ public:
   
   std::shared_ptr<oatpp::network::server::ConnectionHandler> getConnectionUpgradeHandler();
   
+  /**
+   * Send response. If body data is in memory (see &id:oatpp::web::protocol::http::outgoing::Body::appendDataVectors;),
+   * headers block and body data are written by one gather-write without copying.
+   * Otherwise headers are written to stream and body is written by Body::writeToStream().
+   * @param stream
+   */
   void send(const std::shared_ptr<data::stream::OutputStream>& stream);
   
   oatpp::async::Action sendAsync(oatpp::async::AbstractCoroutine* parentCoroutine,
@@ -28,6 +28,10 @@
 #include "./ChunkedBufferBody.hpp"
 #include "./DtoBody.hpp"
 
+#include "oatpp/core/utils/ConversionUtils.hpp"
+
+#include <cstring>
+
 namespace oatpp { namespace web { namespace protocol { namespace http { namespace outgoing {
   
 std::shared_ptr<Response>
@@ -47,5 +51,24 @@ ResponseFactory::createShared(const Status& status,
   return Response::createShared(status, DtoBody::createShared(dto, objectMapper));
 }
 
+std::shared_ptr<Response>
+ResponseFactory::createShared(const std::shared_ptr<FileBody>& body, const oatpp::String& rangeHeader) {
+  
+  if(rangeHeader && std::memchr(rangeHeader->getData(), ',', rangeHeader->getSize()) == nullptr) {
+    auto range = Range::parse(rangeHeader);
+    if(range.isValid() && range.units->equals(Range::UNIT_BYTES)) {
+      if(body->setRange(range)) {
+        return Response::createShared(Status::CODE_206, body);
+      }
+      auto response = Response::createShared(Status::CODE_416, nullptr);
+      response->putHeader(Header::CONTENT_RANGE, oatpp::String(Range::UNIT_BYTES) + " */" + oatpp::utils::conversion::int64ToStr(body->getFileSize()));
+      return response;
+    }
+  }
+  
+  return Response::createShared(Status::CODE_200, body);
+  
+}
+
   
 }}}}}
@@ -26,6 +26,7 @@
 #define oatpp_web_protocol_http_outgoing_ResponseFactory_hpp
 
 #include "./Response.hpp"
+#include "./FileBody.hpp"
 
 #include "oatpp/core/data/mapping/ObjectMapper.hpp"
 #include "oatpp/core/data/mapping/type/Type.hpp"
@@ -42,6 +43,15 @@ public:
                               const oatpp::data::mapping::type::AbstractObjectWrapper& dto,
                               oatpp::data::mapping::ObjectMapper* objectMapper);
   
+  /**
+   * Create response for file body honoring value of the request `Range` header.
+   * @param body - &id:oatpp::web::protocol::http::outgoing::FileBody;.
+   * @param rangeHeader - value of the request `Range` header. May be `nullptr`.
+   * @return - `206` with `Content-Range` for a satisfiable bytes range, `416` for unsatisfiable range.
+   * `200` with the whole file if there is no range, or if range is malformed or can't be served (multiple ranges, other units).
+   */
+  static std::shared_ptr<Response> createShared(const std::shared_ptr<FileBody>& body, const oatpp::String& rangeHeader);
+  
 };
   
 }}}}}
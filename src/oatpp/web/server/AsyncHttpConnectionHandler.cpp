@@ -34,6 +34,7 @@ AsyncHttpConnectionHandler::AsyncHttpConnectionHandler(const std::shared_ptr<Htt
   , m_router(router)
   , m_errorHandler(handler::DefaultErrorHandler::createShared())
   , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_requestTimeoutMicros(0)
 {
   m_executor->detach();
 }
@@ -44,6 +45,7 @@ AsyncHttpConnectionHandler::AsyncHttpConnectionHandler(const std::shared_ptr<Htt
   , m_router(router)
   , m_errorHandler(handler::DefaultErrorHandler::createShared())
   , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_requestTimeoutMicros(0)
 {}
 
 std::shared_ptr<AsyncHttpConnectionHandler> AsyncHttpConnectionHandler::createShared(const std::shared_ptr<HttpRouter>& router, v_int32 threadCount){
@@ -65,20 +67,25 @@ void AsyncHttpConnectionHandler::addRequestInterceptor(const std::shared_ptr<han
   m_requestInterceptors.pushBack(interceptor);
 }
 
+void AsyncHttpConnectionHandler::setRequestTimeout(const std::chrono::duration<v_int64, std::micro>& timeout) {
+  m_requestTimeoutMicros = timeout.count();
+}
+
 void AsyncHttpConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection){
   
   auto ioBuffer = oatpp::data::buffer::IOBuffer::createShared();
   auto outStream = oatpp::data::stream::OutputStreamBufferedProxy::createShared(connection, ioBuffer);
   auto inStream = oatpp::data::stream::InputStreamBufferedProxy::createShared(connection, ioBuffer);
   
-  m_executor->execute<HttpProcessor::Coroutine>(m_router.get(),
-                                                m_bodyDecoder,
-                                                m_errorHandler,
-                                                &m_requestInterceptors,
-                                                connection,
-                                                ioBuffer,
-                                                outStream,
-                                                inStream);
+  m_executor->executeLocal<HttpProcessor::Coroutine>(m_router.get(),
+                                                     m_bodyDecoder,
+                                                     m_errorHandler,
+                                                     &m_requestInterceptors,
+                                                     connection,
+                                                     ioBuffer,
+                                                     outStream,
+                                                     inStream,
+                                                     m_requestTimeoutMicros);
   
 }
 
@@ -49,6 +49,7 @@ private:
   std::shared_ptr<handler::ErrorHandler> m_errorHandler;
   HttpProcessor::RequestInterceptors m_requestInterceptors;
   std::shared_ptr<const BodyDecoder> m_bodyDecoder; // TODO make bodyDecoder configurable here
+  v_int64 m_requestTimeoutMicros;
 public:
   AsyncHttpConnectionHandler(const std::shared_ptr<HttpRouter>& router, v_int32 threadCount = THREAD_NUM_DEFAULT);
   AsyncHttpConnectionHandler(const std::shared_ptr<HttpRouter>& router, const std::shared_ptr<oatpp::async::Executor>& executor);
@@ -64,7 +65,24 @@ public:
   
   void addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor);
   
+  /**
+   * Set max time for a connection to receive a request, process it and send the response.
+   * When it passes the connection is dropped and the resources of the connection are released.
+   * Applies to connections accepted after the call.
+   * @param timeout - e.g. `std::chrono::seconds(30)`. 0 - no timeout (default).
+   */
+  void setRequestTimeout(const std::chrono::duration<v_int64, std::micro>& timeout);
+  
+  /**
+   * Start processing of the connection. Called from a thread of the handler's executor
+   * (see &id:oatpp::network::server::AsyncServer;) the connection is processed by the calling thread.
+   * @param connection
+   */
   void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override;
+  
+  std::shared_ptr<oatpp::async::Executor> getExecutor() {
+    return m_executor;
+  }
 
   /**
    * Will call m_executor.stop()
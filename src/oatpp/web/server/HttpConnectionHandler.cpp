@@ -91,6 +91,8 @@ HttpConnectionHandler::HttpConnectionHandler(const std::shared_ptr<HttpRouter>&
   : m_router(router)
   , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
   , m_errorHandler(handler::DefaultErrorHandler::createShared())
+  /* Leave one cpu free of workers */
+  , m_placementPolicy(oatpp::concurrency::PlacementPolicy::createShared(oatpp::concurrency::PlacementPolicy::PIN_NONE, 1))
 {}
 
 std::shared_ptr<HttpConnectionHandler> HttpConnectionHandler::createShared(const std::shared_ptr<HttpRouter>& router){
@@ -107,21 +109,20 @@ void HttpConnectionHandler::setErrorHandler(const std::shared_ptr<handler::Error
 void HttpConnectionHandler::addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor) {
   m_requestInterceptors.pushBack(interceptor);
 }
+
+void HttpConnectionHandler::setPlacementPolicy(const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy) {
+  m_placementPolicy = placementPolicy;
+}
   
 void HttpConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection){
   
   /* Create working thread */
   concurrency::Thread thread(Task::createShared(m_router.get(), connection, m_bodyDecoder, m_errorHandler, &m_requestInterceptors));
   
-  /* Get hardware concurrency -1 in order to have 1cpu free of workers. */
-  v_int32 concurrency = oatpp::concurrency::Thread::getHardwareConcurrency();
-  if(concurrency > 1) {
-    concurrency -= 1;
+  if(m_placementPolicy) {
+    m_placementPolicy->placeConnectionThread(thread.getStdThread()->native_handle());
   }
   
-  /* Set thread affinity group CPUs [0..cpu_count - 1]. Leave one cpu free of workers */
-  oatpp::concurrency::Thread::setThreadAffinityToCpuRange(thread.getStdThread()->native_handle(), 0, concurrency - 1 /* -1 because 0-based index */);
-  
   thread.detach();
 }
 
@@ -34,6 +34,7 @@
 #include "oatpp/network/server/ConnectionHandler.hpp"
 #include "oatpp/network/Connection.hpp"
 
+#include "oatpp/core/concurrency/PlacementPolicy.hpp"
 #include "oatpp/core/concurrency/Thread.hpp"
 #include "oatpp/core/concurrency/Runnable.hpp"
 
@@ -43,8 +44,12 @@
 namespace oatpp { namespace web { namespace server {
   
 class HttpConnectionHandler : public base::Countable, public network::server::ConnectionHandler {
-private:
+public:
   
+  /**
+   * Blocking processing of the connection. Runs request-response loop until the connection is closed or upgraded.
+   * Also used by &id:oatpp::web::server::HttpFiberConnectionHandler; to run in fiber.
+   */
   class Task : public base::Countable, public concurrency::Runnable{
   private:
     HttpRouter* m_router;
@@ -75,6 +80,7 @@ private:
   std::shared_ptr<const oatpp::web::protocol::http::incoming::BodyDecoder> m_bodyDecoder;
   std::shared_ptr<handler::ErrorHandler> m_errorHandler;
   HttpProcessor::RequestInterceptors m_requestInterceptors;
+  std::shared_ptr<oatpp::concurrency::PlacementPolicy> m_placementPolicy;
 public:
   HttpConnectionHandler(const std::shared_ptr<HttpRouter>& router);
 public:
@@ -83,6 +89,14 @@ public:
 
   void setErrorHandler(const std::shared_ptr<handler::ErrorHandler>& errorHandler);
   void addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor);
+  
+  /**
+   * Set placement of connection threads. See &id:oatpp::concurrency::PlacementPolicy::placeConnectionThread;. <br>
+   * By default connection threads run on all CPUs but the last one.
+   * @param placementPolicy - &id:oatpp::concurrency::PlacementPolicy;. `nullptr` - connection threads are not pinned.
+   */
+  void setPlacementPolicy(const std::shared_ptr<oatpp::concurrency::PlacementPolicy>& placementPolicy);
+  
   void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override;
   void stop() override;
   
@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "./HttpFiberConnectionHandler.hpp"
+
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/network/virtual_/Socket.hpp"
+
+#include <fcntl.h>
+
+namespace oatpp { namespace web { namespace server {
+
+const v_int32 HttpFiberConnectionHandler::THREAD_NUM_DEFAULT = OATPP_ASYNC_EXECUTOR_THREAD_NUM_DEFAULT;
+
+HttpFiberConnectionHandler::HttpFiberConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                                                       v_int32 threadCount,
+                                                       v_int32 stackSize)
+  : m_executor(std::make_shared<oatpp::async::Executor>(threadCount))
+  , m_stackPool(oatpp::async::Fiber::StackPool::createShared(stackSize))
+  , m_router(router)
+  , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_errorHandler(handler::DefaultErrorHandler::createShared())
+{
+  m_executor->detach();
+}
+
+HttpFiberConnectionHandler::HttpFiberConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                                                       const std::shared_ptr<oatpp::async::Executor>& executor,
+                                                       v_int32 stackSize)
+  : m_executor(executor)
+  , m_stackPool(oatpp::async::Fiber::StackPool::createShared(stackSize))
+  , m_router(router)
+  , m_bodyDecoder(std::make_shared<oatpp::web::protocol::http::incoming::SimpleBodyDecoder>())
+  , m_errorHandler(handler::DefaultErrorHandler::createShared())
+{}
+
+std::shared_ptr<HttpFiberConnectionHandler> HttpFiberConnectionHandler::createShared(const std::shared_ptr<HttpRouter>& router,
+                                                                                     v_int32 threadCount,
+                                                                                     v_int32 stackSize)
+{
+  return std::make_shared<HttpFiberConnectionHandler>(router, threadCount, stackSize);
+}
+
+std::shared_ptr<HttpFiberConnectionHandler> HttpFiberConnectionHandler::createShared(const std::shared_ptr<HttpRouter>& router,
+                                                                                     const std::shared_ptr<oatpp::async::Executor>& executor,
+                                                                                     v_int32 stackSize)
+{
+  return std::make_shared<HttpFiberConnectionHandler>(router, executor, stackSize);
+}
+
+void HttpFiberConnectionHandler::setErrorHandler(const std::shared_ptr<handler::ErrorHandler>& errorHandler){
+  m_errorHandler = errorHandler;
+  if(!m_errorHandler) {
+    m_errorHandler = handler::DefaultErrorHandler::createShared();
+  }
+}
+
+void HttpFiberConnectionHandler::addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor) {
+  m_requestInterceptors.pushBack(interceptor);
+}
+
+void HttpFiberConnectionHandler::setNonBlocking(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+  
+  auto socket = std::dynamic_pointer_cast<oatpp::network::Connection>(connection);
+  if(socket) {
+    auto handle = socket->getHandle();
+    ::fcntl(handle, F_SETFL, ::fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+    return;
+  }
+  
+  auto virtualSocket = std::dynamic_pointer_cast<oatpp::network::virtual_::Socket>(connection);
+  if(virtualSocket) {
+    virtualSocket->setNonBlocking(true);
+    return;
+  }
+  
+  OATPP_LOGD("[oatpp::web::server::HttpFiberConnectionHandler::setNonBlocking()]",
+             "Warning. Unknown connection type. Blocking I/O will block executor thread.");
+  
+}
+
+void HttpFiberConnectionHandler::handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection){
+  
+  setNonBlocking(connection);
+  
+  auto task = HttpConnectionHandler::Task::createShared(m_router.get(), connection, m_bodyDecoder, m_errorHandler, &m_requestInterceptors);
+  m_executor->execute<oatpp::async::FiberCoroutine>(m_stackPool, [task] {
+    task->run();
+  });
+  
+}
+
+void HttpFiberConnectionHandler::stop() {
+  m_executor->stop();
+}
+
+}}}
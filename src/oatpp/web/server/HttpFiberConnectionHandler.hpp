@@ -0,0 +1,105 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#ifndef oatpp_web_server_HttpFiberConnectionHandler_hpp
+#define oatpp_web_server_HttpFiberConnectionHandler_hpp
+
+#include "./HttpConnectionHandler.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/Fiber.hpp"
+
+namespace oatpp { namespace web { namespace server {
+
+/**
+ * Connection handler which runs blocking request processing (same as &id:oatpp::web::server::HttpConnectionHandler;)
+ * in &id:oatpp::async::Fiber; on &id:oatpp::async::Executor;. <br>
+ * Accepted connections are switched to non-blocking mode. When connection read/write would block,
+ * fiber is suspended and executor thread serves other connections.
+ * Thus synchronous endpoints get connection density of async server without being rewritten. <br>
+ * Endpoints should not block on anything other than the connection I/O (locks, sleeps, other sockets) - that would block executor thread.
+ */
+class HttpFiberConnectionHandler : public base::Countable, public network::server::ConnectionHandler {
+private:
+  typedef oatpp::web::protocol::http::incoming::BodyDecoder BodyDecoder;
+public:
+  static const v_int32 THREAD_NUM_DEFAULT;
+private:
+  std::shared_ptr<oatpp::async::Executor> m_executor;
+  std::shared_ptr<oatpp::async::Fiber::StackPool> m_stackPool;
+private:
+  std::shared_ptr<HttpRouter> m_router;
+  std::shared_ptr<const BodyDecoder> m_bodyDecoder;
+  std::shared_ptr<handler::ErrorHandler> m_errorHandler;
+  HttpProcessor::RequestInterceptors m_requestInterceptors;
+private:
+  void setNonBlocking(const std::shared_ptr<oatpp::data::stream::IOStream>& connection);
+public:
+  
+  /**
+   * Constructor. Creates and detaches own executor.
+   * @param router - &id:oatpp::web::server::HttpRouter;.
+   * @param threadCount - number of executor threads.
+   * @param stackSize - fiber stack size. One fiber per connection.
+   */
+  HttpFiberConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                             v_int32 threadCount = THREAD_NUM_DEFAULT,
+                             v_int32 stackSize = oatpp::async::Fiber::STACK_SIZE_DEFAULT);
+  
+  /**
+   * Constructor.
+   * @param router - &id:oatpp::web::server::HttpRouter;.
+   * @param executor - &id:oatpp::async::Executor; to run fibers on.
+   * @param stackSize - fiber stack size. One fiber per connection.
+   */
+  HttpFiberConnectionHandler(const std::shared_ptr<HttpRouter>& router,
+                             const std::shared_ptr<oatpp::async::Executor>& executor,
+                             v_int32 stackSize = oatpp::async::Fiber::STACK_SIZE_DEFAULT);
+public:
+  
+  static std::shared_ptr<HttpFiberConnectionHandler> createShared(const std::shared_ptr<HttpRouter>& router,
+                                                                  v_int32 threadCount = THREAD_NUM_DEFAULT,
+                                                                  v_int32 stackSize = oatpp::async::Fiber::STACK_SIZE_DEFAULT);
+  
+  static std::shared_ptr<HttpFiberConnectionHandler> createShared(const std::shared_ptr<HttpRouter>& router,
+                                                                  const std::shared_ptr<oatpp::async::Executor>& executor,
+                                                                  v_int32 stackSize = oatpp::async::Fiber::STACK_SIZE_DEFAULT);
+  
+  void setErrorHandler(const std::shared_ptr<handler::ErrorHandler>& errorHandler);
+  
+  void addRequestInterceptor(const std::shared_ptr<handler::RequestInterceptor>& interceptor);
+  
+  void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override;
+  
+  /**
+   * Will call m_executor.stop()
+   */
+  void stop() override;
+  
+};
+  
+}}}
+
+#endif /* oatpp_web_server_HttpFiberConnectionHandler_hpp */
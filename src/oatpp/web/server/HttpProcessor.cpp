@@ -133,6 +133,12 @@ oatpp::async::Action HttpProcessor::Coroutine::onHeadersParsed(const RequestHead
 }
   
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::act() {
+  if(m_requestTimeoutMicros > 0) {
+    /* Deadline covers waiting for the request, its processing and sending of the response */
+    setDeadline(oatpp::base::Environment::getMicroTickCount() + m_requestTimeoutMicros);
+  }
+  /* Priority class of the previous request on this connection doesn't apply anymore */
+  setPriority(oatpp::async::Priority::NORMAL);
   RequestHeadersReader::AsyncCallback callback = static_cast<RequestHeadersReader::AsyncCallback>(&HttpProcessor::Coroutine::onHeadersParsed);
   RequestHeadersReader headersReader(m_ioBuffer->getData(), m_ioBuffer->getSize(), 4096);
   return headersReader.readHeadersAsync(this, callback, m_connection);
@@ -181,6 +187,10 @@ HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::onRequestDone() {
 }
   
 HttpProcessor::Coroutine::Action HttpProcessor::Coroutine::handleError(const oatpp::async::Error& error) {
+  if(error.isTimeout() || error.isCancelled()) {
+    OATPP_LOGD("Server", "'%s'. Dropping connection", error.message);
+    return abort();
+  }
   if(m_currentResponse) {
     if(error.isExceptionThrown) {
       OATPP_LOGE("Server", "Unhandled exception. Dropping connection");
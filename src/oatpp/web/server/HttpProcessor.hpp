@@ -76,6 +76,7 @@ public:
     std::shared_ptr<oatpp::data::stream::OutputStreamBufferedProxy> m_outStream;
     std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy> m_inStream;
     v_int32 m_connectionState;
+    v_int64 m_requestTimeoutMicros;
   private:
     oatpp::web::server::HttpRouter::BranchRouter::Route m_currentRoute;
     std::shared_ptr<protocol::http::incoming::Request> m_currentRequest;
@@ -89,7 +90,8 @@ public:
               const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
               const std::shared_ptr<oatpp::data::buffer::IOBuffer>& ioBuffer,
               const std::shared_ptr<oatpp::data::stream::OutputStreamBufferedProxy>& outStream,
-              const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream)
+              const std::shared_ptr<oatpp::data::stream::InputStreamBufferedProxy>& inStream,
+              v_int64 requestTimeoutMicros = 0)
       : m_router(router)
       , m_bodyDecoder(bodyDecoder)
       , m_errorHandler(errorHandler)
@@ -99,6 +101,7 @@ public:
       , m_outStream(outStream)
       , m_inStream(inStream)
       , m_connectionState(oatpp::web::protocol::http::outgoing::CommunicationUtils::CONNECTION_STATE_KEEP_ALIVE)
+      , m_requestTimeoutMicros(requestTimeoutMicros)
     {}
     
     Action act() override;
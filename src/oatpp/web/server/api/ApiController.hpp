@@ -104,16 +104,19 @@ protected:
     T* m_controller;
     Method m_method;
     MethodAsync m_methodAsync;
+    std::shared_ptr<Endpoint::Info> m_info;
   public:
-    Handler(T* controller, Method method, MethodAsync methodAsync)
+    Handler(T* controller, Method method, MethodAsync methodAsync, const std::shared_ptr<Endpoint::Info>& info = nullptr)
       : m_controller(controller)
       , m_method(method)
       , m_methodAsync(methodAsync)
+      , m_info(info)
     {}
   public:
     
-    static std::shared_ptr<Handler> createShared(T* controller, Method method, MethodAsync methodAsync){
-      return std::make_shared<Handler>(controller, method, methodAsync);
+    static std::shared_ptr<Handler> createShared(T* controller, Method method, MethodAsync methodAsync,
+                                                 const std::shared_ptr<Endpoint::Info>& info = nullptr){
+      return std::make_shared<Handler>(controller, method, methodAsync, info);
     }
     
     std::shared_ptr<OutgoingResponse> processUrl(const std::shared_ptr<protocol::http::incoming::Request>& request) override {
@@ -128,6 +131,10 @@ protected:
                            AsyncCallback callback,
                            const std::shared_ptr<protocol::http::incoming::Request>& request) override {
       if(m_methodAsync != nullptr) {
+        if(m_info) {
+          /* Info is read per request - it may be set by ENDPOINT_INFO after the endpoint is created */
+          parentCoroutine->setPriority(m_info->priority);
+        }
         return (m_controller->*m_methodAsync)(parentCoroutine, callback, request);
       } else {
         return parentCoroutine->callWithParams(reinterpret_cast<oatpp::async::AbstractCoroutine::FunctionPtr>(callback),
@@ -157,7 +164,7 @@ public:
                                                   typename Handler<T>::Method method,
                                                   typename Handler<T>::MethodAsync methodAsync,
                                                   const std::shared_ptr<Endpoint::Info>& info){
-    auto handler = Handler<T>::createShared(controller, method, methodAsync);
+    auto handler = Handler<T>::createShared(controller, method, methodAsync, info);
     auto endpoint = Endpoint::createShared(handler, info);
     endpoints->pushBack(endpoint);
     return endpoint;
@@ -56,6 +56,7 @@ Endpoint::Info::Param& Endpoint::Info::Params::operator [](const oatpp::String&
 }
 
 Endpoint::Info::Info()
+  : priority(oatpp::async::Priority::NORMAL)
 {}
 
 std::shared_ptr<Endpoint::Info> Endpoint::Info::createShared(){
@@ -129,6 +129,12 @@ public:
     oatpp::String path;
     oatpp::String method;
     
+    /**
+     * Scheduling class of async requests handled by the endpoint. See &id:oatpp::async::Priority;. <br>
+     * Example: `ENDPOINT_INFO(upload) { info->priority = oatpp::async::Priority::BULK; }`.
+     */
+    v_int32 priority;
+    
     Param body;
     oatpp::String bodyContentType;
     
@@ -1,11 +1,20 @@
 
 #include "oatpp/web/FullTest.hpp"
 #include "oatpp/web/FullAsyncTest.hpp"
+#include "oatpp/web/FullFiberTest.hpp"
 #include "oatpp/web/server/api/ApiControllerTest.hpp"
+#include "oatpp/web/protocol/http/outgoing/FileBodyTest.hpp"
 
 #include "oatpp/network/virtual_/PipeTest.hpp"
 #include "oatpp/network/virtual_/InterfaceTest.hpp"
 #include "oatpp/network/UrlTest.hpp"
+#include "oatpp/network/ConnectionTest.hpp"
+#include "oatpp/network/SocketOptionsTest.hpp"
+#include "oatpp/network/UnixSocketTest.hpp"
+#include "oatpp/network/UnixSocketPerfTest.hpp"
+#include "oatpp/network/WritevTest.hpp"
+#include "oatpp/network/server/ShardedServerTest.hpp"
+#include "oatpp/network/server/AsyncServerTest.hpp"
 
 #include "oatpp/core/data/stream/ChunkedBufferTest.hpp"
 #include "oatpp/core/data/share/MemoryLabelTest.hpp"
@@ -25,6 +34,24 @@
 #include "oatpp/core/base/memory/PerfTest.hpp"
 #include "oatpp/core/base/CommandLineArgumentsTest.hpp"
 #include "oatpp/core/base/RegRuleTest.hpp"
+#include "oatpp/core/concurrency/PlacementPolicyTest.hpp"
+#include "oatpp/core/async/BurstPerfTest.hpp"
+#include "oatpp/core/async/DeadlineTest.hpp"
+#include "oatpp/core/async/ElasticExecutorTest.hpp"
+#include "oatpp/core/async/ExecutorMetricsTest.hpp"
+#include "oatpp/core/async/FiberTest.hpp"
+#include "oatpp/core/async/FramePoolTest.hpp"
+#include "oatpp/core/async/IOEventPollerPerfTest.hpp"
+#include "oatpp/core/async/IOEventPollerTest.hpp"
+#include "oatpp/core/async/OffloadPoolTest.hpp"
+#include "oatpp/core/async/PriorityTest.hpp"
+#include "oatpp/core/async/ProfilerTest.hpp"
+#include "oatpp/core/async/StallDetectorTest.hpp"
+#include "oatpp/core/async/SubmissionPerfTest.hpp"
+#include "oatpp/core/async/SynchronizationTest.hpp"
+#include "oatpp/core/async/TimerWheelTest.hpp"
+#include "oatpp/core/async/WakeupLatencyTest.hpp"
+#include "oatpp/core/async/WorkStealingTest.hpp"
 
 #include "oatpp/core/concurrency/SpinLock.hpp"
 #include "oatpp/core/base/Environment.hpp"
@@ -59,9 +86,28 @@ void runTests() {
 
   OATPP_RUN_TEST(oatpp::test::memory::MemoryPoolTest);
   OATPP_RUN_TEST(oatpp::test::memory::PerfTest);
+  OATPP_RUN_TEST(oatpp::test::concurrency::PlacementPolicyTest);
 
   OATPP_RUN_TEST(oatpp::test::collection::LinkedListTest);
 
+  OATPP_RUN_TEST(oatpp::test::async::IOEventPollerTest);
+  OATPP_RUN_TEST(oatpp::test::async::IOEventPollerPerfTest);
+  OATPP_RUN_TEST(oatpp::test::async::TimerWheelTest);
+  OATPP_RUN_TEST(oatpp::test::async::DeadlineTest);
+  OATPP_RUN_TEST(oatpp::test::async::WorkStealingTest);
+  OATPP_RUN_TEST(oatpp::test::async::SubmissionPerfTest);
+  OATPP_RUN_TEST(oatpp::test::async::WakeupLatencyTest);
+  OATPP_RUN_TEST(oatpp::test::async::BurstPerfTest);
+  OATPP_RUN_TEST(oatpp::test::async::PriorityTest);
+  OATPP_RUN_TEST(oatpp::test::async::SynchronizationTest);
+  OATPP_RUN_TEST(oatpp::test::async::FiberTest);
+  OATPP_RUN_TEST(oatpp::test::async::OffloadPoolTest);
+  OATPP_RUN_TEST(oatpp::test::async::ElasticExecutorTest);
+  OATPP_RUN_TEST(oatpp::test::async::ExecutorMetricsTest);
+  OATPP_RUN_TEST(oatpp::test::async::ProfilerTest);
+  OATPP_RUN_TEST(oatpp::test::async::StallDetectorTest);
+  OATPP_RUN_TEST(oatpp::test::async::FramePoolTest);
+
   OATPP_RUN_TEST(oatpp::test::core::data::share::MemoryLabelTest);
   OATPP_RUN_TEST(oatpp::test::core::data::stream::ChunkedBufferTest);
   OATPP_RUN_TEST(oatpp::test::core::data::mapping::type::TypeTest);
@@ -75,12 +121,21 @@ void runTests() {
   OATPP_RUN_TEST(oatpp::test::encoding::UnicodeTest);
 
   OATPP_RUN_TEST(oatpp::test::network::UrlTest);
+  OATPP_RUN_TEST(oatpp::test::network::ConnectionTest);
+  OATPP_RUN_TEST(oatpp::test::network::SocketOptionsTest);
+  OATPP_RUN_TEST(oatpp::test::network::UnixSocketTest);
+  OATPP_RUN_TEST(oatpp::test::network::UnixSocketPerfTest);
+  OATPP_RUN_TEST(oatpp::test::network::WritevTest);
   OATPP_RUN_TEST(oatpp::test::network::virtual_::PipeTest);
   OATPP_RUN_TEST(oatpp::test::network::virtual_::InterfaceTest);
+  OATPP_RUN_TEST(oatpp::test::network::server::ShardedServerTest);
+  OATPP_RUN_TEST(oatpp::test::network::server::AsyncServerTest);
 
   OATPP_RUN_TEST(oatpp::test::web::server::api::ApiControllerTest);
+  OATPP_RUN_TEST(oatpp::test::web::protocol::http::outgoing::FileBodyTest);
   OATPP_RUN_TEST(oatpp::test::web::FullTest);
   OATPP_RUN_TEST(oatpp::test::web::FullAsyncTest);
+  OATPP_RUN_TEST(oatpp::test::web::FullFiberTest);
 
 }
   
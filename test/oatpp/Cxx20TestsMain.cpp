@@ -0,0 +1,82 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+/**
+ * Tests of the optional C++20 layer. Built only if compiler supports C++20 coroutines.
+ */
+
+#include "oatpp/core/async/AwaitTest.hpp"
+#include "oatpp/core/async/AwaitPerfTest.hpp"
+
+#include "oatpp/core/concurrency/SpinLock.hpp"
+#include "oatpp/core/base/Environment.hpp"
+
+#include <iostream>
+
+namespace {
+
+class Logger : public oatpp::base::Logger {
+private:
+  oatpp::concurrency::SpinLock::Atom m_atom;
+public:
+  
+  Logger()
+  : m_atom(false)
+  {}
+  
+  void log(v_int32 priority, const std::string& tag, const std::string& message) override {
+    oatpp::concurrency::SpinLock lock(m_atom);
+    std::cout << tag << ":" << message << "\n";
+  }
+  
+};
+
+void runTests() {
+  OATPP_RUN_TEST(oatpp::test::async::AwaitTest);
+  OATPP_RUN_TEST(oatpp::test::async::AwaitPerfTest);
+}
+  
+}
+
+int main() {
+  
+  oatpp::base::Environment::init();
+  oatpp::base::Environment::setLogger(new Logger());
+  
+  runTests();
+  
+  oatpp::base::Environment::setLogger(nullptr);
+  oatpp::base::Environment::destroy();
+  
+  std::cout << "\nEnvironment:\n";
+  std::cout << "objectsCount = " << oatpp::base::Environment::getObjectsCount() << "\n";
+  std::cout << "objectsCreated = " << oatpp::base::Environment::getObjectsCreated() << "\n\n";
+  
+  OATPP_ASSERT(oatpp::base::Environment::getObjectsCount() == 0);
+  
+  oatpp::base::Environment::destroy();
+  
+  return 0;
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "AwaitPerfTest.hpp"
+
+#include "oatpp/core/async/Await.hpp"
+#include "oatpp/core/async/Processor.hpp"
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Action Action;
+typedef oatpp::async::Task Task;
+
+const v_int32 STEPS_COUNT = 1000000;
+const v_int32 CHILDREN_COUNT = 100000;
+
+/**
+ * State machine switching between two functions.
+ */
+class StepsCoroutine : public oatpp::async::Coroutine<StepsCoroutine> {
+private:
+  v_int32 m_counter;
+  v_int32 m_count;
+public:
+
+  StepsCoroutine(v_int32 count)
+    : m_counter(0)
+    , m_count(count)
+  {}
+
+  Action act() override {
+    return yieldTo(&StepsCoroutine::step);
+  }
+
+  Action step() {
+    if(++ m_counter == m_count) {
+      return finish();
+    }
+    return yieldTo(&StepsCoroutine::act);
+  }
+
+};
+
+class ChildCoroutine : public oatpp::async::Coroutine<ChildCoroutine> {
+public:
+
+  Action act() override {
+    return finish();
+  }
+
+};
+
+class ParentCoroutine : public oatpp::async::Coroutine<ParentCoroutine> {
+private:
+  v_int32 m_counter;
+  v_int32 m_count;
+public:
+
+  ParentCoroutine(v_int32 count)
+    : m_counter(0)
+    , m_count(count)
+  {}
+
+  Action act() override {
+    if(m_counter ++ == m_count) {
+      return finish();
+    }
+    return startCoroutine<ChildCoroutine>(yieldTo(&ParentCoroutine::act));
+  }
+
+};
+
+Task stepsTask(v_int32 count) {
+  for(v_int32 i = 0; i < count; i ++) {
+    co_await oatpp::async::yield();
+  }
+}
+
+Task childTask() {
+  co_return;
+}
+
+Task parentTask(v_int32 count) {
+  for(v_int32 i = 0; i < count; i ++) {
+    co_await childTask();
+  }
+}
+
+v_int64 runCoroutine(oatpp::async::AbstractCoroutine* coroutine) {
+  oatpp::async::Processor processor(oatpp::async::IOEventPoller::ENGINE_NONE);
+  v_int64 startTick = oatpp::base::Environment::getMicroTickCount();
+  processor.addCoroutine(coroutine);
+  while(processor.iterate(1000)) {}
+  return oatpp::base::Environment::getMicroTickCount() - startTick;
+}
+
+}
+
+void AwaitPerfTest::onRun() {
+
+  v_int64 actionSteps = runCoroutine(StepsCoroutine::getBench().obtain(STEPS_COUNT));
+  v_int64 awaitSteps = runCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(stepsTask(STEPS_COUNT)));
+
+  OATPP_LOGD(TAG, "switch: Action dispatch %d ns/step, co_await %d ns/step",
+             (v_int32) (actionSteps * 1000 / STEPS_COUNT), (v_int32) (awaitSteps * 1000 / STEPS_COUNT));
+
+  v_int64 actionChildren = runCoroutine(ParentCoroutine::getBench().obtain(CHILDREN_COUNT));
+  v_int64 awaitChildren = runCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(parentTask(CHILDREN_COUNT)));
+
+  OATPP_LOGD(TAG, "child call: Action coroutine %d ns/call, co_await Task %d ns/call (pooled frames)",
+             (v_int32) (actionChildren * 1000 / CHILDREN_COUNT), (v_int32) (awaitChildren * 1000 / CHILDREN_COUNT));
+
+}
+
+}}}
@@ -0,0 +1,308 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "AwaitTest.hpp"
+
+#include "oatpp/core/async/Await.hpp"
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/Semaphore.hpp"
+
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/data/buffer/IOBuffer.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Action Action;
+typedef oatpp::async::AbstractCoroutine AbstractCoroutine;
+typedef oatpp::async::Task Task;
+
+void runAll(oatpp::async::Processor& processor) {
+  while(processor.getTasksCount() > 0) {
+    if(!processor.iterate(100)) {
+      processor.waitForEvents(1000);
+    }
+  }
+}
+
+class IncrementCoroutine : public oatpp::async::Coroutine<IncrementCoroutine> {
+private:
+  v_int32* m_counter;
+public:
+
+  IncrementCoroutine(v_int32* counter)
+    : m_counter(counter)
+  {}
+
+  Action act() override {
+    (*m_counter) ++;
+    return yieldTo(&IncrementCoroutine::increment);
+  }
+
+  Action increment() {
+    (*m_counter) ++;
+    return finish();
+  }
+
+};
+
+class SquareCoroutine : public oatpp::async::CoroutineWithResult<SquareCoroutine, v_int32> {
+private:
+  v_int32 m_value;
+public:
+
+  SquareCoroutine(v_int32 value)
+    : m_value(value)
+  {}
+
+  Action act() override {
+    return _return(m_value * m_value);
+  }
+
+};
+
+class FailingCoroutine : public oatpp::async::Coroutine<FailingCoroutine> {
+public:
+
+  Action act() override {
+    return error("[FailingCoroutine]: boom");
+  }
+
+};
+
+Task nested(std::vector<v_int32>* trace, v_int32 value) {
+  trace->push_back(value);
+  co_await oatpp::async::yield();
+  trace->push_back(value + 1);
+}
+
+Task steps(std::vector<v_int32>* trace) {
+  trace->push_back(1);
+  co_await nested(trace, 2);
+  co_await oatpp::async::waitFor(std::chrono::milliseconds(1));
+  co_await nested(trace, 4);
+  trace->push_back(6);
+}
+
+Task children(v_int32* counter, v_int32* square, bool* errorCaught) {
+  co_await oatpp::async::child<IncrementCoroutine>(counter);
+  *square = co_await oatpp::async::callback<v_int32>([](AbstractCoroutine* parent, auto callback) {
+    return parent->startCoroutineForResult<SquareCoroutine>(callback, 7);
+  });
+  try {
+    co_await oatpp::async::child<FailingCoroutine>();
+  } catch (const oatpp::async::Error& error) {
+    *errorCaught = std::strcmp(error.message, "[FailingCoroutine]: boom") == 0;
+  }
+}
+
+Task throwing() {
+  co_await oatpp::async::yield();
+  throw std::runtime_error("task failed");
+}
+
+Task sleeping(bool* timeoutCaught) {
+  try {
+    co_await oatpp::async::waitFor(std::chrono::seconds(10));
+  } catch (const oatpp::async::Error& error) {
+    *timeoutCaught = error.isTimeout();
+  }
+}
+
+/**
+ * Regular coroutine running Task as child.
+ */
+class ParentCoroutine : public oatpp::async::Coroutine<ParentCoroutine> {
+private:
+  v_int32 m_mode;
+  bool* m_flag;
+  v_int32* m_status;
+public:
+
+  ParentCoroutine(v_int32 mode, bool* flag, v_int32* status)
+    : m_mode(mode)
+    , m_flag(flag)
+    , m_status(status)
+  {}
+
+  Action act() override {
+    if(m_mode == 0) {
+      return oatpp::async::AwaitCoroutine::start(yieldTo(&ParentCoroutine::onDone), throwing());
+    }
+    setTimeout(std::chrono::milliseconds(50));
+    return oatpp::async::AwaitCoroutine::start(yieldTo(&ParentCoroutine::onDone), sleeping(m_flag));
+  }
+
+  Action onDone() {
+    *m_status = 1;
+    return finish();
+  }
+
+  Action handleError(const oatpp::async::Error& error) override {
+    *m_status = error.isExceptionThrown ? 2 : 3;
+    return finish();
+  }
+
+};
+
+Task transfer(oatpp::data::v_io_handle handle, std::shared_ptr<oatpp::data::stream::ChunkedBuffer> output) {
+  co_await oatpp::async::waitForIO(handle, Action::IO_EVENT_READ);
+  auto connection = oatpp::network::Connection::createShared(handle);
+  auto buffer = oatpp::data::buffer::IOBuffer::createShared();
+  co_await oatpp::async::action([&](AbstractCoroutine* parent, const Action& next) {
+    return oatpp::data::stream::transferAsync(parent, next, connection, output, 0, buffer);
+  });
+}
+
+Task acquire(oatpp::async::Semaphore* semaphore, std::atomic<v_int32>* state) {
+  state->store(1);
+  co_await oatpp::async::retry([semaphore](const Action& next) {
+    return semaphore->acquire(next);
+  });
+  state->store(2);
+}
+
+Task bigFrame(v_int32* result) {
+  v_char8 data[8000];
+  std::memset(data, 1, sizeof(data));
+  co_await oatpp::async::yield();
+  v_int32 sum = 0;
+  for(v_int32 i = 0; i < (v_int32) sizeof(data); i ++) {
+    sum += data[i];
+  }
+  *result = sum;
+}
+
+}
+
+void AwaitTest::onRun() {
+
+  oatpp::async::Processor processor;
+
+  {
+    std::vector<v_int32> trace;
+    processor.addCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(steps(&trace)));
+    runAll(processor);
+    std::vector<v_int32> expected = {1, 2, 3, 4, 5, 6};
+    OATPP_ASSERT(trace == expected);
+  }
+
+  {
+    v_int32 counter = 0;
+    v_int32 square = 0;
+    bool errorCaught = false;
+    processor.addCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(children(&counter, &square, &errorCaught)));
+    runAll(processor);
+    OATPP_ASSERT(counter == 2);
+    OATPP_ASSERT(square == 49);
+    OATPP_ASSERT(errorCaught);
+  }
+
+  {
+    v_int32 status = 0;
+    processor.addCoroutine(ParentCoroutine::getBench().obtain(0, nullptr, &status));
+    runAll(processor);
+    OATPP_LOGD(TAG, "uncaught exception in Task -> parent status=%d", status);
+    OATPP_ASSERT(status == 2);
+  }
+
+  {
+    v_int32 status = 0;
+    bool timeoutCaught = false;
+    v_int64 startTick = oatpp::base::Environment::getMicroTickCount();
+    processor.addCoroutine(ParentCoroutine::getBench().obtain(1, &timeoutCaught, &status));
+    runAll(processor);
+    v_int64 elapsed = oatpp::base::Environment::getMicroTickCount() - startTick;
+    OATPP_LOGD(TAG, "deadline delivered into Task in %lld micros", elapsed);
+    OATPP_ASSERT(timeoutCaught);
+    OATPP_ASSERT(status == 1);
+    OATPP_ASSERT(elapsed < 5 * 1000 * 1000);
+  }
+
+  {
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+    auto output = oatpp::data::stream::ChunkedBuffer::createShared();
+    processor.addCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(transfer(handles[0], output)));
+
+    std::thread writer([&handles] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      const char* text = "Hello co_await!";
+      OATPP_ASSERT(::write(handles[1], text, std::strlen(text)) == (ssize_t) std::strlen(text));
+      ::close(handles[1]);
+    });
+
+    runAll(processor);
+    writer.join();
+
+    OATPP_ASSERT(output->toString() == "Hello co_await!");
+  }
+
+  {
+    v_int32 result = 0;
+    processor.addCoroutine(oatpp::async::AwaitCoroutine::getBench().obtain(bigFrame(&result)));
+    runAll(processor);
+    OATPP_ASSERT(result == 8000);
+  }
+
+  {
+    oatpp::async::Executor executor(1);
+    oatpp::async::Semaphore semaphore(0);
+    std::atomic<v_int32> state(0);
+
+    executor.execute<oatpp::async::AwaitCoroutine>(acquire(&semaphore, &state));
+
+    while(state.load() != 1) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    OATPP_ASSERT(state.load() == 1);
+
+    /* Release from foreign thread - Task is resumed on executor's processor */
+    semaphore.release();
+    while(state.load() != 2) {
+      std::this_thread::yield();
+    }
+
+    executor.stop();
+    executor.join();
+  }
+
+}
+
+}}}
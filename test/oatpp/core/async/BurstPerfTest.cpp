@@ -0,0 +1,125 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "BurstPerfTest.hpp"
+
+#include "oatpp/core/async/Processor.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 COROUTINES_COUNT = 2000;
+const v_int32 STAGES_COUNT = 8;
+const v_int32 STATE_SIZE = 4096;
+
+/**
+ * Request-like coroutine - goes through several stages, each touching coroutine's own state.
+ */
+class StagedCoroutine : public oatpp::async::Coroutine<StagedCoroutine> {
+private:
+  std::vector<v_int64>* m_completionTicks;
+  v_int32 m_stage;
+  v_word32 m_checksum;
+  v_char8 m_state[STATE_SIZE];
+public:
+
+  StagedCoroutine(std::vector<v_int64>* completionTicks)
+    : m_completionTicks(completionTicks)
+    , m_stage(0)
+    , m_checksum(0)
+  {}
+
+  Action act() override {
+    for(v_int32 i = 0; i < STATE_SIZE; i++) {
+      m_state[i] = (v_char8) (m_checksum + i);
+    }
+    return yieldTo(&StagedCoroutine::stage);
+  }
+
+  Action stage() {
+    for(v_int32 i = 0; i < STATE_SIZE; i++) {
+      m_checksum = m_checksum * 31 + m_state[i];
+      m_state[i] = (v_char8) m_checksum;
+    }
+    if(++ m_stage < STAGES_COUNT) {
+      return repeat();
+    }
+    m_completionTicks->push_back(oatpp::base::Environment::getMicroTickCount());
+    return finish();
+  }
+
+};
+
+void runBurst(const char* TAG, v_int32 burstSize) {
+
+  std::vector<v_int64> completionTicks;
+  completionTicks.reserve(COROUTINES_COUNT);
+
+  oatpp::async::Processor processor(oatpp::async::IOEventPoller::ENGINE_NONE, burstSize);
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  for(v_int32 i = 0; i < COROUTINES_COUNT; i++) {
+    processor.addCoroutine(StagedCoroutine::getBench().obtain(&completionTicks));
+  }
+
+  while(processor.iterate(1000)) {}
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  OATPP_ASSERT(completionTicks.size() == COROUTINES_COUNT);
+
+  /* Latency - time from submission of all coroutines to completion of each */
+  std::vector<v_int64> latencies;
+  for(auto tick : completionTicks) {
+    latencies.push_back(tick - tick0);
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  v_int64 sum = 0;
+  for(auto latency : latencies) {
+    sum += latency;
+  }
+
+  OATPP_LOGD(TAG, "burst=%d: %d coroutines in %lld micros (%.1f per sec). Latency mean=%lld, p50=%lld, p99=%lld micros",
+             burstSize, COROUTINES_COUNT, ticks, COROUTINES_COUNT * 1000000.0 / ticks,
+             sum / COROUTINES_COUNT, latencies[COROUTINES_COUNT / 2], latencies[COROUTINES_COUNT * 99 / 100]);
+
+}
+
+}
+
+void BurstPerfTest::onRun() {
+  runBurst(TAG, 1);
+  runBurst(TAG, 4);
+  runBurst(TAG, oatpp::async::Processor::BURST_SIZE_DEFAULT);
+  runBurst(TAG, 64);
+}
+
+}}}
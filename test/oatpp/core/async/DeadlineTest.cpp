@@ -0,0 +1,238 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "DeadlineTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/Event.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 WAIT_IO = 0;
+const v_int32 WAIT_TIMER = 1;
+const v_int32 WAIT_RETRY = 2;
+const v_int32 WAIT_EVENT = 3;
+
+struct Counters {
+  std::atomic<v_int32> childErrors;
+  std::atomic<v_int32> parentErrors;
+  std::atomic<v_int32> recovered;
+  std::atomic<v_int32> finished;
+  std::atomic<bool> timeout;
+  std::atomic<bool> cancelled;
+  /* Never set */
+  oatpp::async::Event event;
+  
+  Counters()
+    : childErrors(0)
+    , parentErrors(0)
+    , recovered(0)
+    , finished(0)
+    , timeout(false)
+    , cancelled(false)
+  {}
+};
+
+/**
+ * Waits forever - on I/O which never comes, on a far timer, in the waiting queue or on an event which is never set.
+ */
+class StuckCoroutine : public oatpp::async::Coroutine<StuckCoroutine> {
+private:
+  v_int32 m_waitType;
+  oatpp::data::v_io_handle m_handle;
+  v_int64 m_timeoutMicros;
+  Counters* m_counters;
+public:
+
+  StuckCoroutine(v_int32 waitType, oatpp::data::v_io_handle handle, v_int64 timeoutMicros, Counters* counters)
+    : m_waitType(waitType)
+    , m_handle(handle)
+    , m_timeoutMicros(timeoutMicros)
+    , m_counters(counters)
+  {}
+
+  Action act() override {
+    if(m_timeoutMicros > 0) {
+      setTimeout(std::chrono::microseconds(m_timeoutMicros));
+    }
+    return yieldTo(&StuckCoroutine::stuck);
+  }
+
+  Action stuck() {
+    switch(m_waitType) {
+      case WAIT_IO: {
+        v_char8 byte;
+        auto res = ::read(m_handle, &byte, 1);
+        OATPP_ASSERT(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+        return waitForIO(m_handle, Action::IO_EVENT_READ);
+      }
+      case WAIT_TIMER:
+        return waitFor(std::chrono::seconds(100));
+      case WAIT_EVENT:
+        return m_counters->event.wait(finish());
+      default:
+        return waitRetry();
+    }
+  }
+
+  Action handleError(const oatpp::async::Error& error) override {
+    m_counters->childErrors ++;
+    return error;
+  }
+
+};
+
+class ParentCoroutine : public oatpp::async::Coroutine<ParentCoroutine> {
+private:
+  v_int32 m_waitType;
+  oatpp::data::v_io_handle m_handle;
+  v_int64 m_timeoutMicros;
+  v_int64 m_childTimeoutMicros;
+  std::shared_ptr<oatpp::async::CancellationHandle> m_cancellationHandle;
+  Counters* m_counters;
+public:
+
+  ParentCoroutine(v_int32 waitType,
+                  oatpp::data::v_io_handle handle,
+                  v_int64 timeoutMicros,
+                  v_int64 childTimeoutMicros,
+                  const std::shared_ptr<oatpp::async::CancellationHandle>& cancellationHandle,
+                  Counters* counters)
+    : m_waitType(waitType)
+    , m_handle(handle)
+    , m_timeoutMicros(timeoutMicros)
+    , m_childTimeoutMicros(childTimeoutMicros)
+    , m_cancellationHandle(cancellationHandle)
+    , m_counters(counters)
+  {}
+
+  ~ParentCoroutine() {
+    m_counters->finished ++;
+  }
+
+  Action act() override {
+    if(m_timeoutMicros > 0) {
+      setTimeout(std::chrono::microseconds(m_timeoutMicros));
+    }
+    if(m_cancellationHandle) {
+      setCancellationHandle(m_cancellationHandle);
+    }
+    return startCoroutine<StuckCoroutine>(finish(), m_waitType, m_handle, m_childTimeoutMicros, m_counters);
+  }
+
+  Action handleError(const oatpp::async::Error& error) override {
+    m_counters->parentErrors ++;
+    m_counters->timeout = error.isTimeout();
+    m_counters->cancelled = error.isCancelled();
+    if(m_childTimeoutMicros > 0) {
+      /* Deadline of the child only - parent recovers */
+      m_counters->recovered ++;
+      return finish();
+    }
+    return error;
+  }
+
+};
+
+bool waitFinished(Counters& counters, v_int32 count, v_int64 timeoutMicros) {
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  while(counters.finished < count && oatpp::base::Environment::getMicroTickCount() - tick0 < timeoutMicros) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return counters.finished == count;
+}
+
+}
+
+void DeadlineTest::onRun() {
+
+  oatpp::data::v_io_handle handles[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+  fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+  oatpp::async::Executor executor(1);
+
+  for(v_int32 waitType = WAIT_IO; waitType <= WAIT_EVENT; waitType ++) {
+
+    {
+      OATPP_LOGD(TAG, "wait type %d. Deadline of the top-level coroutine", waitType);
+      Counters counters;
+      v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+      executor.execute<ParentCoroutine>(waitType, handles[0], 50 * 1000, 0, nullptr, &counters);
+      OATPP_ASSERT(waitFinished(counters, 1, 5 * 1000 * 1000));
+      v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+      OATPP_LOGD(TAG, "unwound in %lld micros", ticks);
+      OATPP_ASSERT(ticks >= 50 * 1000);
+      OATPP_ASSERT(counters.childErrors == 1);
+      OATPP_ASSERT(counters.parentErrors == 1);
+      OATPP_ASSERT(counters.timeout);
+    }
+
+    {
+      OATPP_LOGD(TAG, "wait type %d. Deadline of the child coroutine", waitType);
+      Counters counters;
+      executor.execute<ParentCoroutine>(waitType, handles[0], 0, 50 * 1000, nullptr, &counters);
+      OATPP_ASSERT(waitFinished(counters, 1, 5 * 1000 * 1000));
+      OATPP_ASSERT(counters.childErrors == 1);
+      OATPP_ASSERT(counters.parentErrors == 1);
+      OATPP_ASSERT(counters.recovered == 1);
+      OATPP_ASSERT(counters.timeout);
+    }
+
+    {
+      OATPP_LOGD(TAG, "wait type %d. Cancellation", waitType);
+      Counters counters;
+      auto handle = oatpp::async::CancellationHandle::createShared();
+      executor.execute<ParentCoroutine>(waitType, handles[0], 0, 0, handle, &counters);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      OATPP_ASSERT(counters.finished == 0);
+      handle->cancel();
+      OATPP_ASSERT(waitFinished(counters, 1, 5 * 1000 * 1000));
+      OATPP_ASSERT(counters.childErrors == 1);
+      OATPP_ASSERT(counters.parentErrors == 1);
+      OATPP_ASSERT(counters.cancelled);
+      /* Unwound coroutine is not in the wait list anymore */
+      counters.event.set();
+    }
+
+  }
+
+  executor.stop();
+  executor.join();
+
+  ::close(handles[0]);
+  ::close(handles[1]);
+
+}
+
+}}}
@@ -0,0 +1,238 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ElasticExecutorTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 MIN_THREADS = 1;
+const v_int32 MAX_THREADS = 4;
+const v_int32 HEAVY_STEPS = 200;
+const v_int32 TIMER_COUNT = 32;
+const v_int32 TIMER_STEPS = 50;
+const v_int32 IO_COUNT = 8;
+
+struct Counters {
+  std::atomic<v_int32> heavy;
+  std::atomic<v_int32> timer;
+  std::atomic<v_int32> io;
+
+  Counters()
+    : heavy(0)
+    , timer(0)
+    , io(0)
+  {}
+};
+
+/**
+ * CPU-bound coroutine yielding after each step of work.
+ */
+class HeavyCoroutine : public oatpp::async::Coroutine<HeavyCoroutine> {
+private:
+  Counters* m_counters;
+  v_int32 m_steps;
+  volatile v_int64 m_sum;
+public:
+
+  HeavyCoroutine(Counters* counters)
+    : m_counters(counters)
+    , m_steps(0)
+    , m_sum(0)
+  {}
+
+  Action act() override {
+    for(v_int32 i = 0; i < 1000; i++) {
+      m_sum = m_sum + i * m_steps;
+    }
+    if(++ m_steps < HEAVY_STEPS) {
+      return repeat();
+    }
+    m_counters->heavy ++;
+    return finish();
+  }
+
+};
+
+/**
+ * Sleeps in short intervals. Outlives scale-down and is migrated while waiting for timers.
+ */
+class TimerCoroutine : public oatpp::async::Coroutine<TimerCoroutine> {
+private:
+  Counters* m_counters;
+  v_int32 m_steps;
+public:
+
+  TimerCoroutine(Counters* counters)
+    : m_counters(counters)
+    , m_steps(0)
+  {}
+
+  Action act() override {
+    if(++ m_steps < TIMER_STEPS) {
+      return waitFor(std::chrono::milliseconds(20));
+    }
+    m_counters->timer ++;
+    return finish();
+  }
+
+};
+
+/**
+ * Waits for I/O until the test writes to the socket. Migrated while waiting for I/O.
+ */
+class ReadCoroutine : public oatpp::async::Coroutine<ReadCoroutine> {
+private:
+  Counters* m_counters;
+  oatpp::data::v_io_handle m_handle;
+public:
+
+  ReadCoroutine(Counters* counters, oatpp::data::v_io_handle handle)
+    : m_counters(counters)
+    , m_handle(handle)
+  {}
+
+  Action act() override {
+    v_char8 byte;
+    auto res = ::read(m_handle, &byte, 1);
+    if(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return waitForIO(m_handle, Action::IO_EVENT_READ);
+    }
+    OATPP_ASSERT(res == 1);
+    m_counters->io ++;
+    return finish();
+  }
+
+};
+
+template<class Predicate>
+bool waitFor(Predicate predicate, v_int64 timeoutMicros) {
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  while(!predicate()) {
+    if(oatpp::base::Environment::getMicroTickCount() - tick0 > timeoutMicros) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void logStats(const char* TAG, const char* stage, const oatpp::async::Executor::ScalingStats& stats) {
+  OATPP_LOGD(TAG, "%s: threads=%d, retiring=%d, up=%lld, down=%lld, migrated=%lld, utilization=%d%%, latency=%lld micros",
+             stage, stats.threadsCount, stats.retiringCount, stats.scaleUpCount, stats.scaleDownCount,
+             stats.migratedCount, stats.utilization, stats.latencyMicros);
+}
+
+}
+
+void ElasticExecutorTest::onRun() {
+
+  oatpp::async::Executor::ScalingConfig config(MIN_THREADS, MAX_THREADS);
+  config.checkIntervalMicros = 20 * 1000;
+  config.cooldownMicros = 200 * 1000;
+
+  oatpp::async::Executor executor(config);
+  OATPP_ASSERT(executor.getThreadsCount() == MIN_THREADS);
+  OATPP_ASSERT(executor.getMaxThreadsCount() == MAX_THREADS);
+
+  Counters counters;
+
+  /* Keep threads busy until executor scales up to the max */
+  v_int32 heavyCount = 0;
+  bool scaledUp = waitFor([&executor, &counters, &heavyCount] {
+    if(heavyCount - counters.heavy < 64) {
+      for(v_int32 i = 0; i < 16; i++) {
+        executor.execute<HeavyCoroutine>(&counters);
+        heavyCount ++;
+      }
+    }
+    return executor.getThreadsCount() == MAX_THREADS;
+  }, 10 * 1000 * 1000);
+
+  logStats(TAG, "loaded", executor.getScalingStats());
+  OATPP_ASSERT(scaledUp);
+  OATPP_ASSERT(executor.getScalingStats().scaleUpCount >= MAX_THREADS - MIN_THREADS);
+
+  /* Spread long-living coroutines over all threads */
+  for(v_int32 i = 0; i < TIMER_COUNT; i++) {
+    executor.execute<TimerCoroutine>(&counters);
+  }
+
+  int sockets[IO_COUNT][2];
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[i]) == 0);
+    fcntl(sockets[i][0], F_SETFL, O_NONBLOCK);
+    executor.execute<ReadCoroutine>(&counters, sockets[i][0]);
+  }
+
+  OATPP_ASSERT(waitFor([&counters, &heavyCount] { return counters.heavy == heavyCount; }, 30 * 1000 * 1000));
+
+  /* Idle threads are retired. Their coroutines are migrated */
+  bool scaledDown = waitFor([&executor] {
+    auto stats = executor.getScalingStats();
+    return stats.threadsCount == MIN_THREADS && stats.retiringCount == 0;
+  }, 10 * 1000 * 1000);
+
+  auto stats = executor.getScalingStats();
+  logStats(TAG, "idle", stats);
+  OATPP_ASSERT(scaledDown);
+  OATPP_ASSERT(stats.scaleDownCount >= MAX_THREADS - MIN_THREADS);
+  OATPP_ASSERT(stats.migratedCount >= IO_COUNT * (MAX_THREADS - MIN_THREADS) / MAX_THREADS);
+  OATPP_ASSERT(counters.io == 0);
+
+  /* Coroutines submitted after scale-down run as well */
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    v_char8 byte = 1;
+    OATPP_ASSERT(::write(sockets[i][1], &byte, 1) == 1);
+  }
+  for(v_int32 i = 0; i < 16; i++) {
+    executor.execute<HeavyCoroutine>(&counters);
+    heavyCount ++;
+  }
+
+  OATPP_ASSERT(waitFor([&counters, &heavyCount] {
+    return counters.io == IO_COUNT && counters.timer == TIMER_COUNT && counters.heavy == heavyCount;
+  }, 10 * 1000 * 1000));
+
+  executor.stop();
+  executor.join();
+
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    ::close(sockets[i][0]);
+    ::close(sockets[i][1]);
+  }
+
+}
+
+}}}
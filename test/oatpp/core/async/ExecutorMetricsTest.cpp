@@ -0,0 +1,216 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ExecutorMetricsTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 THREADS = 2;
+const v_int32 CPU_COUNT = 100;
+const v_int32 CPU_STEPS = 100;
+const v_int32 RETRY_COUNT = 10;
+const v_int32 RETRY_STEPS = 5;
+const v_int32 IO_COUNT = 4;
+
+std::atomic<v_int32> g_done(0);
+
+class CpuCoroutine : public oatpp::async::Coroutine<CpuCoroutine> {
+private:
+  v_int32 m_steps = 0;
+public:
+
+  Action act() override {
+    if(++ m_steps < CPU_STEPS) {
+      return repeat();
+    }
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class RetryCoroutine : public oatpp::async::Coroutine<RetryCoroutine> {
+private:
+  v_int32 m_steps = 0;
+public:
+
+  Action act() override {
+    if(++ m_steps < RETRY_STEPS) {
+      return waitRetry();
+    }
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class ReadCoroutine : public oatpp::async::Coroutine<ReadCoroutine> {
+private:
+  oatpp::data::v_io_handle m_handle;
+public:
+
+  ReadCoroutine(oatpp::data::v_io_handle handle)
+    : m_handle(handle)
+  {}
+
+  Action act() override {
+    v_char8 byte;
+    auto res = ::read(m_handle, &byte, 1);
+    if(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return waitForIO(m_handle, Action::IO_EVENT_READ);
+    }
+    OATPP_ASSERT(res == 1);
+    g_done ++;
+    return finish();
+  }
+
+};
+
+template<class Predicate>
+bool waitFor(Predicate predicate, v_int64 timeoutMicros) {
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  while(!predicate()) {
+    if(oatpp::base::Environment::getMicroTickCount() - tick0 > timeoutMicros) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}
+
+void ExecutorMetricsTest::onRun() {
+
+  oatpp::async::Executor executor(THREADS);
+
+  auto metrics0 = executor.getMetrics();
+  OATPP_ASSERT(metrics0.processors.size() == THREADS);
+  OATPP_ASSERT(metrics0.total.submittedCount == 0);
+  OATPP_ASSERT(metrics0.total.finishedCount == 0);
+
+  int sockets[IO_COUNT][2];
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets[i]) == 0);
+    fcntl(sockets[i][0], F_SETFL, O_NONBLOCK);
+    executor.execute<ReadCoroutine>(sockets[i][0]);
+  }
+
+  for(v_int32 i = 0; i < CPU_COUNT; i++) {
+    executor.execute<CpuCoroutine>();
+  }
+
+  for(v_int32 i = 0; i < RETRY_COUNT; i++) {
+    executor.execute<RetryCoroutine>();
+  }
+
+  OATPP_ASSERT(waitFor([] { return g_done == CPU_COUNT + RETRY_COUNT; }, 10 * 1000 * 1000));
+
+  /* Readers are parked on I/O */
+  OATPP_ASSERT(waitFor([&executor] { return executor.getMetrics().total.ioWaitingCount == IO_COUNT; }, 10 * 1000 * 1000));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    OATPP_ASSERT(::write(sockets[i][1], "x", 1) == 1);
+  }
+
+  const v_int32 total = CPU_COUNT + RETRY_COUNT + IO_COUNT;
+  OATPP_ASSERT(waitFor([] { return g_done == total; }, 10 * 1000 * 1000));
+  OATPP_ASSERT(waitFor([&executor] { return executor.getMetrics().total.finishedCount == total; }, 10 * 1000 * 1000));
+
+  auto metrics = executor.getMetrics();
+  auto& m = metrics.total;
+
+  OATPP_LOGD(TAG, "submitted=%lld, finished=%lld, steps=%lld, passes=%lld, sleeps=%lld, wakeups=%lld, busy=%lld, idle=%lld micros",
+             m.submittedCount, m.finishedCount, m.stepsCount, m.passesCount, m.sleepsCount, m.wakeupsCount,
+             m.busyMicros, m.idleMicros);
+  OATPP_LOGD(TAG, "pass p50=%lld, p99=%lld; waiting mean=%lld; io-waiting mean=%lld micros",
+             m.passMicros.getPercentileMicros(50), m.passMicros.getPercentileMicros(99),
+             m.waitingMicros.getMeanMicros(), m.ioWaitingMicros.getMeanMicros());
+
+  OATPP_ASSERT(m.submittedCount == total);
+  OATPP_ASSERT(m.finishedCount == total);
+  OATPP_ASSERT(m.pendingCount == 0);
+  OATPP_ASSERT(m.activeCount == 0);
+  OATPP_ASSERT(m.waitingCount == 0);
+  OATPP_ASSERT(m.ioWaitingCount == 0);
+  OATPP_ASSERT(m.parkedCount == 0);
+  OATPP_ASSERT(m.stepsCount >= CPU_COUNT * CPU_STEPS);
+  OATPP_ASSERT(m.passesCount > 0);
+  OATPP_ASSERT(m.passMicros.count == m.passesCount);
+  OATPP_ASSERT(m.sleepsCount > 0);
+
+  /* Every coroutine goes through the waiting queue on submission. Retrying coroutines stay there until they are done */
+  OATPP_ASSERT(m.waitingMicros.count >= total);
+  OATPP_ASSERT(m.ioWaitingMicros.count >= IO_COUNT);
+  OATPP_ASSERT(m.ioWaitingMicros.getPercentileMicros(100) >= 20 * 1000);
+
+  v_int64 submittedCount = 0;
+  for(auto& p : metrics.processors) {
+    submittedCount += p.submittedCount;
+  }
+  OATPP_ASSERT(submittedCount == total);
+
+  OATPP_ASSERT(metrics.getStepsPerSecond(metrics0) > 0);
+  OATPP_ASSERT(metrics.getBusyRatio(metrics0) > 0);
+
+  /* Histogram buckets */
+  oatpp::async::Histogram histogram;
+  histogram.record(0);
+  histogram.record(1);
+  histogram.record(3);
+  histogram.record(1000);
+  auto snapshot = histogram.getSnapshot();
+  OATPP_ASSERT(snapshot.count == 4);
+  OATPP_ASSERT(snapshot.sumMicros == 1004);
+  OATPP_ASSERT(snapshot.buckets[0] == 1);
+  OATPP_ASSERT(snapshot.buckets[1] == 1);
+  OATPP_ASSERT(snapshot.buckets[2] == 1);
+  OATPP_ASSERT(snapshot.buckets[10] == 1);
+  OATPP_ASSERT(snapshot.getPercentileMicros(50) == oatpp::async::Histogram::getBucketUpperBoundMicros(2));
+  OATPP_ASSERT(snapshot.getPercentileMicros(100) == oatpp::async::Histogram::getBucketUpperBoundMicros(10));
+
+  executor.stop();
+  executor.join();
+
+  for(v_int32 i = 0; i < IO_COUNT; i++) {
+    ::close(sockets[i][0]);
+    ::close(sockets[i][1]);
+  }
+
+}
+
+}}}
@@ -0,0 +1,251 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FiberTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/Processor.hpp"
+#include "oatpp/core/async/Fiber.hpp"
+
+#include "oatpp/network/Connection.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Action Action;
+typedef oatpp::async::Fiber Fiber;
+
+const v_int32 DATA_SIZE = 4 * 1024 * 1024;
+
+void createSocketPair(std::shared_ptr<oatpp::network::Connection>& a, std::shared_ptr<oatpp::network::Connection>& b) {
+  int fds[2];
+  OATPP_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  for(v_int32 i = 0; i < 2; i ++) {
+    ::fcntl(fds[i], F_SETFL, ::fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+  }
+  a = oatpp::network::Connection::createShared(fds[0]);
+  b = oatpp::network::Connection::createShared(fds[1]);
+}
+
+void testTransfer(v_int32 ioEngine) {
+
+  std::shared_ptr<oatpp::network::Connection> writerConnection;
+  std::shared_ptr<oatpp::network::Connection> readerConnection;
+  createSocketPair(writerConnection, readerConnection);
+
+  auto stackPool = Fiber::StackPool::createShared(64 * 1024);
+  std::atomic<v_int32> finished(0);
+  std::atomic<bool> transferred(false);
+
+  /* Single thread. Blocking-style write of data larger than socket buffer would deadlock if fiber didn't yield */
+  oatpp::async::Executor executor(1, ioEngine);
+
+  executor.execute<oatpp::async::FiberCoroutine>(stackPool, [writerConnection, &finished] {
+    std::vector<v_char8> data(DATA_SIZE);
+    for(v_int32 i = 0; i < DATA_SIZE; i ++) {
+      data[i] = (v_char8) (i % 251);
+    }
+    auto res = oatpp::data::stream::writeExactSizeData(writerConnection.get(), data.data(), DATA_SIZE);
+    OATPP_ASSERT(res == DATA_SIZE);
+    finished ++;
+  });
+
+  executor.execute<oatpp::async::FiberCoroutine>(stackPool, [readerConnection, &finished, &transferred] {
+    std::vector<v_char8> data(DATA_SIZE);
+    auto res = oatpp::data::stream::readExactSizeData(readerConnection.get(), data.data(), DATA_SIZE);
+    OATPP_ASSERT(res == DATA_SIZE);
+    bool valid = true;
+    for(v_int32 i = 0; i < DATA_SIZE; i ++) {
+      valid = valid && data[i] == (v_char8) (i % 251);
+    }
+    transferred = valid;
+    finished ++;
+  });
+
+  while(finished.load() < 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  executor.stop();
+  executor.join();
+
+  OATPP_ASSERT(transferred.load());
+
+}
+
+class PinnedCoroutine : public oatpp::async::Coroutine<PinnedCoroutine> {
+public:
+
+  PinnedCoroutine(bool pinned) {
+    setPinned(pinned);
+  }
+
+  Action act() override {
+    return finish();
+  }
+
+};
+
+void testFibersStayOnThread() {
+
+  const v_int32 fibersCount = 64;
+  const v_int32 switchesCount = 200;
+
+  auto stackPool = Fiber::StackPool::createShared(64 * 1024);
+  std::atomic<v_int32> finished(0);
+  std::atomic<v_int32> migrated(0);
+
+  oatpp::async::Executor executor(4);
+
+  for(v_int32 i = 0; i < fibersCount; i ++) {
+    executor.execute<oatpp::async::FiberCoroutine>(stackPool, [&finished, &migrated] {
+      std::thread::id threadId = std::this_thread::get_id();
+      for(v_int32 n = 0; n < switchesCount; n ++) {
+        OATPP_ASSERT(Fiber::getCurrent()->suspend(Action::_REPEAT));
+        if(std::this_thread::get_id() != threadId) {
+          migrated ++;
+        }
+      }
+      finished ++;
+    });
+  }
+
+  while(finished.load() < fibersCount) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  executor.stop();
+  executor.join();
+
+  OATPP_ASSERT(migrated.load() == 0);
+
+}
+
+}
+
+void FiberTest::onRun() {
+
+  { // pinned coroutines are not shared with other processors
+    oatpp::async::Processor processor;
+    for(v_int32 i = 0; i < 8; i ++) {
+      processor.addCoroutine(PinnedCoroutine::getBench().obtain(i % 2 == 0));
+    }
+    oatpp::collection::FastQueue<oatpp::async::AbstractCoroutine> shared;
+    OATPP_ASSERT(processor.splitActiveQueue(shared) == 2);
+    OATPP_ASSERT(processor.getTasksCount() == 6);
+    while(shared.first != nullptr) {
+      auto coroutine = shared.popFront();
+      OATPP_ASSERT(!coroutine->isPinned());
+      coroutine->free();
+    }
+  }
+
+  { // stack pool reuses released stacks
+    Fiber::StackPool pool(10000);
+    OATPP_ASSERT(pool.getStackSize() >= 10000);
+    p_char8 stack = pool.obtain();
+    stack[0] = 1;
+    stack[pool.getStackSize() - 1] = 1;
+    pool.free(stack);
+    OATPP_ASSERT(pool.obtain() == stack);
+    pool.free(stack);
+  }
+
+  auto stackPool = Fiber::StackPool::createShared();
+
+  { // suspend / resume
+    v_int32 counter = 0;
+    Fiber fiber(stackPool, [&counter] {
+      for(v_int32 i = 0; i < 3; i ++) {
+        counter ++;
+        OATPP_ASSERT(Fiber::getCurrent() != nullptr);
+        OATPP_ASSERT(Fiber::getCurrent()->suspend(Action::_REPEAT));
+      }
+    });
+    OATPP_ASSERT(Fiber::getCurrent() == nullptr);
+    for(v_int32 i = 1; i <= 3; i ++) {
+      auto action = fiber.resume();
+      OATPP_ASSERT(action.getType() == Action::TYPE_REPEAT);
+      OATPP_ASSERT(counter == i);
+      OATPP_ASSERT(!fiber.isFinished());
+    }
+    OATPP_ASSERT(fiber.resume().getType() == Action::TYPE_FINISH);
+    OATPP_ASSERT(fiber.isFinished());
+    OATPP_ASSERT(!fiber.getException());
+  }
+
+  { // exception is captured
+    Fiber fiber(stackPool, [] {
+      throw std::runtime_error("error in fiber");
+    });
+    fiber.resume();
+    OATPP_ASSERT(fiber.isFinished());
+    OATPP_ASSERT(fiber.getException());
+  }
+
+  { // Connection suspends fiber on EAGAIN. Destroyed fiber is cancelled and unwinds
+    std::shared_ptr<oatpp::network::Connection> a;
+    std::shared_ptr<oatpp::network::Connection> b;
+    createSocketPair(a, b);
+
+    data::v_io_size readResult = 0;
+    bool unwound = false;
+    {
+      Fiber fiber(stackPool, [a, &readResult, &unwound] {
+        v_char8 buffer[16];
+        readResult = oatpp::data::stream::readExactSizeData(a.get(), buffer, 16);
+        unwound = true;
+      });
+      auto action = fiber.resume();
+      OATPP_ASSERT(action.getType() == Action::TYPE_WAIT_FOR_IO);
+      OATPP_ASSERT(action.getIOHandle() == a->getHandle());
+      OATPP_ASSERT(action.getIOEventType() == Action::IO_EVENT_READ);
+      OATPP_ASSERT(!unwound);
+    }
+    OATPP_ASSERT(unwound);
+    OATPP_ASSERT(readResult == 0);
+
+    /* Outside of fiber non-blocking connection returns WAIT_RETRY as before */
+    v_char8 buffer[16];
+    OATPP_ASSERT(a->read(buffer, 16) == data::IOError::WAIT_RETRY);
+  }
+
+  OATPP_LOGD(TAG, "fibers stay on their thread");
+  testFibersStayOnThread();
+
+  OATPP_LOGD(TAG, "transfer with IO poller");
+  testTransfer(oatpp::async::IOEventPoller::ENGINE_AUTO);
+  OATPP_LOGD(TAG, "transfer without IO poller");
+  testTransfer(oatpp::async::IOEventPoller::ENGINE_NONE);
+
+}
+
+}}}
@@ -0,0 +1,218 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FramePoolTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::FramePool FramePool;
+
+std::atomic<v_int32> g_done(0);
+
+class SmallCoroutine : public oatpp::async::Coroutine<SmallCoroutine> {
+public:
+
+  Action act() override {
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class BigCoroutine : public oatpp::async::Coroutine<BigCoroutine> {
+private:
+  v_char8 m_buffer[1000];
+public:
+
+  Action act() override {
+    m_buffer[0] = 0;
+    g_done ++;
+    return finish();
+  }
+
+};
+
+FramePool::TypeStats getTypeStats(const char* name) {
+  auto stats = FramePool::getStats();
+  for(auto& type : stats.types) {
+    if(type.typeName.find(name) != std::string::npos) {
+      return type;
+    }
+  }
+  FramePool::TypeStats empty;
+  empty.objectSize = 0;
+  empty.inUseCount = 0;
+  empty.peakCount = 0;
+  empty.allocatedCount = 0;
+  empty.inUseBytes = 0;
+  return empty;
+}
+
+}
+
+void FramePoolTest::onRun() {
+
+  /* Per type stats */
+  {
+    std::vector<SmallCoroutine*> small;
+    std::vector<BigCoroutine*> big;
+    for(v_int32 i = 0; i < 100; i ++) {
+      small.push_back(SmallCoroutine::getBench().obtain());
+    }
+    for(v_int32 i = 0; i < 10; i ++) {
+      big.push_back(BigCoroutine::getBench().obtain());
+    }
+
+    auto smallStats = getTypeStats("SmallCoroutine");
+    auto bigStats = getTypeStats("BigCoroutine");
+    OATPP_LOGD(TAG, "small: size=%d, inUse=%lld, bytes=%lld; big: size=%d, inUse=%lld, bytes=%lld",
+               smallStats.objectSize, smallStats.inUseCount, smallStats.inUseBytes,
+               bigStats.objectSize, bigStats.inUseCount, bigStats.inUseBytes);
+
+    OATPP_ASSERT(smallStats.objectSize == sizeof(SmallCoroutine));
+    OATPP_ASSERT(smallStats.inUseCount == 100);
+    OATPP_ASSERT(smallStats.peakCount == 100);
+    OATPP_ASSERT(smallStats.inUseBytes >= 100 * (v_int64) sizeof(SmallCoroutine));
+    OATPP_ASSERT(bigStats.inUseCount == 10);
+    OATPP_ASSERT(bigStats.inUseBytes >= 10 * 1024);
+
+    for(auto c : small) {
+      c->free();
+    }
+    for(auto c : big) {
+      c->free();
+    }
+
+    smallStats = getTypeStats("SmallCoroutine");
+    OATPP_ASSERT(smallStats.inUseCount == 0);
+    OATPP_ASSERT(smallStats.inUseBytes == 0);
+    OATPP_ASSERT(smallStats.peakCount == 100);
+    OATPP_ASSERT(smallStats.allocatedCount == 100);
+    OATPP_ASSERT(getTypeStats("BigCoroutine").inUseCount == 0);
+  }
+
+  FramePool& pool = FramePool::getThreadPool();
+  FramePool::Counters* counters = pool.getCounters(typeid(FramePoolTest), 0);
+
+  /* Frames of the same size class are shared by types */
+  {
+    void* frame = pool.allocate(counters, sizeof(SmallCoroutine));
+    FramePool::free(frame);
+    SmallCoroutine* coroutine = SmallCoroutine::getBench().obtain();
+    OATPP_ASSERT((void*) coroutine == frame);
+    coroutine->free();
+  }
+
+  /* Frame freed on another thread goes back to the pool */
+  {
+    std::vector<void*> frames;
+    for(v_int32 i = 0; i < 10; i ++) {
+      frames.push_back(pool.allocate(counters, 200));
+    }
+    std::thread thread([&frames] {
+      for(auto frame : frames) {
+        FramePool::free(frame);
+      }
+    });
+    thread.join();
+    OATPP_ASSERT(getTypeStats("FramePoolTest").inUseCount == 10);
+    pool.onIdle(oatpp::base::Environment::getMicroTickCount());
+    OATPP_ASSERT(getTypeStats("FramePoolTest").inUseCount == 0);
+  }
+
+  /* Frames larger than the last size class */
+  {
+    void* frame = pool.allocate(counters, FramePool::MAX_POOLED_FRAME_SIZE * 2);
+    OATPP_ASSERT(((v_int64) frame) % 16 == 0);
+    OATPP_ASSERT(getTypeStats("FramePoolTest").inUseBytes > FramePool::MAX_POOLED_FRAME_SIZE * 2);
+    FramePool::free(frame);
+    OATPP_ASSERT(getTypeStats("FramePoolTest").inUseBytes == 0);
+  }
+
+  /* Free chunks are released when the thread is idle */
+  {
+    auto stats0 = FramePool::getStats();
+
+    std::vector<void*> frames;
+    for(v_int32 i = 0; i < 1000; i ++) {
+      void* frame = pool.allocate(counters, 100);
+      OATPP_ASSERT(((v_int64) frame) % 16 == 0);
+      frames.push_back(frame);
+    }
+
+    auto stats1 = FramePool::getStats();
+    OATPP_ASSERT(stats1.chunksCount > stats0.chunksCount + 1);
+
+    for(auto frame : frames) {
+      FramePool::free(frame);
+    }
+
+    /* Pool has just grown - nothing is released yet */
+    v_int64 currentMicros = oatpp::base::Environment::getMicroTickCount();
+    v_int64 timeout = pool.onIdle(currentMicros);
+    OATPP_ASSERT(timeout > 0 && timeout <= FramePool::SHRINK_DELAY_MICROS);
+    OATPP_ASSERT(FramePool::getStats().chunksCount == stats1.chunksCount);
+
+    pool.onIdle(currentMicros + FramePool::SHRINK_DELAY_MICROS);
+    auto stats2 = FramePool::getStats();
+    OATPP_LOGD(TAG, "chunks: %lld -> %lld -> %lld, reserved bytes: %lld -> %lld -> %lld",
+               stats0.chunksCount, stats1.chunksCount, stats2.chunksCount,
+               stats0.reservedBytes, stats1.reservedBytes, stats2.reservedBytes);
+    OATPP_ASSERT(stats2.chunksCount < stats1.chunksCount);
+    OATPP_ASSERT(stats2.chunksCount <= stats0.chunksCount + 1);
+    OATPP_ASSERT(stats2.reservedBytes < stats1.reservedBytes);
+
+    /* Remaining frames are still usable */
+    void* frame = pool.allocate(counters, 100);
+    FramePool::free(frame);
+  }
+
+  /* Coroutines run by executor */
+  {
+    oatpp::async::Executor executor(2);
+    for(v_int32 i = 0; i < 1000; i ++) {
+      executor.execute<SmallCoroutine>();
+      executor.execute<BigCoroutine>();
+    }
+    while(g_done < 2000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.stop();
+    executor.join();
+    pool.onIdle(oatpp::base::Environment::getMicroTickCount());
+    OATPP_ASSERT(getTypeStats("SmallCoroutine").inUseCount == 0);
+    OATPP_ASSERT(getTypeStats("SmallCoroutine").allocatedCount == 100 + 1 + 1000);
+    OATPP_ASSERT(getTypeStats("BigCoroutine").inUseCount == 0);
+  }
+
+}
+
+}}}
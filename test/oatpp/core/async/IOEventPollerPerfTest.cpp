@@ -0,0 +1,267 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "IOEventPollerPerfTest.hpp"
+
+#include "oatpp/network/Connection.hpp"
+
+#include "oatpp/core/async/Processor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 CONNECTIONS_COUNT = 100;
+const v_int32 ROUNDS_COUNT = 200;
+
+/**
+ * Sends one byte and waits for the echo.
+ */
+class PingCoroutine : public oatpp::async::Coroutine<PingCoroutine> {
+private:
+  oatpp::data::v_io_handle m_handle;
+  v_int32 m_rounds;
+public:
+
+  PingCoroutine(oatpp::data::v_io_handle handle)
+    : m_handle(handle)
+    , m_rounds(0)
+  {}
+
+  Action act() override {
+    v_char8 byte = 'p';
+    OATPP_ASSERT(::write(m_handle, &byte, 1) == 1);
+    return yieldTo(&PingCoroutine::onPong);
+  }
+
+  Action onPong() {
+    v_char8 byte;
+    auto res = ::read(m_handle, &byte, 1);
+    if(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return waitForIO(m_handle, Action::IO_EVENT_READ);
+    }
+    OATPP_ASSERT(res == 1);
+    m_rounds ++;
+    if(m_rounds < ROUNDS_COUNT) {
+      return yieldTo(&PingCoroutine::act);
+    }
+    return finish();
+  }
+
+};
+
+/**
+ * Echoes every byte received.
+ */
+class PongCoroutine : public oatpp::async::Coroutine<PongCoroutine> {
+private:
+  oatpp::data::v_io_handle m_handle;
+  v_int32 m_rounds;
+public:
+
+  PongCoroutine(oatpp::data::v_io_handle handle)
+    : m_handle(handle)
+    , m_rounds(0)
+  {}
+
+  Action act() override {
+    v_char8 byte;
+    auto res = ::read(m_handle, &byte, 1);
+    if(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return waitForIO(m_handle, Action::IO_EVENT_READ);
+    }
+    OATPP_ASSERT(res == 1);
+    OATPP_ASSERT(::write(m_handle, &byte, 1) == 1);
+    m_rounds ++;
+    if(m_rounds < ROUNDS_COUNT) {
+      return repeat();
+    }
+    return finish();
+  }
+
+};
+
+/**
+ * Same as PingCoroutine but with &id:oatpp::network::Connection; I/O -
+ * with io_uring engine reads and writes are submitted to the ring.
+ */
+class ConnectionPingCoroutine : public oatpp::async::Coroutine<ConnectionPingCoroutine> {
+private:
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+  v_int32 m_rounds;
+public:
+
+  ConnectionPingCoroutine(const std::shared_ptr<oatpp::network::Connection>& connection)
+    : m_connection(connection)
+    , m_rounds(0)
+  {}
+
+  Action act() override {
+    v_char8 byte = 'p';
+    auto res = m_connection->write(&byte, 1);
+    if(res == oatpp::data::IOError::WAIT_RETRY) {
+      return m_connection->suggestOutputStreamAction(res);
+    }
+    OATPP_ASSERT(res == 1);
+    return yieldTo(&ConnectionPingCoroutine::onPong);
+  }
+
+  Action onPong() {
+    v_char8 byte;
+    auto res = m_connection->read(&byte, 1);
+    if(res == oatpp::data::IOError::WAIT_RETRY) {
+      return m_connection->suggestInputStreamAction(res);
+    }
+    OATPP_ASSERT(res == 1);
+    m_rounds ++;
+    if(m_rounds < ROUNDS_COUNT) {
+      return yieldTo(&ConnectionPingCoroutine::act);
+    }
+    return finish();
+  }
+
+};
+
+/**
+ * Same as PongCoroutine but with &id:oatpp::network::Connection; I/O.
+ */
+class ConnectionPongCoroutine : public oatpp::async::Coroutine<ConnectionPongCoroutine> {
+private:
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+  v_int32 m_rounds;
+  v_char8 m_byte;
+public:
+
+  ConnectionPongCoroutine(const std::shared_ptr<oatpp::network::Connection>& connection)
+    : m_connection(connection)
+    , m_rounds(0)
+  {}
+
+  Action act() override {
+    auto res = m_connection->read(&m_byte, 1);
+    if(res == oatpp::data::IOError::WAIT_RETRY) {
+      return m_connection->suggestInputStreamAction(res);
+    }
+    OATPP_ASSERT(res == 1);
+    return yieldTo(&ConnectionPongCoroutine::echo);
+  }
+
+  Action echo() {
+    auto res = m_connection->write(&m_byte, 1);
+    if(res == oatpp::data::IOError::WAIT_RETRY) {
+      return m_connection->suggestOutputStreamAction(res);
+    }
+    OATPP_ASSERT(res == 1);
+    m_rounds ++;
+    if(m_rounds < ROUNDS_COUNT) {
+      return yieldTo(&ConnectionPongCoroutine::act);
+    }
+    return finish();
+  }
+
+};
+
+void runEngine(const char* TAG, v_int32 engine, const char* engineName) {
+
+  oatpp::async::Processor processor(engine);
+  if(processor.getIOEngine() != engine) {
+    OATPP_LOGD(TAG, "engine '%s' is not available. Skipping.", engineName);
+    return;
+  }
+
+  oatpp::data::v_io_handle handles[CONNECTIONS_COUNT * 2];
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT; i++) {
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, &handles[i * 2]) == 0);
+    fcntl(handles[i * 2], F_SETFL, O_NONBLOCK);
+    fcntl(handles[i * 2 + 1], F_SETFL, O_NONBLOCK);
+    processor.addCoroutine(PongCoroutine::getBench().obtain(handles[i * 2 + 1]));
+    processor.addCoroutine(PingCoroutine::getBench().obtain(handles[i * 2]));
+  }
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  while(!processor.isEmpty()) {
+    if(!processor.iterate(1000)) {
+      processor.pollIOEvents(10);
+    }
+  }
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT * 2; i++) {
+    ::close(handles[i]);
+  }
+
+  OATPP_LOGD(TAG, "engine '%s': %d round trips in %lld micros", engineName, CONNECTIONS_COUNT * ROUNDS_COUNT, ticks);
+
+}
+
+void runEngineWithConnections(const char* TAG, v_int32 engine, const char* engineName) {
+
+  oatpp::async::Processor processor(engine);
+  if(processor.getIOEngine() != engine) {
+    OATPP_LOGD(TAG, "engine '%s' is not available. Skipping.", engineName);
+    return;
+  }
+
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT; i++) {
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    fcntl(handles[0], F_SETFL, O_NONBLOCK);
+    fcntl(handles[1], F_SETFL, O_NONBLOCK);
+    processor.addCoroutine(ConnectionPongCoroutine::getBench().obtain(oatpp::network::Connection::createShared(handles[1])));
+    processor.addCoroutine(ConnectionPingCoroutine::getBench().obtain(oatpp::network::Connection::createShared(handles[0])));
+  }
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  while(!processor.isEmpty()) {
+    if(!processor.iterate(1000)) {
+      processor.pollIOEvents(10);
+    }
+  }
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  OATPP_LOGD(TAG, "engine '%s', connections: %d round trips in %lld micros", engineName, CONNECTIONS_COUNT * ROUNDS_COUNT, ticks);
+
+}
+
+}
+
+void IOEventPollerPerfTest::onRun() {
+#if defined(__linux__)
+  runEngine(TAG, oatpp::async::IOEventPoller::ENGINE_EPOLL, "epoll");
+  runEngine(TAG, oatpp::async::IOEventPoller::ENGINE_IO_URING, "io_uring");
+  runEngineWithConnections(TAG, oatpp::async::IOEventPoller::ENGINE_EPOLL, "epoll");
+  runEngineWithConnections(TAG, oatpp::async::IOEventPoller::ENGINE_IO_URING, "io_uring");
+#endif
+}
+
+}}}
@@ -0,0 +1,243 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "IOEventPollerTest.hpp"
+
+#include "oatpp/network/Connection.hpp"
+
+#include "oatpp/core/async/IOEventPoller.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+class IdleCoroutine : public oatpp::async::Coroutine<IdleCoroutine> {
+public:
+
+  Action act() override {
+    return finish();
+  }
+
+};
+
+/**
+ * Write to the handle until its send buffer is full.
+ */
+void fillSendBuffer(oatpp::data::v_io_handle handle) {
+  v_char8 buffer[4096];
+  std::memset(buffer, 0, sizeof(buffer));
+  while(::write(handle, buffer, sizeof(buffer)) > 0) {}
+  OATPP_ASSERT(errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+void drain(oatpp::data::v_io_handle handle) {
+  v_char8 buffer[4096];
+  while(::read(handle, buffer, sizeof(buffer)) > 0) {}
+}
+
+v_int32 poll(oatpp::async::IOEventPoller* poller, oatpp::async::AbstractCoroutine** coroutines, v_int32 timeoutMillis) {
+  return poller->pollEvents(coroutines, 8, timeoutMillis);
+}
+
+void testReadWriteOnSameHandle(oatpp::async::IOEventPoller* poller) {
+
+  oatpp::data::v_io_handle handles[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+  fcntl(handles[0], F_SETFL, O_NONBLOCK);
+  fcntl(handles[1], F_SETFL, O_NONBLOCK);
+
+  fillSendBuffer(handles[0]);
+
+  IdleCoroutine* reader = new IdleCoroutine();
+  IdleCoroutine* writer = new IdleCoroutine();
+  oatpp::async::AbstractCoroutine* coroutines[8];
+
+  OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_READ, reader));
+  OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_WRITE, writer));
+  OATPP_ASSERT(poll(poller, coroutines, 0) == 0);
+
+  /* Readable - reader is resumed, writer keeps waiting */
+  v_char8 byte = 'x';
+  OATPP_ASSERT(::write(handles[1], &byte, 1) == 1);
+  OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+  OATPP_ASSERT(coroutines[0] == reader);
+  OATPP_ASSERT(::read(handles[0], &byte, 1) == 1);
+
+  /* Writable - writer is resumed */
+  drain(handles[1]);
+  OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+  OATPP_ASSERT(coroutines[0] == writer);
+  OATPP_ASSERT(poll(poller, coroutines, 0) == 0);
+
+  /* Unwatched reader is not resumed, writer still is */
+  fillSendBuffer(handles[0]);
+  OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_READ, reader));
+  OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_WRITE, writer));
+  if(!poller->unwatch(handles[0], reader)) {
+    /* Asynchronous cancellation - reader is returned once more */
+    OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+    OATPP_ASSERT(coroutines[0] == reader);
+  }
+  OATPP_ASSERT(::write(handles[1], &byte, 1) == 1);
+  drain(handles[1]);
+  OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+  OATPP_ASSERT(coroutines[0] == writer);
+  OATPP_ASSERT(poll(poller, coroutines, 0) == 0);
+
+  delete reader;
+  delete writer;
+
+  ::close(handles[0]);
+  ::close(handles[1]);
+
+}
+
+#if defined(OATPP_ASYNC_IO_URING)
+
+oatpp::data::v_io_size readExactly(oatpp::data::v_io_handle handle, void* buffer, oatpp::data::v_io_size count,
+                                   oatpp::async::IOEventPoller* poller)
+{
+  oatpp::async::AbstractCoroutine* coroutines[8];
+  oatpp::data::v_io_size progress = 0;
+  for(v_int32 i = 0; i < 1000 && progress < count; i ++) {
+    poll(poller, coroutines, 1);
+    auto res = ::read(handle, (p_char8) buffer + progress, count - progress);
+    if(res <= 0) {
+      if(res == 0) {
+        break;
+      }
+      continue;
+    }
+    progress += res;
+  }
+  return progress;
+}
+
+void testConnectionThroughRing(oatpp::async::IOEventPoller* poller) {
+
+  oatpp::data::v_io_handle handles[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+  fcntl(handles[0], F_SETFL, O_NONBLOCK);
+  fcntl(handles[1], F_SETFL, O_NONBLOCK);
+
+  auto previousPoller = oatpp::async::IOEventPoller::setCurrent(poller);
+
+  IdleCoroutine* reader = new IdleCoroutine();
+  IdleCoroutine* writer = new IdleCoroutine();
+  oatpp::async::AbstractCoroutine* coroutines[8];
+  v_char8 buffer[16];
+
+  {
+    auto connection = oatpp::network::Connection::createShared(handles[0]);
+
+    /* Read submits receive. Reader is resumed by its completion */
+    OATPP_ASSERT(connection->read(buffer, sizeof(buffer)) == oatpp::data::IOError::WAIT_RETRY);
+    auto action = connection->suggestInputStreamAction(oatpp::data::IOError::WAIT_RETRY);
+    OATPP_ASSERT(action.getType() == oatpp::async::Action::TYPE_WAIT_FOR_IO);
+    OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_READ, reader));
+    OATPP_ASSERT(poll(poller, coroutines, 0) == 0);
+
+    OATPP_ASSERT(::write(handles[1], "hello", 5) == 5);
+    OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+    OATPP_ASSERT(coroutines[0] == reader);
+
+    /* Received data is read without syscalls */
+    OATPP_ASSERT(connection->read(buffer, 3) == 3);
+    OATPP_ASSERT(std::memcmp(buffer, "hel", 3) == 0);
+    OATPP_ASSERT(connection->read(buffer, sizeof(buffer)) == 2);
+    OATPP_ASSERT(std::memcmp(buffer, "lo", 2) == 0);
+
+    /* Write returns once data is copied. Next write waits for the send to complete */
+    OATPP_ASSERT(connection->write("ping", 4) == 4);
+    OATPP_ASSERT(connection->write("pong", 4) == oatpp::data::IOError::WAIT_RETRY);
+    OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_WRITE, writer));
+    OATPP_ASSERT(poll(poller, coroutines, 1000) == 1);
+    OATPP_ASSERT(coroutines[0] == writer);
+    OATPP_ASSERT(connection->write("pong", 4) == 4);
+
+    OATPP_ASSERT(readExactly(handles[1], buffer, 8, poller) == 8);
+    OATPP_ASSERT(std::memcmp(buffer, "pingpong", 8) == 0);
+
+    /* Unwatched reader is not resumed by completion */
+    OATPP_ASSERT(connection->read(buffer, sizeof(buffer)) == oatpp::data::IOError::WAIT_RETRY);
+    OATPP_ASSERT(poller->watch(handles[0], oatpp::async::Action::IO_EVENT_READ, reader));
+    OATPP_ASSERT(poller->unwatch(handles[0], reader));
+    OATPP_ASSERT(::write(handles[1], "x", 1) == 1);
+    OATPP_ASSERT(poll(poller, coroutines, 100) == 0);
+    OATPP_ASSERT(connection->read(buffer, sizeof(buffer)) == 1);
+
+    /* Connection is closed with receive and send in flight */
+    OATPP_ASSERT(connection->read(buffer, sizeof(buffer)) == oatpp::data::IOError::WAIT_RETRY);
+    OATPP_ASSERT(connection->write("bye", 3) == 3);
+  }
+
+  /* Send completes after close. Handle is closed once both operations complete */
+  OATPP_ASSERT(readExactly(handles[1], buffer, 3, poller) == 3);
+  OATPP_ASSERT(std::memcmp(buffer, "bye", 3) == 0);
+  OATPP_ASSERT(readExactly(handles[1], buffer, 1, poller) == 0);
+
+  oatpp::async::IOEventPoller::setCurrent(previousPoller);
+
+  delete reader;
+  delete writer;
+
+  ::close(handles[1]);
+
+}
+
+#endif
+
+}
+
+void IOEventPollerTest::onRun() {
+
+  v_int32 engines[] = {oatpp::async::IOEventPoller::ENGINE_EPOLL, oatpp::async::IOEventPoller::ENGINE_IO_URING};
+
+  for(v_int32 engine : engines) {
+    oatpp::async::IOEventPoller* poller = oatpp::async::IOEventPoller::createPoller(engine);
+    if(poller == nullptr) {
+      OATPP_LOGD(TAG, "engine %d is not available. Skipping", engine);
+      continue;
+    }
+    OATPP_LOGD(TAG, "engine %d. Reader and writer waiting on the same handle", engine);
+    testReadWriteOnSameHandle(poller);
+#if defined(OATPP_ASYNC_IO_URING)
+    if(engine == oatpp::async::IOEventPoller::ENGINE_IO_URING) {
+      OATPP_LOGD(TAG, "engine %d. Connection reads and writes through the ring", engine);
+      testConnectionThroughRing(poller);
+    }
+#endif
+    delete poller;
+  }
+
+}
+
+}}}
@@ -0,0 +1,187 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "OffloadPoolTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/OffloadPool.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Action Action;
+
+const v_int32 TASKS_COUNT = 8;
+const v_int32 POOL_THREADS = 2;
+const v_int32 POOL_QUEUE_SIZE = 2;
+
+struct Stats {
+  std::atomic<v_int32> finished;
+  std::atomic<v_int64> sum;
+  std::atomic<v_int32> errors;
+  std::atomic<v_int32> ticks;
+
+  Stats()
+    : finished(0)
+    , sum(0)
+    , errors(0)
+    , ticks(0)
+  {}
+
+};
+
+class OffloadCoroutine : public oatpp::async::Coroutine<OffloadCoroutine> {
+private:
+  oatpp::async::OffloadPool* m_pool;
+  Stats* m_stats;
+  v_int64 m_value;
+public:
+
+  OffloadCoroutine(oatpp::async::OffloadPool* pool, Stats* stats, v_int64 value)
+    : m_pool(pool)
+    , m_stats(stats)
+    , m_value(value)
+  {}
+
+  Action act() override {
+    v_int64 value = m_value;
+    return m_pool->offload(this, [value] {
+      /* Blocking call */
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      return value * value;
+    }, &OffloadCoroutine::onResult);
+  }
+
+  Action onResult(v_int64 result) {
+    m_stats->sum += result;
+    m_stats->finished ++;
+    return finish();
+  }
+
+};
+
+class ThrowingCoroutine : public oatpp::async::Coroutine<ThrowingCoroutine> {
+private:
+  oatpp::async::OffloadPool* m_pool;
+  Stats* m_stats;
+public:
+
+  ThrowingCoroutine(oatpp::async::OffloadPool* pool, Stats* stats)
+    : m_pool(pool)
+    , m_stats(stats)
+  {}
+
+  Action act() override {
+    return m_pool->offload(this, [] {
+      throw std::runtime_error("offloaded task error");
+    }, yieldTo(&ThrowingCoroutine::onDone));
+  }
+
+  Action onDone() {
+    m_stats->finished ++;
+    return finish();
+  }
+
+  Action handleError(const oatpp::async::Error& error) override {
+    m_stats->errors ++;
+    m_stats->finished ++;
+    return error;
+  }
+
+};
+
+class TickerCoroutine : public oatpp::async::Coroutine<TickerCoroutine> {
+private:
+  Stats* m_stats;
+  v_int32 m_count;
+public:
+
+  TickerCoroutine(Stats* stats, v_int32 count)
+    : m_stats(stats)
+    , m_count(count)
+  {}
+
+  Action act() override {
+    if(m_stats->finished.load() >= m_count) {
+      return finish();
+    }
+    m_stats->ticks ++;
+    return waitFor(std::chrono::milliseconds(1));
+  }
+
+};
+
+}
+
+void OffloadPoolTest::onRun() {
+
+  oatpp::async::OffloadPool pool("test", POOL_THREADS, POOL_QUEUE_SIZE);
+  Stats stats;
+
+  {
+    /* Single executor thread. Blocking tasks would stall the ticker if run on it */
+    oatpp::async::Executor executor(1);
+
+    executor.execute<TickerCoroutine>(&stats, TASKS_COUNT + 1);
+    for(v_int32 i = 0; i < TASKS_COUNT; i ++) {
+      executor.execute<OffloadCoroutine>(&pool, &stats, i);
+    }
+    executor.execute<ThrowingCoroutine>(&pool, &stats);
+
+    while(stats.finished.load() < TASKS_COUNT + 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    executor.stop();
+    executor.join();
+  }
+
+  v_int64 expectedSum = 0;
+  for(v_int32 i = 0; i < TASKS_COUNT; i ++) {
+    expectedSum += i * i;
+  }
+
+  auto poolStats = pool.getStats();
+
+  OATPP_LOGD(TAG, "ticks=%d, peak queue=%d, queue micros=%lld, execution micros=%lld",
+             stats.ticks.load(), poolStats.peakQueueSize, poolStats.queueMicros, poolStats.executionMicros);
+
+  OATPP_ASSERT(stats.sum.load() == expectedSum);
+  OATPP_ASSERT(stats.errors.load() == 1);
+  OATPP_ASSERT(stats.ticks.load() > TASKS_COUNT);
+
+  OATPP_ASSERT(poolStats.submittedCount == TASKS_COUNT + 1);
+  OATPP_ASSERT(poolStats.completedCount == TASKS_COUNT + 1);
+  /* Admitted tasks are bounded. Tasks may sit in the queue until workers pick them up */
+  OATPP_ASSERT(poolStats.peakQueueSize <= POOL_THREADS + POOL_QUEUE_SIZE);
+  OATPP_ASSERT(poolStats.queueSize == 0);
+  OATPP_ASSERT(poolStats.activeCount == 0);
+
+}
+
+}}}
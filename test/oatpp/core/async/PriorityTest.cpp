@@ -0,0 +1,173 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "PriorityTest.hpp"
+
+#include "oatpp/core/async/Processor.hpp"
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Priority Priority;
+
+class Stats {
+public:
+  v_int64 steps = 0;
+  v_int64 stepsByClass[Priority::CLASSES_COUNT] = {0, 0, 0};
+  v_int64 finishStep[Priority::CLASSES_COUNT] = {0, 0, 0};
+  v_int32 finishedCount[Priority::CLASSES_COUNT] = {0, 0, 0};
+};
+
+/**
+ * Makes `stepsCount` steps in its priority class.
+ */
+class WorkCoroutine : public oatpp::async::Coroutine<WorkCoroutine> {
+private:
+  Stats* m_stats;
+  v_int32 m_priority;
+  v_int32 m_stepsLeft;
+public:
+
+  WorkCoroutine(Stats* stats, v_int32 priority, v_int32 stepsCount)
+    : m_stats(stats)
+    , m_priority(priority)
+    , m_stepsLeft(stepsCount)
+  {}
+
+  Action act() override {
+    setPriority(m_priority);
+    return yieldTo(&WorkCoroutine::step);
+  }
+
+  Action step() {
+    m_stats->steps ++;
+    m_stats->stepsByClass[m_priority] ++;
+    if(-- m_stepsLeft > 0) {
+      return repeat();
+    }
+    m_stats->finishedCount[m_priority] ++;
+    m_stats->finishStep[m_priority] = m_stats->steps;
+    return finish();
+  }
+
+};
+
+/**
+ * Sets priority class from a child coroutine - same as endpoint coroutine started by HttpProcessor.
+ */
+class ChildPriorityCoroutine : public oatpp::async::Coroutine<ChildPriorityCoroutine> {
+public:
+
+  Action act() override {
+    setPriority(Priority::LATENCY);
+    return finish();
+  }
+
+};
+
+class ParentCoroutine : public oatpp::async::Coroutine<ParentCoroutine> {
+private:
+  v_int32* m_priority;
+public:
+
+  ParentCoroutine(v_int32* priority)
+    : m_priority(priority)
+  {}
+
+  Action act() override {
+    return startCoroutine<ChildPriorityCoroutine>(yieldTo(&ParentCoroutine::onChildDone));
+  }
+
+  Action onChildDone() {
+    *m_priority = getPriority();
+    return finish();
+  }
+
+};
+
+}
+
+void PriorityTest::onRun() {
+
+  const v_int32 bulkCount = 20;
+  const v_int32 bulkSteps = 1000;
+  const v_int32 latencyCount = 20;
+  const v_int32 latencySteps = 10;
+
+  {
+    OATPP_LOGD(TAG, "Latency class is served ahead of bulk class");
+
+    Stats stats;
+    oatpp::async::Processor processor(oatpp::async::IOEventPoller::ENGINE_NONE, 1);
+
+    for(v_int32 i = 0; i < bulkCount; i++) {
+      processor.addCoroutine(WorkCoroutine::getBench().obtain(&stats, Priority::BULK, bulkSteps));
+    }
+    for(v_int32 i = 0; i < latencyCount; i++) {
+      processor.addCoroutine(WorkCoroutine::getBench().obtain(&stats, Priority::LATENCY, latencySteps));
+    }
+
+    while(processor.iterate(100)) {}
+
+    OATPP_ASSERT(stats.finishedCount[Priority::BULK] == bulkCount);
+    OATPP_ASSERT(stats.finishedCount[Priority::LATENCY] == latencyCount);
+
+    /* Round-robin would finish latency coroutines after ~ (bulkCount + latencyCount) * latencySteps steps */
+    v_int64 latencyWork = latencyCount * latencySteps;
+    OATPP_LOGD(TAG, "latency class done at step %lld of %lld", stats.finishStep[Priority::LATENCY], stats.steps);
+    OATPP_ASSERT(stats.finishStep[Priority::LATENCY] < latencyWork * 2);
+  }
+
+  {
+    OATPP_LOGD(TAG, "Bulk class is not starved by latency class");
+
+    Stats stats;
+    oatpp::async::Processor processor(oatpp::async::IOEventPoller::ENGINE_NONE, 1);
+
+    processor.addCoroutine(WorkCoroutine::getBench().obtain(&stats, Priority::BULK, 100));
+    for(v_int32 i = 0; i < latencyCount; i++) {
+      processor.addCoroutine(WorkCoroutine::getBench().obtain(&stats, Priority::LATENCY, bulkSteps));
+    }
+
+    while(processor.iterate(100)) {}
+
+    /* Bulk class gets 1 / (8 + 1) of the time while both are runnable */
+    OATPP_LOGD(TAG, "bulk class done at step %lld of %lld", stats.finishStep[Priority::BULK], stats.steps);
+    OATPP_ASSERT(stats.finishStep[Priority::BULK] < 100 * (Priority::getWeight(Priority::LATENCY) + 2));
+  }
+
+  {
+    OATPP_LOGD(TAG, "Child coroutine sets priority class of the chain");
+    v_int32 priority = -1;
+    oatpp::async::Processor processor(oatpp::async::IOEventPoller::ENGINE_NONE);
+    processor.addCoroutine(ParentCoroutine::getBench().obtain(&priority));
+    while(processor.iterate(100)) {}
+    OATPP_ASSERT(priority == Priority::LATENCY);
+  }
+
+}
+
+}}}
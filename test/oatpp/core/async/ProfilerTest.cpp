@@ -0,0 +1,176 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ProfilerTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 COUNT = 20;
+const v_int32 LIGHT_STEPS = 10;
+const v_int32 HEAVY_STEPS = 10;
+
+std::atomic<v_int32> g_done(0);
+
+class LightCoroutine : public oatpp::async::Coroutine<LightCoroutine> {
+private:
+  v_int32 m_steps = 0;
+public:
+
+  Action act() override {
+    return yieldTo(&LightCoroutine::step);
+  }
+
+  Action step() {
+    if(++ m_steps < LIGHT_STEPS) {
+      return repeat();
+    }
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class HeavyCoroutine : public oatpp::async::Coroutine<HeavyCoroutine> {
+private:
+  v_int32 m_steps = 0;
+  volatile v_int64 m_sum = 0;
+public:
+
+  Action act() override {
+    return yieldTo(&HeavyCoroutine::compute);
+  }
+
+  Action compute() {
+    for(v_int32 i = 0; i < 100000; i++) {
+      m_sum = m_sum + i;
+    }
+    if(++ m_steps < HEAVY_STEPS) {
+      return repeat();
+    }
+    g_done ++;
+    return finish();
+  }
+
+};
+
+void runAll(oatpp::async::Executor& executor) {
+  g_done = 0;
+  for(v_int32 i = 0; i < COUNT; i++) {
+    executor.execute<LightCoroutine>();
+    executor.execute<HeavyCoroutine>();
+  }
+  while(g_done < 2 * COUNT) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+const oatpp::async::Profiler::StepStats* find(const std::vector<oatpp::async::Profiler::StepStats>& stats,
+                                              const char* coroutineName, v_int64 count)
+{
+  for(auto& s : stats) {
+    if(s.coroutineName.find(coroutineName) != std::string::npos && s.count == count) {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+}
+
+void ProfilerTest::onRun() {
+
+  typedef oatpp::async::Profiler Profiler;
+
+  oatpp::async::Executor executor(2);
+
+  OATPP_ASSERT(!Profiler::isEnabled());
+
+  /* Nothing is recorded while profiler is off */
+  Profiler::reset();
+  runAll(executor);
+  OATPP_ASSERT(Profiler::getStats().empty());
+
+  Profiler::start();
+  OATPP_ASSERT(Profiler::isEnabled());
+  runAll(executor);
+  Profiler::stop();
+
+  auto stats = Profiler::getStats();
+  OATPP_LOGD(TAG, "\n%s", Profiler::dump().c_str());
+
+  /* act() and the step function of each type */
+  OATPP_ASSERT(stats.size() == 4);
+
+  auto lightAct = find(stats, "LightCoroutine", COUNT);
+  auto lightStep = find(stats, "LightCoroutine", COUNT * LIGHT_STEPS);
+  auto heavyAct = find(stats, "HeavyCoroutine", COUNT);
+  auto heavyStep = find(stats, "HeavyCoroutine", COUNT * HEAVY_STEPS);
+  OATPP_ASSERT(lightAct && lightStep && heavyAct && heavyStep);
+  OATPP_ASSERT(lightAct->stepName != lightStep->stepName);
+  OATPP_ASSERT(heavyAct->stepName != heavyStep->stepName);
+
+  /* Hottest step first */
+  OATPP_ASSERT(&stats[0] == heavyStep);
+  OATPP_ASSERT(heavyStep->totalNanos > lightStep->totalNanos);
+  OATPP_ASSERT(heavyStep->maxNanos > 0);
+  OATPP_ASSERT(heavyStep->maxNanos * HEAVY_STEPS * COUNT >= heavyStep->totalNanos);
+
+  /* Stats are kept when profiler is stopped */
+  runAll(executor);
+  OATPP_ASSERT(Profiler::getStats().size() == 4);
+  OATPP_ASSERT(find(Profiler::getStats(), "HeavyCoroutine", COUNT * HEAVY_STEPS) != nullptr);
+
+  Profiler::reset();
+  OATPP_ASSERT(Profiler::getStats().empty());
+
+  /* Sampling - counts are estimated from every N-th step */
+  const v_int32 interval = 7;
+  Profiler::start(interval);
+  runAll(executor);
+  Profiler::stop();
+
+  v_int64 totalCount = 0;
+  for(auto& s : Profiler::getStats()) {
+    OATPP_ASSERT(s.count % interval == 0);
+    totalCount += s.count;
+  }
+  const v_int64 stepsCount = COUNT * (1 + LIGHT_STEPS) + COUNT * (1 + HEAVY_STEPS);
+  OATPP_LOGD(TAG, "sampled steps estimate=%lld, actual=%lld", totalCount, stepsCount);
+  OATPP_ASSERT(totalCount > stepsCount / 2 && totalCount < stepsCount * 2);
+
+  Profiler::reset();
+
+  executor.stop();
+  executor.join();
+
+}
+
+}}}
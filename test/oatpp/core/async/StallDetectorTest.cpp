@@ -0,0 +1,178 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "StallDetectorTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int64 THRESHOLD_MICROS = 50 * 1000;
+const v_int64 BLOCK_MICROS = 300 * 1000;
+
+std::atomic<v_int32> g_done(0);
+
+class ShortStepsCoroutine : public oatpp::async::Coroutine<ShortStepsCoroutine> {
+private:
+  v_int32 m_steps = 0;
+public:
+
+  Action act() override {
+    if(++ m_steps < 100) {
+      return repeat();
+    }
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class BlockingCoroutine : public oatpp::async::Coroutine<BlockingCoroutine> {
+public:
+
+  Action act() override {
+    return yieldTo(&BlockingCoroutine::block);
+  }
+
+  Action block() {
+    /* Stands for a synchronous call made from a coroutine */
+    std::this_thread::sleep_for(std::chrono::microseconds(BLOCK_MICROS));
+    g_done ++;
+    return finish();
+  }
+
+};
+
+class Stalls {
+private:
+  std::mutex m_mutex;
+  std::vector<oatpp::async::StallDetector::Stall> m_stalls;
+public:
+
+  void add(const oatpp::async::StallDetector::Stall& stall) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stalls.push_back(stall);
+  }
+
+  std::vector<oatpp::async::StallDetector::Stall> get() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stalls;
+  }
+
+};
+
+void waitDone(v_int32 count) {
+  while(g_done < count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+}
+
+void StallDetectorTest::onRun() {
+
+  Stalls stalls;
+
+  oatpp::async::StallDetector::Config config(THRESHOLD_MICROS);
+  config.captureBacktrace = true;
+  auto detector = oatpp::async::StallDetector::createShared(config, [&stalls](const oatpp::async::StallDetector::Stall& stall) {
+    stalls.add(stall);
+  });
+
+  oatpp::async::Executor executor(1);
+  executor.setStallDetector(detector);
+
+  /* Short steps are not reported */
+  for(v_int32 i = 0; i < 100; i ++) {
+    executor.execute<ShortStepsCoroutine>();
+  }
+  waitDone(100);
+  std::this_thread::sleep_for(std::chrono::microseconds(2 * THRESHOLD_MICROS));
+  OATPP_ASSERT(stalls.get().empty());
+  OATPP_ASSERT(executor.getMetrics().total.stallsCount == 0);
+
+  g_done = 0;
+  executor.execute<BlockingCoroutine>();
+  for(v_int32 i = 0; i < 10; i ++) {
+    executor.execute<ShortStepsCoroutine>();
+  }
+  waitDone(11);
+
+  /* Ended stall is reported on the next check after the step returned */
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  while(stalls.get().size() < 2 && oatpp::base::Environment::getMicroTickCount() - tick0 < 1000 * 1000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  auto reported = stalls.get();
+  OATPP_ASSERT(reported.size() == 2);
+
+  auto& detected = reported[0];
+  auto& ended = reported[1];
+
+  OATPP_LOGD(TAG, "detected: %s :: %s, %lld micros, %d frames",
+             detected.coroutineName.c_str(), detected.stepName.c_str(), detected.durationMicros, (v_int32) detected.backtrace.size());
+  for(auto& frame : detected.backtrace) {
+    OATPP_LOGD(TAG, "    %s", frame.c_str());
+  }
+  OATPP_LOGD(TAG, "ended: %lld micros", ended.durationMicros);
+
+  OATPP_ASSERT(!detected.ended);
+  OATPP_ASSERT(detected.coroutineName.find("BlockingCoroutine") != std::string::npos);
+  OATPP_ASSERT(detected.durationMicros >= THRESHOLD_MICROS);
+  OATPP_ASSERT(detected.durationMicros < BLOCK_MICROS);
+#if defined(__GLIBC__)
+  OATPP_ASSERT(!detected.backtrace.empty());
+#endif
+
+  OATPP_ASSERT(ended.ended);
+  OATPP_ASSERT(ended.processorName == detected.processorName);
+  OATPP_ASSERT(ended.coroutineName == detected.coroutineName);
+  OATPP_ASSERT(ended.stepName == detected.stepName);
+  OATPP_ASSERT(ended.durationMicros >= detected.durationMicros);
+  OATPP_ASSERT(ended.durationMicros >= BLOCK_MICROS - 2 * config.checkIntervalMicros);
+
+  auto metrics = executor.getMetrics();
+  OATPP_ASSERT(metrics.total.stallsCount == 1);
+  OATPP_ASSERT(metrics.total.stallMicros.count == 1);
+  OATPP_ASSERT(metrics.total.finishedCount == 111);
+
+  /* Executor without detector is not watched */
+  g_done = 0;
+  executor.setStallDetector(nullptr);
+  executor.execute<BlockingCoroutine>();
+  waitDone(1);
+  OATPP_ASSERT(stalls.get().size() == 2);
+
+  executor.stop();
+  executor.join();
+
+}
+
+}}}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "SubmissionPerfTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+#include <list>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 EXECUTOR_THREADS_COUNT = 2;
+const v_int32 PRODUCERS_COUNT = 4;
+const v_int32 SUBMISSIONS_PER_PRODUCER = 100000;
+
+class Counter {
+public:
+  std::atomic<v_int32> value;
+  Counter() : value(0) {}
+};
+
+/**
+ * Coroutine with shared_ptr parameter - same as connection handling coroutines.
+ */
+class TaskCoroutine : public oatpp::async::Coroutine<TaskCoroutine> {
+private:
+  std::shared_ptr<Counter> m_counter;
+public:
+
+  TaskCoroutine(const std::shared_ptr<Counter>& counter)
+    : m_counter(counter)
+  {}
+
+  Action act() override {
+    m_counter->value.fetch_add(1, std::memory_order_relaxed);
+    return finish();
+  }
+
+};
+
+void produce(oatpp::async::Executor* executor, const std::shared_ptr<Counter>& counter) {
+  for(v_int32 i = 0; i < SUBMISSIONS_PER_PRODUCER; i++) {
+    executor->execute<TaskCoroutine>(counter);
+  }
+}
+
+}
+
+void SubmissionPerfTest::onRun() {
+
+  const v_int32 totalCount = PRODUCERS_COUNT * SUBMISSIONS_PER_PRODUCER;
+
+  auto counter = std::make_shared<Counter>();
+
+  oatpp::async::Executor executor(EXECUTOR_THREADS_COUNT);
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  std::list<std::thread> producers;
+  for(v_int32 i = 0; i < PRODUCERS_COUNT; i++) {
+    producers.push_back(std::thread(produce, &executor, counter));
+  }
+
+  for(auto& thread : producers) {
+    thread.join();
+  }
+
+  v_int64 submitTicks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  while(counter->value.load() < totalCount) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  v_int64 stopTick0 = oatpp::base::Environment::getMicroTickCount();
+  executor.stop();
+  executor.join();
+  v_int64 stopTicks = oatpp::base::Environment::getMicroTickCount() - stopTick0;
+
+  OATPP_ASSERT(counter->value.load() == totalCount);
+
+  OATPP_LOGD(TAG, "%d producers submitted %d coroutines to %d threads in %lld micros. %.1f nanos per submission",
+             PRODUCERS_COUNT, totalCount, EXECUTOR_THREADS_COUNT, submitTicks, (v_float64) submitTicks * 1000 / totalCount);
+  OATPP_LOGD(TAG, "all coroutines done in %lld micros. Executor stopped in %lld micros", ticks, stopTicks);
+
+}
+
+}}}
@@ -0,0 +1,348 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "SynchronizationTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+#include "oatpp/core/async/Semaphore.hpp"
+#include "oatpp/core/async/Mutex.hpp"
+#include "oatpp/core/async/Channel.hpp"
+#include "oatpp/core/async/Event.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+typedef oatpp::async::Action Action;
+
+struct Stats {
+  std::atomic<v_int32> inside;
+  std::atomic<v_int32> maxInside;
+  std::atomic<v_int32> finished;
+  std::atomic<v_int32> calls;
+  std::atomic<v_int64> sum;
+  v_int32 unsafeCounter;
+
+  Stats()
+    : inside(0)
+    , maxInside(0)
+    , finished(0)
+    , calls(0)
+    , sum(0)
+    , unsafeCounter(0)
+  {}
+
+};
+
+void waitFinished(Stats& stats, v_int32 count) {
+  while(stats.finished.load() < count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+class SemaphoreCoroutine : public oatpp::async::Coroutine<SemaphoreCoroutine> {
+private:
+  oatpp::async::Semaphore* m_semaphore;
+  Stats* m_stats;
+  bool m_held;
+public:
+
+  SemaphoreCoroutine(oatpp::async::Semaphore* semaphore, Stats* stats)
+    : m_semaphore(semaphore)
+    , m_stats(stats)
+    , m_held(false)
+  {}
+
+  Action act() override {
+    return m_semaphore->acquire(yieldTo(&SemaphoreCoroutine::onAcquired));
+  }
+
+  Action onAcquired() {
+    v_int32 inside = ++ m_stats->inside;
+    v_int32 maxInside = m_stats->maxInside.load();
+    while(inside > maxInside && !m_stats->maxInside.compare_exchange_weak(maxInside, inside)) {}
+    return yieldTo(&SemaphoreCoroutine::hold);
+  }
+
+  Action hold() {
+    if(!m_held) {
+      m_held = true;
+      return waitFor(std::chrono::microseconds(500));
+    }
+    m_stats->inside --;
+    m_semaphore->release();
+    m_stats->finished ++;
+    return finish();
+  }
+
+};
+
+class MutexCoroutine : public oatpp::async::Coroutine<MutexCoroutine> {
+private:
+  oatpp::async::Mutex* m_mutex;
+  Stats* m_stats;
+  v_int32 m_value;
+  bool m_paused;
+public:
+
+  MutexCoroutine(oatpp::async::Mutex* mutex, Stats* stats)
+    : m_mutex(mutex)
+    , m_stats(stats)
+    , m_value(0)
+    , m_paused(false)
+  {}
+
+  Action act() override {
+    return m_mutex->lock(yieldTo(&MutexCoroutine::onLocked));
+  }
+
+  Action onLocked() {
+    /* Read-modify-write spread over several steps. Lost updates if lock doesn't work */
+    m_value = m_stats->unsafeCounter;
+    return yieldTo(&MutexCoroutine::pause);
+  }
+
+  Action pause() {
+    if(!m_paused) {
+      m_paused = true;
+      return waitFor(std::chrono::microseconds(100));
+    }
+    return yieldTo(&MutexCoroutine::write);
+  }
+
+  Action write() {
+    m_stats->unsafeCounter = m_value + 1;
+    m_mutex->unlock();
+    m_stats->finished ++;
+    return finish();
+  }
+
+};
+
+class ProducerCoroutine : public oatpp::async::Coroutine<ProducerCoroutine> {
+private:
+  oatpp::async::Channel<v_int32>* m_channel;
+  Stats* m_stats;
+  v_int32 m_counter;
+  v_int32 m_count;
+public:
+
+  ProducerCoroutine(oatpp::async::Channel<v_int32>* channel, Stats* stats, v_int32 count)
+    : m_channel(channel)
+    , m_stats(stats)
+    , m_counter(0)
+    , m_count(count)
+  {}
+
+  Action act() override {
+    if(m_counter == m_count) {
+      m_stats->finished ++;
+      return finish();
+    }
+    return m_channel->send(m_counter + 1, yieldTo(&ProducerCoroutine::onSent), error("closed"));
+  }
+
+  Action onSent() {
+    m_counter ++;
+    return yieldTo(&ProducerCoroutine::act);
+  }
+
+};
+
+class ConsumerCoroutine : public oatpp::async::Coroutine<ConsumerCoroutine> {
+private:
+  oatpp::async::Channel<v_int32>* m_channel;
+  Stats* m_stats;
+  v_int32 m_value;
+public:
+
+  ConsumerCoroutine(oatpp::async::Channel<v_int32>* channel, Stats* stats)
+    : m_channel(channel)
+    , m_stats(stats)
+    , m_value(0)
+  {}
+
+  Action act() override {
+    m_stats->calls ++;
+    return m_channel->receive(m_value, yieldTo(&ConsumerCoroutine::onReceived), yieldTo(&ConsumerCoroutine::onClosed));
+  }
+
+  Action onReceived() {
+    m_stats->sum += m_value;
+    return yieldTo(&ConsumerCoroutine::act);
+  }
+
+  Action onClosed() {
+    m_stats->finished ++;
+    return finish();
+  }
+
+};
+
+class EventCoroutine : public oatpp::async::Coroutine<EventCoroutine> {
+private:
+  oatpp::async::Event* m_event;
+  Stats* m_stats;
+public:
+
+  EventCoroutine(oatpp::async::Event* event, Stats* stats)
+    : m_event(event)
+    , m_stats(stats)
+  {}
+
+  Action act() override {
+    m_stats->calls ++;
+    return m_event->wait(yieldTo(&EventCoroutine::onSet));
+  }
+
+  Action onSet() {
+    m_stats->finished ++;
+    return finish();
+  }
+
+};
+
+void testEvent(v_int32 ioEngine) {
+
+  const v_int32 waitersCount = 20;
+
+  oatpp::async::Executor executor(2, ioEngine);
+  oatpp::async::Event event;
+  Stats stats;
+
+  for(v_int32 i = 0; i < waitersCount; i ++) {
+    executor.execute<EventCoroutine>(&event, &stats);
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  /* Waiters are parked - not polled */
+  OATPP_ASSERT(stats.finished.load() == 0);
+  OATPP_ASSERT(stats.calls.load() == waitersCount);
+
+  /* Set from non-executor thread - waiters are resumed on their processors */
+  v_int64 startTick = oatpp::base::Environment::getMicroTickCount();
+  event.set();
+  waitFinished(stats, waitersCount);
+  v_int64 latency = oatpp::base::Environment::getMicroTickCount() - startTick;
+
+  OATPP_LOGD("TEST[async::SynchronizationTest]", "event (engine=%d): %d waiters resumed in %lld micros", ioEngine, waitersCount, latency);
+  OATPP_ASSERT(stats.calls.load() == waitersCount * 2);
+
+  /* Event stays set */
+  executor.execute<EventCoroutine>(&event, &stats);
+  waitFinished(stats, waitersCount + 1);
+
+  executor.stop();
+  executor.join();
+
+}
+
+}
+
+void SynchronizationTest::onRun() {
+
+  {
+    const v_int32 coroutinesCount = 100;
+    const v_int32 permits = 3;
+
+    oatpp::async::Executor executor(2);
+    oatpp::async::Semaphore semaphore(permits);
+    Stats stats;
+
+    for(v_int32 i = 0; i < coroutinesCount; i ++) {
+      executor.execute<SemaphoreCoroutine>(&semaphore, &stats);
+    }
+    waitFinished(stats, coroutinesCount);
+
+    OATPP_LOGD(TAG, "semaphore: max concurrent holders=%d of %d permits", stats.maxInside.load(), permits);
+    OATPP_ASSERT(stats.maxInside.load() <= permits);
+    OATPP_ASSERT(semaphore.getPermits() == permits);
+
+    executor.stop();
+    executor.join();
+  }
+
+  {
+    const v_int32 coroutinesCount = 100;
+
+    oatpp::async::Executor executor(2);
+    oatpp::async::Mutex mutex;
+    Stats stats;
+
+    for(v_int32 i = 0; i < coroutinesCount; i ++) {
+      executor.execute<MutexCoroutine>(&mutex, &stats);
+    }
+    waitFinished(stats, coroutinesCount);
+
+    OATPP_LOGD(TAG, "mutex: counter=%d", stats.unsafeCounter);
+    OATPP_ASSERT(stats.unsafeCounter == coroutinesCount);
+    OATPP_ASSERT(!mutex.isLocked());
+
+    executor.stop();
+    executor.join();
+  }
+
+  {
+    const v_int32 producersCount = 4;
+    const v_int32 consumersCount = 3;
+    const v_int32 valuesCount = 1000;
+
+    oatpp::async::Executor executor(2);
+    oatpp::async::Channel<v_int32> channel(4);
+    Stats producerStats;
+    Stats consumerStats;
+
+    for(v_int32 i = 0; i < consumersCount; i ++) {
+      executor.execute<ConsumerCoroutine>(&channel, &consumerStats);
+    }
+    for(v_int32 i = 0; i < producersCount; i ++) {
+      executor.execute<ProducerCoroutine>(&channel, &producerStats, valuesCount);
+    }
+
+    waitFinished(producerStats, producersCount);
+    channel.close();
+    waitFinished(consumerStats, consumersCount);
+
+    v_int64 expectedSum = (v_int64) producersCount * valuesCount * (valuesCount + 1) / 2;
+    OATPP_LOGD(TAG, "channel: sum=%lld, expected=%lld, receive calls=%d", consumerStats.sum.load(), expectedSum, consumerStats.calls.load());
+    OATPP_ASSERT(consumerStats.sum.load() == expectedSum);
+
+    v_int32 value;
+    OATPP_ASSERT(channel.tryReceive(value) == oatpp::async::Channel<v_int32>::RESULT_CLOSED);
+    OATPP_ASSERT(channel.trySend(1) == oatpp::async::Channel<v_int32>::RESULT_CLOSED);
+
+    executor.stop();
+    executor.join();
+  }
+
+  testEvent(oatpp::async::IOEventPoller::ENGINE_AUTO);
+  testEvent(oatpp::async::IOEventPoller::ENGINE_NONE);
+
+}
+
+}}}
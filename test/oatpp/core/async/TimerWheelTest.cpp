@@ -0,0 +1,170 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "TimerWheelTest.hpp"
+
+#include "oatpp/core/async/TimerWheel.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+#include <random>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+class TimerCoroutine : public oatpp::async::Coroutine<TimerCoroutine> {
+public:
+  v_int64 timePoint;
+public:
+
+  TimerCoroutine(v_int64 pTimePoint)
+    : timePoint(pTimePoint)
+  {}
+
+  Action act() override {
+    return finish();
+  }
+
+};
+
+class SleepCoroutine : public oatpp::async::Coroutine<SleepCoroutine> {
+private:
+  std::atomic<v_int64>* m_minSleepMicros;
+  std::atomic<v_int32>* m_counter;
+  v_int32 m_sleepsLeft;
+  v_int64 m_lastTick;
+public:
+
+  SleepCoroutine(std::atomic<v_int64>* minSleepMicros, std::atomic<v_int32>* counter)
+    : m_minSleepMicros(minSleepMicros)
+    , m_counter(counter)
+    , m_sleepsLeft(3)
+    , m_lastTick(0)
+  {}
+
+  Action act() override {
+    v_int64 tick = oatpp::base::Environment::getMicroTickCount();
+    if(m_lastTick > 0 && tick - m_lastTick < *m_minSleepMicros) {
+      *m_minSleepMicros = tick - m_lastTick;
+    }
+    m_lastTick = tick;
+    if(m_sleepsLeft -- > 0) {
+      return waitFor(std::chrono::milliseconds(50));
+    }
+    (*m_counter) ++;
+    return finish();
+  }
+
+};
+
+void testWheel(const char* TAG) {
+
+  const v_int64 startMicros = 1000 * 1000;
+  const v_int64 maxDelayMicros = oatpp::async::TimerWheel::TICK_MICROS * oatpp::async::TimerWheel::MAX_TICKS * 2;
+
+  oatpp::async::TimerWheel wheel(startMicros);
+
+  std::mt19937_64 random(0);
+  v_int32 timersCount = 0;
+
+  /* Near timers, timers cascading from every level and timers farther than the wheel range */
+  for(v_int32 i = 0; i < 2000; i++) {
+    v_int64 delay = (v_int64) (random() % (1 << (6 * (i % 5) + 6)));
+    if(i % 100 == 0) {
+      delay = maxDelayMicros - i;
+    }
+    wheel.add(TimerCoroutine::getBench().obtain(startMicros + delay), startMicros + delay);
+    timersCount ++;
+  }
+
+  OATPP_ASSERT(wheel.getCount() == timersCount);
+
+  v_int64 now = startMicros;
+  v_int64 prevNow = startMicros;
+  v_int32 expiredCount = 0;
+
+  while(wheel.getCount() > 0) {
+
+    v_int64 timeout = wheel.getNextTimeoutMicros(now);
+    OATPP_ASSERT(timeout >= 0);
+    now += timeout > 0 ? timeout : oatpp::async::TimerWheel::TICK_MICROS;
+
+    oatpp::collection::FastQueue<oatpp::async::AbstractCoroutine> queue;
+    expiredCount += wheel.expire(now, queue);
+
+    while(queue.first != nullptr) {
+      auto coroutine = static_cast<TimerCoroutine*>(queue.popFront());
+      /* Not earlier than requested and not later than one tick after */
+      OATPP_ASSERT(coroutine->timePoint <= now);
+      OATPP_ASSERT(coroutine->timePoint > prevNow - oatpp::async::TimerWheel::TICK_MICROS);
+      coroutine->free();
+    }
+
+    prevNow = now;
+
+  }
+
+  OATPP_ASSERT(expiredCount == timersCount);
+  OATPP_LOGD(TAG, "wheel: %d timers expired in order", expiredCount);
+
+}
+
+}
+
+void TimerWheelTest::onRun() {
+
+  testWheel(TAG);
+
+  const v_int32 coroutinesCount = 100;
+
+  std::atomic<v_int64> minSleepMicros(1000 * 1000);
+  std::atomic<v_int32> counter(0);
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  {
+    oatpp::async::Executor executor(1);
+    for(v_int32 i = 0; i < coroutinesCount; i++) {
+      executor.execute<SleepCoroutine>(&minSleepMicros, &counter);
+    }
+
+    while(counter < coroutinesCount && oatpp::base::Environment::getMicroTickCount() - tick0 < 5 * 1000 * 1000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    executor.stop();
+    executor.join();
+  }
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+  OATPP_LOGD(TAG, "executor: %d coroutines slept 3 x 50ms in %lld micros. Min sleep=%lld micros",
+             counter.load(), ticks, minSleepMicros.load());
+
+  OATPP_ASSERT(counter == coroutinesCount);
+  OATPP_ASSERT(minSleepMicros >= 50 * 1000);
+
+}
+
+}}}
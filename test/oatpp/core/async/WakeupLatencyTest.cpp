@@ -0,0 +1,177 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "WakeupLatencyTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <thread>
+#include <algorithm>
+#include <vector>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 SAMPLES_COUNT = 100;
+const v_int64 MAX_MEDIAN_LATENCY_MICROS = 2000;
+
+struct Probe {
+  std::atomic<v_int64> startTick;
+  std::atomic<v_int64> latency;
+
+  Probe()
+    : startTick(0)
+    , latency(-1)
+  {}
+
+  void start() {
+    latency = -1;
+    startTick = oatpp::base::Environment::getMicroTickCount();
+  }
+
+  void done() {
+    latency = oatpp::base::Environment::getMicroTickCount() - startTick;
+  }
+
+  v_int64 waitDone() {
+    while(latency.load() < 0) {
+      std::this_thread::yield();
+    }
+    return latency.load();
+  }
+};
+
+/**
+ * Reads bytes from socket. Marks probe done on each byte. Exits on 'q'.
+ */
+class ReaderCoroutine : public oatpp::async::Coroutine<ReaderCoroutine> {
+private:
+  oatpp::data::v_io_handle m_handle;
+  Probe* m_probe;
+public:
+
+  ReaderCoroutine(oatpp::data::v_io_handle handle, Probe* probe)
+    : m_handle(handle)
+    , m_probe(probe)
+  {}
+
+  Action act() override {
+    v_char8 byte;
+    auto res = ::read(m_handle, &byte, 1);
+    if(res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return waitForIO(m_handle, Action::IO_EVENT_READ);
+    }
+    if(res <= 0 || byte == 'q') {
+      return finish();
+    }
+    m_probe->done();
+    return repeat();
+  }
+
+};
+
+class ProbeCoroutine : public oatpp::async::Coroutine<ProbeCoroutine> {
+private:
+  Probe* m_probe;
+public:
+
+  ProbeCoroutine(Probe* probe)
+    : m_probe(probe)
+  {}
+
+  Action act() override {
+    m_probe->done();
+    return finish();
+  }
+
+};
+
+v_int64 getMedian(std::vector<v_int64>& samples) {
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+}
+
+void WakeupLatencyTest::onRun() {
+
+  oatpp::data::v_io_handle handles[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+  fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+  oatpp::async::Executor executor(1);
+
+  Probe ioProbe;
+  Probe submissionProbe;
+
+  /* Keep processor busy with nothing but I/O wait */
+  executor.execute<ReaderCoroutine>(handles[0], &ioProbe);
+
+  std::vector<v_int64> submissionLatencies;
+  std::vector<v_int64> ioLatencies;
+
+  for(v_int32 i = 0; i < SAMPLES_COUNT; i++) {
+
+    /* Let processor go to sleep */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    submissionProbe.start();
+    executor.execute<ProbeCoroutine>(&submissionProbe);
+    submissionLatencies.push_back(submissionProbe.waitDone());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ioProbe.start();
+    v_char8 byte = 'x';
+    OATPP_ASSERT(::write(handles[1], &byte, 1) == 1);
+    ioLatencies.push_back(ioProbe.waitDone());
+
+  }
+
+  v_char8 byte = 'q';
+  OATPP_ASSERT(::write(handles[1], &byte, 1) == 1);
+
+  executor.stop();
+  executor.join();
+
+  ::close(handles[0]);
+  ::close(handles[1]);
+
+  v_int64 submissionMedian = getMedian(submissionLatencies);
+  v_int64 ioMedian = getMedian(ioLatencies);
+
+  OATPP_LOGD(TAG, "submission to sleeping processor: median=%lld, max=%lld micros", submissionMedian, submissionLatencies.back());
+  OATPP_LOGD(TAG, "I/O readiness to sleeping processor: median=%lld, max=%lld micros", ioMedian, ioLatencies.back());
+
+  OATPP_ASSERT(submissionMedian < MAX_MEDIAN_LATENCY_MICROS);
+  OATPP_ASSERT(ioMedian < MAX_MEDIAN_LATENCY_MICROS);
+
+}
+
+}}}
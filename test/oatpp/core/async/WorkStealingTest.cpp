@@ -0,0 +1,137 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "WorkStealingTest.hpp"
+
+#include "oatpp/core/async/Executor.hpp"
+
+#include <thread>
+
+namespace oatpp { namespace test { namespace async {
+
+namespace {
+
+const v_int32 THREADS_COUNT = 4;
+const v_int32 HEAVY_COUNT = 64;
+const v_int32 HEAVY_STEPS = 2000;
+
+/**
+ * CPU-bound coroutine yielding after each step of work.
+ */
+class HeavyCoroutine : public oatpp::async::Coroutine<HeavyCoroutine> {
+private:
+  std::atomic<v_int32>* m_counter;
+  v_int32 m_steps;
+  volatile v_int64 m_sum;
+public:
+
+  HeavyCoroutine(std::atomic<v_int32>* counter)
+    : m_counter(counter)
+    , m_steps(0)
+    , m_sum(0)
+  {}
+
+  Action act() override {
+    for(v_int32 i = 0; i < 1000; i++) {
+      m_sum = m_sum + i * m_steps;
+    }
+    if(++ m_steps < HEAVY_STEPS) {
+      return repeat();
+    }
+    (*m_counter) ++;
+    return finish();
+  }
+
+};
+
+class LightCoroutine : public oatpp::async::Coroutine<LightCoroutine> {
+private:
+  std::atomic<v_int32>* m_counter;
+public:
+
+  LightCoroutine(std::atomic<v_int32>* counter)
+    : m_counter(counter)
+  {}
+
+  Action act() override {
+    (*m_counter) ++;
+    return finish();
+  }
+
+};
+
+v_int64 runSkewed(const char* TAG, v_int32 threadsCount) {
+
+  std::atomic<v_int32> heavyCounter(0);
+  std::atomic<v_int32> lightCounter(0);
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  oatpp::async::Executor executor(threadsCount);
+
+  /* Round-robin puts all heavy coroutines to the first thread */
+  for(v_int32 i = 0; i < HEAVY_COUNT; i++) {
+    executor.execute<HeavyCoroutine>(&heavyCounter);
+    for(v_int32 n = 1; n < threadsCount; n++) {
+      executor.execute<LightCoroutine>(&lightCounter);
+    }
+  }
+
+  while(heavyCounter < HEAVY_COUNT) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  v_int64 stolenCount = 0;
+  for(v_int32 i = 0; i < executor.getThreadsCount(); i++) {
+    auto load = executor.getProcessorLoad(i);
+    OATPP_LOGD(TAG, "threads=%d, thread[%d]: tasks=%d, shared=%d, stolen=%lld",
+               threadsCount, i, load.tasksCount, load.sharedCount, load.stolenCount);
+    stolenCount += load.stolenCount;
+  }
+
+  executor.stop();
+  executor.join();
+
+  OATPP_ASSERT(lightCounter == HEAVY_COUNT * (threadsCount - 1));
+  OATPP_LOGD(TAG, "threads=%d: %d heavy coroutines done in %lld micros. Stolen=%lld", threadsCount, HEAVY_COUNT, ticks, stolenCount);
+
+  if(threadsCount > 1) {
+    OATPP_ASSERT(stolenCount > 0);
+  }
+
+  return ticks;
+
+}
+
+}
+
+void WorkStealingTest::onRun() {
+  v_int64 singleThreadTicks = runSkewed(TAG, 1);
+  v_int64 multiThreadTicks = runSkewed(TAG, THREADS_COUNT);
+  OATPP_LOGD(TAG, "speedup on %d threads: %.2f", THREADS_COUNT, (v_float64) singleThreadTicks / multiThreadTicks);
+}
+
+}}}
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "PlacementPolicyTest.hpp"
+
+#include "oatpp/core/concurrency/PlacementPolicy.hpp"
+#include "oatpp/core/concurrency/Thread.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace oatpp { namespace test { namespace concurrency {
+
+namespace {
+
+typedef oatpp::concurrency::PlacementPolicy PlacementPolicy;
+typedef oatpp::concurrency::Topology Topology;
+
+class CounterCoroutine : public oatpp::async::Coroutine<CounterCoroutine> {
+private:
+  std::atomic<v_int32>* m_counter;
+public:
+
+  CounterCoroutine(std::atomic<v_int32>* counter)
+    : m_counter(counter)
+  {}
+
+  Action act() override {
+    (*m_counter) ++;
+    return finish();
+  }
+
+};
+
+bool contains(const std::vector<v_int32>& cpus, v_int32 cpu) {
+  return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+}
+
+void testTopology() {
+
+  Topology topology({{4, 5, 6, 7}, {}, {3, 2, 1, 0}});
+
+  OATPP_ASSERT(topology.getNodesCount() == 2);
+  OATPP_ASSERT(topology.getCpusCount() == 8);
+  OATPP_ASSERT(topology.getNodeCpus(1) == std::vector<v_int32>({0, 1, 2, 3}));
+  OATPP_ASSERT(topology.getNodeOfCpu(5) == 0);
+  OATPP_ASSERT(topology.getNodeOfCpu(2) == 1);
+  OATPP_ASSERT(topology.getNodeOfCpu(100) == 0);
+
+  const Topology& machine = Topology::getInstance();
+  OATPP_ASSERT(machine.getNodesCount() > 0);
+  OATPP_ASSERT(machine.getCpusCount() > 0);
+
+}
+
+void testPlacement() {
+
+  Topology topology({{0, 1, 2, 3}, {4, 5, 6, 7}});
+
+  PlacementPolicy core(PlacementPolicy::PIN_CORE, 3, topology);
+  OATPP_ASSERT(core.getWorkerCpus() == std::vector<v_int32>({0, 1, 2, 3, 4}));
+  OATPP_ASSERT(core.getReservedCpus() == std::vector<v_int32>({5, 6, 7}));
+  OATPP_ASSERT(core.getWorkerCpus(0) == std::vector<v_int32>({0}));
+  OATPP_ASSERT(core.getWorkerCpus(4) == std::vector<v_int32>({4}));
+  OATPP_ASSERT(core.getWorkerCpus(5) == std::vector<v_int32>({0}));
+
+  PlacementPolicy node(PlacementPolicy::PIN_NODE, 3, topology);
+  OATPP_ASSERT(node.getWorkerCpus(0) == std::vector<v_int32>({0, 1, 2, 3}));
+  OATPP_ASSERT(node.getWorkerCpus(1) == std::vector<v_int32>({4}));
+  OATPP_ASSERT(node.getWorkerCpus(2) == std::vector<v_int32>({0, 1, 2, 3}));
+
+  PlacementPolicy none(PlacementPolicy::PIN_NONE, 0, topology);
+  OATPP_ASSERT(none.getWorkerCpus(3) == std::vector<v_int32>({0, 1, 2, 3, 4, 5, 6, 7}));
+  OATPP_ASSERT(none.getReservedCpus().empty());
+
+  /* At least one CPU is left to workers */
+  PlacementPolicy all(PlacementPolicy::PIN_NONE, 100, topology);
+  OATPP_ASSERT(all.getWorkerCpus() == std::vector<v_int32>({0}));
+  OATPP_ASSERT(all.getReservedCpus().size() == 7);
+
+}
+
+void testPinning(const char* TAG) {
+
+  auto policy = PlacementPolicy::createShared(PlacementPolicy::PIN_CORE, 0);
+  const Topology& topology = Topology::getInstance();
+  OATPP_LOGD(TAG, "nodes=%d, cpus=%d", topology.getNodesCount(), topology.getCpusCount());
+
+  for(v_int32 i = 0; i < 2; i++) {
+    v_int32 cpu = -1;
+    std::thread thread([&policy, &cpu, i] {
+      OATPP_ASSERT(policy->placeWorker(oatpp::concurrency::Thread::getCurrentNativeHandle(), i) == 0);
+      /* Acceptor is not pinned - no CPU is reserved */
+      OATPP_ASSERT(policy->placeAcceptor(oatpp::concurrency::Thread::getCurrentNativeHandle()) == 0);
+      cpu = Topology::getCurrentCpu();
+    });
+    thread.join();
+    OATPP_ASSERT(cpu < 0 || contains(policy->getWorkerCpus(i), cpu));
+  }
+
+  std::atomic<v_int32> counter(0);
+  oatpp::async::Executor executor(2, oatpp::async::IOEventPoller::ENGINE_AUTO, oatpp::async::Processor::BURST_SIZE_DEFAULT,
+                                  PlacementPolicy::createShared(PlacementPolicy::PIN_NODE, 1));
+  for(v_int32 i = 0; i < 100; i++) {
+    executor.execute<CounterCoroutine>(&counter);
+  }
+  while(counter < 100) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  executor.stop();
+  executor.join();
+
+}
+
+}
+
+void PlacementPolicyTest::onRun() {
+  testTopology();
+  testPlacement();
+  testPinning(TAG);
+}
+
+}}}
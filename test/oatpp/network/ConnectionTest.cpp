@@ -0,0 +1,126 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+#include "ConnectionTest.hpp"
+
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <thread>
+#include <chrono>
+
+namespace oatpp { namespace test { namespace network {
+
+namespace {
+
+const v_int32 CHUNKS_COUNT = 10;
+const v_int32 CHUNK_SIZE = 10;
+
+class ReadCoroutine : public oatpp::async::Coroutine<ReadCoroutine> {
+private:
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+  std::atomic<v_int32>* m_readCalls;
+  std::atomic<bool>* m_done;
+  v_char8 m_buffer[CHUNKS_COUNT * CHUNK_SIZE];
+  void* m_bufferPtr;
+  oatpp::data::v_io_size m_bytesLeft;
+public:
+
+  ReadCoroutine(const std::shared_ptr<oatpp::network::Connection>& connection,
+                std::atomic<v_int32>* readCalls,
+                std::atomic<bool>* done)
+    : m_connection(connection)
+    , m_readCalls(readCalls)
+    , m_done(done)
+    , m_bufferPtr(m_buffer)
+    , m_bytesLeft(CHUNKS_COUNT * CHUNK_SIZE)
+  {}
+
+  Action act() override {
+    (*m_readCalls) ++;
+    return oatpp::data::stream::readExactSizeDataAsyncInline(m_connection.get(),
+                                                             m_bufferPtr,
+                                                             m_bytesLeft,
+                                                             yieldTo(&ReadCoroutine::onRead));
+  }
+
+  Action onRead() {
+    for(v_int32 i = 0; i < CHUNKS_COUNT * CHUNK_SIZE; i++) {
+      OATPP_ASSERT(m_buffer[i] == 'a' + i / CHUNK_SIZE);
+    }
+    *m_done = true;
+    return finish();
+  }
+
+};
+
+}
+
+void ConnectionTest::onRun() {
+
+  oatpp::data::v_io_handle handles[2];
+  OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+  fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+  std::atomic<v_int32> readCalls(0);
+  std::atomic<bool> done(false);
+
+  {
+    oatpp::async::Executor executor(1);
+    executor.execute<ReadCoroutine>(oatpp::network::Connection::createShared(handles[0]), &readCalls, &done);
+
+    for(v_int32 i = 0; i < CHUNKS_COUNT; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      v_char8 chunk[CHUNK_SIZE];
+      std::memset(chunk, 'a' + i, CHUNK_SIZE);
+      OATPP_ASSERT(::write(handles[1], chunk, CHUNK_SIZE) == CHUNK_SIZE);
+    }
+
+    v_int32 waitMillis = 0;
+    while(!done && waitMillis < 5000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      waitMillis += 10;
+    }
+
+    executor.stop();
+    executor.join();
+  }
+
+  ::close(handles[1]);
+
+  OATPP_LOGD(TAG, "read calls=%d", readCalls.load());
+  OATPP_ASSERT(done);
+
+#if defined(__linux__)
+  /* Coroutine should be resumed only when data arrives - not polled in between */
+  OATPP_ASSERT(readCalls <= CHUNKS_COUNT * 4);
+#endif
+
+}
+
+}}}
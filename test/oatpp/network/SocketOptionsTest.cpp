@@ -0,0 +1,157 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "SocketOptionsTest.hpp"
+
+#include "oatpp/network/SocketOptions.hpp"
+#include "oatpp/network/server/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/Connection.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+namespace oatpp { namespace test { namespace network {
+
+namespace {
+
+const v_int32 BUFFER_SIZE = 128 * 1024;
+
+int getOption(oatpp::data::v_io_handle handle, int level, int name) {
+  int value = 0;
+  socklen_t length = sizeof(int);
+  OATPP_ASSERT(getsockopt(handle, level, name, &value, &length) == 0);
+  return value;
+}
+
+oatpp::data::v_io_handle getHandle(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+  return std::static_pointer_cast<oatpp::network::Connection>(connection)->getHandle();
+}
+
+void checkConnectionOptions(oatpp::data::v_io_handle handle) {
+  OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_NODELAY) != 0);
+  OATPP_ASSERT(getOption(handle, SOL_SOCKET, SO_KEEPALIVE) != 0);
+#if defined(__linux__)
+  OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_KEEPIDLE) == 30);
+  OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_KEEPINTVL) == 5);
+  OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_KEEPCNT) == 3);
+#endif
+}
+
+}
+
+void SocketOptionsTest::onRun() {
+
+  { // defaults keep the system defaults
+    oatpp::network::SocketOptions options;
+    OATPP_ASSERT(options.listenBacklog == 10000);
+    OATPP_ASSERT(options.reuseAddress);
+    OATPP_ASSERT(!options.reusePort);
+    OATPP_ASSERT(!options.tcpNoDelay);
+    OATPP_ASSERT(!options.keepAlive);
+    OATPP_ASSERT(options.receiveBufferSize == 0 && options.sendBufferSize == 0);
+    OATPP_ASSERT(options.deferAcceptSeconds == 0 && options.fastOpenQueueLength == 0);
+    OATPP_ASSERT(!options.quickAck && !options.fastOpenConnect);
+  }
+
+  oatpp::network::SocketOptions options;
+  options.tcpNoDelay = true;
+  options.receiveBufferSize = BUFFER_SIZE;
+  options.sendBufferSize = BUFFER_SIZE;
+  options.keepAlive = true;
+  options.keepAliveIdleSeconds = 30;
+  options.keepAliveIntervalSeconds = 5;
+  options.keepAliveProbesCount = 3;
+  options.quickAck = true;
+  options.deferAcceptSeconds = 5;
+  options.fastOpenQueueLength = 16;
+  options.fastOpenConnect = true;
+
+  { // listening socket
+    oatpp::data::v_io_handle handle = socket(AF_INET6, SOCK_STREAM, 0);
+    OATPP_ASSERT(handle >= 0);
+    options.applyToServerSocket(handle);
+    OATPP_ASSERT(getOption(handle, SOL_SOCKET, SO_REUSEADDR) != 0);
+    OATPP_ASSERT(getOption(handle, SOL_SOCKET, SO_RCVBUF) >= BUFFER_SIZE);
+    OATPP_ASSERT(getOption(handle, SOL_SOCKET, SO_SNDBUF) >= BUFFER_SIZE);
+    checkConnectionOptions(handle);
+#if defined(__linux__)
+    OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_DEFER_ACCEPT) > 0);
+    OATPP_ASSERT(getOption(handle, IPPROTO_TCP, TCP_FASTOPEN) == 16);
+#endif
+    ::close(handle);
+  }
+
+  { // accepted and client connections
+
+    auto serverProvider = oatpp::network::server::SimpleTCPConnectionProvider::createShared(0, options);
+    auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", serverProvider->getPort(), options);
+
+    auto clientConnection = clientProvider->getConnection();
+    OATPP_ASSERT(clientConnection);
+    /* With TCP_DEFER_ACCEPT the connection is accepted once data arrives */
+    OATPP_ASSERT(clientConnection->write("a", 1) == 1);
+
+    auto serverConnection = serverProvider->getConnection();
+    OATPP_ASSERT(serverConnection);
+
+    oatpp::data::v_io_handle accepted = getHandle(serverConnection);
+    checkConnectionOptions(accepted);
+    OATPP_ASSERT(getOption(accepted, SOL_SOCKET, SO_RCVBUF) >= BUFFER_SIZE);
+    OATPP_ASSERT(getOption(accepted, SOL_SOCKET, SO_SNDBUF) >= BUFFER_SIZE);
+
+    oatpp::data::v_io_handle client = getHandle(clientConnection);
+    checkConnectionOptions(client);
+    OATPP_ASSERT(getOption(client, SOL_SOCKET, SO_RCVBUF) >= BUFFER_SIZE);
+#if defined(__linux__) && defined(TCP_FASTOPEN_CONNECT)
+    OATPP_ASSERT(getOption(client, IPPROTO_TCP, TCP_FASTOPEN_CONNECT) != 0);
+#endif
+
+    v_char8 buffer[1];
+    OATPP_ASSERT(oatpp::data::stream::readExactSizeData(serverConnection.get(), buffer, 1) == 1);
+    OATPP_ASSERT(buffer[0] == 'a');
+
+    serverProvider->close();
+
+  }
+
+  { // no options set by default
+    auto serverProvider = oatpp::network::server::SimpleTCPConnectionProvider::createShared(0);
+    auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", serverProvider->getPort());
+    auto clientConnection = clientProvider->getConnection();
+    OATPP_ASSERT(clientConnection);
+    auto serverConnection = serverProvider->getConnection();
+    OATPP_ASSERT(serverConnection);
+    OATPP_ASSERT(getOption(getHandle(serverConnection), IPPROTO_TCP, TCP_NODELAY) == 0);
+    OATPP_ASSERT(getOption(getHandle(clientConnection), IPPROTO_TCP, TCP_NODELAY) == 0);
+    OATPP_ASSERT(getOption(getHandle(clientConnection), SOL_SOCKET, SO_KEEPALIVE) == 0);
+    serverProvider->close();
+  }
+
+}
+
+}}}
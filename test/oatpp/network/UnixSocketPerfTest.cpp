@@ -0,0 +1,165 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "UnixSocketPerfTest.hpp"
+
+#include "oatpp/network/server/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/server/SimpleUnixConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleUnixConnectionProvider.hpp"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <thread>
+
+namespace oatpp { namespace test { namespace network {
+
+namespace {
+
+const v_int32 CONNECTIONS_COUNT = 1000;
+const v_int32 ROUND_TRIPS_COUNT = 10000;
+const v_int32 MESSAGE_SIZE = 64;
+const v_int32 CHUNK_SIZE = 64 * 1024;
+const v_int32 CHUNKS_COUNT = 1024;
+
+struct Result {
+  v_int64 connectMicros;
+  v_int64 roundTripsMicros;
+  v_int64 transferMicros;
+};
+
+v_int64 measureConnect(const std::shared_ptr<oatpp::network::ServerConnectionProvider>& serverProvider,
+                       const std::shared_ptr<oatpp::network::ClientConnectionProvider>& clientProvider)
+{
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT; i ++) {
+    auto clientConnection = clientProvider->getConnection();
+    OATPP_ASSERT(clientConnection);
+    auto serverConnection = serverProvider->getConnection();
+    OATPP_ASSERT(serverConnection);
+  }
+  return oatpp::base::Environment::getMicroTickCount() - tick0;
+}
+
+v_int64 measureRoundTrips(const std::shared_ptr<oatpp::network::ServerConnectionProvider>& serverProvider,
+                          const std::shared_ptr<oatpp::network::ClientConnectionProvider>& clientProvider)
+{
+  auto clientConnection = clientProvider->getConnection();
+  OATPP_ASSERT(clientConnection);
+  auto serverConnection = serverProvider->getConnection();
+  OATPP_ASSERT(serverConnection);
+
+  std::thread echoThread([&serverConnection] {
+    v_char8 buffer[MESSAGE_SIZE];
+    for(v_int32 i = 0; i < ROUND_TRIPS_COUNT; i ++) {
+      OATPP_ASSERT(oatpp::data::stream::readExactSizeData(serverConnection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+      OATPP_ASSERT(oatpp::data::stream::writeExactSizeData(serverConnection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+    }
+  });
+
+  v_char8 buffer[MESSAGE_SIZE] = {};
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+  for(v_int32 i = 0; i < ROUND_TRIPS_COUNT; i ++) {
+    OATPP_ASSERT(oatpp::data::stream::writeExactSizeData(clientConnection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+    OATPP_ASSERT(oatpp::data::stream::readExactSizeData(clientConnection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+  }
+  v_int64 ticks = oatpp::base::Environment::getMicroTickCount() - tick0;
+
+  echoThread.join();
+  return ticks;
+}
+
+v_int64 measureTransfer(const std::shared_ptr<oatpp::network::ServerConnectionProvider>& serverProvider,
+                        const std::shared_ptr<oatpp::network::ClientConnectionProvider>& clientProvider)
+{
+  auto clientConnection = clientProvider->getConnection();
+  OATPP_ASSERT(clientConnection);
+  auto serverConnection = serverProvider->getConnection();
+  OATPP_ASSERT(serverConnection);
+
+  v_int64 tick0 = oatpp::base::Environment::getMicroTickCount();
+
+  std::thread readerThread([&serverConnection] {
+    std::unique_ptr<v_char8[]> buffer(new v_char8[CHUNK_SIZE]);
+    for(v_int32 i = 0; i < CHUNKS_COUNT; i ++) {
+      OATPP_ASSERT(oatpp::data::stream::readExactSizeData(serverConnection.get(), buffer.get(), CHUNK_SIZE) == CHUNK_SIZE);
+    }
+  });
+
+  std::unique_ptr<v_char8[]> buffer(new v_char8[CHUNK_SIZE]());
+  for(v_int32 i = 0; i < CHUNKS_COUNT; i ++) {
+    OATPP_ASSERT(oatpp::data::stream::writeExactSizeData(clientConnection.get(), buffer.get(), CHUNK_SIZE) == CHUNK_SIZE);
+  }
+
+  readerThread.join();
+  return oatpp::base::Environment::getMicroTickCount() - tick0;
+}
+
+Result measureTransport(const char* TAG,
+                        const char* name,
+                        const std::shared_ptr<oatpp::network::ServerConnectionProvider>& serverProvider,
+                        const std::shared_ptr<oatpp::network::ClientConnectionProvider>& clientProvider)
+{
+  Result result;
+  result.connectMicros = measureConnect(serverProvider, clientProvider);
+  result.roundTripsMicros = measureRoundTrips(serverProvider, clientProvider);
+  result.transferMicros = measureTransfer(serverProvider, clientProvider);
+  serverProvider->close();
+
+  v_float64 megabytes = (v_float64) CHUNK_SIZE * CHUNKS_COUNT / (1024 * 1024);
+  OATPP_LOGD(TAG, "%s: %d connects in %lld micros, %d round trips of %d bytes in %lld micros, %.0fMB in %lld micros (%.0fMB/s)",
+             name,
+             CONNECTIONS_COUNT, result.connectMicros,
+             ROUND_TRIPS_COUNT, MESSAGE_SIZE, result.roundTripsMicros,
+             megabytes, result.transferMicros, megabytes * 1000000 / (result.transferMicros > 0 ? result.transferMicros : 1));
+
+  return result;
+}
+
+}
+
+void UnixSocketPerfTest::onRun() {
+
+  oatpp::network::SocketOptions options;
+  options.tcpNoDelay = true;
+
+  auto tcpServer = oatpp::network::server::SimpleTCPConnectionProvider::createShared(0, options);
+  auto tcp = measureTransport(TAG, "tcp loopback", tcpServer,
+                              oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", tcpServer->getPort(), options));
+
+  char path[108];
+  snprintf(path, sizeof(path), "/tmp/oatpp-perf-%d.sock", (int) getpid());
+  auto local = measureTransport(TAG, "unix", oatpp::network::server::SimpleUnixConnectionProvider::createShared(path),
+                                oatpp::network::client::SimpleUnixConnectionProvider::createShared(path));
+
+  OATPP_LOGD(TAG, "unix vs tcp: connect x%.2f, round trip x%.2f, transfer x%.2f",
+             (v_float64) tcp.connectMicros / local.connectMicros,
+             (v_float64) tcp.roundTripsMicros / local.roundTripsMicros,
+             (v_float64) tcp.transferMicros / local.transferMicros);
+
+}
+
+}}}
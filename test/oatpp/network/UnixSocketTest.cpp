@@ -0,0 +1,297 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "UnixSocketTest.hpp"
+
+#include "oatpp/web/app/Client.hpp"
+#include "oatpp/web/app/Controller.hpp"
+#include "oatpp/web/app/ControllerAsync.hpp"
+
+#include "oatpp/web/client/HttpRequestExecutor.hpp"
+#include "oatpp/web/server/AsyncHttpConnectionHandler.hpp"
+#include "oatpp/web/server/HttpConnectionHandler.hpp"
+#include "oatpp/web/server/HttpRouter.hpp"
+
+#include "oatpp/parser/json/mapping/ObjectMapper.hpp"
+
+#include "oatpp/network/server/SimpleUnixConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleUnixConnectionProvider.hpp"
+#include "oatpp/network/server/AsyncServer.hpp"
+#include "oatpp/network/server/Server.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <chrono>
+
+namespace oatpp { namespace test { namespace network {
+
+namespace {
+
+typedef oatpp::network::server::SimpleUnixConnectionProvider ServerProvider;
+typedef oatpp::network::client::SimpleUnixConnectionProvider ClientProvider;
+
+oatpp::String getSocketPath(const char* name) {
+  char path[108];
+  snprintf(path, sizeof(path), "/tmp/oatpp-test-%d-%s.sock", (int) getpid(), name);
+  return path;
+}
+
+void checkEcho(const std::shared_ptr<ServerProvider>& serverProvider,
+               const std::shared_ptr<ClientProvider>& clientProvider)
+{
+  auto clientConnection = clientProvider->getConnection();
+  OATPP_ASSERT(clientConnection);
+  auto serverConnection = serverProvider->getConnection();
+  OATPP_ASSERT(serverConnection);
+
+  OATPP_ASSERT(clientConnection->write("ping", 4) == 4);
+  v_char8 buffer[4];
+  OATPP_ASSERT(oatpp::data::stream::readExactSizeData(serverConnection.get(), buffer, 4) == 4);
+  OATPP_ASSERT(std::memcmp(buffer, "ping", 4) == 0);
+
+  OATPP_ASSERT(serverConnection->write("pong", 4) == 4);
+  OATPP_ASSERT(oatpp::data::stream::readExactSizeData(clientConnection.get(), buffer, 4) == 4);
+  OATPP_ASSERT(std::memcmp(buffer, "pong", 4) == 0);
+}
+
+class ConnectCoroutine : public oatpp::async::Coroutine<ConnectCoroutine> {
+private:
+  std::shared_ptr<ClientProvider> m_clientProvider;
+  std::shared_ptr<oatpp::data::stream::IOStream> m_connection;
+  std::atomic<bool>* m_done;
+  const void* m_data;
+  oatpp::data::v_io_size m_bytesLeft;
+public:
+
+  ConnectCoroutine(const std::shared_ptr<ClientProvider>& clientProvider, std::atomic<bool>* done)
+    : m_clientProvider(clientProvider)
+    , m_done(done)
+    , m_data("ping")
+    , m_bytesLeft(4)
+  {}
+
+  Action act() override {
+    ClientProvider::AsyncCallback callback = static_cast<ClientProvider::AsyncCallback>(&ConnectCoroutine::onConnected);
+    return m_clientProvider->getConnectionAsync(this, callback);
+  }
+
+  Action onConnected(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) {
+    m_connection = connection;
+    return yieldTo(&ConnectCoroutine::write);
+  }
+
+  Action write() {
+    return oatpp::data::stream::writeExactSizeDataAsyncInline(m_connection.get(), m_data, m_bytesLeft, yieldTo(&ConnectCoroutine::onWritten));
+  }
+
+  Action onWritten() {
+    *m_done = true;
+    return finish();
+  }
+
+};
+
+void checkHttp(const std::shared_ptr<oatpp::network::ClientConnectionProvider>& clientProvider,
+               const std::shared_ptr<oatpp::data::mapping::ObjectMapper>& objectMapper,
+               const char* expectedBody)
+{
+  auto client = oatpp::test::web::app::Client::createShared(oatpp::web::client::HttpRequestExecutor::createShared(clientProvider), objectMapper);
+
+  for(v_int32 i = 0; i < 10; i ++) {
+    auto response = client->getRoot();
+    OATPP_ASSERT(response->getStatusCode() == 200);
+    OATPP_ASSERT(response->readBodyToString() == expectedBody);
+  }
+
+  auto connection = client->getConnection();
+  for(v_int32 i = 0; i < 10; i ++) {
+    auto response = client->getWithParams("unix", connection);
+    OATPP_ASSERT(response->getStatusCode() == 200);
+    auto dto = response->readBodyToDto<oatpp::test::web::app::TestDto>(objectMapper);
+    OATPP_ASSERT(dto);
+    OATPP_ASSERT(dto->testValue == "unix");
+  }
+}
+
+}
+
+void UnixSocketTest::onRun() {
+
+  { // filesystem address, permissions, stale socket file
+    oatpp::String path = getSocketPath("fs");
+
+    {
+      auto serverProvider = ServerProvider::createShared(path, false, 0660);
+      struct stat fileStat;
+      OATPP_ASSERT(lstat((const char*) path->getData(), &fileStat) == 0);
+      OATPP_ASSERT(S_ISSOCK(fileStat.st_mode));
+      OATPP_ASSERT((fileStat.st_mode & 0777) == 0660);
+
+      checkEcho(serverProvider, ClientProvider::createShared(path));
+
+      serverProvider->close();
+      OATPP_ASSERT(lstat((const char*) path->getData(), &fileStat) != 0);
+    }
+
+    { // socket file left by a crashed server is replaced
+      oatpp::data::v_io_handle handle = socket(AF_UNIX, SOCK_STREAM, 0);
+      struct sockaddr_un addr;
+      std::memset(&addr, 0, sizeof(addr));
+      addr.sun_family = AF_UNIX;
+      std::memcpy(addr.sun_path, path->getData(), path->getSize());
+      OATPP_ASSERT(bind(handle, (struct sockaddr*) &addr, sizeof(addr)) == 0);
+      ::close(handle);
+
+      auto serverProvider = ServerProvider::createShared(path);
+      checkEcho(serverProvider, ClientProvider::createShared(path));
+    }
+
+    OATPP_ASSERT(!ClientProvider::createShared(path)->getConnection());
+  }
+
+#if defined(__linux__)
+  { // abstract namespace
+    oatpp::String path = getSocketPath("abstract");
+    path->getData()[0] = '@';
+    auto serverProvider = ServerProvider::createShared(path);
+    checkEcho(serverProvider, ClientProvider::createShared(path));
+  }
+#endif
+
+#if defined(__linux__)
+  { // listen backlog is taken from SocketOptions. Pending connections beyond it are refused
+    oatpp::String path = getSocketPath("backlog");
+    oatpp::network::SocketOptions options;
+    options.listenBacklog = 2;
+    auto serverProvider = ServerProvider::createShared(path, options);
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path->getData(), path->getSize());
+
+    oatpp::data::v_io_handle handles[16];
+    v_int32 connectedCount = 0;
+    while(connectedCount < 16) {
+      handles[connectedCount] = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+      if(connect(handles[connectedCount], (struct sockaddr*) &addr, sizeof(addr)) != 0) {
+        ::close(handles[connectedCount]);
+        break;
+      }
+      connectedCount ++;
+    }
+    OATPP_LOGD(TAG, "backlog=%d, pending connections=%d", options.listenBacklog, connectedCount);
+    OATPP_ASSERT(connectedCount > 0 && connectedCount <= options.listenBacklog + 1);
+
+    for(v_int32 i = 0; i < connectedCount; i ++) {
+      ::close(handles[i]);
+    }
+  }
+#endif
+
+  { // async connect
+    oatpp::String path = getSocketPath("async");
+    auto serverProvider = ServerProvider::createShared(path);
+    std::atomic<bool> done(false);
+
+    oatpp::async::Executor executor(1);
+    executor.execute<ConnectCoroutine>(ClientProvider::createShared(path), &done);
+
+    auto serverConnection = serverProvider->getConnection();
+    OATPP_ASSERT(serverConnection);
+    v_char8 buffer[4];
+    OATPP_ASSERT(oatpp::data::stream::readExactSizeData(serverConnection.get(), buffer, 4) == 4);
+    OATPP_ASSERT(std::memcmp(buffer, "ping", 4) == 0);
+
+    for(v_int32 i = 0; i < 500 && !done; i ++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    OATPP_ASSERT(done);
+
+    executor.stop();
+    executor.join();
+  }
+
+  auto objectMapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
+
+  { // HttpConnectionHandler + ApiClient
+    oatpp::String path = getSocketPath("http");
+
+    auto router = oatpp::web::server::HttpRouter::createShared();
+    oatpp::test::web::app::Controller::createShared(objectMapper)->addEndpointsToRouter(router);
+
+    auto serverProvider = ServerProvider::createShared(path);
+    auto handler = oatpp::web::server::HttpConnectionHandler::createShared(router);
+    oatpp::network::server::Server server(serverProvider, handler);
+    std::thread serverThread([&server] {
+      server.run();
+    });
+
+    checkHttp(ClientProvider::createShared(path), objectMapper, "Hello World!!!");
+
+    server.stop();
+    serverProvider->close();
+    serverThread.join();
+    handler->stop();
+
+    /* Connection threads are detached. Let them finish before the router is destroyed */
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  }
+
+  { // AsyncHttpConnectionHandler + ApiClient. Connections are accepted in the executor
+    oatpp::String path = getSocketPath("http-async");
+
+    auto router = oatpp::web::server::HttpRouter::createShared();
+    oatpp::test::web::app::ControllerAsync::createShared(objectMapper)->addEndpointsToRouter(router);
+
+    auto executor = std::make_shared<oatpp::async::Executor>(1);
+    auto serverProvider = ServerProvider::createShared(path, true /* nonBlocking */);
+    auto handler = oatpp::web::server::AsyncHttpConnectionHandler::createShared(router, executor);
+    auto server = oatpp::network::server::AsyncServer::createShared(serverProvider, handler, executor);
+    server->start();
+
+    checkHttp(ClientProvider::createShared(path), objectMapper, "Hello World Async!!!");
+
+    server->stop();
+
+    /* Accept coroutine is unwound on the next interrupts check, connection coroutines end once clients are gone */
+    for(v_int32 i = 0; i < 500 && executor->getProcessorLoad(0).tasksCount > 0; i ++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    OATPP_ASSERT(executor->getProcessorLoad(0).tasksCount == 0);
+
+    executor->stop();
+    executor->join();
+  }
+
+}
+
+}}}
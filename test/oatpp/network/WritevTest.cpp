@@ -0,0 +1,276 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "WritevTest.hpp"
+
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/web/protocol/http/outgoing/Response.hpp"
+#include "oatpp/web/protocol/http/outgoing/BufferBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/ChunkedBufferBody.hpp"
+#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+namespace oatpp { namespace test { namespace network {
+
+namespace {
+
+typedef oatpp::data::stream::IOVector IOVector;
+typedef oatpp::web::protocol::http::outgoing::Response Response;
+
+const v_int32 VECTORS_COUNT = 200;
+const v_int32 VECTOR_SIZE = 32 * 1024;
+
+/**
+ * Read from handle until EOF.
+ */
+oatpp::String readAll(oatpp::data::v_io_handle handle) {
+  auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  v_char8 data[4096];
+  while(true) {
+    auto res = ::read(handle, data, sizeof(data));
+    if(res <= 0) {
+      break;
+    }
+    buffer->write(data, res);
+  }
+  return buffer->toString();
+}
+
+/**
+ * VECTORS_COUNT vectors of VECTOR_SIZE. Vector i is filled with 'a' + i % 26.
+ */
+class VectorsData {
+public:
+  std::vector<v_char8> data;
+  std::vector<IOVector> vectors;
+public:
+  VectorsData()
+    : data(VECTORS_COUNT * VECTOR_SIZE)
+  {
+    for(v_int32 i = 0; i < VECTORS_COUNT; i ++) {
+      std::memset(&data[i * VECTOR_SIZE], 'a' + i % 26, VECTOR_SIZE);
+      vectors.push_back({&data[i * VECTOR_SIZE], VECTOR_SIZE});
+    }
+  }
+};
+
+void checkVectorsData(const oatpp::String& received, v_int32 offset) {
+  OATPP_ASSERT(received->getSize() == offset + VECTORS_COUNT * VECTOR_SIZE);
+  for(v_int32 i = 0; i < VECTORS_COUNT; i ++) {
+    p_char8 vectorData = &received->getData()[offset + i * VECTOR_SIZE];
+    OATPP_ASSERT(vectorData[0] == 'a' + i % 26 && vectorData[VECTOR_SIZE - 1] == 'a' + i % 26);
+  }
+}
+
+class WriteVectorsCoroutine : public oatpp::async::Coroutine<WriteVectorsCoroutine> {
+private:
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+  std::atomic<bool>* m_done;
+  VectorsData m_data;
+  IOVector* m_currVectors;
+  v_int32 m_currVectorsCount;
+public:
+
+  WriteVectorsCoroutine(const std::shared_ptr<oatpp::network::Connection>& connection, std::atomic<bool>* done)
+    : m_connection(connection)
+    , m_done(done)
+    , m_currVectors(m_data.vectors.data())
+    , m_currVectorsCount(VECTORS_COUNT)
+  {}
+
+  Action act() override {
+    return oatpp::data::stream::writeExactSizeDataVAsyncInline(m_connection.get(),
+                                                               m_currVectors,
+                                                               m_currVectorsCount,
+                                                               yieldTo(&WriteVectorsCoroutine::onWritten));
+  }
+
+  Action onWritten() {
+    m_connection.reset(); // close connection - EOF for the reader
+    *m_done = true;
+    return finish();
+  }
+
+};
+
+}
+
+void WritevTest::onRun() {
+
+  { // Connection::writev - single call for few vectors
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    auto connection = oatpp::network::Connection::createShared(handles[0]);
+
+    IOVector vectors[] = {{"Hello", 5}, {"", 0}, {", ", 2}, {"World!", 6}};
+    OATPP_ASSERT(connection->writev(vectors, 4) == 13);
+
+    connection.reset();
+    auto received = readAll(handles[1]);
+    ::close(handles[1]);
+    OATPP_ASSERT(received == "Hello, World!");
+  }
+
+  { // writeExactSizeDataV - more vectors than one call takes, partial writes on a small socket buffer
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+
+    oatpp::String received;
+    std::thread reader([&received, &handles] {
+      received = readAll(handles[1]);
+    });
+
+    VectorsData data;
+    {
+      auto connection = oatpp::network::Connection::createShared(handles[0]);
+      auto res = oatpp::data::stream::writeExactSizeDataV(connection.get(), data.vectors.data(), VECTORS_COUNT);
+      OATPP_ASSERT(res == VECTORS_COUNT * VECTOR_SIZE);
+    }
+
+    reader.join();
+    ::close(handles[1]);
+    checkVectorsData(received, 0);
+  }
+
+  { // OutputStreamBufferedProxy - buffered data goes before vectors, vectors are not copied to the buffer
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+
+    oatpp::String received;
+    std::thread reader([&received, &handles] {
+      received = readAll(handles[1]);
+    });
+
+    VectorsData data;
+    {
+      v_char8 buffer[1024];
+      auto proxy = oatpp::data::stream::OutputStreamBufferedProxy::createShared(oatpp::network::Connection::createShared(handles[0]),
+                                                                                buffer, sizeof(buffer));
+      proxy->write("prefix", 6);
+      auto res = oatpp::data::stream::writeExactSizeDataV(proxy.get(), data.vectors.data(), VECTORS_COUNT);
+      OATPP_ASSERT(res == VECTORS_COUNT * VECTOR_SIZE);
+      OATPP_ASSERT(proxy->flush() == 0);
+    }
+
+    reader.join();
+    ::close(handles[1]);
+    OATPP_ASSERT(std::memcmp(received->getData(), "prefix", 6) == 0);
+    checkVectorsData(received, 6);
+  }
+
+  { // Default OutputStream::writev
+    VectorsData data;
+    auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+    auto res = oatpp::data::stream::writeExactSizeDataV(buffer.get(), data.vectors.data(), VECTORS_COUNT);
+    OATPP_ASSERT(res == VECTORS_COUNT * VECTOR_SIZE);
+    checkVectorsData(buffer->toString(), 0);
+  }
+
+  { // writeExactSizeDataVAsyncInline - non-blocking connection, coroutine waits for writability
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+    std::atomic<bool> done(false);
+    oatpp::String received;
+
+    {
+      oatpp::async::Executor executor(1);
+      executor.execute<WriteVectorsCoroutine>(oatpp::network::Connection::createShared(handles[0]), &done);
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      OATPP_ASSERT(!done); // socket buffer is smaller than the data
+
+      received = readAll(handles[1]);
+
+      v_int32 waitMillis = 0;
+      while(executor.getProcessorLoad(0).tasksCount > 0 && waitMillis < 5000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        waitMillis += 10;
+      }
+
+      executor.stop();
+      executor.join();
+    }
+
+    ::close(handles[1]);
+    OATPP_ASSERT(done);
+    checkVectorsData(received, 0);
+  }
+
+  { // Response with in-memory body - headers and body are sent with gather-write, bypassing the proxy buffer
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+
+    oatpp::String received;
+    std::thread reader([&received, &handles] {
+      received = readAll(handles[1]);
+    });
+
+    {
+      v_char8 buffer[16];
+      auto proxy = oatpp::data::stream::OutputStreamBufferedProxy::createShared(oatpp::network::Connection::createShared(handles[0]),
+                                                                                buffer, sizeof(buffer));
+
+      auto response = Response::createShared(oatpp::web::protocol::http::Status::CODE_200,
+                                             oatpp::web::protocol::http::outgoing::BufferBody::createShared("Hello World!!!"));
+      response->send(proxy);
+
+      auto chunkedBuffer = oatpp::data::stream::ChunkedBuffer::createShared();
+      for(v_int32 i = 0; i < 1000; i ++) {
+        chunkedBuffer->write("0123456789", 10);
+      }
+      response = Response::createShared(oatpp::web::protocol::http::Status::CODE_404,
+                                        oatpp::web::protocol::http::outgoing::ChunkedBufferBody::createShared(chunkedBuffer));
+      response->send(proxy);
+
+      OATPP_ASSERT(proxy->flush() == 0);
+    }
+
+    reader.join();
+    ::close(handles[1]);
+
+    oatpp::String expected1 = "HTTP/1.1 200 OK\r\nContent-Length: 14\r\n\r\nHello World!!!";
+    oatpp::String expected2 = "HTTP/1.1 404 Not Found\r\nContent-Length: 10000\r\n\r\n";
+    OATPP_ASSERT(received->getSize() == expected1->getSize() + expected2->getSize() + 10000);
+    OATPP_ASSERT(std::memcmp(received->getData(), expected1->getData(), expected1->getSize()) == 0);
+    OATPP_ASSERT(std::memcmp(&received->getData()[expected1->getSize()], expected2->getData(), expected2->getSize()) == 0);
+    p_char8 body = &received->getData()[expected1->getSize() + expected2->getSize()];
+    for(v_int32 i = 0; i < 10000; i ++) {
+      OATPP_ASSERT(body[i] == '0' + i % 10);
+    }
+  }
+
+}
+
+}}}
@@ -0,0 +1,266 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "AsyncServerTest.hpp"
+
+#include "oatpp/network/server/AsyncServer.hpp"
+#include "oatpp/network/server/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/Connection.hpp"
+
+#include <fcntl.h>
+
+#include <cstring>
+
+#include <thread>
+#include <chrono>
+
+namespace oatpp { namespace test { namespace network { namespace server {
+
+namespace {
+
+const v_int32 CONNECTIONS_COUNT = 50;
+const v_int32 MESSAGE_SIZE = 4;
+
+class EchoCoroutine : public oatpp::async::Coroutine<EchoCoroutine> {
+private:
+  std::shared_ptr<oatpp::data::stream::IOStream> m_connection;
+  std::thread::id m_acceptThreadId;
+  std::atomic<v_int32>* m_localCount;
+  std::atomic<v_int32>* m_doneCount;
+  v_char8 m_buffer[MESSAGE_SIZE];
+  void* m_bufferPtr;
+  const void* m_writePtr;
+  oatpp::data::v_io_size m_bytesLeft;
+public:
+
+  EchoCoroutine(const std::shared_ptr<oatpp::data::stream::IOStream>& connection,
+                std::thread::id acceptThreadId,
+                std::atomic<v_int32>* localCount,
+                std::atomic<v_int32>* doneCount)
+    : m_connection(connection)
+    , m_acceptThreadId(acceptThreadId)
+    , m_localCount(localCount)
+    , m_doneCount(doneCount)
+    , m_bufferPtr(m_buffer)
+    , m_writePtr(m_buffer)
+    , m_bytesLeft(MESSAGE_SIZE)
+  {}
+
+  Action act() override {
+    if(std::this_thread::get_id() == m_acceptThreadId) {
+      (*m_localCount) ++;
+    }
+    return yieldTo(&EchoCoroutine::read);
+  }
+
+  Action read() {
+    return oatpp::data::stream::readExactSizeDataAsyncInline(m_connection.get(), m_bufferPtr, m_bytesLeft, yieldTo(&EchoCoroutine::onRead));
+  }
+
+  Action onRead() {
+    m_writePtr = m_buffer;
+    m_bytesLeft = MESSAGE_SIZE;
+    return yieldTo(&EchoCoroutine::write);
+  }
+
+  Action write() {
+    return oatpp::data::stream::writeExactSizeDataAsyncInline(m_connection.get(), m_writePtr, m_bytesLeft, yieldTo(&EchoCoroutine::onWritten));
+  }
+
+  Action onWritten() {
+    (*m_doneCount) ++;
+    return finish();
+  }
+
+};
+
+class EchoConnectionHandler : public oatpp::network::server::ConnectionHandler {
+private:
+  std::shared_ptr<oatpp::async::Executor> m_executor;
+  std::atomic<v_int32>* m_localCount;
+  std::atomic<v_int32>* m_doneCount;
+public:
+
+  std::atomic<v_int32> acceptedCount;
+  std::atomic<v_int32> flagsOkCount;
+
+public:
+
+  EchoConnectionHandler(const std::shared_ptr<oatpp::async::Executor>& executor,
+                        std::atomic<v_int32>* localCount,
+                        std::atomic<v_int32>* doneCount)
+    : m_executor(executor)
+    , m_localCount(localCount)
+    , m_doneCount(doneCount)
+    , acceptedCount(0)
+    , flagsOkCount(0)
+  {}
+
+  void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override {
+    acceptedCount ++;
+    auto handle = std::static_pointer_cast<oatpp::network::Connection>(connection)->getHandle();
+    if((fcntl(handle, F_GETFL) & O_NONBLOCK) != 0 && (fcntl(handle, F_GETFD) & FD_CLOEXEC) != 0) {
+      flagsOkCount ++;
+    }
+    m_executor->executeLocal<EchoCoroutine>(connection, std::this_thread::get_id(), m_localCount, m_doneCount);
+  }
+
+  void stop() override {
+    // DO NOTHING
+  }
+
+};
+
+/**
+ * Fails first accepts with an error. Then accepts with the wrapped provider.
+ */
+class FailingConnectionProvider : public oatpp::network::ServerConnectionProvider {
+private:
+  std::shared_ptr<oatpp::network::ServerConnectionProvider> m_provider;
+public:
+
+  std::atomic<v_int32> failuresLeft;
+
+public:
+
+  FailingConnectionProvider(const std::shared_ptr<oatpp::network::ServerConnectionProvider>& provider, v_int32 failuresCount)
+    : m_provider(provider)
+    , failuresLeft(failuresCount)
+  {}
+
+  std::shared_ptr<IOStream> getConnection() override {
+    return m_provider->getConnection();
+  }
+
+  Action getConnectionAsync(oatpp::async::AbstractCoroutine* parentCoroutine, AsyncCallback callback) override {
+    if(failuresLeft > 0) {
+      failuresLeft --;
+      return oatpp::async::Action(oatpp::async::Error("[FailingConnectionProvider::getConnectionAsync()]: Error. Accept failed."));
+    }
+    return m_provider->getConnectionAsync(parentCoroutine, callback);
+  }
+
+  void close() override {
+    m_provider->close();
+  }
+
+};
+
+void testAcceptErrorsDontStopServer() {
+
+  std::atomic<v_int32> localCount(0);
+  std::atomic<v_int32> doneCount(0);
+
+  auto executor = std::make_shared<oatpp::async::Executor>(1);
+  auto tcpProvider = oatpp::network::server::SimpleTCPConnectionProvider::createShared(0, true /* nonBlocking */);
+  auto provider = std::make_shared<FailingConnectionProvider>(tcpProvider, 3);
+  auto handler = std::make_shared<EchoConnectionHandler>(executor, &localCount, &doneCount);
+
+  auto server = oatpp::network::server::AsyncServer::createShared(provider, handler, executor);
+  server->start();
+
+  auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", tcpProvider->getPort());
+  auto connection = clientProvider->getConnection();
+  OATPP_ASSERT(connection);
+  OATPP_ASSERT(connection->write("ping", MESSAGE_SIZE) == MESSAGE_SIZE);
+  v_char8 buffer[MESSAGE_SIZE];
+  OATPP_ASSERT(oatpp::data::stream::readExactSizeData(connection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+  OATPP_ASSERT(std::memcmp(buffer, "ping", MESSAGE_SIZE) == 0);
+  OATPP_ASSERT(provider->failuresLeft == 0);
+
+  server->stop();
+  for(v_int32 i = 0; i < 500 && executor->getProcessorLoad(0).tasksCount > 0; i ++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  OATPP_ASSERT(executor->getProcessorLoad(0).tasksCount == 0);
+
+  executor->stop();
+  executor->join();
+
+}
+
+}
+
+void AsyncServerTest::onRun() {
+
+  OATPP_LOGD(TAG, "Accept errors don't stop the server");
+  testAcceptErrorsDontStopServer();
+
+  std::atomic<v_int32> localCount(0);
+  std::atomic<v_int32> doneCount(0);
+
+  auto executor = std::make_shared<oatpp::async::Executor>(2);
+  auto provider = oatpp::network::server::SimpleTCPConnectionProvider::createShared(0, true /* nonBlocking */);
+  auto handler = std::make_shared<EchoConnectionHandler>(executor, &localCount, &doneCount);
+
+  auto server = oatpp::network::server::AsyncServer::createShared(provider, handler, executor);
+  server->start();
+
+  auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", provider->getPort());
+
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT; i ++) {
+    auto connection = clientProvider->getConnection();
+    OATPP_ASSERT(connection);
+    OATPP_ASSERT(connection->write("ping", MESSAGE_SIZE) == MESSAGE_SIZE);
+    v_char8 buffer[MESSAGE_SIZE];
+    OATPP_ASSERT(oatpp::data::stream::readExactSizeData(connection.get(), buffer, MESSAGE_SIZE) == MESSAGE_SIZE);
+    OATPP_ASSERT(std::memcmp(buffer, "ping", MESSAGE_SIZE) == 0);
+  }
+
+  for(v_int32 i = 0; i < 500 && doneCount < CONNECTIONS_COUNT; i ++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  OATPP_LOGD(TAG, "accepted=%d, flags ok=%d, started locally=%d, done=%d",
+             handler->acceptedCount.load(), handler->flagsOkCount.load(), localCount.load(), doneCount.load());
+
+  OATPP_ASSERT(handler->acceptedCount == CONNECTIONS_COUNT);
+  OATPP_ASSERT(handler->flagsOkCount == CONNECTIONS_COUNT);
+  OATPP_ASSERT(localCount == CONNECTIONS_COUNT);
+  OATPP_ASSERT(doneCount == CONNECTIONS_COUNT);
+
+  server->stop();
+
+  /* Accept coroutine is unwound on the next interrupts check and closes the listening socket */
+  auto executorTasksCount = [&executor] {
+    v_int32 count = 0;
+    for(v_int32 i = 0; i < executor->getThreadsCount(); i ++) {
+      count += executor->getProcessorLoad(i).tasksCount;
+    }
+    return count;
+  };
+  for(v_int32 i = 0; i < 500 && executorTasksCount() > 0; i ++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  OATPP_ASSERT(executorTasksCount() == 0);
+  OATPP_ASSERT(!clientProvider->getConnection());
+
+  executor->stop();
+  executor->join();
+
+}
+
+}}}}
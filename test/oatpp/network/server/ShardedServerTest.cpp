@@ -0,0 +1,122 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "ShardedServerTest.hpp"
+
+#include "oatpp/network/server/ShardedServer.hpp"
+#include "oatpp/network/server/SimpleTCPConnectionProvider.hpp"
+#include "oatpp/network/client/SimpleTCPConnectionProvider.hpp"
+
+#include <thread>
+#include <chrono>
+
+namespace oatpp { namespace test { namespace network { namespace server {
+
+namespace {
+
+const v_int32 SHARDS_COUNT = 4;
+const v_int32 CONNECTIONS_COUNT = 200;
+
+class CountingConnectionHandler : public oatpp::network::server::ConnectionHandler {
+private:
+  std::atomic<v_int32>* m_counter;
+  std::atomic<v_int32>* m_totalCounter;
+public:
+
+  CountingConnectionHandler(std::atomic<v_int32>* counter, std::atomic<v_int32>* totalCounter)
+    : m_counter(counter)
+    , m_totalCounter(totalCounter)
+  {}
+
+  void handleConnection(const std::shared_ptr<oatpp::data::stream::IOStream>& connection) override {
+    (*m_counter) ++;
+    (*m_totalCounter) ++;
+  }
+
+  void stop() override {
+    // DO NOTHING
+  }
+
+};
+
+}
+
+void ShardedServerTest::onRun() {
+
+  std::atomic<v_int32> counters[SHARDS_COUNT];
+  std::atomic<v_int32> totalCounter(0);
+  for(v_int32 i = 0; i < SHARDS_COUNT; i ++) {
+    counters[i] = 0;
+  }
+
+  auto server = oatpp::network::server::ShardedServer::createTCPShared(0, SHARDS_COUNT, [&counters, &totalCounter](v_int32 shardIndex) {
+    return std::make_shared<CountingConnectionHandler>(&counters[shardIndex], &totalCounter);
+  });
+
+  OATPP_ASSERT(server->getShardsCount() == SHARDS_COUNT);
+
+  auto firstProvider = std::static_pointer_cast<oatpp::network::server::SimpleTCPConnectionProvider>(server->getConnectionProvider(0));
+  v_word16 port = firstProvider->getPort();
+  OATPP_ASSERT(port != 0);
+
+  for(v_int32 i = 0; i < SHARDS_COUNT; i ++) {
+    auto provider = std::static_pointer_cast<oatpp::network::server::SimpleTCPConnectionProvider>(server->getConnectionProvider(i));
+    OATPP_ASSERT(provider->isReusePort());
+    OATPP_ASSERT(provider->getPort() == port);
+  }
+
+  std::thread serverThread([server]{
+    server->run();
+  });
+
+  auto clientProvider = oatpp::network::client::SimpleTCPConnectionProvider::createShared("127.0.0.1", port);
+  for(v_int32 i = 0; i < CONNECTIONS_COUNT; i ++) {
+    auto connection = clientProvider->getConnection();
+    OATPP_ASSERT(connection);
+  }
+
+  for(v_int32 i = 0; i < 500 && totalCounter < CONNECTIONS_COUNT; i ++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  server->stop();
+  serverThread.join();
+
+  OATPP_ASSERT(totalCounter == CONNECTIONS_COUNT);
+
+  v_int32 activeShards = 0;
+  for(v_int32 i = 0; i < SHARDS_COUNT; i ++) {
+    OATPP_LOGD(TAG, "shard[%d] accepted %d connections", i, counters[i].load());
+    if(counters[i] > 0) {
+      activeShards ++;
+    }
+  }
+
+  // kernel distributes connections by hash of the source port. All 200 on one shard is practically impossible.
+  OATPP_ASSERT(activeShards > 1);
+
+}
+
+}}}}
@@ -147,6 +147,13 @@ void FullAsyncTest::onRun() {
         OATPP_ASSERT(dto->testValue == "my_test_body-Async");
       }
 
+      { // test endpoint declaring its priority class
+        auto response = client->getPriority(connection);
+        OATPP_ASSERT(response->getStatusCode() == 200);
+        auto value = response->readBodyToString();
+        OATPP_ASSERT(value == oatpp::utils::conversion::int32ToStr(oatpp::async::Priority::BULK));
+      }
+
       { // test Big Echo with body
         oatpp::data::stream::ChunkedBuffer stream;
         for(v_int32 i = 0; i < oatpp::data::buffer::IOBuffer::BUFFER_SIZE; i++) {
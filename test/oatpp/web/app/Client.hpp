@@ -42,6 +42,7 @@ class Client : public oatpp::web::client::ApiClient {
   API_CALL("GET", "headers", getWithHeaders, HEADER(String, param, "X-TEST-HEADER"))
   API_CALL("POST", "body", postBody, BODY_STRING(String, body))
   API_CALL("POST", "echo", echoBody, BODY_STRING(String, body))
+  API_CALL("GET", "priority", getPriority)
   
 #include OATPP_CODEGEN_END(ApiClient)
 };
@@ -31,6 +31,7 @@
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp"
 #include "oatpp/core/macro/codegen.hpp"
 #include "oatpp/core/macro/component.hpp"
+#include "oatpp/core/utils/ConversionUtils.hpp"
 
 namespace oatpp { namespace test { namespace web { namespace app {
   
@@ -122,6 +123,19 @@ public:
 
   };
   
+  ENDPOINT_INFO(GetPriority) {
+    info->priority = oatpp::async::Priority::BULK;
+  }
+  ENDPOINT_ASYNC("GET", "priority", GetPriority) {
+
+    ENDPOINT_ASYNC_INIT(GetPriority)
+
+    Action act() {
+      return _return(controller->createResponse(Status::CODE_200, oatpp::utils::conversion::int32ToStr(getPriority())));
+    }
+
+  };
+  
 #include OATPP_CODEGEN_END(ApiController)
   
 };
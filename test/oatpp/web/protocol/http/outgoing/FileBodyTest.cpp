@@ -0,0 +1,281 @@
+/***************************************************************************
+ *
+ * Project         _____    __   ____   _      _
+ *                (  _  )  /__\ (_  _)_| |_  _| |_
+ *                 )(_)(  /(__)\  )( (_   _)(_   _)
+ *                (_____)(__)(__)(__)  |_|    |_|
+ *
+ *
+ * Copyright 2018-present, Leonid Stryzhevskyi <lganzzzo@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include "FileBodyTest.hpp"
+
+#include "oatpp/web/protocol/http/outgoing/FileBody.hpp"
+#include "oatpp/web/protocol/http/outgoing/ResponseFactory.hpp"
+#include "oatpp/network/Connection.hpp"
+#include "oatpp/core/data/stream/StreamBufferedProxy.hpp"
+#include "oatpp/core/data/stream/ChunkedBuffer.hpp"
+#include "oatpp/core/async/Executor.hpp"
+
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include <cstdio>
+#include <thread>
+
+namespace oatpp { namespace test { namespace web { namespace protocol { namespace http { namespace outgoing {
+
+namespace {
+
+typedef oatpp::web::protocol::http::outgoing::FileBody FileBody;
+typedef oatpp::web::protocol::http::outgoing::Response Response;
+typedef oatpp::web::protocol::http::outgoing::ResponseFactory ResponseFactory;
+typedef oatpp::web::protocol::http::Range Range;
+
+const v_int32 FILE_SIZE = 1024 * 1024 + 17;
+
+v_char8 fileByte(v_int64 position) {
+  return (v_char8) ((position * 7) % 251);
+}
+
+oatpp::String createFile() {
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/oatpp-file-body-%d.bin", (int) getpid());
+  auto data = oatpp::String(FILE_SIZE);
+  for(v_int32 i = 0; i < FILE_SIZE; i ++) {
+    data->getData()[i] = fileByte(i);
+  }
+  data->saveToFile(path);
+  return oatpp::String(path);
+}
+
+/**
+ * Read from handle until EOF. Handle is closed.
+ */
+oatpp::String receive(oatpp::data::v_io_handle handle) {
+  auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  v_char8 data[4096];
+  oatpp::data::stream::transfer(oatpp::network::Connection::createShared(handle), buffer, 0, data, sizeof(data));
+  return buffer->toString();
+}
+
+/**
+ * Check serialized response - status line, header and body which is expected to be the file data from `start` to `end`.
+ */
+void checkResponse(const oatpp::String& received, const char* statusLine, const char* header, v_int64 start, v_int64 end) {
+
+  v_int32 statusLineSize = (v_int32) std::strlen(statusLine);
+  OATPP_ASSERT(received->getSize() >= statusLineSize && std::memcmp(received->getData(), statusLine, statusLineSize) == 0);
+
+  oatpp::String text((const char*) received->getData(), received->getSize(), false);
+  auto headersEnd = std::strstr(text->c_str(), "\r\n\r\n");
+  OATPP_ASSERT(headersEnd != nullptr);
+  v_int64 headersSize = headersEnd - text->c_str() + 4;
+  oatpp::String headers(text->c_str(), (v_int32) headersSize, true);
+  OATPP_ASSERT(std::strstr(headers->c_str(), header) != nullptr);
+
+  p_char8 body = &received->getData()[headersSize];
+  v_int64 bodySize = received->getSize() - headersSize;
+  OATPP_ASSERT(bodySize == end - start);
+  for(v_int64 i = 0; i < bodySize; i ++) {
+    OATPP_ASSERT(body[i] == fileByte(start + i));
+  }
+
+}
+
+oatpp::String sendToBuffer(const std::shared_ptr<Response>& response) {
+  auto buffer = oatpp::data::stream::ChunkedBuffer::createShared();
+  response->send(buffer);
+  return buffer->toString();
+}
+
+class SendCoroutine : public oatpp::async::Coroutine<SendCoroutine> {
+private:
+  std::shared_ptr<Response> m_response;
+  std::shared_ptr<oatpp::network::Connection> m_connection;
+public:
+
+  SendCoroutine(const std::shared_ptr<Response>& response, const std::shared_ptr<oatpp::network::Connection>& connection)
+    : m_response(response)
+    , m_connection(connection)
+  {}
+
+  Action act() override {
+    return m_response->sendAsync(this, yieldTo(&SendCoroutine::onSent), m_connection);
+  }
+
+  Action onSent() {
+    m_connection.reset(); // close connection - EOF for the reader
+    return finish();
+  }
+
+};
+
+}
+
+void FileBodyTest::onRun() {
+
+  OATPP_ASSERT(FileBody::createShared("/tmp/oatpp-file-body-does-not-exist") == nullptr);
+  OATPP_ASSERT(FileBody::createShared("/tmp") == nullptr);
+
+  { // Range parsing - open and suffix ranges
+    auto range = Range::parse(oatpp::String("bytes=100-"));
+    OATPP_ASSERT(range.isValid() && range.start == 100 && range.end == -1);
+    OATPP_ASSERT(range.toString() == "bytes=100-");
+    range = Range::parse(oatpp::String("bytes=-500"));
+    OATPP_ASSERT(range.isValid() && range.start == -1 && range.end == 500);
+    OATPP_ASSERT(range.toString() == "bytes=-500");
+    range = Range::parse(oatpp::String("bytes=-"));
+    OATPP_ASSERT(!range.isValid());
+    range = Range::parse(oatpp::String("bytes=abc-"));
+    OATPP_ASSERT(!range.isValid());
+    range = Range::parse(oatpp::String("bytes=10-2x"));
+    OATPP_ASSERT(!range.isValid());
+    range = Range::parse(oatpp::String("bytes=500-100"));
+    OATPP_ASSERT(!range.isValid());
+  }
+
+  auto path = createFile();
+
+  { // whole file and ranges - default writeFile (pread + write)
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), nullptr)),
+                  "HTTP/1.1 200 ", "Accept-Ranges: bytes\r\n", 0, FILE_SIZE);
+
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=100-199")),
+                  "HTTP/1.1 206 ", "Content-Range: bytes 100-199/1048593\r\n", 100, 200);
+
+    // resumable download
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=1000000-")),
+                  "HTTP/1.1 206 ", "Content-Range: bytes 1000000-1048592/1048593\r\n", 1000000, FILE_SIZE);
+
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=-500")),
+                  "HTTP/1.1 206 ", "Content-Length: 500\r\n", FILE_SIZE - 500, FILE_SIZE);
+
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=1000-99999999")),
+                  "HTTP/1.1 206 ", "Content-Range: bytes 1000-1048592/1048593\r\n", 1000, FILE_SIZE);
+
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=1048593-")),
+                  "HTTP/1.1 416 ", "Content-Range: bytes */1048593\r\n", 0, 0);
+
+    // malformed ranges are ignored - whole file
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=abc-")),
+                  "HTTP/1.1 200 ", "Content-Length: 1048593\r\n", 0, FILE_SIZE);
+
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=500-100")),
+                  "HTTP/1.1 200 ", "Content-Length: 1048593\r\n", 0, FILE_SIZE);
+
+    // multiple ranges are not supported - whole file
+    checkResponse(sendToBuffer(ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=0-1,5-6")),
+                  "HTTP/1.1 200 ", "Content-Length: 1048593\r\n", 0, FILE_SIZE);
+  }
+
+  { // sendfile - blocking connection through buffered proxy
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+
+    oatpp::String received;
+    std::thread reader([&received, &handles] {
+      received = receive(handles[1]);
+    });
+
+    {
+      v_char8 buffer[1024];
+      auto proxy = oatpp::data::stream::OutputStreamBufferedProxy::createShared(oatpp::network::Connection::createShared(handles[0]),
+                                                                                buffer, sizeof(buffer));
+      auto response = ResponseFactory::createShared(FileBody::createShared(path->c_str()), "bytes=10-");
+      response->send(proxy);
+      OATPP_ASSERT(proxy->flush() == 0);
+    }
+
+    reader.join();
+    checkResponse(received, "HTTP/1.1 206 ", "Content-Range: bytes 10-1048592/1048593\r\n", 10, FILE_SIZE);
+  }
+
+  { // sendfile - non-blocking connection, coroutine waits for writability
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    fcntl(handles[0], F_SETFL, O_NONBLOCK);
+
+    oatpp::String received;
+
+    {
+      oatpp::async::Executor executor(1);
+      executor.execute<SendCoroutine>(ResponseFactory::createShared(FileBody::createShared(path->c_str()), nullptr),
+                                      oatpp::network::Connection::createShared(handles[0]));
+
+      received = receive(handles[1]);
+
+      v_int32 waitMillis = 0;
+      while(executor.getProcessorLoad(0).tasksCount > 0 && waitMillis < 5000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        waitMillis += 10;
+      }
+
+      executor.stop();
+      executor.join();
+    }
+
+    checkResponse(received, "HTTP/1.1 200 ", "Content-Length: 1048593\r\n", 0, FILE_SIZE);
+  }
+
+  { // peer closed connection - error is returned, no SIGPIPE
+    oatpp::data::v_io_handle handles[2];
+    OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+    ::close(handles[1]);
+
+    auto connection = oatpp::network::Connection::createShared(handles[0]);
+    auto fileHandle = ::open(path->c_str(), O_RDONLY);
+    OATPP_ASSERT(connection->writeFile(fileHandle, 0, 100) == oatpp::data::IOError::BROKEN_PIPE);
+    ::close(fileHandle);
+  }
+
+  { // peer closed connection - SIGPIPE is blocked by the thread already, signal mask is left as is
+    std::thread writer([&path] {
+      sigset_t pipeSet;
+      sigemptyset(&pipeSet);
+      sigaddset(&pipeSet, SIGPIPE);
+      pthread_sigmask(SIG_BLOCK, &pipeSet, nullptr);
+
+      oatpp::data::v_io_handle handles[2];
+      OATPP_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, handles) == 0);
+      ::close(handles[1]);
+
+      auto connection = oatpp::network::Connection::createShared(handles[0]);
+      auto fileHandle = ::open(path->c_str(), O_RDONLY);
+      OATPP_ASSERT(connection->writeFile(fileHandle, 0, 100) == oatpp::data::IOError::BROKEN_PIPE);
+      ::close(fileHandle);
+
+      sigset_t currentSet;
+      pthread_sigmask(SIG_BLOCK, nullptr, &currentSet);
+      OATPP_ASSERT(sigismember(&currentSet, SIGPIPE) == 1);
+
+      /* Pending signal stays with the thread which blocked it */
+      struct timespec zeroTimeout = {0, 0};
+      sigtimedwait(&pipeSet, nullptr, &zeroTimeout);
+    });
+    writer.join();
+  }
+
+  std::remove(path->c_str());
+
+}
+
+}}}}}}